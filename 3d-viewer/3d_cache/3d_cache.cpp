@@ -24,15 +24,23 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <mutex>
+#include <set>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
+#include <wx/intl.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
 
@@ -49,6 +57,7 @@
 
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_mesh_cache.h"
 #include "3d_plugin_manager.h"
 #include "sg/scenegraph.h"
 #include "plugins/3dapi/ifsg_api.h"
@@ -56,13 +65,16 @@
 #include <filename_resolver.h>
 #include <pgm_base.h>
 #include <project.h>
+#include <reporter.h>
 #include <settings/common_settings.h>
 #include <settings/settings_manager.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static std::mutex mutex3D_cache;
+#define SCENE_CACHE_EXT wxT( ".3dc" )   // scene graph cache files
+#define MESH_CACHE_EXT  wxT( ".3dm" )   // render data (mesh) cache files
+
 static std::mutex mutex3D_cacheManager;
 
 
@@ -132,33 +144,58 @@ private:
 
 public:
     S3D_CACHE_ENTRY();
-    ~S3D_CACHE_ENTRY();
 
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName();
 
+    // release sceneData and renderData before a reload: the render data already returned
+    // by S3D_CACHE::GetModel() is freed when its users release it
+    void RetireData();
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
-    SCENEGRAPH*   sceneData;
-    S3DMODEL*     renderData;
+    std::shared_ptr<SCENEGRAPH> sceneData;
+    bool          sceneLoaded;  // false until the scene is needed: renderData can come from
+                                // the mesh cache file without it
+    std::shared_ptr<S3DMODEL> renderData;   // shared with the renderers using it
+    bool          renderDataMapped;         // renderData is mapped from a mesh cache file
+
+    std::shared_future<void> loaded;    // ready when the first load of sceneData is done
+    std::mutex    lock;         // protects the reloads and renderData
 };
 
 
+/**
+ * Take the ownership of a scene loaded by the plugins or read from a cache file
+ */
+static std::shared_ptr<SCENEGRAPH> shareScene( SCENEGRAPH* aScene )
+{
+    if( NULL == aScene )
+        return nullptr;
+
+    return std::shared_ptr<SCENEGRAPH>( aScene,
+                                        []( SCENEGRAPH* aNode )
+                                        {
+                                            S3D::DestroyNode( (SGNODE*) aNode );
+                                        } );
+}
+
+
 S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
-    sceneData = NULL;
-    renderData = NULL;
+    sceneLoaded = false;
+    renderDataMapped = false;
     memset( sha1sum, 0, 20 );
 }
 
 
-S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
+void S3D_CACHE_ENTRY::RetireData()
 {
-    delete sceneData;
-
-    if( NULL != renderData )
-        S3D::Destroy3DModel( &renderData );
+    sceneData.reset();
+    renderData.reset();
+    renderDataMapped = false;
+    sceneLoaded = false;
 }
 
 
@@ -173,6 +210,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
 }
 
 
@@ -212,7 +250,8 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr,
+                             bool aNeedScene )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
@@ -227,57 +266,92 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    std::lock_guard<std::mutex> lock( mutex3D_cache );
+    // check cache if file is already loaded, or create the entry
+    S3D_CACHE_ENTRY*   ep = NULL;
+    bool               isNewEntry = false;
+    std::promise<void> loadPromise;
 
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    {
+        std::lock_guard<std::mutex> lock( m_CacheMutex );
+
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( full3Dpath );
+
+        if( mi != m_CacheMap.end() )
+        {
+            ep = mi->second;
+        }
+        else
+        {
+            ep = new S3D_CACHE_ENTRY;
+            ep->loaded = loadPromise.get_future().share();
+
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( full3Dpath, ep ) );
+            isNewEntry = true;
+        }
+    }
 
-    if( mi != m_CacheMap.end() )
+    if( isNewEntry )
     {
-        wxFileName fname( full3Dpath );
+        // this thread loads the new entry, without holding the cache map lock.  The
+        // waiting threads must be released whatever happens.
+        try
+        {
+            loadCacheEntry( full3Dpath, ep, aNeedScene );
+        }
+        catch( ... )
+        {
+            loadPromise.set_value();
+            throw;
+        }
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+        // read before releasing the waiting threads, which can reload the entry
+        SCENEGRAPH* sceneData = ep->sceneData.get();
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
+        loadPromise.set_value();
 
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+        if( NULL != aCachePtr )
+            *aCachePtr = ep;
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+        return sceneData;
+    }
+
+    // the entry exists: wait for the thread which loads it
+    ep->loaded.wait();
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+    wxFileName fname( full3Dpath );
+    std::lock_guard<std::mutex> lock( ep->lock );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
+
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( full3Dpath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
+            {
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
         }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
-
-        return mi->second->sceneData;
+        // the renderers can still use the previous render data
+        if( reload )
+            ep->RetireData();
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    loadEntryData( full3Dpath, ep, aNeedScene );
+
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
+
+    return ep->sceneData.get();
 }
 
 
@@ -287,75 +361,52 @@ SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+void S3D_CACHE::loadCacheEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                                bool aNeedScene )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
+    wxFileName fname( aFileName );
+    aCacheItem->modTime = fname.GetModificationTime();
 
     unsigned char sha1sum[20];
 
+    // just in case we can't get a hash digest (for example, on access issues)
+    // or we do not have a configured cache file directory, the entry is left
+    // empty to prevent further attempts at loading the file
     if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
-
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
-        }
-
-        return NULL;
+        aCacheItem->sceneLoaded = true;
+        return;
     }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    aCacheItem->SetSHA1( sha1sum );
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+    loadEntryData( aFileName, aCacheItem, aNeedScene );
+}
 
-        m_CacheList.pop_back();
-        delete ep;
-        return NULL;
-    }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+void S3D_CACHE::loadEntryData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                               bool aNeedScene )
+{
+    if( aCacheItem->sceneLoaded )
+        return;
 
-    ep->SetSHA1( sha1sum );
+    // the render data alone is enough: the mesh cache file avoids loading the scene
+    if( !aNeedScene && ( aCacheItem->renderData || loadMeshCacheData( aCacheItem ) ) )
+        return;
 
-    wxString bname = ep->GetCacheBaseName();
-    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+    aCacheItem->sceneLoaded = true;
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    wxString bname = aCacheItem->GetCacheBaseName();
+    wxString cachename = m_CacheDir + bname + SCENE_CACHE_EXT;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    aCacheItem->sceneData = shareScene( m_Plugins->Load3DModel( aFileName,
+                                                                aCacheItem->pluginInfo ) );
 
-    return ep->sceneData;
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 }
 
 
@@ -435,7 +486,7 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
         return false;
     }
 
-    wxString fname = m_CacheDir + bname + wxT( ".3dc" );
+    wxString fname = m_CacheDir + bname + SCENE_CACHE_EXT;
 
     if( !wxFileName::FileExists( fname ) )
     {
@@ -444,10 +495,8 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
         return false;
     }
 
-    if( NULL != aCacheItem->sceneData )
-        S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
-
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    aCacheItem->sceneData = shareScene( (SCENEGRAPH*) S3D::ReadCache( fname.ToUTF8(), m_Plugins,
+                                                                      checkTag ) );
 
     if( NULL == aCacheItem->sceneData )
         return false;
@@ -492,7 +541,7 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         return false;
     }
 
-    wxString fname = m_CacheDir + bname + wxT( ".3dc" );
+    wxString fname = m_CacheDir + bname + SCENE_CACHE_EXT;
 
     if( wxFileName::Exists( fname ) )
     {
@@ -505,11 +554,52 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
-    return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
+    return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData.get(),
         aCacheItem->pluginInfo.c_str() );
 }
 
 
+bool S3D_CACHE::loadMeshCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + bname + MESH_CACHE_EXT;
+
+    if( !wxFileName::FileExists( fname ) )
+        return false;
+
+    std::shared_ptr<S3D_MESH_CACHE> meshCache = std::make_shared<S3D_MESH_CACHE>();
+
+    if( !meshCache->Open( fname, m_Plugins, checkTag ) )
+        return false;
+
+    // the render data keeps the mapped file alive
+    aCacheItem->renderData = std::shared_ptr<S3DMODEL>( meshCache, meshCache->GetModel() );
+    aCacheItem->renderDataMapped = true;
+    aCacheItem->pluginInfo = meshCache->GetPluginInfo();
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveMeshCacheData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( NULL == aCacheItem->renderData || aCacheItem->renderDataMapped )
+        return false;
+
+    wxString bname = aCacheItem->GetCacheBaseName();
+
+    if( bname.empty() || m_CacheDir.empty() )
+        return false;
+
+    return S3D::WriteMeshCache( m_CacheDir + bname + MESH_CACHE_EXT, *aCacheItem->renderData,
+                                aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -597,6 +687,8 @@ bool S3D_CACHE::SetProject( PROJECT* aProject )
 
     if( m_FNResolver->SetProject( aProject, &hasChanged ) && hasChanged )
     {
+        std::lock_guard<std::mutex> lock( m_CacheMutex );
+
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -637,6 +729,8 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters() const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    std::unique_lock<std::mutex> lock( m_CacheMutex );
+
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -649,6 +743,8 @@ void S3D_CACHE::FlushCache( bool closePlugins )
     m_CacheList.clear();
     m_CacheMap.clear();
 
+    lock.unlock();
+
     if( closePlugins )
         ClosePlugins();
 }
@@ -661,37 +757,103 @@ void S3D_CACHE::ClosePlugins()
 }
 
 
-S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
+std::shared_ptr<S3DMODEL> S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
     S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
 
-    if( !sp )
-        return NULL;
+    // the scene is only loaded if the render data is not in the mesh cache
+    load( aModelFileName, &cp, false );
 
     if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
+        return nullptr;
 
-        return NULL;
-    }
+    std::lock_guard<std::mutex> lock( cp->lock );
 
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    if( !cp->sceneData )
+        return nullptr;
+
+    S3DMODEL* mp = S3D::GetModel( cp->sceneData.get() );
+
+    if( !mp )
+        return nullptr;
+
+    cp->renderData = std::shared_ptr<S3DMODEL>( mp,
+                                                []( S3DMODEL* aModel )
+                                                {
+                                                    S3D::Destroy3DModel( &aModel );
+                                                } );
+    saveMeshCacheData( cp );
+
+    return cp->renderData;
+}
+
+
+void S3D_CACHE::PreloadModels( const std::vector<wxString>& aModelFileNames,
+                               REPORTER* aStatusReporter )
+{
+    // Each distinct model is loaded once
+    std::set<wxString> uniqueNames( aModelFileNames.begin(), aModelFileNames.end() );
+    std::vector<wxString> names( uniqueNames.begin(), uniqueNames.end() );
+
+    if( names.empty() )
+        return;
+
+    std::atomic<size_t> nextModel( 0 );
+    std::atomic<size_t> lastStartedModel( names.size() );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            names.size() );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t i = nextModel.fetch_add( 1 );
+                        i < names.size();
+                        i = nextModel.fetch_add( 1 ) )
+            {
+                lastStartedModel = i;
+                GetModel( names[i] );
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    size_t lastReported = names.size();
+
+    while( threadsFinished < parallelThreadCount )
+    {
+        size_t started = lastStartedModel;
+
+        if( aStatusReporter && started != lastReported )
+        {
+            // Display the short filename of the 3D model loaded:
+            // (the full name is usually too long to be displayed)
+            wxFileName fn( names[started] );
+
+            lastReported = started;
+            aStatusReporter->Report( wxString::Format( _( "Loading %s" ), fn.GetFullName() ) );
+        }
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
 
-    return mp;
+    // the loading threads cannot show the path resolution errors
+    m_FNResolver->ShowPendingMessages();
 }
 
 void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
 {
     wxDir         dir;
-    wxString      fileSpec = wxT( "*.3dc" );
-    wxArrayString fileList; // Holds list of ".3dc" files found in cache directory
+    wxArrayString fileList; // Holds list of ".3dc" and ".3dm" files found in cache directory
     size_t        numFilesFound = 0;
 
     wxFileName thisFile;
@@ -707,8 +869,11 @@ void S3D_CACHE::CleanCacheDir( int aNumDaysOld )
     {
         thisFile.SetPath( m_CacheDir ); // Set the base path to the cache folder
 
-        // Get a list of all the ".3dc" files in the cache directory
-        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList, fileSpec );
+        // Get a list of all the ".3dc" and ".3dm" files in the cache directory
+        numFilesFound = dir.GetAllFiles( m_CacheDir, &fileList,
+                                         wxString( "*" ) + SCENE_CACHE_EXT );
+        numFilesFound += dir.GetAllFiles( m_CacheDir, &fileList,
+                                          wxString( "*" ) + MESH_CACHE_EXT );
 
         for( unsigned int i = 0; i < numFilesFound; i++ )
         {
@@ -34,11 +34,15 @@
 #include "kicad_string.h"
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "plugins/3dapi/c3dmodel.h"
 #include <project.h>
 #include <wx/string.h>
 
 class  PGM_BASE;
+class  REPORTER;
 class  S3D_CACHE_ENTRY;
 class  SCENEGRAPH;
 class  FILENAME_RESOLVER;
@@ -68,18 +72,29 @@ private:
     wxString            m_CacheDir;
     wxString            m_ConfigDir;       /// base configuration path for 3D items
 
-    /** Find or create cache entry for file name
+    /// protects m_CacheList and m_CacheMap; it is only held for lookups and inserts,
+    /// the models are loaded without it
+    std::mutex          m_CacheMutex;
+
+    /** Load the data of a new cache entry
+     *
+     * Computes the file hash, then loads the entry data with loadEntryData().
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the new cache entry, that is not yet loaded
+     * @param[in]   aNeedScene  false if only the render data is needed
+     */
+    void loadCacheEntry( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                         bool aNeedScene );
+
+    /** Load the data of a cache entry, if not already done
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
-     * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * When only the render data is needed, it is mapped from the mesh cache file if there
+     * is one. Otherwise the scene data is read from the cache file if there is one, or
+     * loaded with the plugins and saved to the cache file.
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    void loadEntryData( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem,
+                        bool aNeedScene );
 
     /**
      * Function getSHA1
@@ -98,8 +113,23 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // map the render data from a mesh cache file
+    bool loadMeshCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save the render data to a mesh cache file
+    bool saveMeshCacheData( S3D_CACHE_ENTRY* aCacheItem );
+
+    /**
+     * The real load function (can supply a cache entry pointer to member functions).
+     *
+     * It can be called from several threads: a model is loaded only once, and the
+     * concurrent requests for the same model wait for this load.
+     *
+     * When aNeedScene is false, the scene data may not be loaded (the return value is
+     * then NULL) if the render data of the entry is available from the mesh cache.
+     */
+    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL,
+                      bool aNeedScene = true );
 
 public:
     S3D_CACHE();
@@ -147,7 +177,8 @@ public:
      * @param aModelFile [in] is the partial or full path to the model to be loaded
      * @return true if the model was successfully loaded, otherwise false.
      * The model may fail to load if, for example, the plugin does not
-     * support rendering of the 3D model.
+     * support rendering of the 3D model.  The returned scene stays valid until
+     * FlushCache(), or until the model file changes and is reloaded.
      */
     SCENEGRAPH* Load( const wxString& aModelFile );
 
@@ -180,17 +211,32 @@ public:
      * into an S3D_MODEL structure for display by a renderer
      *
      * @param aModelFileName is the full path to the model to be loaded
-     * @return is a pointer to the render data or NULL if not available
+     * @return is the render data or NULL if not available.  It is shared with the cache:
+     * it stays valid while the caller holds it, even if the model file changes and is
+     * reloaded meanwhile, or the cache is flushed.
+     * The render data is immutable: it can be mapped read only from a mesh cache file
+     * (see S3D_MESH_CACHE), so the caller must copy it to modify it.
+     */
+    std::shared_ptr<S3DMODEL> GetModel( const wxString& aModelFileName );
+
+    /**
+     * Function PreloadModels
+     * loads the render data of a list of models in parallel, so the following calls
+     * to GetModel() for these models return at once.
+     *
+     * @param aModelFileNames is the list of models; duplicated names are loaded once
+     * @param aStatusReporter is an optional reporter for the loading progress
      */
-    S3DMODEL* GetModel( const wxString& aModelFileName );
+    void PreloadModels( const std::vector<wxString>& aModelFileNames,
+                        REPORTER* aStatusReporter = nullptr );
 
     /**
      * Function Delete up old cache files in cache directory
      *
-     * Deletes ".3dc" files in the cache directory that are older than
+     * Deletes ".3dc" and ".3dm" files in the cache directory that are older than
      * "aNumDaysOld".
      *
-     * @param aNumDaysOld is age threshold to delete ".3dc" cache files
+     * @param aNumDaysOld is age threshold to delete the cache files
      */
     void CleanCacheDir( int aNumDaysOld );
 };
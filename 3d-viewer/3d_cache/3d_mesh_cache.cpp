@@ -0,0 +1,543 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "3d_mesh_cache.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+#define MESH_CACHE_MAGIC    "KICAD3DM"
+#define MESH_CACHE_VERSION  2
+#define MESH_CACHE_ALIGN    64
+
+// written in the native byte order: reads back differently on another architecture
+#define MESH_CACHE_BYTE_ORDER 0x01020304
+
+
+/**
+ * The file header, at offset 0
+ */
+struct MESH_CACHE_HEADER
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t materialSize;      ///< sizeof( SMATERIAL )
+    uint32_t vec3Size;          ///< sizeof( SFVEC3F )
+    uint32_t vec2Size;          ///< sizeof( SFVEC2F )
+    uint32_t materialsCount;
+    uint32_t meshesCount;
+    uint32_t pluginInfoSize;    ///< length of the plugin tag, without terminating nul
+    uint64_t materialsOffset;   ///< the SMATERIAL array
+    uint64_t meshesOffset;      ///< the MESH_CACHE_RECORD array
+    uint64_t fileSize;          ///< to detect truncated files
+    uint64_t pluginInfoOffset;  ///< the "PluginName:Version" tag, nul terminated
+    char     reserved[56];
+};
+
+
+/**
+ * The description of a mesh. The array offsets are 0 for missing (optional) arrays.
+ */
+struct MESH_CACHE_RECORD
+{
+    uint32_t vertexSize;
+    uint32_t faceIdxSize;
+    uint32_t materialIdx;
+    uint32_t reserved;
+    uint64_t positionsOffset;
+    uint64_t normalsOffset;
+    uint64_t texcoordsOffset;
+    uint64_t colorsOffset;
+    uint64_t faceIdxOffset;
+    uint64_t reserved2;
+};
+
+
+static_assert( sizeof( MESH_CACHE_HEADER ) == 128, "mesh cache header layout" );
+static_assert( sizeof( MESH_CACHE_RECORD ) == 64, "mesh cache record layout" );
+
+
+static uint64_t alignOffset( uint64_t aOffset )
+{
+    return ( aOffset + MESH_CACHE_ALIGN - 1 ) & ~( (uint64_t) MESH_CACHE_ALIGN - 1 );
+}
+
+
+/**
+ * Compute the layout of the file, and the offsets of the arrays of each mesh.
+ *
+ * @return the file size
+ */
+static uint64_t layoutFile( const S3DMODEL& aModel, MESH_CACHE_HEADER& aHeader,
+                            std::vector<MESH_CACHE_RECORD>& aRecords )
+{
+    uint64_t offset = alignOffset( sizeof( MESH_CACHE_HEADER ) );
+
+    aHeader.pluginInfoOffset = offset;
+    offset = alignOffset( offset + (uint64_t) aHeader.pluginInfoSize + 1 );
+
+    aHeader.materialsOffset = offset;
+    offset = alignOffset( offset + (uint64_t) aModel.m_MaterialsSize * sizeof( SMATERIAL ) );
+
+    aHeader.meshesOffset = offset;
+    offset = alignOffset( offset + (uint64_t) aModel.m_MeshesSize * sizeof( MESH_CACHE_RECORD ) );
+
+    aRecords.resize( aModel.m_MeshesSize );
+
+    auto addArray =
+            [&offset]( bool aPresent, uint64_t aSize ) -> uint64_t
+            {
+                if( !aPresent || aSize == 0 )
+                    return 0;
+
+                uint64_t start = offset;
+                offset = alignOffset( offset + aSize );
+                return start;
+            };
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH&       mesh   = aModel.m_Meshes[i];
+        MESH_CACHE_RECORD& record = aRecords[i];
+        const uint64_t     nv     = mesh.m_VertexSize;
+
+        memset( &record, 0, sizeof( record ) );
+        record.vertexSize  = mesh.m_VertexSize;
+        record.faceIdxSize = mesh.m_FaceIdxSize;
+        record.materialIdx = mesh.m_MaterialIdx;
+
+        record.positionsOffset = addArray( mesh.m_Positions, nv * sizeof( SFVEC3F ) );
+        record.normalsOffset   = addArray( mesh.m_Normals, nv * sizeof( SFVEC3F ) );
+        record.texcoordsOffset = addArray( mesh.m_Texcoords, nv * sizeof( SFVEC2F ) );
+        record.colorsOffset    = addArray( mesh.m_Color, nv * sizeof( SFVEC3F ) );
+        record.faceIdxOffset   = addArray( mesh.m_FaceIdx,
+                                           (uint64_t) mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    return offset;
+}
+
+
+/**
+ * Write aSize bytes at aOffset; the gap from the current position is filled with zeros.
+ */
+static bool writeAt( FILE* aFile, uint64_t& aPosition, uint64_t aOffset, const void* aData,
+                     size_t aSize )
+{
+    static const char padding[MESH_CACHE_ALIGN] = { 0 };
+
+    if( aOffset < aPosition || aOffset - aPosition > MESH_CACHE_ALIGN )
+        return false;
+
+    size_t gap = aOffset - aPosition;
+
+    if( gap && fwrite( padding, 1, gap, aFile ) != gap )
+        return false;
+
+    if( aSize && fwrite( aData, 1, aSize, aFile ) != aSize )
+        return false;
+
+    aPosition = aOffset + aSize;
+    return true;
+}
+
+
+static bool writeFile( FILE* aFile, const S3DMODEL& aModel, const MESH_CACHE_HEADER& aHeader,
+                       const std::vector<MESH_CACHE_RECORD>& aRecords,
+                       const std::string& aPluginInfo )
+{
+    uint64_t pos = 0;
+
+    if( !writeAt( aFile, pos, 0, &aHeader, sizeof( aHeader ) ) )
+        return false;
+
+    // with the terminating nul
+    if( !writeAt( aFile, pos, aHeader.pluginInfoOffset, aPluginInfo.c_str(),
+                  aPluginInfo.size() + 1 ) )
+        return false;
+
+    if( !writeAt( aFile, pos, aHeader.materialsOffset, aModel.m_Materials,
+                  aModel.m_MaterialsSize * sizeof( SMATERIAL ) ) )
+        return false;
+
+    if( !writeAt( aFile, pos, aHeader.meshesOffset, aRecords.data(),
+                  aRecords.size() * sizeof( MESH_CACHE_RECORD ) ) )
+        return false;
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH&             mesh   = aModel.m_Meshes[i];
+        const MESH_CACHE_RECORD& record = aRecords[i];
+        const size_t             nv     = mesh.m_VertexSize;
+
+        if( record.positionsOffset && !writeAt( aFile, pos, record.positionsOffset,
+                                                mesh.m_Positions, nv * sizeof( SFVEC3F ) ) )
+            return false;
+
+        if( record.normalsOffset && !writeAt( aFile, pos, record.normalsOffset,
+                                              mesh.m_Normals, nv * sizeof( SFVEC3F ) ) )
+            return false;
+
+        if( record.texcoordsOffset && !writeAt( aFile, pos, record.texcoordsOffset,
+                                                mesh.m_Texcoords, nv * sizeof( SFVEC2F ) ) )
+            return false;
+
+        if( record.colorsOffset && !writeAt( aFile, pos, record.colorsOffset,
+                                             mesh.m_Color, nv * sizeof( SFVEC3F ) ) )
+            return false;
+
+        if( record.faceIdxOffset
+                && !writeAt( aFile, pos, record.faceIdxOffset, mesh.m_FaceIdx,
+                             mesh.m_FaceIdxSize * sizeof( unsigned int ) ) )
+            return false;
+    }
+
+    // pad the end, so the file size is the one in the header
+    return writeAt( aFile, pos, aHeader.fileSize, nullptr, 0 );
+}
+
+
+bool S3D::WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel,
+                          const std::string& aPluginInfo )
+{
+    if( aModel.m_MeshesSize == 0 || aModel.m_Meshes == NULL
+            || ( aModel.m_MaterialsSize && aModel.m_Materials == NULL ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] invalid model",
+                    __FILE__, __FUNCTION__, __LINE__ );
+
+        return false;
+    }
+
+    MESH_CACHE_HEADER header;
+    memset( &header, 0, sizeof( header ) );
+
+    memcpy( header.magic, MESH_CACHE_MAGIC, sizeof( header.magic ) );
+    header.version        = MESH_CACHE_VERSION;
+    header.byteOrder      = MESH_CACHE_BYTE_ORDER;
+    header.materialSize   = sizeof( SMATERIAL );
+    header.vec3Size       = sizeof( SFVEC3F );
+    header.vec2Size       = sizeof( SFVEC2F );
+    header.materialsCount = aModel.m_MaterialsSize;
+    header.meshesCount    = aModel.m_MeshesSize;
+    header.pluginInfoSize = aPluginInfo.size();
+
+    std::vector<MESH_CACHE_RECORD> records;
+    header.fileSize = layoutFile( aModel, header, records );
+
+    // Several models can have the same content (so the same cache file name): each writer
+    // uses its own temporary file, and the last rename wins
+    wxFileName fn( aFileName );
+    wxString   tmpName = wxFileName::CreateTempFileName( fn.GetPathWithSep() + fn.GetName() );
+
+    if( tmpName.empty() )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot create a temporary file for '%s'",
+                    aFileName );
+
+        return false;
+    }
+
+    #ifdef _WIN32
+    FILE* fp = _wfopen( tmpName.wc_str(), L"wb" );
+    #else
+    FILE* fp = fopen( tmpName.ToUTF8(), "wb" );
+    #endif
+
+    bool ok = fp && writeFile( fp, aModel, header, records, aPluginInfo );
+
+    if( fp && fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write mesh cache file '%s'",
+                    aFileName );
+
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    if( !wxRenameFile( tmpName, aFileName, true ) )
+    {
+        // On Windows, a file cannot be replaced while it is mapped, for instance by the
+        // entry of another model with the same content.  The file is kept: it is replaced
+        // by a later write, if it is rejected when it is read.
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot replace mesh cache file '%s'",
+                    aFileName );
+
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    return true;
+}
+
+
+S3D_MESH_CACHE::S3D_MESH_CACHE() :
+        m_isOpen( false )
+{
+    memset( &m_model, 0, sizeof( m_model ) );
+}
+
+
+S3D_MESH_CACHE::~S3D_MESH_CACHE()
+{
+}
+
+
+void S3D_MESH_CACHE::close()
+{
+    m_region.reset();
+    m_file.reset();
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_meshes.clear();
+    m_pluginInfo.clear();
+    memset( &m_model, 0, sizeof( m_model ) );
+    m_isOpen = false;
+}
+
+
+bool S3D_MESH_CACHE::readFile( const wxString& aFileName )
+{
+    wxFFile file( aFileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    wxFileOffset length = file.Length();
+
+    if( length < 0 )
+        return false;
+
+    m_buffer.resize( length );
+
+    if( length && file.Read( m_buffer.data(), length ) != (size_t) length )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot read mesh cache file '%s'",
+                    aFileName );
+
+        return false;
+    }
+
+    return true;
+}
+
+
+bool S3D_MESH_CACHE::Open( const wxString& aFileName, void* aPluginMgr,
+                           bool (*aTagCheck)( const char*, void* ) )
+{
+    using namespace boost::interprocess;
+
+    close();
+
+    const char* base = nullptr;
+    uint64_t    size = 0;
+
+    // file_mapping only takes a narrow file name, which Windows does not read as UTF-8:
+    // the files with a non ASCII name are read instead of mapped
+#ifdef _WIN32
+    bool canMap = aFileName.IsAscii();
+#else
+    bool canMap = true;
+#endif
+
+    if( canMap )
+    {
+        try
+        {
+            m_file.reset( new file_mapping( aFileName.ToUTF8(), read_only ) );
+            m_region.reset( new mapped_region( *m_file, read_only ) );
+
+            base = static_cast<const char*>( m_region->get_address() );
+            size = m_region->get_size();
+        }
+        catch( const interprocess_exception& e )
+        {
+            wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot map mesh cache file '%s': %s",
+                        aFileName, e.what() );
+
+            m_region.reset();
+            m_file.reset();
+        }
+    }
+
+    if( !base )
+    {
+        if( !readFile( aFileName ) )
+        {
+            close();
+            return false;
+        }
+
+        base = m_buffer.data();
+        size = m_buffer.size();
+    }
+
+    auto reject =
+            [&]( const char* aReason )
+            {
+                wxLogTrace( MASK_3D_CACHE, " * [3D model] invalid mesh cache file '%s': %s",
+                            aFileName, aReason );
+
+                close();
+                return false;
+            };
+
+    if( size < sizeof( MESH_CACHE_HEADER ) )
+        return reject( "truncated header" );
+
+    const MESH_CACHE_HEADER* header = reinterpret_cast<const MESH_CACHE_HEADER*>( base );
+
+    if( memcmp( header->magic, MESH_CACHE_MAGIC, sizeof( header->magic ) ) != 0
+            || header->version != MESH_CACHE_VERSION
+            || header->byteOrder != MESH_CACHE_BYTE_ORDER
+            || header->materialSize != sizeof( SMATERIAL )
+            || header->vec3Size != sizeof( SFVEC3F )
+            || header->vec2Size != sizeof( SFVEC2F ) )
+    {
+        return reject( "unsupported version or layout" );
+    }
+
+    if( header->fileSize != size )
+        return reject( "truncated file" );
+
+    if( header->pluginInfoOffset < sizeof( MESH_CACHE_HEADER )
+            || header->pluginInfoOffset > size
+            || header->pluginInfoSize >= size - header->pluginInfoOffset
+            || base[ header->pluginInfoOffset + header->pluginInfoSize ] != 0 )
+    {
+        return reject( "invalid plugin tag" );
+    }
+
+    m_pluginInfo.assign( base + header->pluginInfoOffset, header->pluginInfoSize );
+
+    if( aTagCheck && !aTagCheck( m_pluginInfo.c_str(), aPluginMgr ) )
+        return reject( "plugin tag mismatch" );
+
+    // an array is valid if it is aligned and inside the file
+    auto getArray =
+            [&]( uint64_t aOffset, uint64_t aCount, uint64_t aItemSize ) -> const char*
+            {
+                // empty arrays are not written
+                if( aCount == 0 )
+                    return base;
+
+                if( aOffset % MESH_CACHE_ALIGN || aOffset < sizeof( MESH_CACHE_HEADER )
+                        || aOffset > size || aCount > ( size - aOffset ) / aItemSize )
+                {
+                    return nullptr;
+                }
+
+                return base + aOffset;
+            };
+
+    const char* materials = getArray( header->materialsOffset, header->materialsCount,
+                                      sizeof( SMATERIAL ) );
+    const char* records = getArray( header->meshesOffset, header->meshesCount,
+                                    sizeof( MESH_CACHE_RECORD ) );
+
+    if( !materials || !records || header->meshesCount == 0 )
+        return reject( "invalid material or mesh table" );
+
+    m_meshes.resize( header->meshesCount );
+
+    for( uint32_t i = 0; i < header->meshesCount; ++i )
+    {
+        const MESH_CACHE_RECORD& record =
+                reinterpret_cast<const MESH_CACHE_RECORD*>( records )[i];
+        SMESH& mesh = m_meshes[i];
+
+        if( record.materialIdx >= header->materialsCount )
+            return reject( "invalid material index" );
+
+        const char* positions = getArray( record.positionsOffset, record.vertexSize,
+                                          sizeof( SFVEC3F ) );
+        const char* normals = getArray( record.normalsOffset, record.vertexSize,
+                                        sizeof( SFVEC3F ) );
+        const char* faceIdx = getArray( record.faceIdxOffset, record.faceIdxSize,
+                                        sizeof( unsigned int ) );
+        const char* texcoords = nullptr;
+        const char* colors = nullptr;
+
+        if( !positions || !normals || !faceIdx || record.faceIdxSize % 3 )
+            return reject( "invalid mesh arrays" );
+
+        if( record.texcoordsOffset )
+        {
+            texcoords = getArray( record.texcoordsOffset, record.vertexSize, sizeof( SFVEC2F ) );
+
+            if( !texcoords )
+                return reject( "invalid texture coordinates" );
+        }
+
+        if( record.colorsOffset )
+        {
+            colors = getArray( record.colorsOffset, record.vertexSize, sizeof( SFVEC3F ) );
+
+            if( !colors )
+                return reject( "invalid colors" );
+        }
+
+        // the renderers index the vertex arrays without checks
+        const unsigned int* indices = reinterpret_cast<const unsigned int*>( faceIdx );
+
+        for( uint32_t j = 0; j < record.faceIdxSize; ++j )
+        {
+            if( indices[j] >= record.vertexSize )
+                return reject( "invalid face index" );
+        }
+
+        // The mapping is read only: the model is immutable, see S3D_MESH_CACHE
+        mesh.m_VertexSize  = record.vertexSize;
+        mesh.m_Positions   = (SFVEC3F*) positions;
+        mesh.m_Normals     = (SFVEC3F*) normals;
+        mesh.m_Texcoords   = (SFVEC2F*) texcoords;
+        mesh.m_Color       = (SFVEC3F*) colors;
+        mesh.m_FaceIdxSize = record.faceIdxSize;
+        mesh.m_FaceIdx     = (unsigned int*) faceIdx;
+        mesh.m_MaterialIdx = record.materialIdx;
+    }
+
+    m_model.m_MeshesSize    = header->meshesCount;
+    m_model.m_Meshes        = m_meshes.data();
+    m_model.m_MaterialsSize = header->materialsCount;
+    m_model.m_Materials     = (SMATERIAL*) materials;
+    m_isOpen = true;
+
+    return true;
+}
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_cache.h
+ * defines the binary mesh cache files, which store the render data (S3DMODEL) of a 3D model
+ *
+ * Unlike the ".3dc" files, which store the scene graph node by node, a mesh cache file is a
+ * flat image of the S3DMODEL arrays: a header, the material table, one record per mesh and
+ * the vertex and index arrays, all aligned to 64 bytes. The file is memory mapped and the
+ * S3DMODEL points directly into the mapping, so nothing is parsed or copied when it is read.
+ * The files which cannot be mapped (on Windows, the files with a non ASCII path) are read in
+ * a buffer instead.
+ *
+ * The files are written and read by the same machine (they live in the user cache
+ * directory), so they use the native byte order and the native layout of SMATERIAL and of
+ * the vectors; a file written with a different layout is rejected and rebuilt.
+ */
+
+#ifndef MESH_CACHE_3D_H
+#define MESH_CACHE_3D_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "plugins/3dapi/c3dmodel.h"
+
+namespace boost
+{
+namespace interprocess
+{
+    class file_mapping;
+    class mapped_region;
+}
+}
+
+
+namespace S3D
+{
+    /**
+     * Function WriteMeshCache
+     * writes the render data of a model to a mesh cache file. The file is first written
+     * under a temporary name, then renamed, so a reader never sees a partial file.
+     *
+     * @param aFileName is the name of the file to write
+     * @param aModel is the render data to write
+     * @param aPluginInfo is the "PluginName:Version" tag of the plugin which loaded the model
+     * @return true on success
+     */
+    bool WriteMeshCache( const wxString& aFileName, const S3DMODEL& aModel,
+                         const std::string& aPluginInfo );
+}
+
+
+/**
+ * S3D_MESH_CACHE
+ *
+ * A mesh cache file mapped in memory, and the S3DMODEL which points into it.
+ *
+ * The model is immutable: its arrays are in a read only mapping, and writing to them
+ * faults.  It must not be freed with S3D::Destroy3DModel(). It is valid as long as this
+ * object exists.  A caller which needs to modify the model must copy it.
+ */
+class S3D_MESH_CACHE
+{
+public:
+    S3D_MESH_CACHE();
+    ~S3D_MESH_CACHE();
+
+    S3D_MESH_CACHE( const S3D_MESH_CACHE& ) = delete;
+    S3D_MESH_CACHE& operator=( const S3D_MESH_CACHE& ) = delete;
+
+    /**
+     * Map a mesh cache file and check its content.
+     *
+     * @param aFileName is the name of the file to read
+     * @param aPluginMgr is passed to aTagCheck
+     * @param aTagCheck if not NULL, is called with the plugin tag stored in the file, and
+     *                  the file is rejected if it returns false (as S3D::ReadCache() does)
+     * @return true if the file is a valid mesh cache file
+     */
+    bool Open( const wxString& aFileName, void* aPluginMgr,
+               bool (*aTagCheck)( const char*, void* ) );
+
+    /**
+     * @return the model stored in the file, or NULL if no file is open
+     */
+    S3DMODEL* GetModel() { return m_isOpen ? &m_model : NULL; }
+
+    /**
+     * @return the plugin tag stored in the file
+     */
+    const std::string& GetPluginInfo() const { return m_pluginInfo; }
+
+private:
+    void close();
+
+    /// read the file in m_buffer, when it cannot be mapped
+    bool readFile( const wxString& aFileName );
+
+    std::unique_ptr<boost::interprocess::file_mapping>  m_file;
+    std::unique_ptr<boost::interprocess::mapped_region> m_region;
+    std::vector<char>   m_buffer;       ///< the file content, if it is not mapped
+
+    bool                m_isOpen;
+    S3DMODEL            m_model;
+    std::vector<SMESH>  m_meshes;       ///< the only part of the model not in the mapping
+    std::string         m_pluginInfo;
+};
+
+#endif  // MESH_CACHE_3D_H
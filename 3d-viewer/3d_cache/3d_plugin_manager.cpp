@@ -109,10 +109,22 @@ S3D_PLUGIN_MANAGER::~S3D_PLUGIN_MANAGER()
     }
 
     m_Plugins.clear();
+    m_PluginLocks.clear();
     return;
 }
 
 
+std::unique_lock<std::mutex> S3D_PLUGIN_MANAGER::lockPlugin( KICAD_PLUGIN_LDR_3D* aPlugin )
+{
+    auto it = m_PluginLocks.find( aPlugin );
+
+    if( it == m_PluginLocks.end() )
+        return std::unique_lock<std::mutex>();
+
+    return std::unique_lock<std::mutex>( *it->second );
+}
+
+
 void S3D_PLUGIN_MANAGER::loadPlugins( void )
 {
     std::list< wxString > searchpaths;
@@ -232,6 +244,10 @@ void S3D_PLUGIN_MANAGER::loadPlugins( void )
             } while( 0 );
 #endif
             m_Plugins.push_back( pp );
+
+            if( !pp->IsReentrant() )
+                m_PluginLocks[pp].reset( new std::mutex );
+
             int nf = pp->GetNFilters();
 
             #ifdef DEBUG
@@ -494,6 +510,8 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
     while( sL != items.second )
     {
+        std::unique_lock<std::mutex> lock = lockPlugin( sL->second );
+
         if( sL->second->CanRender() )
         {
             SCENEGRAPH* sp = sL->second->Load( aFileName.ToUTF8() );
@@ -528,6 +546,7 @@ void S3D_PLUGIN_MANAGER::ClosePlugins( void )
 
     while( sP != eP )
     {
+        std::unique_lock<std::mutex> lock = lockPlugin( *sP );
         (*sP)->Close();
         ++sP;
     }
@@ -559,7 +578,11 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     while( pS != pE )
     {
         ptag.clear();
-        (*pS)->GetPluginInfo( ptag );
+
+        {
+            std::unique_lock<std::mutex> lock = lockPlugin( *pS );
+            (*pS)->GetPluginInfo( ptag );
+        }
 
         // if the plugin name matches then the version
         // must also match
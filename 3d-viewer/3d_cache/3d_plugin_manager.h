@@ -31,6 +31,8 @@
 
 #include <map>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -50,6 +52,13 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// a lock per non-reentrant plugin: such a plugin loads one model at a time, while the
+    /// reentrant plugins (see KICAD_PLUGIN_LDR_3D::IsReentrant()) are not locked
+    std::map< KICAD_PLUGIN_LDR_3D*, std::unique_ptr<std::mutex> > m_PluginLocks;
+
+    /// lock aPlugin if it is not reentrant; the returned lock owns no mutex otherwise
+    std::unique_lock<std::mutex> lockPlugin( KICAD_PLUGIN_LDR_3D* aPlugin );
+
     /// load plugins
     void loadPlugins( void );
 
@@ -82,6 +91,11 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const noexcept;
 
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin able to read it. This function can be called
+     * from several threads.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
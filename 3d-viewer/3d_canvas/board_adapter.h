@@ -48,6 +48,7 @@
 #include <reporter.h>
 
 class COLOR_SETTINGS;
+class EDA_3D_VIEWER_SETTINGS;
 
 /// A type that stores a container of 2d objects for each layer id
 typedef std::map< PCB_LAYER_ID, CBVHCONTAINER2D *> MAP_CONTAINER_2D;
@@ -105,6 +106,13 @@ class BOARD_ADAPTER
      */
     void SetFlag( DISPLAY3D_FLG aFlag, bool aState );
 
+    /**
+     * @brief LoadSettings - Set the render options, lights and flags from the
+     * 3D viewer settings.  Colors and render engine are not changed.
+     * @param aCfg: the settings to use
+     */
+    void LoadSettings( const EDA_3D_VIEWER_SETTINGS& aCfg );
+
     /**
      * @brief Is3DLayerEnabled - Check if a layer is enabled
      * @param aLayer: layer ID to get status
@@ -634,6 +642,11 @@ public:
     int m_raytrace_recursivelevel_reflections;
     int m_raytrace_recursivelevel_refractions;
 
+    // Raytracing progressive rendering options
+    int   m_raytrace_progressive_passes;        ///< max refinement passes, 0 to disable
+    float m_raytrace_progressive_noise;         ///< noise level of a converged block
+    int   m_raytrace_progressive_time_budget;   ///< in ms, 0 for no limit
+
 private:
 
     BOARD*              m_board;
@@ -47,10 +47,11 @@
 #include <thread>
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
 #include <profile.h>
-#endif
 
 
 void BOARD_ADAPTER::destroyLayers()
@@ -120,19 +121,51 @@ void BOARD_ADAPTER::destroyLayers()
 }
 
 
-void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
+/**
+ * Run a list of independent tasks with a pool of threads, and wait for all of them.
+ */
+static void runTasks( const std::vector<std::function<void()>>& aTasks )
 {
-    destroyLayers();
+    if( aTasks.empty() )
+        return;
 
-    // Build Copper layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
-    // /////////////////////////////////////////////////////////////////////////
+    std::atomic<size_t> nextTask( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startCopperLayersTime = GetRunningMicroSecs();
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            aTasks.size() );
 
-    unsigned start_Time = stats_startCopperLayersTime;
-#endif
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&nextTask, &threadsFinished, &aTasks]()
+        {
+            for( size_t i = nextTask.fetch_add( 1 );
+                        i < aTasks.size();
+                        i = nextTask.fetch_add( 1 ) )
+            {
+                aTasks[i]();
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+}
+
+
+void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
+{
+    destroyLayers();
+
+    // The layers are built in 3 phases, each one made of independent tasks run in
+    // parallel: the items of each layer are created (in containers and polygons), then
+    // the polygons of each layer are merged, then the BVH of the containers are built.
+    PROF_COUNTER totalTimer;
 
     PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
     LSET         cu_set = LSET::AllCuMask( m_copperLayersCount );
@@ -180,6 +213,7 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
 
     // Prepare copper layers index and containers
+    // The layer maps are filled here: the tasks only look them up
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
     layer_id.clear();
@@ -188,6 +222,9 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
     for( unsigned i = 0; i < arrayDim( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
+    const bool copperThickness = GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
+                                 && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY );
+
     for( LSEQ cu = cu_set.Seq( cu_seq, arrayDim( cu_seq ) ); cu; ++cu )
     {
         const PCB_LAYER_ID curr_layer_id = *cu;
@@ -200,15 +237,16 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
         CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
         m_layers_container2D[curr_layer_id] = layerContainer;
 
-        if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-                && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+        if( copperThickness )
         {
             SHAPE_POLY_SET* layerPoly    = new SHAPE_POLY_SET;
             m_layers_poly[curr_layer_id] = layerPoly;
         }
     }
 
-    if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
+    const bool renderPlatedPadsAsPlated = GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED );
+
+    if( renderPlatedPadsAsPlated )
     {
         m_F_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
         m_B_Cu_PlatedPads_poly = new SHAPE_POLY_SET;
@@ -218,870 +256,649 @@ void BOARD_ADAPTER::createLayers( REPORTER* aStatusReporter )
 
     }
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Create tracks and vias" ) );
-
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
+    // draw graphic items, on technical layers
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
 
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
 
-        // Add track segments shapes and via annulus shapes
-        unsigned int nTracks = trackList.size();
+    std::vector< PCB_LAYER_ID > tech_layer_id;
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+    // User layers are not drawn here, only technical layers
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
+    {
+        const PCB_LAYER_ID curr_layer_id = *seq;
 
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+        if( !Is3DLayerEnabled( curr_layer_id ) )
+            continue;
 
-            // Skip vias annulus when not connected on this layer (if removing is enabled)
-            const VIA *via = dyn_cast< const VIA*>( track );
+        tech_layer_id.push_back( curr_layer_id );
 
-            if( via && !via->FlashLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
-                continue;
+        m_layers_container2D[curr_layer_id] = new CBVHCONTAINER2D;
+        m_layers_poly[curr_layer_id] = new SHAPE_POLY_SET;
+    }
 
-            // Add object item to layer container
-            createNewTrack( track, layerContainer, 0.0f );
-        }
+    // The pads build their shapes on demand: build them now, before they are shared by
+    // the tasks of several layers
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+            pad->GetBoundingBox();
     }
 
-    // Create VIAS and THTs objects and add it to holes containers
+    // Phase 1: create the items of each layer
     // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
+    if( aStatusReporter )
+        aStatusReporter->Report( _( "Create layer items" ) );
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+    PROF_COUNTER itemsTimer;
+
+    std::vector<std::function<void()>> tasks;
+
+    // protects the creation of the via holes containers and polygons of the layers
+    std::mutex holesLock;
+
+    // Build Copper layers
+    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
+    for( PCB_LAYER_ID layer : layer_id )
+    {
+        tasks.push_back( [this, layer, &trackList, &holesLock, copperThickness,
+                          renderPlatedPadsAsPlated]()
         {
-            const TRACK *track = trackList[trackIdx];
+            CBVHCONTAINER2D *layerContainer = m_layers_container2D.at( layer );
+            SHAPE_POLY_SET  *layerPoly = copperThickness ? m_layers_poly.at( layer ) : nullptr;
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+            // The holes of the blind and buried vias of the layer, created if there are some
+            CBVHCONTAINER2D *layerHoleContainer = NULL;
+            SHAPE_POLY_SET  *layerOuterHolesPoly = NULL;
+            SHAPE_POLY_SET  *layerInnerHolesPoly = NULL;
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
+            // Add track segments shapes and via annulus shapes
+            for( const TRACK* track : trackList )
             {
-                const VIA*    via               = static_cast<const VIA*>( track );
-                const VIATYPE viatype           = via->GetViaType();
-                const float   holediameter      = via->GetDrillValue() * BiuTo3Dunits();
-                const float   thickness         = GetCopperThickness3DU();
-                const float   hole_inner_radius = ( holediameter / 2.0f );
-                const float   ring_radius       = via->GetWidth() * BiuTo3Dunits() / 2.0f;
+                // NOTE: Vias can be on multiple layers
+                if( !track->IsOnLayer( layer ) )
+                    continue;
 
-                const SFVEC2F via_center(
-                        via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
+                const VIA *via = dyn_cast< const VIA*>( track );
 
-                if( viatype != VIATYPE::THROUGH )
+                // Add the hole of the blind and buried vias
+                if( via && via->GetViaType() != VIATYPE::THROUGH )
                 {
+                    const float holediameter      = via->GetDrillValue() * BiuTo3Dunits();
+                    const float thickness         = GetCopperThickness3DU();
+                    const float hole_inner_radius = ( holediameter / 2.0f );
 
-                    // Add hole objects
-                    // /////////////////////////////////////////////////////////
+                    const SFVEC2F via_center( via->GetStart().x * m_biuTo3Dunits,
+                                              -via->GetStart().y * m_biuTo3Dunits );
 
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
+                    if( !layerHoleContainer )
                     {
-                        // not found, create a new container
                         layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
+                        layerOuterHolesPoly = new SHAPE_POLY_SET;
+                        layerInnerHolesPoly = new SHAPE_POLY_SET;
                     }
 
-                    // Add a hole for this layer
                     layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
                                                                   hole_inner_radius + thickness,
                                                                   *track ) );
+
+                    const int holeDiameterBIU = via->GetDrillValue();
+                    const int hole_outer_radius = ( holeDiameterBIU / 2 )
+                                                  + GetHolePlatingThicknessBIU();
+
+                    TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
+                                              hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
+
+                    TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
+                                              holeDiameterBIU / 2, ARC_HIGH_DEF, ERROR_INSIDE );
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
 
-                    if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
-                    {
-                        m_through_holes_outer_ring.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                             ring_radius,
-                                                                             *track ) );
-                    }
+                // Skip vias annulus when not connected on this layer (if removing is enabled)
+                if( via && !via->FlashLayer( layer ) && IsCopperLayer( layer ) )
+                    continue;
 
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
+                // Add object item to layer container
+                createNewTrack( track, layerContainer, 0.0f );
 
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
+                // Add the track/via contour
+                if( layerPoly )
+                {
+                    track->TransformShapeWithClearanceToPolygon( *layerPoly, layer, 0,
+                                                                 ARC_HIGH_DEF, ERROR_INSIDE );
                 }
             }
-        }
-    }
 
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
-    {
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
+            if( layerHoleContainer )
+            {
+                std::lock_guard<std::mutex> lock( holesLock );
 
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
+                m_layers_holes2D[layer] = layerHoleContainer;
+                m_layers_outer_holes_poly[layer] = layerOuterHolesPoly;
+                m_layers_inner_holes_poly[layer] = layerInnerHolesPoly;
+            }
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
+            // Add footprints PADs objects to containers
+            for( MODULE* module : m_board->Modules() )
             {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE viatype = via->GetViaType();
+                // Note: NPTH pads are not drawn on copper layers when the pad
+                // has same shape as its hole
+                AddPadsShapesWithClearanceToContainer( module, layerContainer, layer, 0,
+                                                       true, renderPlatedPadsAsPlated, false );
+
+                // Micro-wave footprints may have items on copper layers
+                AddGraphicsShapesWithClearanceToContainer( module, layerContainer, layer, 0 );
 
-                if( viatype != VIATYPE::THROUGH )
+                // Add pads poly contourns (vertical outlines)
+                if( layerPoly )
                 {
-                    // Add VIA hole contourns
+                    module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, layer, 0,
+                                                                       ARC_HIGH_DEF, ERROR_INSIDE,
+                                                                       true,
+                                                                       renderPlatedPadsAsPlated,
+                                                                       false );
 
-                    // Add outer holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
+                    transformGraphicModuleEdgeToPolygonSet( module, layer, *layerPoly );
+                }
+            }
 
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
+            // Add graphic items on copper layers (texts and other graphics)
+            for( BOARD_ITEM* item : m_board->Drawings() )
+            {
+                if( !item->IsOnLayer( layer ) )
+                    continue;
 
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
+                switch( item->Type() )
+                {
+                case PCB_SHAPE_T:
+                    AddShapeWithClearanceToContainer( (PCB_SHAPE*) item, layerContainer, layer,
+                                                      0 );
 
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
+                    if( layerPoly )
                     {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
+                        ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
+                                                                                     layer, 0,
+                                                                                     ARC_HIGH_DEF,
+                                                                                     ERROR_INSIDE );
+                    }
+                    break;
 
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
+                case PCB_TEXT_T:
+                    AddShapeWithClearanceToContainer( (PCB_TEXT*) item, layerContainer, layer,
+                                                      0 );
 
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
+                    if( layerPoly )
+                    {
+                        ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0,
+                                                                                       ARC_HIGH_DEF,
+                                                                                       ERROR_INSIDE );
                     }
+                    break;
 
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetHolePlatingThicknessBIU();
-
-                    TransformCircleToPolygon( *layerOuterHolesPoly, via->GetStart(),
-                                              hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
+                case PCB_DIM_ALIGNED_T:
+                case PCB_DIM_CENTER_T:
+                case PCB_DIM_ORTHOGONAL_T:
+                case PCB_DIM_LEADER_T:
+                    AddShapeWithClearanceToContainer( (DIMENSION*) item, layerContainer, layer,
+                                                      0 );
+                    break;
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly, via->GetStart(),
-                                              holediameter / 2, ARC_HIGH_DEF, ERROR_INSIDE );
+                default:
+                    wxLogTrace( m_logTrace,
+                                wxT( "createLayers: item type: %d not implemented" ),
+                                item->Type() );
+                    break;
                 }
-                else if( curr_layer_id == layer_id[0] ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetHolePlatingThicknessBIU();
-                    const int hole_outer_ring_radius = via->GetWidth() / 2.0f;
-
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
-                                              hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
-
-                    // Add same thing for vias only
-
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
-                                              hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
+            }
 
-                    if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
-                    {
-                        TransformCircleToPolygon( m_through_outer_ring_holes_poly,
-                                                  via->GetStart(), hole_outer_ring_radius,
-                                                  ARC_HIGH_DEF, ERROR_INSIDE );
-                    }
+            // Add copper zones contours; the zone objects are added by their own tasks
+            if( layerPoly && GetFlag( FL_ZONE ) )
+            {
+                for( ZONE_CONTAINER* zone : m_board->Zones() )
+                {
+                    if( zone->IsOnLayer( layer ) )
+                        zone->TransformSolidAreasShapesToPolygon( layer, *layerPoly );
                 }
             }
-        }
+        } );
     }
 
-    // Creates vertical outline contours of the tracks and add it to the poly of the layer
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Add zones objects; the containers can be filled by several tasks
+    if( GetFlag( FL_ZONE ) )
     {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
         {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
-
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
             {
-                const TRACK *track = trackList[trackIdx];
-
-                if( !track->IsOnLayer( curr_layer_id ) )
+                if( !IsCopperLayer( layer ) )
                     continue;
 
-                // Skip vias annulus when not connected on this layer (if removing is enabled)
-                const VIA *via = dyn_cast< const VIA*>( track );
+                auto layerContainer = m_layers_container2D.find( layer );
 
-                if( via && !via->FlashLayer( curr_layer_id ) && IsCopperLayer( curr_layer_id ) )
+                if( layerContainer == m_layers_container2D.end() )
                     continue;
 
-                // Add the track/via contour
-                track->TransformShapeWithClearanceToPolygon( *layerPoly, curr_layer_id, 0,
-                                                             ARC_HIGH_DEF, ERROR_INSIDE );
+                CBVHCONTAINER2D* container = layerContainer->second;
+
+                tasks.push_back( [this, zone, layer, container]()
+                {
+                    AddSolidAreasShapesToContainer( zone, container, layer );
+                } );
             }
         }
     }
 
-    // Add holes of footprints
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
+    // Create the through holes objects: through vias, then footprints holes
+    tasks.push_back( [this, &trackList, &layer_id]()
     {
-        for( D_PAD* pad : module->Pads() )
+        for( const TRACK* track : trackList )
         {
-            const wxSize padHole = pad->GetDrillSize();
+            if( layer_id.empty() || !track->IsOnLayer( layer_id[0] ) )
+                continue;
+
+            const VIA* via = dyn_cast<const VIA*>( track );
 
-            if( !padHole.x )    // Not drilled pad like SMD pad
+            if( !via || via->GetViaType() != VIATYPE::THROUGH )
                 continue;
 
-            // The hole in the body is inflated by copper thickness, if not plated, no copper
-            const int inflate = ( pad->GetAttribute () != PAD_ATTRIB_NPTH ) ?
-                                GetHolePlatingThicknessBIU() : 0;
+            const float holediameter      = via->GetDrillValue() * BiuTo3Dunits();
+            const float thickness         = GetCopperThickness3DU();
+            const float hole_inner_radius = ( holediameter / 2.0f );
+            const float ring_radius       = via->GetWidth() * BiuTo3Dunits() / 2.0f;
 
-            m_stats_nr_holes++;
-            m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
-                                             pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+            const SFVEC2F via_center(
+                    via->GetStart().x * m_biuTo3Dunits, -via->GetStart().y * m_biuTo3Dunits );
 
-            m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
+            m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius + thickness,
+                                                            *track ) );
+            m_through_holes_vias_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                 hole_inner_radius + thickness,
+                                                                 *track ) );
 
             if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
             {
-                m_through_holes_outer_ring.Add( createNewPadDrill( pad, inflate ) );
+                m_through_holes_outer_ring.Add( new CFILLEDCIRCLE2D( via_center,
+                                                                     ring_radius,
+                                                                     *track ) );
             }
 
-            m_through_holes_inner.Add( createNewPadDrill( pad, 0 ) );
+            m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                                                            hole_inner_radius,
+                                                            *track ) );
         }
-    }
-
-    if( m_stats_nr_holes )
-        m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
-    // Add contours of the pad holes (pads can be Circle or Segment holes)
-    // /////////////////////////////////////////////////////////////////////////
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
+        for( MODULE* module : m_board->Modules() )
         {
-            const wxSize padHole = pad->GetDrillSize();
+            for( D_PAD* pad : module->Pads() )
+            {
+                const wxSize padHole = pad->GetDrillSize();
 
-            if( !padHole.x ) // Not drilled pad like SMD pad
-                continue;
+                if( !padHole.x )    // Not drilled pad like SMD pad
+                    continue;
 
-            // The hole in the body is inflated by copper thickness.
-            const int inflate = GetHolePlatingThicknessBIU();
+                // The hole in the body is inflated by copper thickness, if not plated, no copper
+                const int inflate = ( pad->GetAttribute () != PAD_ATTRIB_NPTH ) ?
+                                    GetHolePlatingThicknessBIU() : 0;
 
-            if( pad->GetAttribute () != PAD_ATTRIB_NPTH )
-            {
-                if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
-                {
-                    pad->TransformHoleWithClearanceToPolygon( m_through_outer_ring_holes_poly,
-                                                              inflate,
-                                                              ARC_HIGH_DEF, ERROR_INSIDE );
-                }
+                m_stats_nr_holes++;
+                m_stats_hole_med_diameter += ( ( pad->GetDrillSize().x +
+                                                 pad->GetDrillSize().y ) / 2.0f ) * m_biuTo3Dunits;
+
+                m_through_holes_outer.Add( createNewPadDrill( pad, inflate ) );
 
-                pad->TransformHoleWithClearanceToPolygon( m_through_outer_holes_poly, inflate,
-                                                          ARC_HIGH_DEF, ERROR_INSIDE );
-            }
-            else
-            {
-                // If not plated, no copper.
                 if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
                 {
-                    pad->TransformHoleWithClearanceToPolygon( m_through_outer_ring_holes_poly, 0,
-                                                              ARC_HIGH_DEF, ERROR_INSIDE );
+                    m_through_holes_outer_ring.Add( createNewPadDrill( pad, inflate ) );
                 }
 
-                pad->TransformHoleWithClearanceToPolygon( m_through_outer_holes_poly_NPTH, 0,
-                                                          ARC_HIGH_DEF, ERROR_INSIDE );
+                m_through_holes_inner.Add( createNewPadDrill( pad, 0 ) );
             }
         }
-    }
 
-    const bool renderPlatedPadsAsPlated = GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED );
+        if( m_stats_nr_holes )
+            m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
+    } );
 
-    // Add footprints PADs objects to containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    // Create the through holes contours: through vias, then footprints holes
+    tasks.push_back( [this, &trackList, &layer_id]()
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( MODULE* module : m_board->Modules() )
+        for( const TRACK* track : trackList )
         {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0,
-                                                   true, renderPlatedPadsAsPlated, false );
-
-            // Micro-wave footprints may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
-        }
-    }
+            if( layer_id.empty() || !track->IsOnLayer( layer_id[0] ) )
+                continue;
 
-    if( renderPlatedPadsAsPlated )
-    {
-        // ADD PLATED PADS
-        for( MODULE* module : m_board->Modules() )
-        {
-            AddPadsShapesWithClearanceToContainer( module, m_platedpads_container2D_F_Cu, F_Cu, 0,
-                                                   true, false, true );
+            const VIA* via = dyn_cast<const VIA*>( track );
 
-            AddPadsShapesWithClearanceToContainer( module, m_platedpads_container2D_B_Cu, B_Cu, 0,
-                                                   true, false, true );
-        }
+            if( !via || via->GetViaType() != VIATYPE::THROUGH )
+                continue;
 
-        m_platedpads_container2D_F_Cu->BuildBVH();
-        m_platedpads_container2D_B_Cu->BuildBVH();
-    }
+            const int holediameter = via->GetDrillValue();
+            const int hole_outer_radius = (holediameter / 2) + GetHolePlatingThicknessBIU();
+            const int hole_outer_ring_radius = via->GetWidth() / 2.0f;
 
-    // Add footprints PADs poly contourns (vertical outlines)
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        for( PCB_LAYER_ID curr_layer_id : layer_id )
-        {
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+            TransformCircleToPolygon( m_through_outer_holes_poly, via->GetStart(),
+                                      hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+            // Add same thing for vias only
+            TransformCircleToPolygon( m_through_outer_holes_vias_poly, via->GetStart(),
+                                      hole_outer_radius, ARC_HIGH_DEF, ERROR_INSIDE );
 
-            // Add pads to polygon list
-            for( auto module : m_board->Modules() )
+            if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
             {
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, curr_layer_id,
-                                                                   0, ARC_HIGH_DEF, ERROR_INSIDE,
-                                                                   true, renderPlatedPadsAsPlated,
-                                                                   false );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+                TransformCircleToPolygon( m_through_outer_ring_holes_poly,
+                                          via->GetStart(), hole_outer_ring_radius,
+                                          ARC_HIGH_DEF, ERROR_INSIDE );
             }
         }
 
-        if( renderPlatedPadsAsPlated )
+        // Add contours of the pad holes (pads can be Circle or Segment holes)
+        for( MODULE* module : m_board->Modules() )
         {
-            // ADD PLATED PADS contourns
-            for( auto module : m_board->Modules() )
+            for( D_PAD* pad : module->Pads() )
             {
-                module->TransformPadsShapesWithClearanceToPolygon( *m_F_Cu_PlatedPads_poly, F_Cu,
-                                                                   0, ARC_HIGH_DEF, ERROR_INSIDE,
-                                                                   true, false, true );
+                const wxSize padHole = pad->GetDrillSize();
+
+                if( !padHole.x ) // Not drilled pad like SMD pad
+                    continue;
 
-                //transformGraphicModuleEdgeToPolygonSet( module, F_Cu, *m_F_Cu_PlatedPads_poly );
+                // The hole in the body is inflated by copper thickness.
+                const int inflate = GetHolePlatingThicknessBIU();
 
-                module->TransformPadsShapesWithClearanceToPolygon( *m_B_Cu_PlatedPads_poly, B_Cu,
-                                                                   0, ARC_HIGH_DEF, ERROR_INSIDE,
-                                                                   true, false, true );
+                if( pad->GetAttribute () != PAD_ATTRIB_NPTH )
+                {
+                    if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
+                    {
+                        pad->TransformHoleWithClearanceToPolygon( m_through_outer_ring_holes_poly,
+                                                                  inflate,
+                                                                  ARC_HIGH_DEF, ERROR_INSIDE );
+                    }
+
+                    pad->TransformHoleWithClearanceToPolygon( m_through_outer_holes_poly, inflate,
+                                                              ARC_HIGH_DEF, ERROR_INSIDE );
+                }
+                else
+                {
+                    // If not plated, no copper.
+                    if( GetFlag( FL_CLIP_SILK_ON_VIA_ANNULUS ) )
+                    {
+                        pad->TransformHoleWithClearanceToPolygon( m_through_outer_ring_holes_poly,
+                                                                  0, ARC_HIGH_DEF, ERROR_INSIDE );
+                    }
 
-                //transformGraphicModuleEdgeToPolygonSet( module, B_Cu, *m_B_Cu_PlatedPads_poly );
+                    pad->TransformHoleWithClearanceToPolygon( m_through_outer_holes_poly_NPTH, 0,
+                                                              ARC_HIGH_DEF, ERROR_INSIDE );
+                }
             }
         }
-    }
+    } );
 
-
-    // Add graphic item on copper layers to object containers
-    for( PCB_LAYER_ID curr_layer_id : layer_id )
+    if( renderPlatedPadsAsPlated )
     {
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // Add graphic items on copper layers (texts and other graphics)
-        for( auto item : m_board->Drawings() )
+        // ADD PLATED PADS, and the plated pads contours
+        for( PCB_LAYER_ID layer : { F_Cu, B_Cu } )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            CBVHCONTAINER2D* container = ( layer == F_Cu ) ? m_platedpads_container2D_F_Cu
+                                                           : m_platedpads_container2D_B_Cu;
+            SHAPE_POLY_SET*  poly = ( layer == F_Cu ) ? m_F_Cu_PlatedPads_poly
+                                                      : m_B_Cu_PlatedPads_poly;
 
-            switch( item->Type() )
+            tasks.push_back( [this, layer, container]()
             {
-            case PCB_SHAPE_T:
+                for( MODULE* module : m_board->Modules() )
+                {
+                    AddPadsShapesWithClearanceToContainer( module, container, layer, 0,
+                                                           true, false, true );
+                }
+
+                container->BuildBVH();
+            } );
+
+            if( copperThickness )
             {
-                AddShapeWithClearanceToContainer( (PCB_SHAPE*)item, layerContainer, curr_layer_id,
-                                                  0 );
-            }
-            break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (PCB_TEXT*) item, layerContainer, curr_layer_id,
-                                                  0 );
-            break;
-
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item, layerContainer, curr_layer_id,
-                                                  0 );
-            break;
-
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
+                tasks.push_back( [this, layer, poly]()
+                {
+                    for( MODULE* module : m_board->Modules() )
+                    {
+                        module->TransformPadsShapesWithClearanceToPolygon( *poly, layer, 0,
+                                                                           ARC_HIGH_DEF,
+                                                                           ERROR_INSIDE,
+                                                                           true, false, true );
+                    }
+                } );
             }
         }
     }
 
-    // Add graphic item on copper layers to poly contourns (vertical outlines)
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
+    // Build Tech layers
+    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
+    for( PCB_LAYER_ID curr_layer_id : tech_layer_id )
     {
-        for( PCB_LAYER_ID cur_layer_id : layer_id )
+        tasks.push_back( [this, curr_layer_id]()
         {
-            wxASSERT( m_layers_poly.find( cur_layer_id ) != m_layers_poly.end() );
+            CBVHCONTAINER2D *layerContainer = m_layers_container2D.at( curr_layer_id );
+            SHAPE_POLY_SET  *layerPoly = m_layers_poly.at( curr_layer_id );
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[cur_layer_id];
-
-            // Add graphic items on copper layers (texts and other )
+            // Add drawing objects and contours
             for( BOARD_ITEM* item : m_board->Drawings() )
             {
-                if( !item->IsOnLayer( cur_layer_id ) )
+                if( !item->IsOnLayer( curr_layer_id ) )
                     continue;
 
                 switch( item->Type() )
                 {
                 case PCB_SHAPE_T:
+                    AddShapeWithClearanceToContainer( (PCB_SHAPE*) item,
+                                                      layerContainer,
+                                                      curr_layer_id,
+                                                      0 );
+
                     ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                                 cur_layer_id, 0,
+                                                                                 curr_layer_id, 0,
                                                                                  ARC_HIGH_DEF,
                                                                                  ERROR_INSIDE );
                     break;
 
                 case PCB_TEXT_T:
+                    AddShapeWithClearanceToContainer( (PCB_TEXT*) item,
+                                                      layerContainer,
+                                                      curr_layer_id,
+                                                      0 );
+
                     ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0,
                                                                                    ARC_HIGH_DEF,
                                                                                    ERROR_INSIDE );
                     break;
 
+                case PCB_DIM_ALIGNED_T:
+                case PCB_DIM_CENTER_T:
+                case PCB_DIM_ORTHOGONAL_T:
+                case PCB_DIM_LEADER_T:
+                    AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                                      layerContainer,
+                                                      curr_layer_id,
+                                                      0 );
+                    break;
+
                 default:
-                    wxLogTrace( m_logTrace, wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
                     break;
                 }
             }
-        }
-    }
-
-    if( GetFlag( FL_ZONE ) )
-    {
-        if( aStatusReporter )
-            aStatusReporter->Report( _( "Create zones" ) );
 
-        std::vector<std::pair<const ZONE_CONTAINER*, PCB_LAYER_ID>> zones;
-
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
-        {
-            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-                zones.emplace_back( std::make_pair( zone, layer ) );
-        }
-
-        // Add zones objects
-        // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
+            // Add footprints tech layers - objects and contours
+            for( MODULE* module : m_board->Modules() )
             {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < zones.size();
-                            areaId = nextZone.fetch_add( 1 ) )
+                if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
                 {
-                    const ZONE_CONTAINER* zone = zones[areaId].first;
+                    const int linewidth = g_DrawDefaultLineThickness;
 
-                    if( zone == nullptr )
-                        break;
-
-                    PCB_LAYER_ID layer = zones[areaId].second;
-
-                    auto layerContainer = m_layers_container2D.find( layer );
+                    for( D_PAD* pad : module->Pads() )
+                    {
+                        if( !pad->IsOnLayer( curr_layer_id ) )
+                            continue;
 
-                    if( layerContainer != m_layers_container2D.end() )
-                        AddSolidAreasShapesToContainer( zone, layerContainer->second, layer );
+                        buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
+                        buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
+                    }
                 }
+                else
+                {
+                    AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id,
+                                                           0, false, false, false );
 
-                threadsFinished++;
-            } );
-
-            t.detach();
-        }
-
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-
-    }
-
-    if( GetFlag( FL_ZONE ) && GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        // Add copper zones
-        for( ZONE_CONTAINER* zone : m_board->Zones() )
-        {
-            if( zone == nullptr )
-                break;
-
-            for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-            {
-                auto layerContainer = m_layers_poly.find( layer );
-
-                if( layerContainer != m_layers_poly.end() )
-                    zone->TransformSolidAreasShapesToPolygon( layer, *layerContainer->second );
-            }
-        }
-    }
-
-    // Simplify layer polygons
-
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Simplifying copper layers polygons" ) );
-
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS )
-            && ( m_render_engine == RENDER_ENGINE::OPENGL_LEGACY ) )
-    {
-        if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
-        {
-            if( m_F_Cu_PlatedPads_poly && ( m_layers_poly.find( F_Cu ) != m_layers_poly.end() ) )
-            {
-                SHAPE_POLY_SET *layerPoly_F_Cu = m_layers_poly[F_Cu];
-                layerPoly_F_Cu->BooleanSubtract( *m_F_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-                m_F_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-            }
-
-            if( m_B_Cu_PlatedPads_poly && ( m_layers_poly.find( B_Cu ) != m_layers_poly.end() ) )
-            {
-                SHAPE_POLY_SET *layerPoly_B_Cu = m_layers_poly[B_Cu];
-                layerPoly_B_Cu->BooleanSubtract( *m_B_Cu_PlatedPads_poly, SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
-
-                m_B_Cu_PlatedPads_poly->Simplify( SHAPE_POLY_SET::PM_FAST );
-            }
-        }
+                    module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, curr_layer_id,
+                                                                       0, ARC_HIGH_DEF,
+                                                                       ERROR_INSIDE );
+                }
 
-        std::vector< PCB_LAYER_ID > &selected_layer_id = layer_id;
-        std::vector< PCB_LAYER_ID > layer_id_without_F_and_B;
+                AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id,
+                                                           0 );
 
-        if( GetFlag( FL_RENDER_PLATED_PADS_AS_PLATED ) )
-        {
-            layer_id_without_F_and_B.clear();
-            layer_id_without_F_and_B.reserve( layer_id.size() );
+                // On tech layers, use a poor circle approximation, only for texts (stroke font)
+                module->TransformGraphicTextWithClearanceToPolygonSet( *layerPoly, curr_layer_id,
+                                                                       0, ARC_HIGH_DEF,
+                                                                       ERROR_INSIDE );
 
-            for( size_t i = 0; i < layer_id.size(); ++i )
-            {
-                if( ( layer_id[i] != F_Cu ) &&
-                    ( layer_id[i] != B_Cu ) )
-                    layer_id_without_F_and_B.push_back( layer_id[i] );
+                // Add the remaining things with dynamic seg count for circles
+                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
             }
 
-            selected_layer_id = layer_id_without_F_and_B;
-        }
-
-        if( selected_layer_id.size() > 0 )
-        {
-            std::atomic<size_t> nextItem( 0 );
-            std::atomic<size_t> threadsFinished( 0 );
-
-            size_t parallelThreadCount = std::min<size_t>(
-                    std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                    selected_layer_id.size() );
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            // Draw non copper zones
+            if( GetFlag( FL_ZONE ) )
             {
-                std::thread t = std::thread( [&nextItem, &threadsFinished, &selected_layer_id, this]()
+                for( ZONE_CONTAINER* zone : m_board->Zones() )
                 {
-                    for( size_t i = nextItem.fetch_add( 1 );
-                                i < selected_layer_id.size();
-                                i = nextItem.fetch_add( 1 ) )
+                    if( zone->IsOnLayer( curr_layer_id ) )
                     {
-                        auto layerPoly = m_layers_poly.find( selected_layer_id[i] );
-
-                        if( layerPoly != m_layers_poly.end() )
-                            // This will make a union of all added contours
-                            layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+                        AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
+                        zone->TransformSolidAreasShapesToPolygon( curr_layer_id, *layerPoly );
                     }
-
-                    threadsFinished++;
-                } );
-
-                t.detach();
+                }
             }
 
-            while( threadsFinished < parallelThreadCount )
-                std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-        }
+            // This will make a union of all added contours
+            layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+        } );
     }
 
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Simplify holes contours" ) );
+    runTasks( tasks );
+    tasks.clear();
 
-    for( PCB_LAYER_ID layer : layer_id )
-    {
-        if( m_layers_outer_holes_poly.find( layer ) != m_layers_outer_holes_poly.end() )
-        {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-
-            wxASSERT( m_layers_inner_holes_poly.find( layer ) != m_layers_inner_holes_poly.end() );
-
-            polyLayer = m_layers_inner_holes_poly[layer];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
-    }
-
-    // End Build Copper layers
+    double itemsTime = itemsTimer.msecs();
 
-    // This will make a union of all added contourns
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_ring_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
+    // Phase 2: merge the polygons of each layer
     // /////////////////////////////////////////////////////////////////////////
     if( aStatusReporter )
-        aStatusReporter->Report( _( "Build Tech layers" ) );
-
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
+        aStatusReporter->Report( _( "Simplifying copper layers polygons" ) );
 
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
+    PROF_COUNTER polygonsTimer;
 
-    // User layers are not drawn here, only technical layers
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
+    if( copperThickness )
     {
-        const PCB_LAYER_ID curr_layer_id = *seq;
-
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-            continue;
-
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
-
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
-
-        // Add drawing objects
-        for( BOARD_ITEM* item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_SHAPE_T:
-                AddShapeWithClearanceToContainer( (PCB_SHAPE*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (PCB_TEXT*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIM_ALIGNED_T:
-            case PCB_DIM_CENTER_T:
-            case PCB_DIM_ORTHOGONAL_T:
-            case PCB_DIM_LEADER_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            default:
-                break;
-            }
-        }
-
-
-        // Add drawing contours
-        for( BOARD_ITEM* item : m_board->Drawings() )
+        for( PCB_LAYER_ID layer : layer_id )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+            SHAPE_POLY_SET* layerPoly = m_layers_poly.at( layer );
+            SHAPE_POLY_SET* platedPadsPoly = nullptr;
 
-            switch( item->Type() )
-            {
-            case PCB_SHAPE_T:
-                ( (PCB_SHAPE*) item )->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                             curr_layer_id, 0,
-                                                                             ARC_HIGH_DEF,
-                                                                             ERROR_INSIDE );
-                break;
-
-            case PCB_TEXT_T:
-                ( (PCB_TEXT*) item )->TransformShapeWithClearanceToPolygonSet( *layerPoly, 0,
-                                                                               ARC_HIGH_DEF,
-                                                                               ERROR_INSIDE );
-                break;
-
-            default:
-                break;
-            }
-        }
+            if( renderPlatedPadsAsPlated && layer == F_Cu )
+                platedPadsPoly = m_F_Cu_PlatedPads_poly;
+            else if( renderPlatedPadsAsPlated && layer == B_Cu )
+                platedPadsPoly = m_B_Cu_PlatedPads_poly;
 
-
-        // Add footprints tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
+            tasks.push_back( [layerPoly, platedPadsPoly]()
             {
-                int     linewidth = g_DrawDefaultLineThickness;
-
-                for( D_PAD* pad : module->Pads() )
+                if( platedPadsPoly )
                 {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+                    layerPoly->BooleanSubtract( *platedPadsPoly,
+                                                SHAPE_POLY_SET::POLYGON_MODE::PM_FAST );
 
-                    buildPadShapeThickOutlineAsSegments( pad, layerContainer, linewidth );
+                    platedPadsPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
                 }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0,
-                                                       false,
-                                                       false,
-                                                       false );
-            }
-
-            AddGraphicsShapesWithClearanceToContainer( module, layerContainer, curr_layer_id, 0 );
+                else
+                {
+                    // This will make a union of all added contours
+                    layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+                }
+            } );
         }
+    }
 
+    // Simplify holes polygon contours
+    for( auto& holes : m_layers_outer_holes_poly )
+    {
+        SHAPE_POLY_SET* outerPoly = holes.second;
+        SHAPE_POLY_SET* innerPoly = m_layers_inner_holes_poly.at( holes.first );
 
-        // Add footprints tech layers - contours
-        for( MODULE* module : m_board->Modules() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                const int linewidth = g_DrawDefaultLineThickness;
+        tasks.push_back( [outerPoly]() { outerPoly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+        tasks.push_back( [innerPoly]() { innerPoly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+    }
 
-                for( D_PAD* pad : module->Pads() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+    // This will make a union of all added contourns
+    for( SHAPE_POLY_SET* poly : { &m_through_outer_holes_poly,
+                                  &m_through_outer_holes_poly_NPTH,
+                                  &m_through_outer_holes_vias_poly,
+                                  &m_through_outer_ring_holes_poly } )
+    {
+        tasks.push_back( [poly]() { poly->Simplify( SHAPE_POLY_SET::PM_FAST ); } );
+    }
 
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                module->TransformPadsShapesWithClearanceToPolygon( *layerPoly, curr_layer_id, 0,
-                                                                   ARC_HIGH_DEF, ERROR_INSIDE );
-            }
+    runTasks( tasks );
+    tasks.clear();
 
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( *layerPoly, curr_layer_id, 0,
-                                                                   ARC_HIGH_DEF, ERROR_INSIDE );
+    double polygonsTime = polygonsTimer.msecs();
 
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-        }
+    // Phase 3: build BVH (Bounding volume hierarchy) for holes and vias
+    // /////////////////////////////////////////////////////////////////////////
+    if( aStatusReporter )
+        aStatusReporter->Report( _( "Build BVH for holes and vias" ) );
 
+    PROF_COUNTER bvhTimer;
 
-        // Draw non copper zones
-        if( GetFlag( FL_ZONE ) )
-        {
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    AddSolidAreasShapesToContainer( zone, layerContainer, curr_layer_id );
-            }
+    std::vector<CBVHCONTAINER2D*> bvhContainers = { &m_through_holes_inner,
+                                                    &m_through_holes_outer,
+                                                    &m_through_holes_outer_ring };
 
-            for( ZONE_CONTAINER* zone : m_board->Zones() )
-            {
-                if( zone->IsOnLayer( curr_layer_id ) )
-                    zone->TransformSolidAreasShapesToPolygon( curr_layer_id, *layerPoly );
-            }
-        }
+    for( auto& hole : m_layers_holes2D )
+        bvhContainers.push_back( hole.second );
 
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+    // We only need the Solder mask to initialize the BVH
+    // because..?
+    for( PCB_LAYER_ID layer : { B_Mask, F_Mask } )
+    {
+        auto layerContainer = m_layers_container2D.find( layer );
+
+        if( layerContainer != m_layers_container2D.end() )
+            bvhContainers.push_back( layerContainer->second );
     }
-    // End Build Tech layers
 
-    // Build BVH (Bounding volume hierarchy) for holes and vias
+    for( CBVHCONTAINER2D* container : bvhContainers )
+        tasks.push_back( [container]() { container->BuildBVH(); } );
 
-    if( aStatusReporter )
-        aStatusReporter->Report( _( "Build BVH for holes and vias" ) );
+    runTasks( tasks );
 
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
-    m_through_holes_outer_ring.BuildBVH();
+    double bvhTime = bvhTimer.msecs();
 
-    if( !m_layers_holes2D.empty() )
+    if( aStatusReporter )
     {
-        for( auto& hole : m_layers_holes2D )
-            hole.second->BuildBVH();
+        aStatusReporter->Report( wxString::Format( _( "Layers created in %.0f ms (items: %.0f ms, "
+                                                      "polygons: %.0f ms, BVH: %.0f ms)" ),
+                                                   totalTimer.msecs(), itemsTime, polygonsTime,
+                                                   bvhTime ) );
     }
-
-    // We only need the Solder mask to initialize the BVH
-    // because..?
-    if( m_layers_container2D[B_Mask] )
-        m_layers_container2D[B_Mask]->BuildBVH();
-
-    if( m_layers_container2D[F_Mask] )
-        m_layers_container2D[F_Mask]->BuildBVH();
 }
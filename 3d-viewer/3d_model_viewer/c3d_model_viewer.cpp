@@ -136,6 +136,7 @@ void C3D_MODEL_VIEWER::Set3DModel( const S3DMODEL &a3DModel )
     m_ogl_3dmodel = NULL;
 
     m_3d_model = NULL;
+    m_cachedModel.reset();
 
     if( (a3DModel.m_Materials != NULL) && (a3DModel.m_Meshes != NULL) &&
         (a3DModel.m_MaterialsSize > 0) && (a3DModel.m_MeshesSize > 0) )
@@ -154,12 +155,17 @@ void C3D_MODEL_VIEWER::Set3DModel(const wxString &aModelPathName)
 
     if( m_cacheManager )
     {
-        const S3DMODEL* model = m_cacheManager->GetModel( aModelPathName );
+        std::shared_ptr<S3DMODEL> model = m_cacheManager->GetModel( aModelPathName );
 
         if( model )
+        {
             Set3DModel( (const S3DMODEL &)*model );
+            m_cachedModel = model;
+        }
         else
+        {
             Clear3DModel();
+        }
     }
 }
 
@@ -173,6 +179,7 @@ void C3D_MODEL_VIEWER::Clear3DModel()
     m_ogl_3dmodel = NULL;
 
     m_3d_model = NULL;
+    m_cachedModel.reset();
 
     Refresh();
 }
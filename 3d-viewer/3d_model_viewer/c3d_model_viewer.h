@@ -35,6 +35,8 @@
 #include "3d_rendering/ctrack_ball.h"
 #include <gal/hidpi_gl_canvas.h>
 
+#include <memory>
+
 class S3D_CACHE;
 class C_OGL_3DMODEL;
 
@@ -118,6 +120,9 @@ private:
     /// Original 3d model data
     const S3DMODEL *m_3d_model;
 
+    /// The render data of the cache m_3d_model points to, if it comes from the cache
+    std::shared_ptr<S3DMODEL> m_cachedModel;
+
     /// Class holder for 3d model to display on openGL
     C_OGL_3DMODEL  *m_ogl_3dmodel;
 
@@ -952,29 +952,41 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER* aStatusReporter )
        (!m_boardAdapter.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models not already in our cache map in parallel.  The models of the hidden
+    // footprints are not rendered: toggling their display reloads the models.
+    std::vector<wxString> modelsToLoad;
+
+    for( MODULE* module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( !m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( model.m_Show && !model.m_Filename.empty()
+              && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+                modelsToLoad.push_back( model.m_Filename );
+        }
+    }
+
+    m_boardAdapter.Get3DCacheManager()->PreloadModels( modelsToLoad, aStatusReporter );
+
     // Go for all footprints
     for( MODULE* module : m_boardAdapter.GetBoard()->Modules() )
     {
+        if( !m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
         for( const MODULE_3D_SETTINGS& model : module->Models() )
         {
             if( model.m_Show && !model.m_Filename.empty() )
             {
-                if( aStatusReporter )
-                {
-                    // Display the short filename of the 3D model loaded:
-                    // (the full name is usually too long to be displayed)
-                    wxFileName fn( model.m_Filename );
-                    wxString msg;
-                    msg.Printf( _( "Loading %s" ), fn.GetFullName() );
-                    aStatusReporter->Report( msg );
-                }
-
                 // Check if the model is not present in our cache map
                 // (Not already loaded in memory)
                 if( m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
                 {
                     // It is not present, try get it from cache
-                    const S3DMODEL* modelPtr =
+                    std::shared_ptr<S3DMODEL> modelPtr =
                             m_boardAdapter.Get3DCacheManager()->GetModel( model.m_Filename );
 
                     // only add it if the return is not NULL
@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "cbvh_wide.h"
 #include <wx/debug.h>
 
 
@@ -37,6 +38,9 @@
 
 #define MAX_TODOS 64
 
+// Each wide node can push 3 more nodes than it pops
+#define MAX_WIDE_TODOS ( 3 * MAX_TODOS )
+
 
 struct StackNode
 {
@@ -45,31 +49,6 @@ struct StackNode
 };
 
 
-static inline unsigned int getFirstHit( const RAYPACKET &aRayPacket,
-                                        const CBBOX &aBBox,
-                                        unsigned int ia,
-                                        HITINFO_PACKET *aHitInfoPacket )
-{
-    float hitT;
-
-    if( aBBox.Intersect( aRayPacket.m_ray[ia], &hitT ) )
-        if( hitT < aHitInfoPacket[ia].m_HitInfo.m_tHit )
-            return ia;
-
-    if( !aRayPacket.m_Frustum.Intersect( aBBox ) )
-        return RAYPACKET_RAYS_PER_PACKET;
-
-    for( unsigned int i = ia + 1; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-    {
-        if( aBBox.Intersect( aRayPacket.m_ray[i], &hitT ) )
-            if( hitT < aHitInfoPacket[i].m_HitInfo.m_tHit )
-                return i;
-    }
-
-    return RAYPACKET_RAYS_PER_PACKET;
-}
-
-
 #ifdef BVH_RANGED_TRAVERSAL
 
 static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
@@ -93,62 +72,112 @@ static inline unsigned int getLastHit( const RAYPACKET &aRayPacket,
 // "Large Ray Packets for Real-time Whitted Ray Tracing"
 // http://cseweb.ucsd.edu/~ravir/whitted.pdf
 
-// Ranged Traversal
+// Ranged Traversal, on the 4 wide BVH
 bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
                            HITINFO_PACKET *aHitInfoPacket ) const
 {
-    if( m_nodes == NULL )
+    if( m_wideNodes.empty() )
         return false;
 
-    if( (&m_nodes[0]) == NULL )
-        return false;
+    BVH_WIDE_RAY wideRays[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+        wideRays[i].Init( aRayPacket.m_ray[i] );
 
     bool anyHitted = false;
     int todoOffset = 0, nodeNum = 0;
-    StackNode todo[MAX_TODOS];
+    StackNode todo[MAX_WIDE_TODOS];
 
     unsigned int ia = 0;
 
     while( true )
     {
-        const LinearBVHNode *curCell = &m_nodes[nodeNum];
+        const LinearWideBVHNode &curCell = m_wideNodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        wxASSERT( todoOffset + 4 <= MAX_WIDE_TODOS );
 
-        if( ia < RAYPACKET_RAYS_PER_PACKET )
+        // Find the first ray hitting each child, starting from the first active ray
+        unsigned int firstHit[4] = { RAYPACKET_RAYS_PER_PACKET, RAYPACKET_RAYS_PER_PACKET,
+                                     RAYPACKET_RAYS_PER_PACKET, RAYPACKET_RAYS_PER_PACKET };
+        unsigned int pending = 0;
+
+        for( unsigned int c = 0; c < 4; ++c )
         {
-            if( curCell->nPrimitives == 0 )
+            if( curCell.binaryNodes[c] >= 0 )
+                pending |= 1 << c;
+        }
+
+        unsigned int mask = IntersectWideNode( curCell, wideRays[ia],
+                                               aHitInfoPacket[ia].m_HitInfo.m_tHit ) & pending;
+
+        for( unsigned int c = 0; c < 4; ++c )
+        {
+            if( mask & ( 1 << c ) )
+                firstHit[c] = ia;
+        }
+
+        pending &= ~mask;
+
+        // The children missed by the first ray and out of the packet frustum are culled
+        for( unsigned int c = 0; c < 4; ++c )
+        {
+            if( ( pending & ( 1 << c ) )
+              && !aRayPacket.m_Frustum.Intersect( m_nodes[curCell.binaryNodes[c]].bounds ) )
+                pending &= ~( 1 << c );
+        }
+
+        for( unsigned int i = ia + 1; pending && ( i < RAYPACKET_RAYS_PER_PACKET ); ++i )
+        {
+            mask = IntersectWideNode( curCell, wideRays[i],
+                                      aHitInfoPacket[i].m_HitInfo.m_tHit ) & pending;
+
+            for( unsigned int c = 0; c < 4; ++c )
+            {
+                if( mask & ( 1 << c ) )
+                    firstHit[c] = i;
+            }
+
+            pending &= ~mask;
+        }
+
+        for( unsigned int c = 0; c < 4; ++c )
+        {
+            if( firstHit[c] >= RAYPACKET_RAYS_PER_PACKET )
+                continue;
+
+            if( curCell.children[c] >= 0 )
             {
                 StackNode &node = todo[todoOffset++];
-                node.cell = curCell->secondChildOffset;
-                node.ia = ia;
-                nodeNum = nodeNum + 1;
+                node.cell = curCell.children[c];
+                node.ia = firstHit[c];
                 continue;
             }
-            else
-            {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
+
+            const int leafNum = ~curCell.children[c];
+            const LinearBVHNode *leaf = &m_nodes[leafNum];
+
+            const unsigned int leafIa = firstHit[c];
+            const unsigned int leafIe = getLastHit( aRayPacket,
+                                                    leaf->bounds,
+                                                    leafIa,
                                                     aHitInfoPacket );
 
-                for( int j = 0; j < curCell->nPrimitives; ++j )
-                {
-                    const COBJECT *obj = m_primitives[curCell->primitivesOffset + j];
+            for( int j = 0; j < leaf->nPrimitives; ++j )
+            {
+                const COBJECT *obj = m_primitives[leaf->primitivesOffset + j];
 
-                    if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
+                {
+                    for( unsigned int i = leafIa; i < leafIe; ++i )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
-                        {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                        const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
+                                                            aHitInfoPacket[i].m_HitInfo );
 
-                            if( hitted )
-                            {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
-                            }
+                        if( hitted )
+                        {
+                            anyHitted |= hitted;
+                            aHitInfoPacket[i].m_hitresult |= hitted;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = leafNum;
                         }
                     }
                 }
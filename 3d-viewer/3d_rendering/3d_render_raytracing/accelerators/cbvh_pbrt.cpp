@@ -67,12 +67,14 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "cbvh_wide.h"
 #include "../../../3d_fastmath.h"
 #include <macros.h>
 
 #include <boost/range/algorithm/nth_element.hpp>
 #include <boost/range/algorithm/partition.hpp>
 #include <cstdlib>
+#include <limits>
 #include <vector>
 
 #include <stack>
@@ -305,6 +307,10 @@ CBVH_PBRT::CBVH_PBRT( const CGENERICCONTAINER &aObjectContainer,
     flattenBVHTree( root, &offset );
 
     wxASSERT( offset == (unsigned int)totalNodes );
+
+    // Collapse the binary tree into a 4 wide tree, for faster traversals
+    m_wideNodes.reserve( totalNodes / 2 + 1 );
+    collapseBVHTree( 0 );
 }
 
 
@@ -1106,63 +1112,172 @@ int CBVH_PBRT::flattenBVHTree( BVHBuildNode *node, uint32_t *offset )
 }
 
 
+int CBVH_PBRT::collapseBVHTree( int aBinaryNode )
+{
+    // Gather up to 4 children, opening the largest interior children first
+    int childrenCount = 0;
+    int children[4];
+
+    if( m_nodes[aBinaryNode].nPrimitives > 0 )
+    {
+        // A leaf root
+        children[childrenCount++] = aBinaryNode;
+    }
+    else
+    {
+        children[childrenCount++] = aBinaryNode + 1;
+        children[childrenCount++] = m_nodes[aBinaryNode].secondChildOffset;
+    }
+
+    while( childrenCount < 4 )
+    {
+        int   best = -1;
+        float bestArea = -1.0f;
+
+        for( int i = 0; i < childrenCount; ++i )
+        {
+            const LinearBVHNode& child = m_nodes[children[i]];
+
+            if( child.nPrimitives == 0 && child.bounds.SurfaceArea() > bestArea )
+            {
+                best = i;
+                bestArea = child.bounds.SurfaceArea();
+            }
+        }
+
+        if( best < 0 )
+            break;
+
+        const int opened = children[best];
+
+        children[best] = opened + 1;
+        children[childrenCount++] = m_nodes[opened].secondChildOffset;
+    }
+
+    const int wideIndex = m_wideNodes.size();
+    m_wideNodes.emplace_back();
+
+    for( int i = 0; i < 4; ++i )
+    {
+        LinearWideBVHNode& wideNode = m_wideNodes[wideIndex];
+
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            if( i < childrenCount )
+            {
+                const CBBOX& bbox = m_nodes[children[i]].bounds;
+
+                wideNode.bounds[0][axis][i] = bbox.Min()[axis];
+                wideNode.bounds[1][axis][i] = bbox.Max()[axis];
+            }
+            else
+            {
+                // Empty box: never hit
+                wideNode.bounds[0][axis][i] = std::numeric_limits<float>::infinity();
+                wideNode.bounds[1][axis][i] = -std::numeric_limits<float>::infinity();
+            }
+        }
+
+        wideNode.children[i] = 0;
+        wideNode.binaryNodes[i] = ( i < childrenCount ) ? children[i] : -1;
+    }
+
+    // The recursion can reallocate m_wideNodes, so do not keep references
+    for( int i = 0; i < childrenCount; ++i )
+    {
+        int wideChild;
+
+        if( m_nodes[children[i]].nPrimitives > 0 )
+            wideChild = ~children[i];
+        else
+            wideChild = collapseBVHTree( children[i] );
+
+        m_wideNodes[wideIndex].children[i] = wideChild;
+    }
+
+    return wideIndex;
+}
+
+
+bool CBVH_PBRT::intersectLeaf( const RAY &aRay, HITINFO &aHitInfo, int aLeafNode ) const
+{
+    const LinearBVHNode *node = &m_nodes[aLeafNode];
+
+    bool hit = false;
+
+    for( int i = 0; i < node->nPrimitives; ++i )
+    {
+        if( m_primitives[node->primitivesOffset + i]->Intersect( aRay, aHitInfo ) )
+        {
+            aHitInfo.m_acc_node_info = aLeafNode;
+            hit = true;
+        }
+    }
+
+    return hit;
+}
+
+
 #define MAX_TODOS 64
 
+// Each wide node can push 3 more nodes than it pops
+#define MAX_WIDE_TODOS ( 3 * MAX_TODOS )
+
 bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
 {
-    if( !m_nodes )
+    if( m_wideNodes.empty() )
         return false;
 
     bool hit = false;
 
-    // Follow ray through BVH nodes to find primitive intersections
+    const BVH_WIDE_RAY wideRay( aRay );
+
+    // Follow ray through the wide BVH nodes to find primitive intersections
     int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
+    int todo[MAX_WIDE_TODOS];
 
     while( true )
     {
-        const LinearBVHNode *node = &m_nodes[nodeNum];
+        const LinearWideBVHNode& node = m_wideNodes[nodeNum];
 
-        wxASSERT( todoOffset < MAX_TODOS );
+        wxASSERT( todoOffset + 4 <= MAX_WIDE_TODOS );
 
-        // Check ray against BVH node
-        float hitBox = 0.0f;
+        float        tmin[4];
+        unsigned int mask = IntersectWideNode( node, wideRay, aHitInfo.m_tHit, tmin );
 
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
+        // Intersect the leaves now, and push the interior nodes, the nearest last
+        int   pushed = 0;
+        float pushedT[4];
 
-        if( hitted && (hitBox < aHitInfo.m_tHit) )
+        for( int i = 0; mask; ++i, mask >>= 1 )
         {
-            if( node->nPrimitives > 0 )
+            if( !( mask & 1 ) )
+                continue;
+
+            const int child = node.children[i];
+
+            if( child < 0 )
             {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
-                {
-                    if( m_primitives[node->primitivesOffset + i]->Intersect( aRay,
-                                                                             aHitInfo ) )
-                    {
-                        aHitInfo.m_acc_node_info = nodeNum;
-                        hit = true;
-                    }
-                }
+                hit |= intersectLeaf( aRay, aHitInfo, ~child );
+                continue;
             }
-            else
-            {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
 
-                continue;
+            // Insertion sort of the pushed nodes, by decreasing distance
+            int j = pushed++;
+
+            while( j > 0 && pushedT[j - 1] < tmin[i] )
+            {
+                pushedT[j] = pushedT[j - 1];
+                todo[todoOffset + j] = todo[todoOffset + j - 1];
+                --j;
             }
+
+            pushedT[j] = tmin[i];
+            todo[todoOffset + j] = child;
         }
 
+        todoOffset += pushed;
+
         if( todoOffset == 0 )
             break;
 
@@ -1172,6 +1287,7 @@ bool CBVH_PBRT::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     return hit;
 }
 
+
 // !TODO: this may be optimized
 bool CBVH_PBRT::Intersect( const RAY &aRay,
                            HITINFO &aHitInfo,
@@ -1242,53 +1358,46 @@ bool CBVH_PBRT::Intersect( const RAY &aRay,
 
 bool CBVH_PBRT::IntersectP( const RAY &aRay, float aMaxDistance ) const
 {
-    if( !m_nodes )
+    if( m_wideNodes.empty() )
         return false;
 
-    // Follow ray through BVH nodes to find primitive intersections
+    const BVH_WIDE_RAY wideRay( aRay );
+
+    // Follow ray through the wide BVH nodes to find any primitive intersection
     int todoOffset = 0, nodeNum = 0;
-    int todo[MAX_TODOS];
+    int todo[MAX_WIDE_TODOS];
 
     while( true )
     {
-        const LinearBVHNode *node = &m_nodes[nodeNum];
+        const LinearWideBVHNode& node = m_wideNodes[nodeNum];
 
-        wxASSERT( todoOffset < MAX_TODOS );
+        wxASSERT( todoOffset + 4 <= MAX_WIDE_TODOS );
 
-        // Check ray against BVH node
-        float hitBox = 0.0f;
-
-        const bool hitted = node->bounds.Intersect( aRay, &hitBox );
+        unsigned int mask = IntersectWideNode( node, wideRay, aMaxDistance );
 
-        if( hitted && (hitBox < aMaxDistance) )
+        for( int i = 0; mask; ++i, mask >>= 1 )
         {
-            if( node->nPrimitives > 0 )
-            {
-                // Intersect ray with primitives in leaf BVH node
-                for( int i = 0; i < node->nPrimitives; ++i )
-                {
-                    const COBJECT *obj = m_primitives[node->primitivesOffset + i];
+            if( !( mask & 1 ) )
+                continue;
 
-                    if( obj->GetMaterial()->GetCastShadows() )
-                        if( obj->IntersectP( aRay, aMaxDistance ) )
-                            return true;
-                }
+            const int child = node.children[i];
+
+            if( child >= 0 )
+            {
+                todo[todoOffset++] = child;
+                continue;
             }
-            else
+
+            // Intersect ray with primitives in leaf BVH node
+            const LinearBVHNode *leaf = &m_nodes[~child];
+
+            for( int j = 0; j < leaf->nPrimitives; ++j )
             {
-                // Put far BVH node on _todo_ stack, advance to near node
-                if( aRay.m_dirIsNeg[node->axis] )
-                {
-                    todo[todoOffset++] = nodeNum + 1;
-                    nodeNum = node->secondChildOffset;
-                }
-                else
-                {
-                    todo[todoOffset++] = node->secondChildOffset;
-                    nodeNum = nodeNum + 1;
-                }
+                const COBJECT *obj = m_primitives[leaf->primitivesOffset + j];
 
-                continue;
+                if( obj->GetMaterial()->GetCastShadows() )
+                    if( obj->IntersectP( aRay, aMaxDistance ) )
+                        return true;
             }
         }
 
@@ -73,6 +73,7 @@
 #include "caccelerator.h"
 #include <cstdint>
 #include <list>
+#include <vector>
 
 // Forward Declarations
 struct BVHBuildNode;
@@ -98,6 +99,25 @@ struct LinearBVHNode
 };
 
 
+/**
+ * A node of the 4 wide BVH, collapsed from the binary BVH.
+ *
+ * The children boxes are stored as structure of arrays, so a ray can be tested
+ * against the 4 boxes at once.  Unused children have an empty (inverted) box.
+ */
+struct LinearWideBVHNode
+{
+    /// [min, max][x, y, z][child]
+    float bounds[2][3][4];
+
+    /// >= 0: index of a wide node, < 0: ~(index of a binary leaf node)
+    int children[4];
+
+    /// index of the binary node of each child, -1 for unused children
+    int binaryNodes[4];
+};
+
+
 enum class SPLITMETHOD
 {
     MIDDLE,
@@ -151,12 +171,27 @@ private:
     int flattenBVHTree( BVHBuildNode *node,
                         uint32_t *offset );
 
+    /**
+     * Collapse the binary subtree at aBinaryNode into wide nodes.
+     * @return the index of the wide node
+     */
+    int collapseBVHTree( int aBinaryNode );
+
+    /**
+     * Intersect a ray with the primitives of a binary leaf node.
+     */
+    bool intersectLeaf( const RAY &aRay, HITINFO &aHitInfo, int aLeafNode ) const;
+
     // BVH Private Data
     const int           m_maxPrimsInNode;
     SPLITMETHOD         m_splitMethod;
     CONST_VECTOR_OBJECT m_primitives;
     LinearBVHNode       *m_nodes;
 
+    /// The wide BVH used for traversals from the root, the binary BVH (m_nodes) is
+    /// used for the traversals from a given node
+    std::vector<LinearWideBVHNode> m_wideNodes;
+
     std::list<void *> m_addresses_pointer_to_mm_free;
 
     // Partition traversal
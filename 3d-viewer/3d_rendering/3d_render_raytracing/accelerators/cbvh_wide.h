@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  cbvh_wide.h
+ * @brief Ray tests against the 4 children of a LinearWideBVHNode, using SSE when
+ * available and a scalar implementation otherwise.
+ */
+
+#ifndef _CBVH_WIDE_H_
+#define _CBVH_WIDE_H_
+
+#include "cbvh_pbrt.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define BVH_WIDE_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+
+/**
+ * Ray data used by the wide node tests, prepared once per ray
+ */
+struct BVH_WIDE_RAY
+{
+    float        m_origin[3];
+    float        m_invDir[3];
+    unsigned int m_near[3];     ///< per axis, the index in bounds[] of the entry plane
+
+    BVH_WIDE_RAY() {}
+
+    explicit BVH_WIDE_RAY( const RAY& aRay )
+    {
+        Init( aRay );
+    }
+
+    void Init( const RAY& aRay )
+    {
+        for( unsigned int i = 0; i < 3; ++i )
+        {
+            m_origin[i] = aRay.m_Origin[i];
+            m_invDir[i] = aRay.m_InvDir[i];
+            m_near[i]   = aRay.m_dirIsNeg[i];
+        }
+    }
+};
+
+
+/**
+ * Test a ray against the 4 children boxes of a wide node.
+ *
+ * @param aNode is the node to test
+ * @param aRay is the ray
+ * @param aMaxT is the max distance of a hit (usually the current hit distance)
+ * @param aOutTmin if not NULL, receives the entry distance of each child box
+ * @return a mask of the children hit by the ray (bit i set for child i)
+ */
+static inline unsigned int IntersectWideNode( const LinearWideBVHNode& aNode,
+                                              const BVH_WIDE_RAY& aRay,
+                                              float aMaxT,
+                                              float* aOutTmin = NULL )
+{
+#ifdef BVH_WIDE_USE_SSE
+    __m128 tmin = _mm_setzero_ps();
+    __m128 tmax = _mm_set1_ps( aMaxT );
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        const __m128 origin = _mm_set1_ps( aRay.m_origin[axis] );
+        const __m128 invDir = _mm_set1_ps( aRay.m_invDir[axis] );
+
+        const unsigned int nearIdx = aRay.m_near[axis];
+
+        const __m128 tNear = _mm_mul_ps( _mm_sub_ps(
+                _mm_loadu_ps( aNode.bounds[nearIdx][axis] ), origin ), invDir );
+        const __m128 tFar = _mm_mul_ps( _mm_sub_ps(
+                _mm_loadu_ps( aNode.bounds[1 - nearIdx][axis] ), origin ), invDir );
+
+        // A NaN (ray origin on a slab plane, parallel to it) keeps the current bound
+        tmin = _mm_max_ps( tNear, tmin );
+        tmax = _mm_min_ps( tFar, tmax );
+    }
+
+    if( aOutTmin )
+        _mm_storeu_ps( aOutTmin, tmin );
+
+    return _mm_movemask_ps( _mm_cmple_ps( tmin, tmax ) );
+#else
+    unsigned int mask = 0;
+
+    for( unsigned int child = 0; child < 4; ++child )
+    {
+        float tmin = 0.0f;
+        float tmax = aMaxT;
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const unsigned int nearIdx = aRay.m_near[axis];
+
+            const float tNear = ( aNode.bounds[nearIdx][axis][child] - aRay.m_origin[axis] ) *
+                                aRay.m_invDir[axis];
+            const float tFar = ( aNode.bounds[1 - nearIdx][axis][child] - aRay.m_origin[axis] ) *
+                               aRay.m_invDir[axis];
+
+            tmin = ( tNear > tmin ) ? tNear : tmin;
+            tmax = ( tFar < tmax ) ? tFar : tmax;
+        }
+
+        if( aOutTmin )
+            aOutTmin[child] = tmin;
+
+        if( tmin <= tmax )
+            mask |= 1 << child;
+    }
+
+    return mask;
+#endif
+}
+
+#endif // _CBVH_WIDE_H_
@@ -950,7 +950,7 @@ void C3D_RENDER_RAYTRACING::Reload( REPORTER* aStatusReporter,
 #endif
 
 
-    load_3D_models( m_object_container, aOnlyLoadCopperAndShapes );
+    load_3D_models( m_object_container, aOnlyLoadCopperAndShapes, aStatusReporter );
 
 
 #ifdef PRINT_STATISTICS_3D_VIEWER
@@ -1090,8 +1090,12 @@ void C3D_RENDER_RAYTRACING::Reload( REPORTER* aStatusReporter,
     }
     m_accelerator = 0;
 
+    unsigned stats_startAcceleratorTime = GetRunningMicroSecs();
+
     m_accelerator = new CBVH_PBRT( m_object_container, 8, SPLITMETHOD::MIDDLE );
 
+    m_stats_bvh_build_time = GetRunningMicroSecs() - stats_startAcceleratorTime;
+
     if( aStatusReporter )
     {
         // Calculation time in seconds
@@ -1383,8 +1387,34 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 }
 
 
-void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSkipMaterialInformation )
+void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer,
+                                            bool aSkipMaterialInformation,
+                                            REPORTER* aStatusReporter )
 {
+    S3D_CACHE* cacheMgr = m_boardAdapter.Get3DCacheManager();
+
+    // Offscreen renders can be made without any 3D model cache
+    if( !cacheMgr )
+        return;
+
+    // Load all the models in parallel first
+    std::vector<wxString> modelsToLoad;
+
+    for( auto module : m_boardAdapter.GetBoard()->Modules() )
+    {
+        if( !m_boardAdapter.ShouldModuleBeDisplayed( (MODULE_ATTR_T) module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( ( static_cast<float>( model.m_Opacity ) > FLT_EPSILON ) &&
+                ( model.m_Show && !model.m_Filename.empty() ) )
+                modelsToLoad.push_back( model.m_Filename );
+        }
+    }
+
+    cacheMgr->PreloadModels( modelsToLoad, aStatusReporter );
+
     // Go for all footprints
     for( auto module : m_boardAdapter.GetBoard()->Modules() )
     {
@@ -1433,7 +1463,6 @@ void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSki
             BOARD_ITEM* boardItem = dynamic_cast<BOARD_ITEM*>( module );
 
             // Get the list of model files for this model
-            S3D_CACHE* cacheMgr = m_boardAdapter.Get3DCacheManager();
             auto sM = module->Models().begin();
             auto eM = module->Models().end();
 
@@ -1443,7 +1472,7 @@ void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSki
                     ( sM->m_Show && !sM->m_Filename.empty() ) )
                 {
                     // get it from cache
-                    const S3DMODEL *modelPtr = cacheMgr->GetModel( sM->m_Filename );
+                    std::shared_ptr<S3DMODEL> modelPtr = cacheMgr->GetModel( sM->m_Filename );
 
                     // only add it if the return is not NULL
                     if( modelPtr )
@@ -1476,7 +1505,7 @@ void C3D_RENDER_RAYTRACING::load_3D_models( CCONTAINER &aDstContainer, bool aSki
                                                            sM->m_Scale.z ) );
 
                         add_3D_models( aDstContainer,
-                                       modelPtr,
+                                       modelPtr.get(),
                                        modelMatrix,
                                        (float)sM->m_Opacity,
                                        aSkipMaterialInformation,
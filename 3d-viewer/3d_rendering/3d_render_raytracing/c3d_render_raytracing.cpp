@@ -41,6 +41,7 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <wx/image.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
@@ -58,6 +59,8 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_accelerator = NULL;
     m_stats_converted_dummy_to_plane = 0;
     m_stats_converted_roundsegment2d_to_roundsegment = 0;
+    m_stats_bvh_build_time = 0;
+    m_stats_camera_rays = 0;
     m_oldWindowsSize.x = 0;
     m_oldWindowsSize.y = 0;
     m_outlineBoard2dObjects = NULL;
@@ -73,6 +76,7 @@ C3D_RENDER_RAYTRACING::C3D_RENDER_RAYTRACING( BOARD_ADAPTER& aAdapter, CCAMERA&
     m_rt_render_state = RT_RENDER_STATE_MAX; // Set to an initial invalid state
     m_stats_start_rendering_time = 0;
     m_nrBlocksRenderProgress = 0;
+    m_refinePass = 0;
 }
 
 
@@ -133,6 +137,8 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
 
     m_rt_render_state = RT_RENDER_STATE_TRACING;
     m_nrBlocksRenderProgress = 0;
+    m_refinePass = 0;
+    m_stats_camera_rays = 0;
 
     m_postshader_ssao.InitFrame();
 
@@ -142,6 +148,15 @@ void C3D_RENDER_RAYTRACING::restart_render_state()
     std::fill( m_blockPositionsWasProcessed.begin(),
                m_blockPositionsWasProcessed.end(),
                0 );
+
+    m_blockSamples.assign( m_blockPositions.size(), 0 );
+    m_blockConverged.assign( m_blockPositions.size(), 0 );
+}
+
+
+size_t C3D_RENDER_RAYTRACING::GetNotConvergedBlocksCount() const
+{
+    return std::count( m_blockConverged.begin(), m_blockConverged.end(), 0 );
 }
 
 
@@ -170,6 +185,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -196,6 +212,7 @@ bool C3D_RENDER_RAYTRACING::Redraw(
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -339,6 +356,10 @@ void C3D_RENDER_RAYTRACING::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
         rt_render_tracing( ptrPBO, aStatusReporter );
         break;
 
+    case RT_RENDER_STATE_REFINE:
+        rt_render_refine( ptrPBO, aStatusReporter );
+        break;
+
     case RT_RENDER_STATE_POST_PROCESS_SHADE:
         rt_render_post_process_shade( ptrPBO, aStatusReporter );
         break;
@@ -365,6 +386,58 @@ void C3D_RENDER_RAYTRACING::render( GLubyte* ptrPBO, REPORTER* aStatusReporter )
 }
 
 
+bool C3D_RENDER_RAYTRACING::RenderOffscreen( const wxSize& aSize, wxImage& aImage,
+                                             REPORTER* aStatusReporter,
+                                             REPORTER* aWarningReporter )
+{
+    m_camera.SetCurWindowSize( aSize );
+
+    // Only the tracer buffers are sized here, there is no PBO to create
+    if( m_windowSize != aSize || m_blockPositions.empty() )
+    {
+        m_windowSize = aSize;
+        m_oldWindowsSize = m_windowSize;
+        initialize_block_positions();
+    }
+
+    if( m_reloadRequested )
+        Reload( aStatusReporter, aWarningReporter, false );
+
+    if( !m_accelerator || m_blockPositions.empty() )
+        return false;
+
+    // The CPU framebuffer has the same RGBA layout as the PBO
+    std::vector<GLubyte> frameBuffer( m_realBufferSize.x * m_realBufferSize.y * 4 );
+
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( frameBuffer.data(), aStatusReporter );
+    } while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    // The framebuffer starts with the bottom row (as OpenGL does), the image with the top row
+    aImage.Create( m_realBufferSize.x, m_realBufferSize.y, false );
+
+    unsigned char* dst = aImage.GetData();
+
+    for( unsigned int y = 0; y < m_realBufferSize.y; ++y )
+    {
+        const GLubyte* src = &frameBuffer[( m_realBufferSize.y - 1 - y ) * m_realBufferSize.x * 4];
+
+        for( unsigned int x = 0; x < m_realBufferSize.x; ++x )
+        {
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+            src += 4;
+        }
+    }
+
+    return true;
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
                                                REPORTER* aStatusReporter )
 {
@@ -418,14 +491,113 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte* ptrPBO ,
                                                        (float)(m_nrBlocksRenderProgress * 100) /
                                                        (float)m_blockPositions.size() ) );
 
-    // Check if it finish the rendering and if should continue to a post processing
-    // or mark it as finished
+    // Check if it finish the rendering and if should continue to a refinement,
+    // a post processing or mark it as finished
     if( m_nrBlocksRenderProgress >= m_blockPositions.size() )
+        rt_render_tracing_done();
+}
+
+
+void C3D_RENDER_RAYTRACING::rt_render_tracing_done()
+{
+    const int maxPasses = m_boardAdapter.m_raytrace_progressive_passes;
+    const int timeBudget = m_boardAdapter.m_raytrace_progressive_time_budget;
+
+    const bool budgetExceeded = ( timeBudget > 0 ) &&
+                                ( GetRunningMicroSecs() - m_stats_start_rendering_time ) / 1000
+                                        >= (unsigned long int) timeBudget;
+
+    if( ( (int) m_refinePass < maxPasses ) && !budgetExceeded
+      && ( GetNotConvergedBlocksCount() > 0 ) )
     {
-        if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
-            m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_SHADE;
-        else
-            m_rt_render_state = RT_RENDER_STATE_FINISH;
+        // Start a new refinement pass on the blocks that did not converge
+        m_rt_render_state = RT_RENDER_STATE_REFINE;
+        m_nrBlocksRenderProgress = 0;
+
+        std::fill( m_blockPositionsWasProcessed.begin(),
+                   m_blockPositionsWasProcessed.end(),
+                   0 );
+    }
+    else if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
+    {
+        m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_SHADE;
+    }
+    else
+    {
+        m_rt_render_state = RT_RENDER_STATE_FINISH;
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::rt_render_refine( GLubyte* ptrPBO, REPORTER* aStatusReporter )
+{
+    const int timeBudget = m_boardAdapter.m_raytrace_progressive_time_budget;
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::atomic<bool> breakLoop( false );
+    std::atomic<bool> budgetExceeded( false );
+
+    std::atomic<size_t> numBlocksRendered( 0 );
+    std::atomic<size_t> currentBlock( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            m_blockPositions.size() );
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread( [&]()
+        {
+            for( size_t iBlock = currentBlock.fetch_add( 1 );
+                        iBlock < m_blockPositions.size() && !breakLoop;
+                        iBlock = currentBlock.fetch_add( 1 ) )
+            {
+                if( !m_blockPositionsWasProcessed[iBlock] )
+                {
+                    // Only the blocks that did not converge yet get more samples
+                    if( !m_blockConverged[iBlock] )
+                        rt_render_refine_block( ptrPBO, iBlock );
+
+                    numBlocksRendered++;
+                    m_blockPositionsWasProcessed[iBlock] = 1;
+
+                    if( ( timeBudget > 0 )
+                      && ( GetRunningMicroSecs() - m_stats_start_rendering_time ) / 1000
+                                 >= (unsigned long int) timeBudget )
+                    {
+                        budgetExceeded = true;
+                        breakLoop = true;
+                    }
+
+                    // Check if it spend already some time render and request to exit
+                    // to display the progress
+                    if( std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - startTime ).count() > 150 )
+                        breakLoop = true;
+                }
+            }
+
+            threadsFinished++;
+        } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+    m_nrBlocksRenderProgress += numBlocksRendered;
+
+    if( aStatusReporter )
+        aStatusReporter->Report( wxString::Format( _( "Refining (pass %u): %.0f %%" ),
+                                                   m_refinePass + 1,
+                                                   (float)(m_nrBlocksRenderProgress * 100) /
+                                                   (float)m_blockPositions.size() ) );
+
+    if( budgetExceeded || ( m_nrBlocksRenderProgress >= m_blockPositions.size() ) )
+    {
+        m_refinePass++;
+        rt_render_tracing_done();
     }
 }
 
@@ -669,6 +841,8 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
     RAYPACKET blockPacket( m_camera, (SFVEC2F)blockPosI + SFVEC2F(DISP_FACTOR, DISP_FACTOR),
                            SFVEC2F(DISP_FACTOR, DISP_FACTOR) /* Displacement random factor */ );
 
+    m_stats_camera_rays += RAYPACKET_RAYS_PER_PACKET;
+
 
     HITINFO_PACKET hitPacket_X0Y0[RAYPACKET_RAYS_PER_PACKET];
 
@@ -678,18 +852,15 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
     // /////////////////////////////////////////////////////////////////////////
     SFVEC3F bgColor[RAYPACKET_DIM];// Store a vertical gradient color
 
-    for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
-    {
-        const float posYfactor = (float)(blockPosI.y + y) / (float)m_windowSize.y;
-
-        bgColor[y] = m_BgColorTop_LinearRGB * SFVEC3F(posYfactor) +
-                     m_BgColorBot_LinearRGB * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
-    }
+    rt_block_background( blockPosI, bgColor );
 
     // Intersect ray packets (calculate the intersection with rays and objects)
     // /////////////////////////////////////////////////////////////////////////
     if( !m_accelerator->Intersect( blockPacket, hitPacket_X0Y0 ) )
     {
+        // The background has no noise, no need to refine it
+        m_blockConverged[iBlock] = 1;
+
 
         // If block is empty then set shades and continue
         if( m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING ) )
@@ -754,6 +925,9 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
     {
         SFVEC3F hitColor_AA_X1Y1[RAYPACKET_RAYS_PER_PACKET];
 
+        // One packet at (0.5, 0.5) and 3 sets of displaced rays
+        m_stats_camera_rays += 4 * RAYPACKET_RAYS_PER_PACKET;
+
 
         // Intersect one blockPosI + (0.5, 0.5) used for anti aliasing calculation
         // /////////////////////////////////////////////////////////////////////////
@@ -834,16 +1008,26 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                             blockRayPck_AA_X1Y1_half,
                             hitColor_AA_X0Y1_half );
 
-        // Average the result
-        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
-        {
-            hitColor_X0Y0[i] = ( hitColor_X0Y0[i] +
-                                 hitColor_AA_X1Y1[i] +
-                                 hitColor_AA_X1Y0[i] +
-                                 hitColor_AA_X0Y1[i] +
-                                 hitColor_AA_X0Y1_half[i]
-                                 ) * SFVEC3F(1.0f / 5.0f);
-        }
+        // Average the result, and estimate the noise of the block from the AA samples
+        SFVEC3F samples[5 * RAYPACKET_RAYS_PER_PACKET];
+
+        std::copy( hitColor_X0Y0, hitColor_X0Y0 + RAYPACKET_RAYS_PER_PACKET,
+                   samples + 0 * RAYPACKET_RAYS_PER_PACKET );
+        std::copy( hitColor_AA_X1Y1, hitColor_AA_X1Y1 + RAYPACKET_RAYS_PER_PACKET,
+                   samples + 1 * RAYPACKET_RAYS_PER_PACKET );
+        std::copy( hitColor_AA_X1Y0, hitColor_AA_X1Y0 + RAYPACKET_RAYS_PER_PACKET,
+                   samples + 2 * RAYPACKET_RAYS_PER_PACKET );
+        std::copy( hitColor_AA_X0Y1, hitColor_AA_X0Y1 + RAYPACKET_RAYS_PER_PACKET,
+                   samples + 3 * RAYPACKET_RAYS_PER_PACKET );
+        std::copy( hitColor_AA_X0Y1_half, hitColor_AA_X0Y1_half + RAYPACKET_RAYS_PER_PACKET,
+                   samples + 4 * RAYPACKET_RAYS_PER_PACKET );
+
+        rt_accumulate_block( iBlock, samples, 5, hitColor_X0Y0 );
+    }
+    else
+    {
+        // A single sample: the noise is unknown until the block is refined
+        rt_accumulate_block( iBlock, hitColor_X0Y0, 1, hitColor_X0Y0 );
     }
 
 
@@ -910,6 +1094,179 @@ void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
 }
 
 
+void C3D_RENDER_RAYTRACING::rt_block_background( const SFVEC2I &aBlockPosI,
+                                                 SFVEC3F *aBgColorY ) const
+{
+    for( unsigned int y = 0; y < RAYPACKET_DIM; ++y )
+    {
+        const float posYfactor = (float)(aBlockPosI.y + y) / (float)m_windowSize.y;
+
+        aBgColorY[y] = m_BgColorTop_LinearRGB * SFVEC3F(posYfactor) +
+                       m_BgColorBot_LinearRGB * ( SFVEC3F(1.0f) - SFVEC3F(posYfactor) );
+    }
+}
+
+
+void C3D_RENDER_RAYTRACING::rt_accumulate_block( signed int iBlock,
+                                                 const SFVEC3F *aSamples,
+                                                 unsigned int aSamplesCount,
+                                                 SFVEC3F *aOutColor )
+{
+    const SFVEC2UI &blockPos = m_blockPositions[iBlock];
+    const SFVEC3F lumWeights( 0.2126f, 0.7152f, 0.0722f );
+    const float invSqrt2 = 0.70710678f;
+
+    const unsigned int n = m_blockSamples[iBlock] + aSamplesCount;
+    const float invN = 1.0f / (float) n;
+
+    float blockNoise = 0.0f;
+
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        const unsigned int yConst = blockPos.x + ( (y + blockPos.y) * m_realBufferSize.x );
+
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+        {
+            const unsigned int idx = yConst + x;
+
+            SFVEC3F colorSum( 0.0f );
+            float   lumSqSum = 0.0f;
+
+            for( unsigned int s = 0; s < aSamplesCount; ++s )
+            {
+                const SFVEC3F &sample = aSamples[s * RAYPACKET_RAYS_PER_PACKET + i];
+                const float lum = glm::dot( sample, lumWeights );
+
+                colorSum += sample;
+                lumSqSum += lum * lum;
+            }
+
+            // The first samples of the block reset the accumulation of the previous render
+            if( m_blockSamples[iBlock] == 0 )
+            {
+                m_accumColor[idx] = colorSum;
+                m_accumLumSq[idx] = lumSqSum;
+            }
+            else
+            {
+                m_accumColor[idx] += colorSum;
+                m_accumLumSq[idx] += lumSqSum;
+            }
+
+            aOutColor[i] = m_accumColor[idx] * invN;
+
+            if( n > 1 )
+            {
+                // Standard error of the mean luminance of the pixel
+                const float meanLum = glm::dot( m_accumColor[idx], lumWeights ) * invN;
+                const float variance = ( m_accumLumSq[idx] * invN - meanLum * meanLum ) *
+                                       ( (float) n / (float)( n - 1 ) );
+
+                if( variance > 0.0f )
+                    blockNoise = glm::max( blockNoise, sqrtf( variance * invN ) );
+            }
+            else
+            {
+                // With a single sample per pixel (no anti-aliasing), estimate the noise from
+                // the luminance difference with the previous pixels of the block: a difference
+                // of two samples has sqrt(2) times the standard deviation of one sample.
+                const float lum = glm::dot( aOutColor[i], lumWeights );
+
+                if( x > 0 )
+                {
+                    const float delta = lum - glm::dot( aOutColor[i - 1], lumWeights );
+                    blockNoise = glm::max( blockNoise, fabsf( delta ) * invSqrt2 );
+                }
+
+                if( y > 0 )
+                {
+                    const float delta = lum - glm::dot( aOutColor[i - RAYPACKET_DIM],
+                                                        lumWeights );
+                    blockNoise = glm::max( blockNoise, fabsf( delta ) * invSqrt2 );
+                }
+            }
+        }
+    }
+
+    m_blockSamples[iBlock] = n;
+    m_blockConverged[iBlock] = blockNoise <= m_boardAdapter.m_raytrace_progressive_noise;
+}
+
+
+// Number of camera rays per pixel traced on each refinement pass of a block
+#define REFINE_SAMPLES_PER_PASS 4
+
+void C3D_RENDER_RAYTRACING::rt_render_refine_block( GLubyte *ptrPBO ,
+                                                    signed int iBlock )
+{
+    const SFVEC2UI &blockPos = m_blockPositions[iBlock];
+    const SFVEC2I blockPosI = SFVEC2I( blockPos.x + m_xoffset,
+                                       blockPos.y + m_yoffset );
+
+    const bool is_testShadow = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_SHADOWS );
+
+    SFVEC3F bgColor[RAYPACKET_DIM];
+
+    rt_block_background( blockPosI, bgColor );
+
+    // Trace new samples, randomly distributed on the pixels area
+    // /////////////////////////////////////////////////////////////////////////
+    SFVEC3F samples[REFINE_SAMPLES_PER_PASS * RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int s = 0; s < REFINE_SAMPLES_PER_PASS; ++s )
+    {
+        SFVEC3F *sampleColor = &samples[s * RAYPACKET_RAYS_PER_PACKET];
+
+        RAYPACKET blockPacket( m_camera, (SFVEC2F)blockPosI + SFVEC2F( 0.5f, 0.5f ),
+                               SFVEC2F( 0.5f, 0.5f ) /* Displacement random factor */ );
+
+        HITINFO_PACKET hitPacket[RAYPACKET_RAYS_PER_PACKET];
+
+        HITINFO_PACKET_init( hitPacket );
+
+        if( m_accelerator->Intersect( blockPacket, hitPacket ) )
+        {
+            rt_shades_packet( bgColor, blockPacket.m_ray, hitPacket, is_testShadow, sampleColor );
+        }
+        else
+        {
+            for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+                for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+                    sampleColor[i] = bgColor[y];
+        }
+    }
+
+    m_stats_camera_rays += REFINE_SAMPLES_PER_PASS * RAYPACKET_RAYS_PER_PACKET;
+
+    SFVEC3F outColor[RAYPACKET_RAYS_PER_PACKET];
+
+    rt_accumulate_block( iBlock, samples, REFINE_SAMPLES_PER_PASS, outColor );
+
+    // Update the color of the next stage
+    // /////////////////////////////////////////////////////////////////////////
+    const bool isPostProcessing = m_boardAdapter.GetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING );
+
+    GLubyte *ptr = &ptrPBO[ ( blockPos.x +
+                              (blockPos.y * m_realBufferSize.x) ) * 4 ];
+
+    const uint32_t ptrInc = (m_realBufferSize.x - RAYPACKET_DIM) * 4;
+
+    for( unsigned int y = 0, i = 0; y < RAYPACKET_DIM; ++y )
+    {
+        for( unsigned int x = 0; x < RAYPACKET_DIM; ++x, ++i )
+        {
+            if( isPostProcessing )
+                m_postshader_ssao.SetPixelColor( blockPos.x + x, blockPos.y + y, outColor[i] );
+
+            rt_final_color( ptr, outColor[i], !isPostProcessing );
+            ptr += 4;
+        }
+
+        ptr += ptrInc;
+    }
+}
+
+
 void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte* ptrPBO,
                                                           REPORTER* aStatusReporter )
 {
@@ -2081,7 +2438,9 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
 
-    opengl_init_pbo();
+    // Create the progressive rendering buffers
+    m_accumColor.resize( m_realBufferSize.x * m_realBufferSize.y );
+    m_accumLumSq.resize( m_realBufferSize.x * m_realBufferSize.y );
 }
 
 BOARD_ITEM *C3D_RENDER_RAYTRACING::IntersectBoardItem( const RAY &aRay )
@@ -39,8 +39,11 @@
 #include "cmaterial.h"
 #include <plugins/3dapi/c3dmodel.h>
 
+#include <atomic>
 #include <map>
 
+class wxImage;
+
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
 
@@ -50,6 +53,7 @@ typedef std::map< const S3DMODEL * , MODEL_MATERIALS > MAP_MODEL_MATERIALS;
 typedef enum
 {
     RT_RENDER_STATE_TRACING = 0,
+    RT_RENDER_STATE_REFINE,
     RT_RENDER_STATE_POST_PROCESS_SHADE,
     RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH,
     RT_RENDER_STATE_FINISH,
@@ -73,6 +77,41 @@ public:
 
     BOARD_ITEM *IntersectBoardItem( const RAY &aRay );
 
+    /**
+     * @brief RenderOffscreen - Render the board with the current camera into a CPU
+     * framebuffer, without any OpenGL context. The full render (tracing and post
+     * processing) is done before returning.
+     * @param aSize: the size of the image to render. The traced area is a multiple of
+     * the ray packet size, so the resulting image can be a bit smaller.
+     * @param aImage: the rendered image
+     * @param aStatusReporter: the pointer for the status reporter
+     * @param aWarningReporter: pointer for the warning reporter
+     * @return true if an image was rendered
+     */
+    bool RenderOffscreen( const wxSize& aSize, wxImage& aImage, REPORTER* aStatusReporter,
+                          REPORTER* aWarningReporter );
+
+    /**
+     * @return the time to build the BVH accelerator on the last reload, in microseconds
+     */
+    unsigned int GetBVHBuildTime() const { return m_stats_bvh_build_time; }
+
+    /**
+     * @return the number of camera rays (primary and anti aliasing rays) traced by the
+     * last render
+     */
+    size_t GetCameraRaysCount() const { return m_stats_camera_rays; }
+
+    /**
+     * @return the number of refinement passes done by the last render
+     */
+    unsigned int GetRefinePassesCount() const { return m_refinePass; }
+
+    /**
+     * @return the number of blocks that did not reach the noise threshold in the last render
+     */
+    size_t GetNotConvergedBlocksCount() const;
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -88,7 +127,21 @@ private:
     void rt_render_tracing( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void rt_render_post_process_shade( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void rt_render_post_process_blur_finish( GLubyte* ptrPBO, REPORTER* aStatusReporter );
+    void rt_render_refine( GLubyte* ptrPBO, REPORTER* aStatusReporter );
     void rt_render_trace_block( GLubyte *ptrPBO , signed int iBlock );
+    void rt_render_refine_block( GLubyte *ptrPBO , signed int iBlock );
+    void rt_render_tracing_done();
+    void rt_block_background( const SFVEC2I &aBlockPosI, SFVEC3F *aBgColorY ) const;
+
+    /**
+     * Add samples of a block to the accumulation buffers, and update the block noise
+     * estimation.
+     * @param aSamples: aSamplesCount arrays of RAYPACKET_RAYS_PER_PACKET colors
+     * @param aOutColor: receives the average color of each pixel of the block
+     */
+    void rt_accumulate_block( signed int iBlock, const SFVEC3F *aSamples,
+                              unsigned int aSamplesCount, SFVEC3F *aOutColor );
+
     void rt_final_color( GLubyte *ptrPBO, const SFVEC3F &rgbColor, bool applyColorSpaceConversion );
 
     void rt_shades_packet( const SFVEC3F *bgColorY,
@@ -143,6 +196,20 @@ private:
     /// Save the number of blocks progress of the render
     size_t m_nrBlocksRenderProgress;
 
+    /// Number of the current refinement pass
+    unsigned int m_refinePass;
+
+    /// Progressive rendering: sum of the colors and of the squared luminance of the samples
+    /// of each pixel
+    std::vector< SFVEC3F > m_accumColor;
+    std::vector< float > m_accumLumSq;
+
+    /// Progressive rendering: number of samples per pixel of each block
+    std::vector< unsigned int > m_blockSamples;
+
+    /// Progressive rendering: 1 if the block noise is under the threshold
+    std::vector< int > m_blockConverged;
+
     CPOSTSHADER_SSAO m_postshader_ssao;
 
     CLIGHTCONTAINER m_lights;
@@ -195,6 +262,8 @@ private:
     // Statistics
     unsigned int m_stats_converted_dummy_to_plane;
     unsigned int m_stats_converted_roundsegment2d_to_roundsegment;
+    unsigned int m_stats_bvh_build_time;
+    std::atomic<size_t> m_stats_camera_rays;
 
     void create_3d_object_from( CCONTAINER &aDstContainer,
                                 const COBJECT2D *aObject2D,
@@ -205,7 +274,8 @@ private:
     void add_3D_vias_and_pads_to_container();
     void insert3DViaHole( const VIA* aVia );
     void insert3DPadHole( const D_PAD* aPad );
-    void load_3D_models( CCONTAINER &aDstContainer, bool aSkipMaterialInformation );
+    void load_3D_models( CCONTAINER &aDstContainer, bool aSkipMaterialInformation,
+                         REPORTER* aStatusReporter );
     void add_3D_models( CCONTAINER &aDstContainer,
                         const S3DMODEL *a3DModel,
                         const glm::mat4 &aModelMatrix,
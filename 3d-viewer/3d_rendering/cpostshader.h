@@ -61,6 +61,11 @@ public:
                        float aDepth,
                        float aShadowAttFactor );
 
+    /**
+     * @brief SetPixelColor - update the color of a pixel already set by SetPixelData
+     */
+    void SetPixelColor( unsigned int x, unsigned int y, const SFVEC3F &aColor );
+
     const SFVEC3F &GetColorAtNotProtected( const SFVEC2I &aPos ) const;
 
     void DebugBuffersOutputAsImages() const;
@@ -111,6 +111,13 @@ EDA_3D_VIEWER_SETTINGS::EDA_3D_VIEWER_SETTINGS()
     m_params.emplace_back( new PARAM<float>( "render.raytrace_spread_refractions",
             &m_Render.raytrace_spread_refractions, 0.025f ) );
 
+    m_params.emplace_back( new PARAM<int>( "render.raytrace_progressive_passes",
+            &m_Render.raytrace_progressive_passes, 0 ) );
+    m_params.emplace_back( new PARAM<float>( "render.raytrace_progressive_noise",
+            &m_Render.raytrace_progressive_noise, 0.01f ) );
+    m_params.emplace_back( new PARAM<int>( "render.raytrace_progressive_time_budget",
+            &m_Render.raytrace_progressive_time_budget, 0 ) );
+
     m_params.emplace_back( new PARAM<COLOR4D>( "render.raytrace_lightColorCamera",
                                                &m_Render.raytrace_lightColorCamera,
                                                COLOR4D( 0.2, 0.2, 0.2, 1.0 ) ) );
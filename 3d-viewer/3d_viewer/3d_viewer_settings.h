@@ -62,6 +62,10 @@ public:
         int raytrace_recursivelevel_reflections;
         int raytrace_recursivelevel_refractions;
 
+        int raytrace_progressive_passes;
+        float raytrace_progressive_noise;
+        int raytrace_progressive_time_budget;       // ms, 0 = no limit
+
         KIGFX::COLOR4D raytrace_lightColorCamera;
         KIGFX::COLOR4D raytrace_lightColorTop;
         KIGFX::COLOR4D raytrace_lightColorBottom;
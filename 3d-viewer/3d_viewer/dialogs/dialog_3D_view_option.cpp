@@ -231,6 +231,10 @@ bool DIALOG_3D_VIEW_OPTIONS::TransferDataToWindow()
     m_spinCtrlRecursiveLevel_Reflections->SetValue( m_settings.m_raytrace_recursivelevel_reflections );
     m_spinCtrlRecursiveLevel_Refractions->SetValue( m_settings.m_raytrace_recursivelevel_refractions );
 
+    m_spinCtrlProgressivePasses->SetValue( m_settings.m_raytrace_progressive_passes );
+    m_spinCtrlDoubleProgressiveNoise->SetValue( m_settings.m_raytrace_progressive_noise );
+    m_spinCtrlProgressiveTimeBudget->SetValue( m_settings.m_raytrace_progressive_time_budget );
+
     TransferColorDataToWindow();
 
     // Camera Options
@@ -300,6 +304,10 @@ bool DIALOG_3D_VIEW_OPTIONS::TransferDataFromWindow()
     m_settings.m_raytrace_recursivelevel_reflections = m_spinCtrlRecursiveLevel_Reflections->GetValue();
     m_settings.m_raytrace_recursivelevel_refractions = m_spinCtrlRecursiveLevel_Refractions->GetValue();
 
+    m_settings.m_raytrace_progressive_passes = m_spinCtrlProgressivePasses->GetValue();
+    m_settings.m_raytrace_progressive_noise = static_cast<float>( m_spinCtrlDoubleProgressiveNoise->GetValue() );
+    m_settings.m_raytrace_progressive_time_budget = m_spinCtrlProgressiveTimeBudget->GetValue();
+
     auto Transfer_color = [] ( SFVEC3F& aTarget, wxColourPickerCtrl *aSource )
     {
         const wxColour color = aSource->GetColour();
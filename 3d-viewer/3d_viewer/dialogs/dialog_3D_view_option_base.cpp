@@ -558,6 +558,48 @@ DIALOG_3D_VIEW_OPTIONS_BASE::DIALOG_3D_VIEW_OPTIONS_BASE( wxWindow* parent, wxWi
 
 	bSizer12->Add( sbSizerRaytracingRenderOptions, 0, wxALL|wxEXPAND, 5 );
 
+	wxStaticBoxSizer* sbSizerRaytracingRefinement;
+	sbSizerRaytracingRefinement = new wxStaticBoxSizer( new wxStaticBox( m_panel4, wxID_ANY, _("Progressive Refinement") ), wxVERTICAL );
+
+	wxFlexGridSizer* fgSizerRaytracingRefinement;
+	fgSizerRaytracingRefinement = new wxFlexGridSizer( 0, 2, 0, 0 );
+	fgSizerRaytracingRefinement->SetFlexibleDirection( wxBOTH );
+	fgSizerRaytracingRefinement->SetNonFlexibleGrowMode( wxFLEX_GROWMODE_SPECIFIED );
+
+	m_staticTextProgressivePasses = new wxStaticText( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, _("Refinement passes:"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticTextProgressivePasses->Wrap( -1 );
+	fgSizerRaytracingRefinement->Add( m_staticTextProgressivePasses, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_spinCtrlProgressivePasses = new wxSpinCtrl( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 124,-1 ), wxSP_ARROW_KEYS, 0, 16, 0 );
+	m_spinCtrlProgressivePasses->SetToolTip( _("Max number of passes refining the noisy areas of the image, 0 to disable the refinement") );
+
+	fgSizerRaytracingRefinement->Add( m_spinCtrlProgressivePasses, 0, wxALL, 5 );
+
+	m_staticTextProgressiveNoise = new wxStaticText( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, _("Noise threshold:"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticTextProgressiveNoise->Wrap( -1 );
+	fgSizerRaytracingRefinement->Add( m_staticTextProgressiveNoise, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_spinCtrlDoubleProgressiveNoise = new wxSpinCtrlDouble( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 124,-1 ), wxSP_ARROW_KEYS, 0.001, 1, 0.01, 0.001 );
+	m_spinCtrlDoubleProgressiveNoise->SetDigits( 3 );
+	m_spinCtrlDoubleProgressiveNoise->SetToolTip( _("Noise level under which an area of the image is not refined") );
+
+	fgSizerRaytracingRefinement->Add( m_spinCtrlDoubleProgressiveNoise, 0, wxALL, 5 );
+
+	m_staticTextProgressiveTimeBudget = new wxStaticText( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, _("Time budget (ms):"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticTextProgressiveTimeBudget->Wrap( -1 );
+	fgSizerRaytracingRefinement->Add( m_staticTextProgressiveTimeBudget, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_spinCtrlProgressiveTimeBudget = new wxSpinCtrl( sbSizerRaytracingRefinement->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 124,-1 ), wxSP_ARROW_KEYS, 0, 600000, 0 );
+	m_spinCtrlProgressiveTimeBudget->SetToolTip( _("Max rendering time of the refinement passes, 0 for no limit") );
+
+	fgSizerRaytracingRefinement->Add( m_spinCtrlProgressiveTimeBudget, 0, wxALL, 5 );
+
+
+	sbSizerRaytracingRefinement->Add( fgSizerRaytracingRefinement, 0, wxALL, 5 );
+
+
+	bSizer12->Add( sbSizerRaytracingRefinement, 0, wxALL|wxEXPAND, 5 );
+
 
 	bSizerRaytracing->Add( bSizer12, 1, wxALL|wxEXPAND, 5 );
 
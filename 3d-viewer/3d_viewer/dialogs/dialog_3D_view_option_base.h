@@ -119,6 +119,12 @@ class DIALOG_3D_VIEW_OPTIONS_BASE : public DIALOG_SHIM
 		wxSpinCtrl* m_spinCtrl_NrSamples_Refractions;
 		wxSpinCtrlDouble* m_spinCtrlDouble_SpreadFactor_Refractions;
 		wxSpinCtrl* m_spinCtrlRecursiveLevel_Refractions;
+		wxStaticText* m_staticTextProgressivePasses;
+		wxSpinCtrl* m_spinCtrlProgressivePasses;
+		wxStaticText* m_staticTextProgressiveNoise;
+		wxSpinCtrlDouble* m_spinCtrlDoubleProgressiveNoise;
+		wxStaticText* m_staticTextProgressiveTimeBudget;
+		wxSpinCtrl* m_spinCtrlProgressiveTimeBudget;
 		wxPanel* m_panel5;
 		wxStaticText* m_staticText17;
 		wxColourPickerCtrl* m_colourPickerCameraLight;
@@ -143,6 +143,12 @@ static const wxChar DebugPDFWriter[] = wxT( "DebugPDFWriter" );
 
 static const wxChar SkipBoundingBoxFpLoad[] = wxT( "SkipBoundingBoxFpLoad" );
 
+/**
+ * When true, the libraries of the library tables are loaded in the background, and reloaded
+ * when their files are modified.
+ */
+static const wxChar PreloadLibraries[] = wxT( "PreloadLibraries" );
+
 } // namespace KEYS
 
 
@@ -243,6 +249,8 @@ ADVANCED_CFG::ADVANCED_CFG()
 
     m_SkipBoundingBoxOnFpLoad   = false;
 
+    m_PreloadLibraries          = true;
+
     loadFromConfigFile();
 }
 
@@ -326,6 +334,9 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::SkipBoundingBoxFpLoad,
                                                 &m_SkipBoundingBoxOnFpLoad, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::PreloadLibraries,
+                                                &m_PreloadLibraries, true ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     for( PARAM_CFG* param : configParams )
@@ -28,6 +28,7 @@
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/msgdlg.h>
+#include <wx/thread.h>
 #include <pgm_base.h>
 #include <trace_helpers.h>
 
@@ -46,6 +47,7 @@
 #define MASK_3D_RESOLVER "3D_RESOLVER"
 
 static std::mutex mutex_resolver;
+static std::mutex mutex_messages;    // protects the pending messages
 
 static bool getHollerith( const std::string& aString, size_t& aIndex, wxString& aResult );
 
@@ -453,7 +455,7 @@ bool FILENAME_RESOLVER::addPath( const SEARCH_PATH& aPath )
             wxString msg = _( "The given path does not exist" );
             msg.append( wxT( "\n" ) );
             msg.append( tpath.m_pathvar );
-            wxMessageBox( msg, _( "3D model search path" ) );
+            showMessage( msg, _( "3D model search path" ) );
         }
 
         tpath.m_pathexp.clear();
@@ -487,7 +489,7 @@ bool FILENAME_RESOLVER::addPath( const SEARCH_PATH& aPath )
             msg.append( wxT( "\n" ) );
             msg.append( _( "Existing path:" ) + wxS( " " ));
             msg.append( sPL->m_pathvar );
-            wxMessageBox( msg, _( "Bad alias (duplicate name)" ) );
+            showMessage( msg, _( "Bad alias (duplicate name)" ) );
 
             return false;
         }
@@ -500,6 +502,36 @@ bool FILENAME_RESOLVER::addPath( const SEARCH_PATH& aPath )
 }
 
 
+void FILENAME_RESOLVER::showMessage( const wxString& aMessage, const wxString& aCaption )
+{
+    if( wxIsMainThread() )
+    {
+        wxMessageBox( aMessage, aCaption );
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock( mutex_messages );
+    m_pendingMessages.emplace_back( aMessage, aCaption );
+}
+
+
+void FILENAME_RESOLVER::ShowPendingMessages()
+{
+    if( !wxIsMainThread() )
+        return;
+
+    std::vector<std::pair<wxString, wxString>> messages;
+
+    {
+        std::lock_guard<std::mutex> lock( mutex_messages );
+        messages.swap( m_pendingMessages );
+    }
+
+    for( const std::pair<wxString, wxString>& message : messages )
+        wxMessageBox( message.first, message.second );
+}
+
+
 bool FILENAME_RESOLVER::readPathList()
 {
     if( m_ConfigDir.empty() )
@@ -62,6 +62,30 @@ void FP_LIB_TABLE_ROW::SetType( const wxString& aType )
 }
 
 
+void FP_LIB_TABLE_ROW::Preload( bool aFirstLoad )
+{
+    if( !plugin )
+        setPlugin( IO_MGR::PluginFind( type ) );
+    else if( aFirstLoad )
+        return;
+
+    wxArrayString footprintNames;
+
+    // Enumerating the footprints loads the library cache of the plugin
+    plugin->PrefetchLib( GetFullURI( true ), GetProperties() );
+    plugin->FootprintEnumerate( footprintNames, GetFullURI( true ), false, GetProperties() );
+}
+
+
+long long FP_LIB_TABLE_ROW::GetLibraryTimestamp() const
+{
+    if( !plugin )
+        return LIB_TABLE_ROW::GetLibraryTimestamp();
+
+    return plugin->GetLibraryTimestamp( GetFullURI( true ) );
+}
+
+
 FP_LIB_TABLE::FP_LIB_TABLE( FP_LIB_TABLE* aFallBackTable ) :
     LIB_TABLE( aFallBackTable )
 {
@@ -248,6 +272,7 @@ long long FP_LIB_TABLE::GenerateTimestamp( const wxString* aNickname )
     {
         const FP_LIB_TABLE_ROW* row = FindRow( *aNickname );
         wxASSERT( (PLUGIN*) row->plugin );
+        std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
         return row->plugin->GetLibraryTimestamp( row->GetFullURI( true ) ) + wxHashTable::MakeKey( *aNickname );
     }
 
@@ -256,6 +281,7 @@ long long FP_LIB_TABLE::GenerateTimestamp( const wxString* aNickname )
     {
         const FP_LIB_TABLE_ROW* row = FindRow( nickname );
         wxASSERT( (PLUGIN*) row->plugin );
+        std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
         hash += row->plugin->GetLibraryTimestamp( row->GetFullURI( true ) ) + wxHashTable::MakeKey( nickname );
     }
 
@@ -268,6 +294,7 @@ void FP_LIB_TABLE::FootprintEnumerate( wxArrayString& aFootprintNames, const wxS
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->FootprintEnumerate( aFootprintNames, row->GetFullURI( true ), aBestEfforts,
                                      row->GetProperties() );
 }
@@ -277,6 +304,7 @@ void FP_LIB_TABLE::PrefetchLib( const wxString& aNickname )
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->PrefetchLib( row->GetFullURI( true ), row->GetProperties() );
 }
 
@@ -297,6 +325,8 @@ const FP_LIB_TABLE_ROW* FP_LIB_TABLE::FindRow( const wxString& aNickname )
         THROW_IO_ERROR( msg );
     }
 
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
+
     // We've been 'lazy' up until now, but it cannot be deferred any longer,
     // instantiate a PLUGIN of the proper kind if it is not already in this
     // FP_LIB_TABLE_ROW.
@@ -336,6 +366,7 @@ const MODULE* FP_LIB_TABLE::GetEnumeratedFootprint( const wxString& aNickname,
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     return row->plugin->GetEnumeratedFootprint( row->GetFullURI( true ), aFootprintName,
                                                 row->GetProperties() );
@@ -348,6 +379,7 @@ bool FP_LIB_TABLE::FootprintExists( const wxString& aNickname, const wxString& a
     {
         const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
         wxASSERT( (PLUGIN*) row->plugin );
+        std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
         return row->plugin->FootprintExists( row->GetFullURI( true ), aFootprintName,
                                              row->GetProperties() );
@@ -363,6 +395,7 @@ MODULE* FP_LIB_TABLE::FootprintLoad( const wxString& aNickname, const wxString&
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     MODULE* ret = row->plugin->FootprintLoad( row->GetFullURI( true ), aFootprintName,
                                               row->GetProperties() );
@@ -378,6 +411,7 @@ FP_LIB_TABLE::SAVE_T FP_LIB_TABLE::FootprintSave( const wxString& aNickname,
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     if( !aOverwrite )
     {
@@ -403,6 +437,7 @@ void FP_LIB_TABLE::FootprintDelete( const wxString& aNickname, const wxString& a
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     return row->plugin->FootprintDelete( row->GetFullURI( true ), aFootprintName,
                                          row->GetProperties() );
 }
@@ -412,6 +447,7 @@ bool FP_LIB_TABLE::IsFootprintLibWritable( const wxString& aNickname )
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     return row->plugin->IsFootprintLibWritable( row->GetFullURI( true ) );
 }
 
@@ -420,6 +456,7 @@ void FP_LIB_TABLE::FootprintLibDelete( const wxString& aNickname )
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->FootprintLibDelete( row->GetFullURI( true ), row->GetProperties() );
 }
 
@@ -428,6 +465,7 @@ void FP_LIB_TABLE::FootprintLibCreate( const wxString& aNickname )
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxASSERT( (PLUGIN*) row->plugin );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->FootprintLibCreate( row->GetFullURI( true ), row->GetProperties() );
 }
 
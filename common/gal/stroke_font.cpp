@@ -32,6 +32,8 @@
 #include <wx/string.h>
 #include <gr_text.h>
 
+#include <mutex>
+
 
 using namespace KIGFX;
 
@@ -45,6 +47,7 @@ const double STROKE_FONT::ITALIC_TILT = 1.0 / 8;
 
 GLYPH_LIST*         g_newStrokeFontGlyphs = nullptr;     ///< Glyph list
 std::vector<BOX2D>* g_newStrokeFontGlyphBoundingBoxes;   ///< Bounding boxes of the glyphs
+std::mutex          g_newStrokeFontMutex;                ///< Guards the loading of the glyphs
 
 
 STROKE_FONT::STROKE_FONT( GAL* aGal ) :
@@ -55,6 +58,9 @@ STROKE_FONT::STROKE_FONT( GAL* aGal ) :
 
 bool STROKE_FONT::LoadNewStrokeFont( const char* const aNewStrokeFont[], int aNewStrokeFontSize )
 {
+    // Each thread has its own basic GAL, which can be the first one to load the font
+    std::lock_guard<std::mutex> lock( g_newStrokeFontMutex );
+
     if( g_newStrokeFontGlyphs )
     {
         m_glyphs = g_newStrokeFontGlyphs;
@@ -33,6 +33,7 @@
 #include <kiface_i.h>
 #include <lib_table_base.h>
 #include <lib_table_lexer.h>
+#include <lib_table_preloader.h>
 #include <macros.h>
 #include <settings/app_settings.h>
 
@@ -125,8 +126,20 @@ void LIB_TABLE_ROW::SetOptions( const wxString& aOptions )
 }
 
 
+long long LIB_TABLE_ROW::GetLibraryTimestamp() const
+{
+    wxString uri = GetFullURI( true );
+
+    if( !wxFileName::FileExists( uri ) && !wxFileName::DirExists( uri ) )
+        return 0;
+
+    return wxFileName( uri ).GetModificationTime().GetValue().GetValue();
+}
+
+
 LIB_TABLE::LIB_TABLE( LIB_TABLE* aFallBackTable ) :
-    fallBack( aFallBackTable )
+    fallBack( aFallBackTable ),
+    m_preloader( nullptr )
 {
     // not copying fall back, simply search aFallBackTable separately
     // if "nickName not found".
@@ -136,6 +149,14 @@ LIB_TABLE::LIB_TABLE( LIB_TABLE* aFallBackTable ) :
 LIB_TABLE::~LIB_TABLE()
 {
     // *fallBack is not owned here.
+    forgetPreload();
+}
+
+
+void LIB_TABLE::forgetPreload()
+{
+    if( m_preloader )
+        m_preloader->Forget( this );
 }
 
 
@@ -322,6 +343,7 @@ bool LIB_TABLE::InsertRow( LIB_TABLE_ROW* aRow, bool doReplace )
 
     if( doReplace )
     {
+        forgetPreload();
         rows.replace( it->second, aRow );
         return true;
     }
@@ -0,0 +1,414 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <lib_table_preloader.h>
+
+#include <ki_exception.h>
+#include <lib_table_base.h>
+#include <locale_io.h>
+#include <trace_helpers.h>
+
+#include <algorithm>
+
+
+wxDEFINE_EVENT( EDA_EVT_LIBRARY_PRELOADED, wxCommandEvent );
+wxDEFINE_EVENT( EDA_EVT_LIBRARY_UPDATED, wxCommandEvent );
+
+
+/// Interval of the checks of the timestamps of the loaded libraries, in ms
+static const int PRELOAD_POLL_INTERVAL = 5000;
+
+
+LIB_TABLE_PRELOADER::LIB_TABLE_PRELOADER() :
+    m_quit( false ),
+    m_pollTimer( this )
+{
+    Bind( wxEVT_TIMER, &LIB_TABLE_PRELOADER::onPollTimer, this );
+}
+
+
+LIB_TABLE_PRELOADER::~LIB_TABLE_PRELOADER()
+{
+    m_pollTimer.Stop();
+    stopWorkers();
+
+    // The tables which are still registered must not call Forget() on a deleted preloader
+    for( std::pair<LIB_TABLE* const, std::vector<LIBRARY>>& table : m_tables )
+        table.first->m_preloader = nullptr;
+}
+
+
+void LIB_TABLE_PRELOADER::Preload( LIB_TABLE* aTable )
+{
+    std::vector<size_t> newLibraries;
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        std::vector<LIBRARY>&       libraries = m_tables[aTable];
+
+        aTable->m_preloader = this;
+
+        for( LIB_TABLE_ROW& row : aTable->rows )
+        {
+            if( !row.GetIsEnabled() )
+                continue;
+
+            auto it = std::find_if( libraries.begin(), libraries.end(),
+                                    [&row]( const LIBRARY& aLibrary )
+                                    {
+                                        return aLibrary.m_row == &row;
+                                    } );
+
+            if( it != libraries.end() )
+                continue;
+
+            libraries.push_back( { &row, row.GetNickName(), 0, false } );
+            newLibraries.push_back( libraries.size() - 1 );
+        }
+    }
+
+    for( size_t library : newLibraries )
+        queueLoad( aTable, library );
+
+    if( !m_pollTimer.IsRunning() )
+        m_pollTimer.Start( PRELOAD_POLL_INTERVAL );
+}
+
+
+void LIB_TABLE_PRELOADER::Forget( LIB_TABLE* aTable )
+{
+    std::unique_lock<std::mutex> lock( m_lock );
+
+    m_jobs.erase( std::remove_if( m_jobs.begin(), m_jobs.end(),
+                                  [aTable]( const JOB& aJob )
+                                  {
+                                      return aJob.m_table == aTable;
+                                  } ),
+                  m_jobs.end() );
+
+    // The rows of the table are deleted after this call: wait for the running jobs
+    m_jobDone.wait( lock,
+                    [&]()
+                    {
+                        return m_running.find( aTable ) == m_running.end();
+                    } );
+
+    m_tables.erase( aTable );
+    aTable->m_preloader = nullptr;
+}
+
+
+bool LIB_TABLE_PRELOADER::IsLibraryReady( LIB_TABLE* aTable, const wxString& aNickname )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+    auto                        table = m_tables.find( aTable );
+
+    if( table == m_tables.end() )
+        return false;
+
+    for( const LIBRARY& library : table->second )
+    {
+        if( library.m_nickname == aNickname )
+            return library.m_ready;
+    }
+
+    return false;
+}
+
+
+void LIB_TABLE_PRELOADER::AddListener( wxEvtHandler* aListener )
+{
+    if( std::find( m_listeners.begin(), m_listeners.end(), aListener ) == m_listeners.end() )
+        m_listeners.push_back( aListener );
+}
+
+
+void LIB_TABLE_PRELOADER::RemoveListener( wxEvtHandler* aListener )
+{
+    m_listeners.erase( std::remove( m_listeners.begin(), m_listeners.end(), aListener ),
+                       m_listeners.end() );
+}
+
+
+void LIB_TABLE_PRELOADER::queueLoad( LIB_TABLE* aTable, size_t aLibrary )
+{
+    if( m_workers.empty() )
+        startWorkers();
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_jobs.push_back( { LOAD_JOB, aTable, aLibrary } );
+    }
+
+    m_jobQueued.notify_one();
+}
+
+
+void LIB_TABLE_PRELOADER::startWorkers()
+{
+    // Keep a core for the main thread
+    int workerCount = std::max<int>( (int) std::thread::hardware_concurrency() - 1, 1 );
+
+    m_quit = false;
+
+    for( int ii = 0; ii < workerCount; ++ii )
+        m_workers.emplace_back( &LIB_TABLE_PRELOADER::worker, this );
+}
+
+
+void LIB_TABLE_PRELOADER::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_quit = true;
+        m_jobs.clear();
+    }
+
+    m_jobQueued.notify_all();
+
+    for( std::thread& worker : m_workers )
+        worker.join();
+
+    m_workers.clear();
+}
+
+
+void LIB_TABLE_PRELOADER::worker()
+{
+    while( true )
+    {
+        JOB job;
+
+        {
+            std::unique_lock<std::mutex> lock( m_lock );
+
+            m_jobQueued.wait( lock,
+                              [this]()
+                              {
+                                  return m_quit || !m_jobs.empty();
+                              } );
+
+            if( m_quit )
+                return;
+
+            job = m_jobs.front();
+            m_jobs.pop_front();
+            m_running[job.m_table]++;
+        }
+
+        runJob( job );
+
+        {
+            std::lock_guard<std::mutex> lock( m_lock );
+
+            if( --m_running[job.m_table] == 0 )
+                m_running.erase( job.m_table );
+        }
+
+        m_jobDone.notify_all();
+    }
+}
+
+
+void LIB_TABLE_PRELOADER::runJob( const JOB& aJob )
+{
+    LIB_TABLE_ROW* row;
+    wxString       nickname;
+
+    {
+        // The table cannot be forgotten while the job is running
+        std::lock_guard<std::mutex> lock( m_lock );
+        const LIBRARY&              library = m_tables[aJob.m_table][aJob.m_library];
+
+        row = library.m_row;
+        nickname = library.m_nickname;
+    }
+
+    long long timestamp = 0;
+
+    if( aJob.m_type == CHECK_JOB )
+    {
+        {
+            std::lock_guard<std::recursive_mutex> pluginLock( row->GetPluginLock() );
+            timestamp = row->GetLibraryTimestamp();
+        }
+
+        std::lock_guard<std::mutex> lock( m_lock );
+        const LIBRARY&              library = m_tables[aJob.m_table][aJob.m_library];
+
+        if( library.m_ready && library.m_timestamp != timestamp )
+        {
+            LIB_TABLE* table = aJob.m_table;
+            size_t     index = aJob.m_library;
+
+            CallAfter(
+                    [this, table, index]()
+                    {
+                        onLibraryChanged( table, index );
+                    } );
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::recursive_mutex> pluginLock( row->GetPluginLock() );
+
+        // The plugins set the C locale themselves, but the locale of the application must
+        // not be changed by a worker thread
+        THREAD_LOCALE_IO toggle;
+
+        // Read the timestamp first: a change during the load is seen by the next check
+        timestamp = row->GetLibraryTimestamp();
+
+        try
+        {
+            row->Preload( true );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            // The error is reported again by the frame which uses the library
+            wxLogTrace( traceLibPreload, "Cannot load library %s: %s", nickname, ioe.What() );
+        }
+        catch( const std::exception& e )
+        {
+            wxLogTrace( traceLibPreload, "Cannot load library %s: %s", nickname, e.what() );
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        LIBRARY&                    library = m_tables[aJob.m_table][aJob.m_library];
+
+        library.m_ready = true;
+        library.m_timestamp = timestamp;
+    }
+
+    wxLogTrace( traceLibPreload, "Library %s loaded", nickname );
+
+    LIB_TABLE* table = aJob.m_table;
+
+    CallAfter(
+            [this, table, nickname]()
+            {
+                notify( EDA_EVT_LIBRARY_PRELOADED, table, nickname );
+            } );
+}
+
+
+void LIB_TABLE_PRELOADER::onPollTimer( wxTimerEvent& aEvent )
+{
+    CheckLibraries();
+}
+
+
+void LIB_TABLE_PRELOADER::CheckLibraries()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        // Skip the check while libraries are loaded
+        if( m_workers.empty() || !m_jobs.empty() || !m_running.empty() )
+            return;
+
+        for( const std::pair<LIB_TABLE* const, std::vector<LIBRARY>>& table : m_tables )
+        {
+            for( size_t ii = 0; ii < table.second.size(); ++ii )
+            {
+                if( table.second[ii].m_ready )
+                    m_jobs.push_back( { CHECK_JOB, table.first, ii } );
+            }
+        }
+    }
+
+    m_jobQueued.notify_all();
+}
+
+
+void LIB_TABLE_PRELOADER::onLibraryChanged( LIB_TABLE* aTable, size_t aLibrary )
+{
+    LIB_TABLE_ROW* row;
+    wxString       nickname;
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        // The table may have been forgotten since the check
+        auto table = m_tables.find( aTable );
+
+        if( table == m_tables.end() || aLibrary >= table->second.size() )
+            return;
+
+        row = table->second[aLibrary].m_row;
+        nickname = table->second[aLibrary].m_nickname;
+    }
+
+    // The reload deletes the symbols and footprints of the cache of the plugin, which can be
+    // in use by the frames: unlike the first loads, it runs on the main thread, and the
+    // frames update their copies on EDA_EVT_LIBRARY_UPDATED.
+    long long timestamp;
+
+    {
+        std::lock_guard<std::recursive_mutex> pluginLock( row->GetPluginLock() );
+
+        timestamp = row->GetLibraryTimestamp();
+
+        try
+        {
+            row->Preload( false );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            wxLogTrace( traceLibPreload, "Cannot reload library %s: %s", nickname, ioe.What() );
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+        m_tables[aTable][aLibrary].m_timestamp = timestamp;
+    }
+
+    wxLogTrace( traceLibPreload, "Library %s reloaded", nickname );
+
+    notify( EDA_EVT_LIBRARY_UPDATED, aTable, nickname );
+}
+
+
+void LIB_TABLE_PRELOADER::notify( const wxEventType& aType, LIB_TABLE* aTable,
+                                  const wxString& aNickname )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_lock );
+
+        if( m_tables.find( aTable ) == m_tables.end() )
+            return;
+    }
+
+    for( wxEvtHandler* listener : m_listeners )
+    {
+        wxCommandEvent event( aType );
+        event.SetString( aNickname );
+        event.SetClientData( aTable );
+        wxPostEvent( listener, event );
+    }
+}
@@ -22,6 +22,7 @@
 #include <lib_tree_model.h>
 
 #include <algorithm>
+#include <iterator>
 #include <eda_pattern_match.h>
 #include <lib_tree_item.h>
 #include <utility>
@@ -337,3 +338,218 @@ void LIB_TREE_NODE_ROOT::UpdateScore( EDA_COMBINED_MATCHER& aMatcher )
         child->UpdateScore( aMatcher );
 }
 
+
+
+/**
+ * Call aFunc with the key of each trigram of aText.
+ */
+template <typename FUNC>
+static void forEachTrigram( const wxString& aText, FUNC aFunc )
+{
+    // The characters are stored on 21 bits (the Unicode range)
+    const uint64_t mask = ( uint64_t( 1 ) << 63 ) - 1;
+    uint64_t       key = 0;
+    size_t         count = 0;
+
+    for( wxUniChar c : aText )
+    {
+        key = ( ( key << 21 ) | ( uint64_t( c.GetValue() ) & 0x1FFFFF ) ) & mask;
+
+        if( ++count >= 3 )
+            aFunc( key );
+    }
+}
+
+
+/**
+ * @return true if all the matchers of EDA_COMBINED_MATCHER match aTerm as a plain substring
+ * (i.e. the term has no regular expression, wildcard or relational syntax)
+ */
+static bool isPlainTerm( const wxString& aTerm )
+{
+    static const wxString specialChars = wxT( ".*+?^${}()|[]\\<=>" );
+
+    for( wxUniChar c : aTerm )
+    {
+        if( specialChars.Find( c ) != wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+
+void LIB_TREE_SEARCH_INDEX::Clear()
+{
+    m_built = false;
+    m_nodes.clear();
+    m_libs.clear();
+    m_trigrams.clear();
+    m_lastTerms.clear();
+    m_lastMatches.clear();
+}
+
+
+void LIB_TREE_SEARCH_INDEX::build( LIB_TREE_NODE_ROOT& aTree )
+{
+    Clear();
+
+    for( std::unique_ptr<LIB_TREE_NODE>& lib : aTree.m_Children )
+    {
+        LIB_RANGE range = { lib.get(), (unsigned) m_nodes.size(), 0 };
+
+        for( std::unique_ptr<LIB_TREE_NODE>& node : lib->m_Children )
+        {
+            if( node->m_Type != LIB_TREE_NODE::LIBID )
+                continue;
+
+            unsigned id = m_nodes.size();
+            m_nodes.push_back( node.get() );
+
+            // The texts are normalized as in LIB_TREE_NODE_LIB_ID::UpdateScore()
+            addText( node->m_MatchName.Lower(), id );
+            addText( node->m_SearchText.Lower(), id );
+        }
+
+        range.m_end = m_nodes.size();
+        m_libs.push_back( range );
+    }
+
+    m_built = true;
+}
+
+
+void LIB_TREE_SEARCH_INDEX::addText( const wxString& aText, unsigned aNode )
+{
+    forEachTrigram( aText,
+            [&]( uint64_t aKey )
+            {
+                std::vector<unsigned>& nodes = m_trigrams[aKey];
+
+                // The nodes are added in increasing order, so the lists stay sorted
+                if( nodes.empty() || nodes.back() != aNode )
+                    nodes.push_back( aNode );
+            } );
+}
+
+
+void LIB_TREE_SEARCH_INDEX::excludeNonMatching( const wxString& aTerm,
+                                                std::vector<char>& aCandidates ) const
+{
+    std::vector<char>                         matches( m_nodes.size(), 0 );
+    std::vector<const std::vector<unsigned>*> lists;
+    bool                                      missing = false;
+
+    // The nodes of a library are scored when the library name matches
+    for( const LIB_RANGE& range : m_libs )
+    {
+        if( range.m_lib->m_MatchName.Find( aTerm ) != wxNOT_FOUND )
+            std::fill( matches.begin() + range.m_first, matches.begin() + range.m_end, 1 );
+    }
+
+    forEachTrigram( aTerm,
+            [&]( uint64_t aKey )
+            {
+                auto it = m_trigrams.find( aKey );
+
+                if( it == m_trigrams.end() )
+                    missing = true;
+                else
+                    lists.push_back( &it->second );
+            } );
+
+    if( !missing && !lists.empty() )
+    {
+        std::sort( lists.begin(), lists.end(),
+                   []( const std::vector<unsigned>* a, const std::vector<unsigned>* b )
+                   {
+                       return a->size() < b->size();
+                   } );
+
+        std::vector<unsigned> nodes = *lists[0];
+        std::vector<unsigned> buffer;
+
+        for( size_t i = 1; i < lists.size() && !nodes.empty(); ++i )
+        {
+            buffer.clear();
+            std::set_intersection( nodes.begin(), nodes.end(), lists[i]->begin(),
+                                   lists[i]->end(), std::back_inserter( buffer ) );
+            nodes.swap( buffer );
+        }
+
+        for( unsigned node : nodes )
+            matches[node] = 1;
+    }
+
+    for( size_t i = 0; i < aCandidates.size(); ++i )
+        aCandidates[i] &= matches[i];
+}
+
+
+bool LIB_TREE_SEARCH_INDEX::extendsLastSearch( const std::vector<wxString>& aTerms ) const
+{
+    // A node which does not match a plain term does not match a longer plain term starting
+    // with it either
+    if( m_lastMatches.size() != m_nodes.size() || aTerms.size() < m_lastTerms.size() )
+        return false;
+
+    for( size_t i = 0; i < m_lastTerms.size(); ++i )
+    {
+        if( !aTerms[i].StartsWith( m_lastTerms[i] )
+                || !isPlainTerm( m_lastTerms[i] ) || !isPlainTerm( aTerms[i] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void LIB_TREE_SEARCH_INDEX::ExcludeNonMatching( LIB_TREE_NODE_ROOT& aTree,
+                                                const std::vector<wxString>& aTerms )
+{
+    if( !m_built )
+        build( aTree );
+
+    std::vector<char> candidates;
+    bool              filtered = false;
+
+    if( extendsLastSearch( aTerms ) )
+    {
+        candidates = m_lastMatches;
+        filtered = true;
+    }
+    else
+    {
+        candidates.assign( m_nodes.size(), 1 );
+    }
+
+    for( const wxString& term : aTerms )
+    {
+        if( term.length() >= 3 && isPlainTerm( term ) )
+        {
+            excludeNonMatching( term, candidates );
+            filtered = true;
+        }
+    }
+
+    if( !filtered )
+        return;
+
+    for( size_t i = 0; i < m_nodes.size(); ++i )
+    {
+        if( !candidates[i] )
+            m_nodes[i]->m_Score = 0;
+    }
+}
+
+
+void LIB_TREE_SEARCH_INDEX::StoreMatches( const std::vector<wxString>& aTerms )
+{
+    m_lastTerms = aTerms;
+    m_lastMatches.resize( m_nodes.size() );
+
+    for( size_t i = 0; i < m_nodes.size(); ++i )
+        m_lastMatches[i] = m_nodes[i]->m_Score > 0;
+}
@@ -22,8 +22,10 @@
 #ifndef LIB_TREE_MODEL_H
 #define LIB_TREE_MODEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <wx/string.h>
 #include <lib_tree_item.h>
 
@@ -285,4 +287,73 @@ public:
 };
 
 
+/**
+ * Inverted index of the trigrams of the names and search texts of the #LIB_ID nodes of a
+ * tree, used to skip the nodes which cannot match a search string before the scoring.
+ *
+ * Only the search terms of at least 3 characters without regular expression, wildcard or
+ * relational syntax are looked up in the index: for these terms all the matchers of
+ * EDA_COMBINED_MATCHER are plain substring searches, so a node without the trigrams of the
+ * term (and without the term in its library name) cannot match and its score is set to 0.
+ * The scores of the other nodes are computed by UpdateScore() as before, so the ranking is
+ * unchanged.
+ *
+ * When the search string extends the previous one, only the nodes which matched the
+ * previous search are candidates.
+ *
+ * The index is built at the first search, and must be cleared when the tree is modified.
+ */
+class LIB_TREE_SEARCH_INDEX
+{
+public:
+    LIB_TREE_SEARCH_INDEX() :
+        m_built( false )
+    {}
+
+    /**
+     * Clear the index (it is built again at the next search).
+     */
+    void Clear();
+
+    /**
+     * Set to 0 the score of the #LIB_ID nodes of aTree which cannot match all the search
+     * terms.  To be called after ResetScore() and before UpdateScore().
+     *
+     * @param aTree     the tree to search, which is indexed if needed
+     * @param aTerms    the search terms, in lowercase
+     */
+    void ExcludeNonMatching( LIB_TREE_NODE_ROOT& aTree, const std::vector<wxString>& aTerms );
+
+    /**
+     * Store the #LIB_ID nodes matching the search terms, for the next search.  To be called
+     * after UpdateScore() for all the search terms.
+     */
+    void StoreMatches( const std::vector<wxString>& aTerms );
+
+private:
+    struct LIB_RANGE
+    {
+        LIB_TREE_NODE* m_lib;
+        unsigned       m_first;    ///< index of the first #LIB_ID node of the library
+        unsigned       m_end;      ///< index after the last #LIB_ID node of the library
+    };
+
+    void build( LIB_TREE_NODE_ROOT& aTree );
+
+    void addText( const wxString& aText, unsigned aNode );
+
+    /// Clear in aCandidates the nodes which cannot match aTerm
+    void excludeNonMatching( const wxString& aTerm, std::vector<char>& aCandidates ) const;
+
+    bool extendsLastSearch( const std::vector<wxString>& aTerms ) const;
+
+    bool                                                m_built;
+    std::vector<LIB_TREE_NODE*>                         m_nodes;     ///< the #LIB_ID nodes
+    std::vector<LIB_RANGE>                              m_libs;
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_trigrams;  ///< trigram -> nodes
+    std::vector<wxString>                               m_lastTerms;
+    std::vector<char>                                   m_lastMatches;
+};
+
+
 #endif // LIB_TREE_MODEL_H
@@ -168,6 +168,8 @@ LIB_TREE_NODE_LIB& LIB_TREE_MODEL_ADAPTER::DoAddLibraryNode( wxString const& aNo
 {
     LIB_TREE_NODE_LIB& lib_node = m_tree.AddLib( aNodeName, aDesc );
 
+    m_searchIndex.Clear();
+
     lib_node.m_Pinned = m_pinnedLibs.Index( lib_node.m_LibId.GetLibNickname() ) != wxNOT_FOUND;
 
     return lib_node;
@@ -212,16 +214,25 @@ void LIB_TREE_MODEL_ADAPTER::UpdateSearchString( wxString const& aSearch )
                 child->m_Score *= 2;
         }
 
-        wxStringTokenizer tokenizer( aSearch );
+        wxStringTokenizer     tokenizer( aSearch );
+        std::vector<wxString> terms;
 
         while( tokenizer.HasMoreTokens() )
+            terms.push_back( tokenizer.GetNextToken().Lower() );
+
+        // Skip the items which cannot match before the scoring
+        if( !terms.empty() )
+            m_searchIndex.ExcludeNonMatching( m_tree, terms );
+
+        for( const wxString& term : terms )
         {
-            const wxString term = tokenizer.GetNextToken().Lower();
             EDA_COMBINED_MATCHER matcher( term );
 
             m_tree.UpdateScore( matcher );
         }
 
+        m_searchIndex.StoreMatches( terms );
+
         m_tree.SortNodes();
         AfterReset();
         Thaw();
@@ -182,6 +182,12 @@ public:
      */
     void UpdateSearchString( wxString const& aSearch );
 
+    /**
+     * Drop the search index, so the next search rebuilds it.  Must be called when the search
+     * text of a node is changed outside of the adapter, e.g. by LIB_TREE_NODE_LIB_ID::Update().
+     */
+    void InvalidateSearchIndex() { m_searchIndex.Clear(); }
+
     /**
      * Attach to a wxDataViewCtrl and initialize it. This will set up columns
      * and associate the model via the adapter.
@@ -271,7 +277,8 @@ protected:
     static LIB_TREE_NODE* ToNode( wxDataViewItem aItem );
     static unsigned int IntoArray( LIB_TREE_NODE const& aNode, wxDataViewItemArray& aChildren );
 
-    LIB_TREE_NODE_ROOT m_tree;
+    LIB_TREE_NODE_ROOT    m_tree;
+    LIB_TREE_SEARCH_INDEX m_searchIndex;    ///< must be cleared when m_tree is modified
 
     /**
      * Creates the adapter
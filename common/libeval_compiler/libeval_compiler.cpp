@@ -1052,12 +1052,50 @@ bool COMPILER::generateUCode( UCODE* aCode, CONTEXT* aPreflightContext )
         stack.pop_back();
     }
 
+    aCode->BuildProgram();
+
     libeval_dbg(2,"dump: \n%s\n", aCode->Dump().c_str() );
 
     return true;
 }
 
 
+static double binaryOp( int aOp, VALUE* arg1, VALUE* arg2 )
+{
+    double arg2Value = arg2 ? arg2->AsDouble() : 0.0;
+    double arg1Value = arg1 ? arg1->AsDouble() : 0.0;
+
+    switch( aOp )
+    {
+    case TR_OP_ADD:           return arg1Value + arg2Value;
+    case TR_OP_SUB:           return arg1Value - arg2Value;
+    case TR_OP_MUL:           return arg1Value * arg2Value;
+    case TR_OP_DIV:           return arg1Value / arg2Value;
+    case TR_OP_LESS_EQUAL:    return arg1Value <= arg2Value ? 1 : 0;
+    case TR_OP_GREATER_EQUAL: return arg1Value >= arg2Value ? 1 : 0;
+    case TR_OP_LESS:          return arg1Value < arg2Value ? 1 : 0;
+    case TR_OP_GREATER:       return arg1Value > arg2Value ? 1 : 0;
+    case TR_OP_EQUAL:         return arg1 && arg2 && arg1->EqualTo( arg2 ) ? 1 : 0;
+    case TR_OP_NOT_EQUAL:     return arg1 && arg2 && arg1->EqualTo( arg2 ) ? 0 : 1;
+    case TR_OP_BOOL_AND:      return arg1Value != 0.0 && arg2Value != 0.0 ? 1 : 0;
+    case TR_OP_BOOL_OR:       return arg1Value != 0.0 || arg2Value != 0.0 ? 1 : 0;
+    default:                  return 0.0;
+    }
+}
+
+
+static double unaryOp( int aOp, VALUE* arg1 )
+{
+    double arg1Value = arg1 ? arg1->AsDouble() : 0.0;
+
+    switch( aOp )
+    {
+    case TR_OP_BOOL_NOT: return arg1Value != 0.0 ? 0 : 1;
+    default:             return 0.0;
+    }
+}
+
+
 void UOP::Exec( CONTEXT* ctx )
 {
     switch( m_op )
@@ -1086,78 +1124,97 @@ void UOP::Exec( CONTEXT* ctx )
     {
         LIBEVAL::VALUE* arg2 = ctx->Pop();
         LIBEVAL::VALUE* arg1 = ctx->Pop();
-        double          arg2Value = arg2 ? arg2->AsDouble() : 0.0;
-        double          arg1Value = arg1 ? arg1->AsDouble() : 0.0;
-        double          result;
-
-        switch( m_op )
-        {
-        case TR_OP_ADD:
-            result = arg1Value + arg2Value;
-            break;
-        case TR_OP_SUB:
-            result = arg1Value - arg2Value;
-            break;
-        case TR_OP_MUL:
-            result = arg1Value * arg2Value;
-            break;
-        case TR_OP_DIV:
-            result = arg1Value / arg2Value;
-            break;
-        case TR_OP_LESS_EQUAL:
-            result = arg1Value <= arg2Value ? 1 : 0;
-            break;
-        case TR_OP_GREATER_EQUAL:
-            result = arg1Value >= arg2Value ? 1 : 0;
-            break;
-        case TR_OP_LESS:
-            result = arg1Value < arg2Value ? 1 : 0;
-            break;
-        case TR_OP_GREATER:
-            result = arg1Value > arg2Value ? 1 : 0;
-            break;
-        case TR_OP_EQUAL:
-            result = arg1 && arg2 && arg1->EqualTo( arg2 ) ? 1 : 0;
-            break;
-        case TR_OP_NOT_EQUAL:
-            result = arg1 && arg2 && arg1->EqualTo( arg2 ) ? 0 : 1;
-            break;
-        case TR_OP_BOOL_AND:
-            result = arg1Value != 0.0 && arg2Value != 0.0 ? 1 : 0;
-            break;
-        case TR_OP_BOOL_OR:
-            result = arg1Value != 0.0 || arg2Value != 0.0 ? 1 : 0;
-            break;
-        default:
-            result = 0.0;
-            break;
-        }
 
         auto rp = ctx->AllocValue();
-        rp->Set( result );
+        rp->Set( binaryOp( m_op, arg1, arg2 ) );
         ctx->Push( rp );
         return;
     }
     else if( m_op & TR_OP_UNARY_MASK )
     {
         LIBEVAL::VALUE* arg1 = ctx->Pop();
-        double          arg1Value = arg1 ? arg1->AsDouble() : 0.0;
-        double          result;
 
-        switch( m_op )
+        auto rp = ctx->AllocValue();
+        rp->Set( unaryOp( m_op, arg1 ) );
+        ctx->Push( rp );
+        return;
+    }
+}
+
+
+void UCODE::BuildProgram()
+{
+    m_program.clear();
+    m_constants.clear();
+
+    // the instruction pushes a value known at compile time
+    auto isConstant =
+            []( const UINSTR& aInstr )
+            {
+                return aInstr.op == TR_UOP_PUSH_VALUE && aInstr.value;
+            };
+
+    for( UOP* uop : m_ucode )
+    {
+        UINSTR instr;
+        instr.op = uop->m_op;
+
+        switch( uop->m_op )
         {
-        case TR_OP_BOOL_NOT:
-            result = arg1Value != 0.0 ? 0 : 1;
-            break;
+        case TR_UOP_PUSH_VAR:
+            instr.ref = uop->m_ref.get();
+            m_program.push_back( instr );
+            continue;
+
+        case TR_UOP_PUSH_VALUE:
+            instr.value = uop->m_value.get();
+            m_program.push_back( instr );
+            continue;
+
+        case TR_OP_METHOD_CALL:
+            instr.uop = uop;
+            m_program.push_back( instr );
+            continue;
+
         default:
-            result = 0.0;
             break;
         }
 
-        auto rp = ctx->AllocValue();
-        rp->Set( result );
-        ctx->Push( rp );
-        return;
+        size_t count = m_program.size();
+
+        if( uop->m_op & TR_OP_BINARY_MASK )
+        {
+            // an operation on two constants is replaced by its result
+            if( count >= 2 && isConstant( m_program[count - 2] )
+                    && isConstant( m_program[count - 1] ) )
+            {
+                double result = binaryOp( uop->m_op, m_program[count - 2].value,
+                                          m_program[count - 1].value );
+
+                m_constants.push_back( std::make_unique<VALUE>( result ) );
+                m_program.pop_back();
+                m_program.back().value = m_constants.back().get();
+                continue;
+            }
+        }
+        else if( uop->m_op & TR_OP_UNARY_MASK )
+        {
+            if( count >= 1 && isConstant( m_program[count - 1] ) )
+            {
+                double result = unaryOp( uop->m_op, m_program[count - 1].value );
+
+                m_constants.push_back( std::make_unique<VALUE>( result ) );
+                m_program.back().value = m_constants.back().get();
+                continue;
+            }
+        }
+        else
+        {
+            // the other op codes have no effect when executed
+            continue;
+        }
+
+        m_program.push_back( instr );
     }
 }
 
@@ -1168,8 +1225,56 @@ VALUE* UCODE::Run( CONTEXT* ctx )
 
     try
     {
-        for( UOP* op : m_ucode )
-            op->Exec( ctx );
+        if( m_program.empty() )
+        {
+            // the program was not built (the UOPs were not added by the compiler)
+            for( UOP* op : m_ucode )
+                op->Exec( ctx );
+        }
+
+        for( const UINSTR& instr : m_program )
+        {
+            switch( instr.op )
+            {
+            case TR_UOP_PUSH_VAR:
+            {
+                VALUE* value = ctx->AllocValue();
+                value->Set( instr.ref->GetValue( ctx ) );
+                ctx->Push( value );
+                break;
+            }
+
+            case TR_UOP_PUSH_VALUE:
+                ctx->Push( instr.value );
+                break;
+
+            case TR_OP_METHOD_CALL:
+                instr.uop->m_func( ctx, instr.uop->m_ref.get() );
+                break;
+
+            default:
+            {
+                VALUE* result;
+
+                if( instr.op & TR_OP_BINARY_MASK )
+                {
+                    VALUE* arg2 = ctx->Pop();
+                    VALUE* arg1 = ctx->Pop();
+                    result = ctx->AllocValue();
+                    result->Set( binaryOp( instr.op, arg1, arg2 ) );
+                }
+                else
+                {
+                    VALUE* arg1 = ctx->Pop();
+                    result = ctx->AllocValue();
+                    result->Set( unaryOp( instr.op, arg1 ) );
+                }
+
+                ctx->Push( result );
+                break;
+            }
+            }
+        }
     }
     catch(...)
     {
@@ -26,9 +26,17 @@
 
 std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
 
+// True in the scope of a THREAD_LOCALE_IO of the thread
+static thread_local bool inThreadLocaleIo = false;
 
-LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
+
+LOCALE_IO::LOCALE_IO() :
+        m_wxLocale( nullptr ),
+        m_threadLocale( inThreadLocaleIo )
 {
+    if( m_threadLocale )
+        return;
+
     // use thread safe, atomic operation
     if( m_c_count++ == 0 )
     {
@@ -39,10 +47,49 @@ LOCALE_IO::LOCALE_IO() : m_wxLocale( nullptr )
 
 LOCALE_IO::~LOCALE_IO()
 {
+    if( m_threadLocale )
+        return;
+
     // use thread safe, atomic operation
     if( --m_c_count == 0 )
     {
         delete m_wxLocale; // Deleting m_wxLocale restored previous locale
         m_wxLocale = nullptr;
     }
+}
+
+
+THREAD_LOCALE_IO::THREAD_LOCALE_IO() :
+        m_nested( inThreadLocaleIo )
+{
+    if( m_nested )
+        return;
+
+#if defined( _WIN32 )
+    m_threadConfig = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+    m_previousLocale = setlocale( LC_ALL, nullptr );
+    setlocale( LC_ALL, "C" );
+#else
+    m_cLocale = newlocale( LC_ALL_MASK, "C", (locale_t) 0 );
+    m_previousLocale = uselocale( m_cLocale );
+#endif
+
+    inThreadLocaleIo = true;
+}
+
+
+THREAD_LOCALE_IO::~THREAD_LOCALE_IO()
+{
+    if( m_nested )
+        return;
+
+    inThreadLocaleIo = false;
+
+#if defined( _WIN32 )
+    setlocale( LC_ALL, m_previousLocale.c_str() );
+    _configthreadlocale( m_threadConfig );
+#else
+    uselocale( m_previousLocale );
+    freelocale( m_cLocale );
+#endif
 }
\ No newline at end of file
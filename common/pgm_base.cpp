@@ -40,6 +40,7 @@
 #include <wx/richmsgdlg.h>
 #include <wx/filedlg.h>
 
+#include <advanced_config.h>
 #include <build_version.h>
 #include <config_params.h>
 #include <confirm.h>
@@ -50,6 +51,7 @@
 #include <gestfich.h>
 #include <hotkeys_basic.h>
 #include <id.h>
+#include <lib_table_preloader.h>
 #include <lockfile.h>
 #include <macros.h>
 #include <menus_helpers.h>
@@ -118,6 +120,8 @@ PGM_BASE::~PGM_BASE()
 void PGM_BASE::Destroy()
 {
     // unlike a normal destructor, this is designed to be called more than once safely:
+    m_lib_preloader.reset();
+
     delete m_pgm_checker;
     m_pgm_checker = 0;
 
@@ -225,6 +229,9 @@ bool PGM_BASE::InitPgm()
     if( !m_settings_manager->IsOK() )
         return false;
 
+    if( ADVANCED_CFG::GetCfg().m_PreloadLibraries )
+        m_lib_preloader = std::make_unique<LIB_TABLE_PRELOADER>();
+
     // Init KiCad environment
     // the environment variable KICAD (if exists) gives the kicad path:
     // something like set KICAD=d:\kicad
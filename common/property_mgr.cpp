@@ -99,6 +99,30 @@ const void* PROPERTY_MANAGER::TypeCast( const void* aSource, TYPE_ID aBase, TYPE
 }
 
 
+bool PROPERTY_MANAGER::ResolveTypeCast( TYPE_ID aBase, TYPE_ID aTarget,
+                                        const TYPE_CAST_BASE** aCast ) const
+{
+    *aCast = nullptr;
+
+    if( aBase == aTarget )
+        return true;
+
+    auto classDesc = m_classes.find( aBase );
+
+    if( classDesc == m_classes.end() )
+        return true;
+
+    auto& converters = classDesc->second.m_typeCasts;
+    auto converter = converters.find( aTarget );
+
+    if( converter == converters.end() )     // explicit type cast not found
+        return IsOfType( aBase, aTarget );
+
+    *aCast = converter->second.get();
+    return true;
+}
+
+
 void PROPERTY_MANAGER::AddProperty( PROPERTY_BASE* aProperty )
 {
     const wxString& name = aProperty->Name();
@@ -582,6 +582,190 @@ void mpFY::Plot( wxDC& dc, mpWindow& w )
 }
 
 
+// -----------------------------------------------------------------------------
+// mpMinMaxPyramid implementation
+// -----------------------------------------------------------------------------
+
+void mpMinMaxPyramid::Build( const std::vector<double>& aValues )
+{
+    Clear();
+    Extend( aValues );
+}
+
+
+void mpMinMaxPyramid::Extend( const std::vector<double>& aValues )
+{
+    size_t blocks = aValues.size() / BLOCK_SIZE;
+
+    if( blocks == 0 )
+        return;
+
+    if( m_mins.empty() )
+    {
+        m_mins.emplace_back();
+        m_maxs.emplace_back();
+    }
+
+    // The first block of the level which is not computed yet
+    size_t first = m_mins[0].size();
+
+    m_mins[0].resize( blocks );
+    m_maxs[0].resize( blocks );
+
+    for( size_t ii = first; ii < blocks; ii++ )
+    {
+        auto block = aValues.begin() + ii * BLOCK_SIZE;
+        auto extrema = std::minmax_element( block, block + BLOCK_SIZE );
+
+        m_mins[0][ii] = *extrema.first;
+        m_maxs[0][ii] = *extrema.second;
+    }
+
+    // Each block of a level merges 2 blocks of the previous level
+    for( size_t level = 1; m_mins[level - 1].size() > 1; level++ )
+    {
+        if( level == m_mins.size() )
+        {
+            m_mins.emplace_back();
+            m_maxs.emplace_back();
+        }
+
+        const std::vector<double>& mins = m_mins[level - 1];
+        const std::vector<double>& maxs = m_maxs[level - 1];
+        std::vector<double>&       levelMins = m_mins[level];
+        std::vector<double>&       levelMaxs = m_maxs[level];
+
+        first /= 2;
+        levelMins.resize( mins.size() / 2 );
+        levelMaxs.resize( maxs.size() / 2 );
+
+        for( size_t ii = first; ii < levelMins.size(); ii++ )
+        {
+            levelMins[ii] = std::min( mins[2 * ii], mins[2 * ii + 1] );
+            levelMaxs[ii] = std::max( maxs[2 * ii], maxs[2 * ii + 1] );
+        }
+    }
+}
+
+
+void mpMinMaxPyramid::Clear()
+{
+    m_mins.clear();
+    m_maxs.clear();
+}
+
+
+void mpMinMaxPyramid::GetMinMax( const std::vector<double>& aValues, size_t aBegin, size_t aEnd,
+                                 double& aMin, double& aMax ) const
+{
+    aMin = aMax = aValues[aBegin];
+
+    auto scan =
+            [&]( size_t aFirst, size_t aLast )
+            {
+                for( size_t ii = aFirst; ii < aLast; ii++ )
+                {
+                    aMin = std::min( aMin, aValues[ii] );
+                    aMax = std::max( aMax, aValues[ii] );
+                }
+            };
+
+    // Whole blocks of the first level in the range
+    size_t firstBlock = ( aBegin + BLOCK_SIZE - 1 ) / BLOCK_SIZE;
+    size_t lastBlock = aEnd / BLOCK_SIZE;
+
+    if( m_mins.empty() || firstBlock >= lastBlock )
+    {
+        scan( aBegin, aEnd );
+        return;
+    }
+
+    scan( aBegin, firstBlock * BLOCK_SIZE );
+    scan( lastBlock * BLOCK_SIZE, aEnd );
+
+    // Climb the levels, taking the blocks at the ends of the range which are not merged in
+    // a block of the next level
+    for( size_t level = 0; firstBlock < lastBlock; level++ )
+    {
+        if( firstBlock & 1 )
+        {
+            aMin = std::min( aMin, m_mins[level][firstBlock] );
+            aMax = std::max( aMax, m_maxs[level][firstBlock] );
+            firstBlock++;
+        }
+
+        if( lastBlock & 1 )
+        {
+            lastBlock--;
+            aMin = std::min( aMin, m_mins[level][lastBlock] );
+            aMax = std::max( aMax, m_maxs[level][lastBlock] );
+        }
+
+        firstBlock /= 2;
+        lastBlock /= 2;
+    }
+}
+
+
+void mpMinMaxPyramid::Decimate( const std::vector<double>& aXs, const std::vector<double>& aYs,
+                                const std::function<wxCoord( double )>& aToPixelX,
+                                const std::function<wxCoord( double )>& aToPixelY,
+                                wxCoord startPx, wxCoord endPx,
+                                std::vector<wxPoint>& aPoints ) const
+{
+    aPoints.clear();
+
+    // The first point in aFirst .. aLast - 1 plotted at or after the pixel column aPx
+    auto firstPointAt =
+            [&]( size_t aFirst, size_t aLast, wxCoord aPx )
+            {
+                while( aFirst < aLast )
+                {
+                    size_t middle = aFirst + ( aLast - aFirst ) / 2;
+
+                    if( aToPixelX( aXs[middle] ) < aPx )
+                        aFirst = middle + 1;
+                    else
+                        aLast = middle;
+                }
+
+                return aFirst;
+            };
+
+    size_t end = firstPointAt( 0, aXs.size(), endPx + 1 );
+
+    for( size_t ii = firstPointAt( 0, end, startPx ); ii < end; )
+    {
+        wxCoord px = aToPixelX( aXs[ii] );
+
+        // Gallop to the end of the column, so the search costs the log of the column points
+        size_t step = 1;
+
+        while( ii + step < end && aToPixelX( aXs[ii + step] ) <= px )
+            step *= 2;
+
+        size_t next = firstPointAt( ii + step / 2 + 1, std::min( ii + step, end ), px + 1 );
+
+        aPoints.emplace_back( px, aToPixelY( aYs[ii] ) );
+
+        if( next - ii == 2 )
+        {
+            aPoints.emplace_back( px, aToPixelY( aYs[ii + 1] ) );
+        }
+        else if( next - ii > 2 )
+        {
+            double minY, maxY;
+            GetMinMax( aYs, ii, next, minY, maxY );
+
+            aPoints.emplace_back( px, aToPixelY( minY ) );
+            aPoints.emplace_back( px, aToPixelY( maxY ) );
+        }
+
+        ii = next;
+    }
+}
+
+
 IMPLEMENT_ABSTRACT_CLASS( mpFXY, mpLayer )
 
 mpFXY::mpFXY( const wxString& name, int flags )
@@ -699,44 +883,59 @@ void mpFXY::Plot( wxDC& dc, mpWindow& w )
             // To avoid artifacts when skipping points to the same x coordinate, for each
             // group of points at a give, x coordinate we also draw a vertical line at this coord,
             // from the ymin to the ymax vertical coordinates of skipped points
-            while( GetNextXY( x, y ) )
-            {
-                double px = m_scaleX->TransformToPlot( x );
-                double py = m_scaleY->TransformToPlot( y );
-
-                wxCoord x1 = w.x2p( px );
-                wxCoord y1 = w.y2p( py );
-
-                // Store only points on the drawing area, to speed up the drawing time
-                if( x1 >= startPx && x1 <= endPx )
-                {
-                    if( !count || line_start.x != x1 )
+            auto addPoint =
+                    [&]( wxCoord x1, wxCoord y1 )
                     {
-                        if( count && dupx0 > 1 && ymin0 != ymax0 )
+                        // Store only points on the drawing area, to speed up the drawing time
+                        if( x1 < startPx || x1 > endPx )
+                            return;
+
+                        if( !count || line_start.x != x1 )
+                        {
+                            if( count && dupx0 > 1 && ymin0 != ymax0 )
+                            {
+                                // Vertical points are merged, draw the pending vertical line
+                                // However, if the line is one pixel length, it is not drawn,
+                                // because the main trace show this point
+                                dc.DrawLine( x0, ymin0, x0, ymax0 );
+                            }
+
+                            x0 = x1;
+                            ymin0 = ymax0 = y1;
+                            dupx0 = 0;
+
+                            pointList.emplace_back( wxPoint( x1, y1 ) );
+
+                            line_start.x = x1;
+                            line_start.y = y1;
+                            count++;
+                        }
+                        else
                         {
-                            // Vertical points are merged, draw the pending vertical line
-                            // However, if the line is one pixel length, it is not drawn,
-                            // because the main trace show this point
-                            dc.DrawLine( x0, ymin0, x0, ymax0 );
+                            ymin0 = std::min( ymin0, y1 );
+                            ymax0 = std::max( ymax0, y1 );
+                            x0 = x1;
+                            dupx0++;
                         }
+                    };
 
-                        x0 = x1;
-                        ymin0 = ymax0 = y1;
-                        dupx0 = 0;
+            // The large traces are decimated to a few points per pixel column, which are
+            // merged the same way
+            std::vector<wxPoint> decimated;
 
-                        pointList.emplace_back( wxPoint( x1, y1 ) );
+            if( GetDecimatedPoints( w, startPx, endPx, decimated ) )
+            {
+                for( const wxPoint& point : decimated )
+                    addPoint( point.x, point.y );
+            }
+            else
+            {
+                while( GetNextXY( x, y ) )
+                {
+                    double px = m_scaleX->TransformToPlot( x );
+                    double py = m_scaleY->TransformToPlot( y );
 
-                        line_start.x = x1;
-                        line_start.y = y1;
-                        count++;
-                    }
-                    else
-                    {
-                        ymin0 = std::min( ymin0, y1 );
-                        ymax0 = std::max( ymax0, y1 );
-                        x0 = x1;
-                        dupx0++;
-                    }
+                    addPoint( w.x2p( px ), w.y2p( py ) );
                 }
             }
 
@@ -3198,6 +3397,7 @@ mpFXYVector::mpFXYVector( const wxString& name, int flags ) : mpFXY( name, flags
     m_minY  = -1;
     m_maxY  = 1;
     m_type  = mpLAYER_PLOT;
+    m_sortedX = false;
 }
 
 
@@ -3279,10 +3479,34 @@ bool mpFXYVector::GetNextXY( double& x, double& y )
 }
 
 
+bool mpFXYVector::GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                                      std::vector<wxPoint>& aPoints )
+{
+    // The columns of the points are searched in m_xs, which must be sorted
+    if( !m_sortedX )
+        return false;
+
+    m_yPyramid.Decimate( m_xs, m_ys,
+                         [&]( double x )
+                         {
+                             return w.x2p( m_scaleX->TransformToPlot( x ) );
+                         },
+                         [&]( double y )
+                         {
+                             return w.y2p( m_scaleY->TransformToPlot( y ) );
+                         },
+                         startPx, endPx, aPoints );
+
+    return true;
+}
+
+
 void mpFXYVector::Clear()
 {
     m_xs.clear();
     m_ys.clear();
+    m_yPyramid.Clear();
+    m_sortedX = false;
 }
 
 
@@ -3296,6 +3520,15 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
     m_xs    = xs;
     m_ys    = ys;
 
+    // The transient and AC simulations have sorted X values: build the pyramid used to
+    // decimate their (possibly millions of) points when plotting
+    m_sortedX = std::is_sorted( m_xs.begin(), m_xs.end() );
+
+    if( m_sortedX )
+        m_yPyramid.Build( m_ys );
+    else
+        m_yPyramid.Clear();
+
     // Update internal variables for the bounding box.
     if( xs.size()>0 )
     {
@@ -3334,6 +3567,40 @@ void mpFXYVector::SetData( const std::vector<double>& xs, const std::vector<doub
 }
 
 
+void mpFXYVector::AppendData( const std::vector<double>& xs, const std::vector<double>& ys )
+{
+    // Check if the data vectors are of the same size
+    if( xs.size() != ys.size() || xs.empty() )
+        return;
+
+    if( m_xs.empty() )
+    {
+        SetData( xs, ys );
+        return;
+    }
+
+    m_sortedX = m_sortedX && m_xs.back() <= xs.front()
+                && std::is_sorted( xs.begin(), xs.end() );
+
+    m_xs.insert( m_xs.end(), xs.begin(), xs.end() );
+    m_ys.insert( m_ys.end(), ys.begin(), ys.end() );
+
+    // Update internal variables for the bounding box, and the pyramid with the new values only
+    auto extremaX = std::minmax_element( xs.begin(), xs.end() );
+    auto extremaY = std::minmax_element( ys.begin(), ys.end() );
+
+    m_minX = std::min( m_minX, *extremaX.first );
+    m_maxX = std::max( m_maxX, *extremaX.second );
+    m_minY = std::min( m_minY, *extremaY.first );
+    m_maxY = std::max( m_maxY, *extremaY.second );
+
+    if( m_sortedX )
+        m_yPyramid.Extend( m_ys );
+    else
+        m_yPyramid.Clear();
+}
+
+
 // -----------------------------------------------------------------------------
 // mpText - provided by Val Greene
 // -----------------------------------------------------------------------------
@@ -88,4 +88,147 @@ void XNODE::FormatContents( OUTPUTFORMATTER* out, int nestLevel )
     }
 }
 
+
+XNODE_WRITER::XNODE_WRITER( OUTPUTFORMATTER* aOut, FORMAT aFormat ) :
+        m_out( aOut ),
+        m_format( aFormat )
+{
+}
+
+
+void XNODE_WRITER::StartElement( const char* aName )
+{
+    int depth = (int) m_elements.size();
+
+    if( depth > 0 )
+    {
+        ELEMENT& parent = m_elements.back();
+
+        if( m_format == XML && !parent.m_hasChildren )
+            m_out->Print( 0, ">" );
+
+        parent.m_hasChildren = true;
+        parent.m_lastChildIsText = false;
+    }
+
+    if( m_format == SEXPR )
+    {
+        // As in XNODE::FormatContents(), the child elements start on new lines
+        if( depth > 0 )
+            m_out->Print( 0, "\n" );
+
+        m_out->Print( depth, "(%s", aName );
+    }
+    else if( depth > 0 )
+    {
+        m_out->Print( 0, "\n%*s<%s", depth * 2, "", aName );
+    }
+    else
+    {
+        m_out->Print( 0, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<%s", aName );
+    }
+
+    m_elements.push_back( { aName, false, false } );
+}
+
+
+void XNODE_WRITER::AddAttribute( const char* aName, const wxString& aValue )
+{
+    wxCHECK_RET( !m_elements.empty() && !m_elements.back().m_hasChildren,
+                 "Attributes must be added before the children" );
+
+    if( m_format == SEXPR )
+        m_out->Print( 0, " (%s %s)", aName, m_out->Quotew( aValue ).c_str() );
+    else
+        m_out->Print( 0, " %s=\"%s\"", aName, escape( aValue, true ).c_str() );
+}
+
+
+void XNODE_WRITER::EndElement()
+{
+    wxCHECK_RET( !m_elements.empty(), "No element to end" );
+
+    const ELEMENT& element = m_elements.back();
+    int            depth = (int) m_elements.size() - 1;
+
+    if( m_format == SEXPR )
+    {
+        // The line end following the element is written by the next element, if any
+        m_out->Print( 0, ")" );
+    }
+    else if( !element.m_hasChildren )
+    {
+        m_out->Print( 0, "/>" );
+    }
+    else if( element.m_lastChildIsText )
+    {
+        m_out->Print( 0, "</%s>", element.m_name.c_str() );
+    }
+    else
+    {
+        m_out->Print( 0, "\n%*s</%s>", depth * 2, "", element.m_name.c_str() );
+    }
+
+    m_elements.pop_back();
+
+    if( m_format == XML && m_elements.empty() )
+        m_out->Print( 0, "\n" );
+}
+
+
+void XNODE_WRITER::AddText( const wxString& aText )
+{
+    wxCHECK_RET( !m_elements.empty(), "No element to add the text to" );
+
+    if( aText.IsEmpty() )
+        return;
+
+    ELEMENT& element = m_elements.back();
+
+    if( m_format == SEXPR )
+        m_out->Print( 0, " %s", m_out->Quotew( aText ).c_str() );
+    else
+        m_out->Print( 0, "%s%s", element.m_hasChildren ? "" : ">",
+                      escape( aText, false ).c_str() );
+
+    element.m_hasChildren = true;
+    element.m_lastChildIsText = true;
+}
+
+
+void XNODE_WRITER::AddElement( const char* aName, const wxString& aText )
+{
+    StartElement( aName );
+    AddText( aText );
+    EndElement();
+}
+
+
+std::string XNODE_WRITER::escape( const wxString& aText, bool aAttribute ) const
+{
+    // The UTF8 multibyte sequences have no ASCII bytes: the special characters can be
+    // replaced in the UTF8 string
+    std::string text = TO_UTF8( aText );
+    std::string escaped;
+
+    escaped.reserve( text.size() );
+
+    for( char c : text )
+    {
+        switch( c )
+        {
+        case '<':  escaped += "&lt;";  break;
+        case '>':  escaped += "&gt;";  break;
+        case '&':  escaped += "&amp;"; break;
+        case '\r': escaped += "&#xD;"; break;
+        case '"':  escaped += aAttribute ? "&quot;" : "\""; break;
+        case '\t': escaped += aAttribute ? "&#x9;" : "\t";  break;
+        case '\n': escaped += aAttribute ? "&#xA;" : "\n";  break;
+        default:   escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
 // EOF
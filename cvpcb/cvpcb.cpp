@@ -30,6 +30,7 @@
 #include <confirm.h>
 #include <fp_lib_table.h>
 #include <kiface_i.h>
+#include <lib_table_preloader.h>
 #include <pgm_base.h>
 #include <settings/settings_manager.h>
 
@@ -171,6 +172,10 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         return false;
     }
 
+    // Load the libraries of the global table in the background
+    if( aProgram->GetLibraryPreloader() )
+        aProgram->GetLibraryPreloader()->Preload( &GFootprintTable );
+
     return true;
 }
 
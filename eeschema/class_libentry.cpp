@@ -50,17 +50,23 @@ int LIB_PART::m_subpartFirstId = 'A';
 
 
 wxString LIB_PART::GetSearchText()
+{
+    return BuildSearchText( GetKeyWords(), GetDescription(), GetFootprintField().GetText() );
+}
+
+
+wxString LIB_PART::BuildSearchText( const wxString& aKeyWords, const wxString& aDescription,
+                                    const wxString& aFootprint )
 {
     // Matches are scored by offset from front of string, so inclusion of this spacer
     // discounts matches found after it.
     static const wxString discount( wxT( "        " ) );
 
-    wxString  text = GetKeyWords() + discount + GetDescription();
-    wxString  footprint = GetFootprintField().GetText();
+    wxString  text = aKeyWords + discount + aDescription;
 
-    if( !footprint.IsEmpty() )
+    if( !aFootprint.IsEmpty() )
     {
-        text += discount + footprint;
+        text += discount + aFootprint;
     }
 
     return text;
@@ -183,6 +183,12 @@ public:
 
     wxString GetSearchText() override;
 
+    /**
+     * Build the text searched in the symbol tree for a symbol.
+     */
+    static wxString BuildSearchText( const wxString& aKeyWords, const wxString& aDescription,
+                                     const wxString& aFootprint );
+
     /**
      * For symbols derived from other symbols, IsRoot() indicates no derivation.
      */
@@ -32,6 +32,9 @@
 
 #include <wx/regex.h>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
 #include <vector>
 #include <unordered_set>
 
@@ -289,6 +292,99 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
     int LastReferenceNumber = 0;
     int NumberOfUnits, Unit;
 
+    /* The searches in the list (the numbers in use, the units already annotated, the
+     * components to annotate with the other units of a multi-unit component and the
+     * components of an instance) use indexes of the list, updated when a component is
+     * annotated, instead of scanning the whole list for each component.
+     * The result is the same as the one of the scans.
+     */
+    struct PREFIX_INDEX
+    {
+        std::map<int, int>                 m_Numbers;  ///< reference numbers -> use count
+        std::map<std::pair<int, int>, int> m_Units;    ///< (number, unit) -> count, for the
+                                                       ///< annotated components
+    };
+
+    typedef std::tuple<std::string, wxString, std::string, KIID_PATH> UNIT_CANDIDATE_KEY;
+    typedef std::pair<SCH_COMPONENT*, KIID_PATH>                     INSTANCE_KEY;
+
+    std::map<std::string, PREFIX_INDEX>                   prefixIndexes;
+    std::map<UNIT_CANDIDATE_KEY, std::set<unsigned>>      unitCandidates;
+    std::map<INSTANCE_KEY, std::vector<unsigned>>         instances;
+    std::map<INSTANCE_KEY, SCH_REFERENCE_LIST*>           lockedLists;
+
+    std::vector<PREFIX_INDEX*>       refPrefixIndex( flatList.size() );
+    std::vector<std::set<unsigned>*> refUnitCandidates( flatList.size() );
+    std::vector<INSTANCE_KEY>        refInstance( flatList.size() );
+
+    auto instanceKey =
+            []( const SCH_REFERENCE& aRef )
+            {
+                return INSTANCE_KEY( aRef.GetComp(), aRef.GetSheetPath().Path() );
+            };
+
+    // Add a component to the indexes
+    auto addToIndex =
+            [&]( unsigned aIndex )
+            {
+                SCH_REFERENCE& ref = flatList[aIndex];
+                PREFIX_INDEX*  prefixIndex = refPrefixIndex[aIndex];
+
+                prefixIndex->m_Numbers[ref.m_NumRef]++;
+
+                if( !ref.m_IsNew )
+                    prefixIndex->m_Units[std::make_pair( ref.m_NumRef, ref.m_Unit )]++;
+
+                if( !ref.m_Flag && ref.m_IsNew )
+                    refUnitCandidates[aIndex]->insert( aIndex );
+            };
+
+    // Remove a component from the indexes, before the change of its annotation
+    auto removeFromIndex =
+            [&]( unsigned aIndex )
+            {
+                SCH_REFERENCE& ref = flatList[aIndex];
+                PREFIX_INDEX*  prefixIndex = refPrefixIndex[aIndex];
+
+                auto number = prefixIndex->m_Numbers.find( ref.m_NumRef );
+
+                if( --number->second == 0 )
+                    prefixIndex->m_Numbers.erase( number );
+
+                if( !ref.m_IsNew )
+                {
+                    auto unit = prefixIndex->m_Units.find( std::make_pair( ref.m_NumRef,
+                                                                           ref.m_Unit ) );
+
+                    if( --unit->second == 0 )
+                        prefixIndex->m_Units.erase( unit );
+                }
+
+                refUnitCandidates[aIndex]->erase( aIndex );
+            };
+
+    for( unsigned ii = 0; ii < flatList.size(); ii++ )
+    {
+        SCH_REFERENCE&     ref = flatList[ii];
+        const std::string& prefix = ref.m_Ref;
+        const std::string& libName = ref.m_RootCmp->GetLibId().GetLibItemName();
+
+        refPrefixIndex[ii] = &prefixIndexes[prefix];
+        refUnitCandidates[ii] = &unitCandidates[UNIT_CANDIDATE_KEY( prefix, ref.m_Value, libName,
+                aUseSheetNum ? ref.GetSheetPath().Path() : KIID_PATH() )];
+        refInstance[ii] = instanceKey( ref );
+        instances[refInstance[ii]].push_back( ii );
+
+        addToIndex( ii );
+    }
+
+    // The locked list of a component is the first one of aLockedUnitMap which contains it
+    for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+    {
+        for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+            lockedLists.emplace( instanceKey( pair.second[thisRefI] ), &pair.second );
+    }
+
     /* calculate index of the first component with the same reference prefix
      * than the current component.  All components having the same reference
      * prefix will receive a reference number with consecutive values:
@@ -319,8 +415,43 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
     // This is the list of all Id already in use for a given reference prefix.
     // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    std::vector<int> idList;
+
+    // The ids are only added to the list of a reference prefix, so the first free id is
+    // searched from the previous one (nextId), instead of from minRefId.
+    size_t idPos = 0;
+    int    nextId = minRefId;
+
+    auto getRefsInUse =
+            [&]( unsigned aIndex )
+            {
+                const std::map<int, int>& numbers = refPrefixIndex[aIndex]->m_Numbers;
+
+                idList.clear();
+
+                for( auto it = numbers.lower_bound( minRefId ); it != numbers.end(); ++it )
+                    idList.push_back( it->first );
+
+                idPos = 0;
+                nextId = minRefId;
+            };
+
+    auto createFirstFreeRefId =
+            [&]()
+            {
+                while( idPos < idList.size() && idList[idPos] < nextId )
+                    idPos++;
+
+                while( idPos < idList.size() && idList[idPos] == nextId )
+                {
+                    idPos++;
+                    nextId++;
+                }
+
+                return nextId++;
+            };
+
+    getRefsInUse( first );
 
     for( unsigned ii = 0; ii < flatList.size(); ii++ )
     {
@@ -331,22 +462,10 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
-
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+        auto                locked = lockedLists.find( refInstance[ii] );
 
-                if( thisRef.IsSameInstance( ref_unit ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
-        }
+        if( locked != lockedLists.end() )
+            lockedList = locked->second;
 
         if(  ( flatList[first].CompareRef( ref_unit ) != 0 )
           || ( aUseSheetNum && ( flatList[first].m_SheetNum != ref_unit.m_SheetNum ) )  )
@@ -360,21 +479,24 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             else
                 minRefId = aStartNumber + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            getRefsInUse( first );
         }
 
+        removeFromIndex( ii );
+
         // Annotation of one part per package components (trivial case).
         if( ref_unit.GetLibPart()->GetUnitCount() <= 1 )
         {
             if( ref_unit.m_IsNew )
             {
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = createFirstFreeRefId();
                 ref_unit.m_NumRef = LastReferenceNumber;
             }
 
             ref_unit.m_Unit  = 1;
             ref_unit.m_Flag  = 1;
             ref_unit.m_IsNew = false;
+            addToIndex( ii );
             continue;
         }
 
@@ -383,7 +505,7 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
 
         if( ref_unit.m_IsNew )
         {
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = createFirstFreeRefId();
             ref_unit.m_NumRef = LastReferenceNumber;
 
             if( !ref_unit.IsUnitsLocked() )
@@ -401,8 +523,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
             for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
             {
                 SCH_REFERENCE &thisRef = (*lockedList)[thisRefI];
+                INSTANCE_KEY   thisInstance = instanceKey( thisRef );
 
-                if( thisRef.IsSameInstance( ref_unit ) )
+                if( thisInstance == refInstance[ii] )
                 {
                     // This is the component we're currently annotating. Hold the unit!
                     ref_unit.m_Unit = thisRef.m_Unit;
@@ -416,12 +539,17 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( thisRef.CompareLibName( ref_unit ) != 0 )
                     continue;
 
+                auto instance = instances.find( thisInstance );
+
+                if( instance == instances.end() )
+                    continue;
+
+                const std::vector<unsigned>& instanceRefs = instance->second;
+
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                for( auto jj = std::upper_bound( instanceRefs.begin(), instanceRefs.end(), ii );
+                     jj != instanceRefs.end(); ++jj )
                 {
-                    if( ! thisRef.IsSameInstance( flatList[jj] ) )
-                        continue;
-
                     wxString ref_candidate = buildFullReference( ref_unit, thisRef.m_Unit );
 
                     // propagate the new reference and unit selection to the "old" component,
@@ -429,19 +557,28 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                     // multiunits components have duplicate references)
                     if( inUseRefs.find( ref_candidate ) == inUseRefs.end() )
                     {
-                        flatList[jj].m_NumRef = ref_unit.m_NumRef;
-                        flatList[jj].m_Unit = thisRef.m_Unit;
-                        flatList[jj].m_IsNew = false;
-                        flatList[jj].m_Flag = 1;
+                        removeFromIndex( *jj );
+                        flatList[*jj].m_NumRef = ref_unit.m_NumRef;
+                        flatList[*jj].m_Unit = thisRef.m_Unit;
+                        flatList[*jj].m_IsNew = false;
+                        flatList[*jj].m_Flag = 1;
+                        addToIndex( *jj );
                         // lock this new full reference
                         inUseRefs.insert( ref_candidate );
                         break;
                     }
                 }
             }
+
+            addToIndex( ii );
         }
         else
         {
+            addToIndex( ii );
+
+            const PREFIX_INDEX&       prefixIndex = *refPrefixIndex[ii];
+            const std::set<unsigned>& candidates = *refUnitCandidates[ii];
+
             /* search for others units of this component.
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
@@ -451,43 +588,25 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId, int
                 if( ref_unit.m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
-
-                if( found >= 0 )
+                if( prefixIndex.m_Units.count( std::make_pair( ref_unit.m_NumRef, Unit ) ) )
                     continue; // this unit exists for this reference (unit already annotated)
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < flatList.size(); jj++ )
+                for( auto it = candidates.upper_bound( ii ); it != candidates.end(); ++it )
                 {
-                    auto& cmp_unit = flatList[jj];
-
-                    if( cmp_unit.m_Flag )    // already tested
-                        continue;
-
-                    if( cmp_unit.CompareRef( ref_unit ) != 0 )
-                        continue;
-
-                    if( cmp_unit.CompareValue( ref_unit ) != 0 )
-                        continue;
-
-                    if( cmp_unit.CompareLibName( ref_unit ) != 0 )
-                        continue;
-
-                    if( aUseSheetNum &&
-                            cmp_unit.GetSheetPath().Cmp( ref_unit.GetSheetPath() ) != 0 )
-                        continue;
-
-                    if( !cmp_unit.m_IsNew )
-                        continue;
+                    unsigned jj = *it;
+                    auto&    cmp_unit = flatList[jj];
 
                     // Component without reference number found, annotate it if possible
                     if( !cmp_unit.IsUnitsLocked()
                         || ( cmp_unit.m_Unit == Unit ) )
                     {
+                        removeFromIndex( jj );
                         cmp_unit.m_NumRef = ref_unit.m_NumRef;
                         cmp_unit.m_Unit   = Unit;
                         cmp_unit.m_Flag   = 1;
                         cmp_unit.m_IsNew  = false;
+                        addToIndex( jj );
                         break;
                     }
                 }
@@ -31,6 +31,7 @@
 #include <confirm.h>
 #include <bitmaps.h>
 #include <lib_table_grid.h>
+#include <lib_table_preloader.h>
 #include <wildcards_and_files_ext.h>
 #include <env_paths.h>
 #include <eeschema_id.h>
@@ -714,6 +715,9 @@ bool PANEL_SYM_LIB_TABLE::TransferDataFromWindow()
         m_globalTable->rows.transfer( m_globalTable->rows.end(), global_model()->rows.begin(),
                                       global_model()->rows.end(), global_model()->rows );
         m_globalTable->reindex();
+
+        if( Pgm().GetLibraryPreloader() )
+            Pgm().GetLibraryPreloader()->Preload( m_globalTable );
     }
 
     if( project_model() && *project_model() != *m_projectTable )
@@ -724,6 +728,9 @@ bool PANEL_SYM_LIB_TABLE::TransferDataFromWindow()
         m_projectTable->rows.transfer( m_projectTable->rows.end(), project_model()->rows.begin(),
                                        project_model()->rows.end(), project_model()->rows );
         m_projectTable->reindex();
+
+        if( Pgm().GetLibraryPreloader() )
+            Pgm().GetLibraryPreloader()->Preload( m_projectTable );
     }
 
     return true;
@@ -34,9 +34,11 @@
 #include <lib_view_frame.h>
 #include <transform.h>
 #include <symbol_lib_table.h>
+#include <template_fieldnames.h>
 #include <dialogs/dialog_global_sym_lib_table_config.h>
 #include <dialogs/panel_sym_lib_table.h>
 #include <kiway.h>
+#include <lib_table_preloader.h>
 #include <sim/sim_plot_frame.h>
 #include <settings/settings_manager.h>
 #include <sexpr/sexpr.h>
@@ -44,6 +46,7 @@
 #include <kiface_ids.h>
 #include <netlist_exporters/netlist_exporter_kicad.h>
 
+#include <sch_sheet.h>
 #include <schematic.h>
 #include <connection_graph.h>
 
@@ -272,6 +275,16 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         }
     }
 
+    // Load the libraries of the global table in the background.  The translated default field
+    // names are cached on their first use: cache them here, in the main thread, before the
+    // symbols loaded by the preloader threads use them.
+    if( aProgram->GetLibraryPreloader() )
+    {
+        TEMPLATE_FIELDNAME::GetDefaultFieldName( REFERENCE );
+        SCH_SHEET::GetDefaultFieldName( SHEETNAME );
+        aProgram->GetLibraryPreloader()->Preload( &SYMBOL_LIB_TABLE::GetGlobalLibTable() );
+    }
+
     return true;
 }
 
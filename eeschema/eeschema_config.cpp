@@ -33,6 +33,7 @@
 #include <eeschema_config.h>
 #include <erc_settings.h>
 #include <kiway.h>
+#include <lib_table_preloader.h>
 #include <symbol_edit_frame.h>
 #include <panel_gal_display_options.h>
 #include <panel_hotkeys_editor.h>
@@ -438,6 +439,9 @@ SYMBOL_LIB_TABLE* PROJECT::SchSymbolLibTable()
                 DisplayErrorMessage( NULL, msg, ioe.What() );
             }
         }
+
+        if( Pgm().GetLibraryPreloader() )
+            Pgm().GetLibraryPreloader()->Preload( tbl );
     }
 
     return tbl;
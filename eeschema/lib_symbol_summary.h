@@ -0,0 +1,83 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIB_SYMBOL_SUMMARY_H
+#define LIB_SYMBOL_SUMMARY_H
+
+#include <class_libentry.h>
+#include <lib_tree_item.h>
+
+
+/**
+ * The properties of a library symbol shown in the symbol tree.
+ *
+ * The plugins can provide them without parsing the symbols, see
+ * SCH_PLUGIN::EnumerateSymbolSummaries().
+ */
+class LIB_SYMBOL_SUMMARY : public LIB_TREE_ITEM
+{
+public:
+    LIB_SYMBOL_SUMMARY( const wxString& aName, const wxString& aDescription,
+                        const wxString& aSearchText, bool aIsRoot, int aUnitCount ) :
+            m_libId( wxEmptyString, aName ),
+            m_description( aDescription ),
+            m_searchText( aSearchText ),
+            m_isRoot( aIsRoot ),
+            m_unitCount( aUnitCount )
+    {
+    }
+
+    explicit LIB_SYMBOL_SUMMARY( LIB_PART* aPart ) :
+            m_libId( aPart->GetLibId() ),
+            m_description( aPart->GetDescription() ),
+            m_searchText( aPart->GetSearchText() ),
+            m_isRoot( aPart->IsRoot() ),
+            m_unitCount( aPart->GetUnitCount() )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return m_libId; }
+
+    wxString GetName() const override { return m_libId.GetLibItemName(); }
+    wxString GetLibNickname() const override { return m_libId.GetLibNickname(); }
+
+    void SetLibNickname( const wxString& aNickname ) { m_libId.SetLibNickname( aNickname ); }
+
+    wxString GetDescription() override { return m_description; }
+
+    wxString GetSearchText() override { return m_searchText; }
+
+    bool IsRoot() const override { return m_isRoot; }
+
+    int GetUnitCount() const override { return m_unitCount; }
+
+    wxString GetUnitReference( int aUnit ) override
+    {
+        return LIB_PART::SubReference( aUnit, false );
+    }
+
+private:
+    LIB_ID   m_libId;
+    wxString m_description;
+    wxString m_searchText;
+    bool     m_isRoot;
+    int      m_unitCount;
+};
+
+#endif // LIB_SYMBOL_SUMMARY_H
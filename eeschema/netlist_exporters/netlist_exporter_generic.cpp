@@ -41,38 +41,48 @@ bool NETLIST_EXPORTER_GENERIC::WriteNetlist( const wxString& aOutFileName,
                                              unsigned aNetlistOptions )
 {
     // output the XML format netlist.
-    wxXmlDocument   xdoc;
+    try
+    {
+        // Binary mode, to write the line ends of wxXmlDocument::Save()
+        FILE_OUTPUTFORMATTER formatter( aOutFileName, wxT( "wb" ) );
+        XNODE_WRITER         writer( &formatter, XNODE_WRITER::XML );
 
-    xdoc.SetRoot( makeRoot( GNL_ALL | aNetlistOptions ) );
+        writeRoot( writer, GNL_ALL | aNetlistOptions );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
 
-    return xdoc.Save( aOutFileName, 2 /* indent bug, today was ignored by wxXml lib */ );
+    return true;
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeRoot( unsigned aCtl )
+void NETLIST_EXPORTER_GENERIC::writeRoot( XNODE_WRITER& aWriter, unsigned aCtl )
 {
-    XNODE*      xroot = node( "export" );
+    m_sheetList = m_schematic->GetSheets();
 
-    xroot->AddAttribute( "version", "D" );
+    aWriter.StartElement( "export" );
+    aWriter.AddAttribute( "version", "D" );
 
     if( aCtl & GNL_HEADER )
-        // add the "design" header
-        xroot->AddChild( makeDesignHeader() );
+        // write the "design" header
+        writeDesignHeader( aWriter );
 
     if( aCtl & GNL_COMPONENTS )
-        xroot->AddChild( makeComponents( aCtl ) );
+        writeComponents( aWriter, aCtl );
 
     if( aCtl & GNL_PARTS )
-        xroot->AddChild( makeLibParts() );
+        writeLibParts( aWriter );
 
     if( aCtl & GNL_LIBRARIES )
-        // must follow makeGenericLibParts()
-        xroot->AddChild( makeLibraries() );
+        // must follow writeLibParts()
+        writeLibraries( aWriter );
 
     if( aCtl & GNL_NETS )
-        xroot->AddChild( makeListOfNets( aCtl ) );
+        writeListOfNets( aWriter, aCtl );
 
-    return xroot;
+    aWriter.EndElement();
 }
 
 
@@ -87,8 +97,8 @@ struct COMP_FIELDS
 };
 
 
-void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT* comp,
-                                                   SCH_SHEET_PATH* aSheet )
+void NETLIST_EXPORTER_GENERIC::writeComponentFields( XNODE_WRITER& aWriter, SCH_COMPONENT* comp,
+                                                     SCH_SHEET_PATH* aSheet )
 {
     COMP_FIELDS fields;
 
@@ -103,68 +113,61 @@ void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT*
 
         wxString    ref = comp->GetRef( aSheet );
 
-        SCH_SHEET_LIST sheetList = m_schematic->GetSheets();
         int minUnit = comp->GetUnit();
 
-        for( unsigned i = 0;  i < sheetList.size();  i++ )
+        // The units are the components of the same reference, in the order of the sheets
+        for( const std::pair<SCH_COMPONENT*, SCH_SHEET_PATH*>& unitItem : m_units[ ref.Lower() ] )
         {
-            for( auto item : sheetList[i].LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
-            {
-                SCH_COMPONENT*  comp2 = (SCH_COMPONENT*) item;
+            SCH_COMPONENT*  comp2 = unitItem.first;
+            SCH_SHEET_PATH* sheet = unitItem.second;
 
-                wxString ref2 = comp2->GetRef( &sheetList[i] );
+            int unit = comp2->GetUnit();
 
-                if( ref2.CmpNoCase( ref ) != 0 )
-                    continue;
+            // The lowest unit number wins.  User should only set fields in any one unit.
+            // remark: IsVoid() returns true for empty strings or the "~" string (empty
+            // field value)
+            if( !comp2->GetValue( sheet ).IsEmpty()
+                    && ( unit < minUnit || fields.value.IsEmpty() ) )
+            {
+                if( m_resolveTextVars )
+                    fields.value = comp2->GetValue( sheet );
+                else
+                    fields.value = comp2->GetField( VALUE )->GetText();
+            }
 
-                int unit = comp2->GetUnit();
+            if( !comp2->GetFootprint( sheet ).IsEmpty()
+                    && ( unit < minUnit || fields.footprint.IsEmpty() ) )
+            {
+                if( m_resolveTextVars )
+                    fields.footprint = comp2->GetFootprint( sheet );
+                else
+                    fields.footprint = comp2->GetField( FOOTPRINT )->GetText();
+            }
 
-                // The lowest unit number wins.  User should only set fields in any one unit.
-                // remark: IsVoid() returns true for empty strings or the "~" string (empty
-                // field value)
-                if( !comp2->GetValue( &sheetList[i] ).IsEmpty()
-                        && ( unit < minUnit || fields.value.IsEmpty() ) )
-                {
-                    if( m_resolveTextVars )
-                        fields.value = comp2->GetValue( &sheetList[i] );
-                    else
-                        fields.value = comp2->GetField( VALUE )->GetText();
-                }
+            if( !comp2->GetField( DATASHEET )->IsVoid()
+                    && ( unit < minUnit || fields.datasheet.IsEmpty() ) )
+            {
+                if( m_resolveTextVars )
+                    fields.datasheet = comp2->GetField( DATASHEET )->GetShownText();
+                else
+                    fields.datasheet = comp2->GetField( DATASHEET )->GetText();
+            }
 
-                if( !comp2->GetFootprint( &sheetList[i] ).IsEmpty()
-                        && ( unit < minUnit || fields.footprint.IsEmpty() ) )
-                {
-                    if( m_resolveTextVars )
-                        fields.footprint = comp2->GetFootprint( &sheetList[i] );
-                    else
-                        fields.footprint = comp2->GetField( FOOTPRINT )->GetText();
-                }
+            for( int fldNdx = MANDATORY_FIELDS;  fldNdx < comp2->GetFieldCount();  ++fldNdx )
+            {
+                SCH_FIELD* f = comp2->GetField( fldNdx );
 
-                if( !comp2->GetField( DATASHEET )->IsVoid()
-                        && ( unit < minUnit || fields.datasheet.IsEmpty() ) )
+                if( f->GetText().size()
+                    && ( unit < minUnit || fields.f.count( f->GetName() ) == 0 ) )
                 {
                     if( m_resolveTextVars )
-                        fields.datasheet = comp2->GetField( DATASHEET )->GetShownText();
+                        fields.f[ f->GetName() ] = f->GetShownText();
                     else
-                        fields.datasheet = comp2->GetField( DATASHEET )->GetText();
-                }
-
-                for( int fldNdx = MANDATORY_FIELDS;  fldNdx < comp2->GetFieldCount();  ++fldNdx )
-                {
-                    SCH_FIELD* f = comp2->GetField( fldNdx );
-
-                    if( f->GetText().size()
-                        && ( unit < minUnit || fields.f.count( f->GetName() ) == 0 ) )
-                    {
-                        if( m_resolveTextVars )
-                            fields.f[ f->GetName() ] = f->GetShownText();
-                        else
-                            fields.f[ f->GetName() ] = f->GetText();
-                    }
+                        fields.f[ f->GetName() ] = f->GetText();
                 }
-
-                minUnit = std::min( unit, minUnit );
             }
+
+            minUnit = std::min( unit, minUnit );
         }
     }
     else
@@ -200,50 +203,63 @@ void NETLIST_EXPORTER_GENERIC::addComponentFields( XNODE* xcomp, SCH_COMPONENT*
 
     // Do not output field values blank in netlist:
     if( fields.value.size() )
-        xcomp->AddChild( node( "value", fields.value ) );
+        aWriter.AddElement( "value", fields.value );
     else    // value field always written in netlist
-        xcomp->AddChild( node( "value", "~" ) );
+        aWriter.AddElement( "value", "~" );
 
     if( fields.footprint.size() )
-        xcomp->AddChild( node( "footprint", fields.footprint ) );
+        aWriter.AddElement( "footprint", fields.footprint );
 
     if( fields.datasheet.size() )
-        xcomp->AddChild( node( "datasheet", fields.datasheet ) );
+        aWriter.AddElement( "datasheet", fields.datasheet );
 
     if( fields.f.size() )
     {
-        XNODE* xfields;
-        xcomp->AddChild( xfields = node( "fields" ) );
+        aWriter.StartElement( "fields" );
 
         // non MANDATORY fields are output alphabetically
         for( std::map< wxString, wxString >::const_iterator it = fields.f.begin();
              it != fields.f.end();  ++it )
         {
-            XNODE*  xfield;
-            xfields->AddChild( xfield = node( "field", it->second ) );
-            xfield->AddAttribute( "name", it->first );
+            aWriter.StartElement( "field" );
+            aWriter.AddAttribute( "name", it->first );
+            aWriter.AddText( it->second );
+            aWriter.EndElement();
         }
+
+        aWriter.EndElement();
     }
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeComponents( unsigned aCtl )
+void NETLIST_EXPORTER_GENERIC::writeComponents( XNODE_WRITER& aWriter, unsigned aCtl )
 {
-    XNODE* xcomps = node( "components" );
+    aWriter.StartElement( "components" );
 
     m_ReferencesAlreadyFound.Clear();
     m_LibParts.clear();
+    m_units.clear();
 
-    SCH_SHEET_LIST sheetList = m_schematic->GetSheets();
+    // Index the units of the components once, rather than searching the whole schematic for
+    // each multi-unit component
+    for( SCH_SHEET_PATH& sheet : m_sheetList )
+    {
+        for( SCH_ITEM* item : sheet.LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
+        {
+            SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( item );
+
+            m_units[ comp->GetRef( &sheet ).Lower() ].emplace_back( comp, &sheet );
+        }
+    }
 
     // Output is xml, so there is no reason to remove spaces from the field values.
     // And XML element names need not be translated to various languages.
 
-    for( unsigned ii = 0; ii < sheetList.size(); ii++ )
+    for( unsigned ii = 0; ii < m_sheetList.size(); ii++ )
     {
-        SCH_SHEET_PATH sheet = sheetList[ii];
+        SCH_SHEET_PATH& sheet = m_sheetList[ii];
 
-        auto cmp = [sheet]( SCH_COMPONENT* a, SCH_COMPONENT* b )
+        auto cmp = [&sheet]( SCH_COMPONENT* a, SCH_COMPONENT* b )
                    {
                        return ( UTIL::RefDesStringCompare( a->GetRef( &sheet ),
                                                            b->GetRef( &sheet ) ) < 0 );
@@ -251,7 +267,7 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents( unsigned aCtl )
 
         std::set<SCH_COMPONENT*, decltype( cmp )> ordered_components( cmp );
 
-        for( SCH_ITEM* item : sheetList[ii].LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
+        for( SCH_ITEM* item : sheet.LastScreen()->Items().OfType( SCH_COMPONENT_T ) )
         {
             SCH_COMPONENT* comp = static_cast<SCH_COMPONENT*>( item );
             auto           test = ordered_components.insert( comp );
@@ -282,203 +298,176 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeComponents( unsigned aCtl )
             // under XSL processing systems which do sequential searching within
             // an element.
 
-            XNODE* xcomp;  // current component being constructed
-            xcomps->AddChild( xcomp = node( "comp" ) );
-
-            xcomp->AddAttribute( "ref", comp->GetRef( &sheet ) );
-            addComponentFields( xcomp, comp, &sheetList[ii] );
+            aWriter.StartElement( "comp" );
+            aWriter.AddAttribute( "ref", comp->GetRef( &sheet ) );
+            writeComponentFields( aWriter, comp, &sheet );
 
-            XNODE*  xlibsource;
-            xcomp->AddChild( xlibsource = node( "libsource" ) );
+            aWriter.StartElement( "libsource" );
 
             // "logical" library name, which is in anticipation of a better search
             // algorithm for parts based on "logical_lib.part" and where logical_lib
             // is merely the library name minus path and extension.
             if( comp->GetPartRef() )
-                xlibsource->AddAttribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
+                aWriter.AddAttribute( "lib", comp->GetPartRef()->GetLibId().GetLibNickname() );
 
             // We only want the symbol name, not the full LIB_ID.
-            xlibsource->AddAttribute( "part", comp->GetLibId().GetLibItemName() );
-
-            xlibsource->AddAttribute( "description", comp->GetDescription() );
+            aWriter.AddAttribute( "part", comp->GetLibId().GetLibItemName() );
 
-            XNODE* xproperty;
+            aWriter.AddAttribute( "description", comp->GetDescription() );
+            aWriter.EndElement();
 
             std::vector<SCH_FIELD>& fields = comp->GetFields();
 
             for( size_t jj = MANDATORY_FIELDS; jj < fields.size(); ++jj )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", fields[jj].GetName() );
-                xproperty->AddAttribute( "value", fields[jj].GetText() );
+                aWriter.StartElement( "property" );
+                aWriter.AddAttribute( "name", fields[jj].GetName() );
+                aWriter.AddAttribute( "value", fields[jj].GetText() );
+                aWriter.EndElement();
             }
 
             for( const SCH_FIELD& sheetField : sheet.Last()->GetFields() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", sheetField.GetName() );
-                xproperty->AddAttribute( "value", sheetField.GetText() );
+                aWriter.StartElement( "property" );
+                aWriter.AddAttribute( "name", sheetField.GetName() );
+                aWriter.AddAttribute( "value", sheetField.GetText() );
+                aWriter.EndElement();
             }
 
             if( !comp->GetIncludeInBom() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", "exclude_from_bom" );
+                aWriter.StartElement( "property" );
+                aWriter.AddAttribute( "name", "exclude_from_bom" );
+                aWriter.EndElement();
             }
 
             if( !comp->GetIncludeOnBoard() )
             {
-                xcomp->AddChild( xproperty = node( "property" ) );
-                xproperty->AddAttribute( "name", "exclude_from_board" );
+                aWriter.StartElement( "property" );
+                aWriter.AddAttribute( "name", "exclude_from_board" );
+                aWriter.EndElement();
             }
 
-            XNODE* xsheetpath;
-            xcomp->AddChild( xsheetpath = node( "sheetpath" ) );
+            aWriter.StartElement( "sheetpath" );
+            aWriter.AddAttribute( "names", sheet.PathHumanReadable() );
+            aWriter.AddAttribute( "tstamps", sheet.PathAsString() );
+            aWriter.EndElement();
 
-            xsheetpath->AddAttribute( "names", sheet.PathHumanReadable() );
-            xsheetpath->AddAttribute( "tstamps", sheet.PathAsString() );
-            xcomp->AddChild( node( "tstamp", comp->m_Uuid.AsString() ) );
+            aWriter.AddElement( "tstamp", comp->m_Uuid.AsString() );
+            aWriter.EndElement();
         }
     }
 
-    return xcomps;
+    m_units.clear();
+
+    aWriter.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeDesignHeader()
+void NETLIST_EXPORTER_GENERIC::writeDesignHeader( XNODE_WRITER& aWriter )
 {
     SCH_SCREEN* screen;
-    XNODE*      xdesign = node( "design" );
-    XNODE*      xtitleBlock;
-    XNODE*      xsheet;
-    XNODE*      xcomment;
-    XNODE*      xtextvar;
-    wxString    sheetTxt;
     wxFileName  sourceFileName;
 
+    aWriter.StartElement( "design" );
+
     // the root sheet is a special sheet, call it source
-    xdesign->AddChild( node( "source", m_schematic->GetFileName() ) );
+    aWriter.AddElement( "source", m_schematic->GetFileName() );
 
-    xdesign->AddChild( node( "date", DateAndTime() ) );
+    aWriter.AddElement( "date", DateAndTime() );
 
     // which Eeschema tool
-    xdesign->AddChild( node( "tool", wxString( "Eeschema " ) + GetBuildVersion() ) );
+    aWriter.AddElement( "tool", wxString( "Eeschema " ) + GetBuildVersion() );
 
     const std::map<wxString, wxString>& properties = m_schematic->Prj().GetTextVars();
 
     for( const std::pair<const wxString, wxString>& prop : properties )
     {
-        xdesign->AddChild( xtextvar = node( "textvar", prop.second ) );
-        xtextvar->AddAttribute( "name", prop.first );
+        aWriter.StartElement( "textvar" );
+        aWriter.AddAttribute( "name", prop.first );
+        aWriter.AddText( prop.second );
+        aWriter.EndElement();
     }
 
     /*
      *  Export the sheets information
      */
-    SCH_SHEET_LIST sheetList = m_schematic->GetSheets();
-
-    for( unsigned i = 0;  i < sheetList.size();  i++ )
+    for( unsigned i = 0;  i < m_sheetList.size();  i++ )
     {
-        screen = sheetList[i].LastScreen();
+        screen = m_sheetList[i].LastScreen();
 
-        xdesign->AddChild( xsheet = node( "sheet" ) );
+        aWriter.StartElement( "sheet" );
 
         // get the string representation of the sheet index number.
         // Note that sheet->GetIndex() is zero index base and we need to increment the
         // number by one to make it human readable
-        sheetTxt.Printf( "%u", i + 1 );
-        xsheet->AddAttribute( "number", sheetTxt );
-        xsheet->AddAttribute( "name", sheetList[i].PathHumanReadable() );
-        xsheet->AddAttribute( "tstamps", sheetList[i].PathAsString() );
-
+        aWriter.AddAttribute( "number", wxString::Format( "%u", i + 1 ) );
+        aWriter.AddAttribute( "name", m_sheetList[i].PathHumanReadable() );
+        aWriter.AddAttribute( "tstamps", m_sheetList[i].PathAsString() );
 
-        TITLE_BLOCK tb = screen->GetTitleBlock();
+        const TITLE_BLOCK& tb = screen->GetTitleBlock();
 
-        xsheet->AddChild( xtitleBlock = node( "title_block" ) );
+        aWriter.StartElement( "title_block" );
 
-        xtitleBlock->AddChild( node( "title", tb.GetTitle() ) );
-        xtitleBlock->AddChild( node( "company", tb.GetCompany() ) );
-        xtitleBlock->AddChild( node( "rev", tb.GetRevision() ) );
-        xtitleBlock->AddChild( node( "date", tb.GetDate() ) );
+        aWriter.AddElement( "title", tb.GetTitle() );
+        aWriter.AddElement( "company", tb.GetCompany() );
+        aWriter.AddElement( "rev", tb.GetRevision() );
+        aWriter.AddElement( "date", tb.GetDate() );
 
         // We are going to remove the fileName directories.
         sourceFileName = wxFileName( screen->GetFileName() );
-        xtitleBlock->AddChild( node( "source", sourceFileName.GetFullName() ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "1" );
-        xcomment->AddAttribute( "value", tb.GetComment( 0 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "2" );
-        xcomment->AddAttribute( "value", tb.GetComment( 1 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "3" );
-        xcomment->AddAttribute( "value", tb.GetComment( 2 ) );
+        aWriter.AddElement( "source", sourceFileName.GetFullName() );
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "4" );
-        xcomment->AddAttribute( "value", tb.GetComment( 3 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "5" );
-        xcomment->AddAttribute( "value", tb.GetComment( 4 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "6" );
-        xcomment->AddAttribute( "value", tb.GetComment( 5 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "7" );
-        xcomment->AddAttribute( "value", tb.GetComment( 6 ) );
-
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "8" );
-        xcomment->AddAttribute( "value", tb.GetComment( 7 ) );
+        for( int ii = 0; ii < 9; ii++ )
+        {
+            aWriter.StartElement( "comment" );
+            aWriter.AddAttribute( "number", wxString::Format( "%d", ii + 1 ) );
+            aWriter.AddAttribute( "value", tb.GetComment( ii ) );
+            aWriter.EndElement();
+        }
 
-        xtitleBlock->AddChild( xcomment = node( "comment" ) );
-        xcomment->AddAttribute( "number", "9" );
-        xcomment->AddAttribute( "value", tb.GetComment( 8 ) );
+        aWriter.EndElement();
+        aWriter.EndElement();
     }
 
-    return xdesign;
+    aWriter.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibraries()
+void NETLIST_EXPORTER_GENERIC::writeLibraries( XNODE_WRITER& aWriter )
 {
-    XNODE*            xlibs = node( "libraries" );     // auto_ptr
     SYMBOL_LIB_TABLE* symbolLibTable = m_schematic->Prj().SchSymbolLibTable();
 
+    aWriter.StartElement( "libraries" );
+
     for( std::set<wxString>::iterator it = m_libraries.begin(); it!=m_libraries.end();  ++it )
     {
         wxString    libNickname = *it;
-        XNODE*      xlibrary;
 
         if( symbolLibTable->HasLibrary( libNickname ) )
         {
-            xlibs->AddChild( xlibrary = node( "library" ) );
-            xlibrary->AddAttribute( "logical", libNickname );
-            xlibrary->AddChild( node( "uri", symbolLibTable->GetFullURI( libNickname ) ) );
+            aWriter.StartElement( "library" );
+            aWriter.AddAttribute( "logical", libNickname );
+            aWriter.AddElement( "uri", symbolLibTable->GetFullURI( libNickname ) );
+            aWriter.EndElement();
         }
 
         // @todo: add more fun stuff here
     }
 
-    return xlibs;
+    aWriter.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
+void NETLIST_EXPORTER_GENERIC::writeLibParts( XNODE_WRITER& aWriter )
 {
-    XNODE*      xlibparts = node( "libparts" );   // auto_ptr
-
     LIB_PINS    pinList;
     LIB_FIELDS  fieldList;
 
     m_libraries.clear();
 
+    aWriter.StartElement( "libparts" );
+
     for( auto lcomp : m_LibParts )
     {
         wxString libNickname = lcomp->GetLibId().GetLibNickname();;
@@ -487,47 +476,49 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
         if( !libNickname.IsEmpty() )
             m_libraries.insert( libNickname );  // inserts component's library if unique
 
-        XNODE* xlibpart;
-        xlibparts->AddChild( xlibpart = node( "libpart" ) );
-        xlibpart->AddAttribute( "lib", libNickname );
-        xlibpart->AddAttribute( "part", lcomp->GetName()  );
+        aWriter.StartElement( "libpart" );
+        aWriter.AddAttribute( "lib", libNickname );
+        aWriter.AddAttribute( "part", lcomp->GetName()  );
 
         //----- show the important properties -------------------------
         if( !lcomp->GetDescription().IsEmpty() )
-            xlibpart->AddChild( node( "description", lcomp->GetDescription() ) );
+            aWriter.AddElement( "description", lcomp->GetDescription() );
 
         if( !lcomp->GetDatasheetField().GetText().IsEmpty() )
-            xlibpart->AddChild( node( "docs",  lcomp->GetDatasheetField().GetText() ) );
+            aWriter.AddElement( "docs",  lcomp->GetDatasheetField().GetText() );
 
         // Write the footprint list
         if( lcomp->GetFootprints().GetCount() )
         {
-            XNODE*  xfootprints;
-            xlibpart->AddChild( xfootprints = node( "footprints" ) );
+            aWriter.StartElement( "footprints" );
 
             for( unsigned i=0; i<lcomp->GetFootprints().GetCount(); ++i )
             {
-                xfootprints->AddChild( node( "fp", lcomp->GetFootprints()[i] ) );
+                aWriter.AddElement( "fp", lcomp->GetFootprints()[i] );
             }
+
+            aWriter.EndElement();
         }
 
         //----- show the fields here ----------------------------------
         fieldList.clear();
         lcomp->GetFields( fieldList );
 
-        XNODE*     xfields;
-        xlibpart->AddChild( xfields = node( "fields" ) );
+        aWriter.StartElement( "fields" );
 
         for( unsigned i=0;  i<fieldList.size();  ++i )
         {
             if( !fieldList[i].GetText().IsEmpty() )
             {
-                XNODE*     xfield;
-                xfields->AddChild( xfield = node( "field", fieldList[i].GetText() ) );
-                xfield->AddAttribute( "name", fieldList[i].GetCanonicalName() );
+                aWriter.StartElement( "field" );
+                aWriter.AddAttribute( "name", fieldList[i].GetCanonicalName() );
+                aWriter.AddText( fieldList[i].GetText() );
+                aWriter.EndElement();
             }
         }
 
+        aWriter.EndElement();
+
         //----- show the pins here ------------------------------------
         pinList.clear();
         lcomp->GetPins( pinList, 0, 0 );
@@ -552,36 +543,40 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeLibParts()
 
         if( pinList.size() )
         {
-            XNODE*     pins;
+            aWriter.StartElement( "pins" );
 
-            xlibpart->AddChild( pins = node( "pins" ) );
             for( unsigned i=0; i<pinList.size();  ++i )
             {
-                XNODE*     pin;
-
-                pins->AddChild( pin = node( "pin" ) );
-                pin->AddAttribute( "num", pinList[i]->GetNumber() );
-                pin->AddAttribute( "name", pinList[i]->GetName() );
-                pin->AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aWriter.StartElement( "pin" );
+                aWriter.AddAttribute( "num", pinList[i]->GetNumber() );
+                aWriter.AddAttribute( "name", pinList[i]->GetName() );
+                aWriter.AddAttribute( "type", pinList[i]->GetCanonicalElectricalTypeName() );
+                aWriter.EndElement();
 
                 // caution: construction work site here, drive slowly
             }
+
+            aWriter.EndElement();
         }
+
+        aWriter.EndElement();
     }
 
-    return xlibparts;
+    aWriter.EndElement();
 }
 
 
-XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( unsigned aCtl )
+/// A pin of a net, with its reference and number computed once for the sort
+struct NET_NODE
 {
-    XNODE*      xnets = node( "nets" );      // auto_ptr if exceptions ever get used.
-    wxString    netCodeTxt;
-    wxString    netName;
-    wxString    ref;
+    SCH_PIN* m_pin;
+    wxString m_ref;
+    wxString m_number;
+};
 
-    XNODE*      xnet = 0;
 
+void NETLIST_EXPORTER_GENERIC::writeListOfNets( XNODE_WRITER& aWriter, unsigned aCtl )
+{
     /*  output:
         <net code="123" name="/cfcard.sch/WAIT#">
             <node ref="R23" pin="1"/>
@@ -589,21 +584,24 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( unsigned aCtl )
         </net>
     */
 
+    aWriter.StartElement( "nets" );
+
     int code = 0;
 
+    // The pins of the current net, reused for all the nets
+    std::vector<NET_NODE> sorted_items;
+
     for( const auto& it : m_schematic->ConnectionGraph()->GetNetMap() )
     {
-        bool     added     = false;
-        wxString net_name  = it.first.first;
-        auto     subgraphs = it.second;
+        bool            added     = false;
+        const wxString& net_name  = it.first.first;
 
         // Code starts at 1
         code++;
 
-        XNODE* xnode;
-        std::vector<std::pair<SCH_PIN*, SCH_SHEET_PATH>> sorted_items;
+        sorted_items.clear();
 
-        for( CONNECTION_SUBGRAPH* subgraph : subgraphs )
+        for( CONNECTION_SUBGRAPH* subgraph : it.second )
         {
             const SCH_SHEET_PATH& sheet = subgraph->m_sheet;
 
@@ -621,46 +619,35 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( unsigned aCtl )
                         continue;
                     }
 
-                    sorted_items.emplace_back( pin, sheet );
+                    sorted_items.push_back( { pin, comp->GetRef( &sheet ), pin->GetNumber() } );
                 }
             }
         }
 
         // Netlist ordering: Net name, then ref des, then pin name
         std::sort( sorted_items.begin(), sorted_items.end(),
-                   []( const std::pair<SCH_PIN*, SCH_SHEET_PATH>& a,
-                       const std::pair<SCH_PIN*, SCH_SHEET_PATH>& b )
+                   []( const NET_NODE& a, const NET_NODE& b )
                    {
-                       wxString ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                       wxString ref_b = b.first->GetParentComponent()->GetRef( &b.second );
+                       if( a.m_ref == b.m_ref )
+                           return a.m_number < b.m_number;
 
-                       if( ref_a == ref_b )
-                           return a.first->GetNumber() < b.first->GetNumber();
-
-                       return ref_a < ref_b;
+                       return a.m_ref < b.m_ref;
                    } );
 
         // Some duplicates can exist, for example on multi-unit parts with duplicated
         // pins across units.  If the user connects the pins on each unit, they will
         // appear on separate subgraphs.  Remove those here:
         sorted_items.erase( std::unique( sorted_items.begin(), sorted_items.end(),
-                []( const std::pair<SCH_PIN*, SCH_SHEET_PATH>& a,
-                    const std::pair<SCH_PIN*, SCH_SHEET_PATH>& b )
+                []( const NET_NODE& a, const NET_NODE& b )
                 {
-                    wxString ref_a = a.first->GetParentComponent()->GetRef( &a.second );
-                    wxString ref_b = b.first->GetParentComponent()->GetRef( &b.second );
-
-                    return ref_a == ref_b && a.first->GetNumber() == b.first->GetNumber();
+                    return a.m_ref == b.m_ref && a.m_number == b.m_number;
                 } ),
                 sorted_items.end() );
 
-        for( const std::pair<SCH_PIN*, SCH_SHEET_PATH>& pair : sorted_items )
+        for( const NET_NODE& netNode : sorted_items )
         {
-            SCH_PIN* pin = pair.first;
-            SCH_SHEET_PATH sheet = pair.second;
-
-            wxString refText = pin->GetParentComponent()->GetRef( &sheet );
-            wxString pinText = pin->GetNumber();
+            const wxString& refText = netNode.m_ref;
+            const wxString& pinText = netNode.m_number;
 
             // Skip power symbols and virtual components
             if( refText[0] == wxChar( '#' ) )
@@ -668,41 +655,34 @@ XNODE* NETLIST_EXPORTER_GENERIC::makeListOfNets( unsigned aCtl )
 
             if( !added )
             {
-                xnets->AddChild( xnet = node( "net" ) );
-                netCodeTxt.Printf( "%d", code );
-                xnet->AddAttribute( "code", netCodeTxt );
-                xnet->AddAttribute( "name", net_name );
+                aWriter.StartElement( "net" );
+                aWriter.AddAttribute( "code", wxString::Format( "%d", code ) );
+                aWriter.AddAttribute( "name", net_name );
 
                 added = true;
             }
 
-            xnet->AddChild( xnode = node( "node" ) );
-            xnode->AddAttribute( "ref", refText );
-            xnode->AddAttribute( "pin", pinText );
+            aWriter.StartElement( "node" );
+            aWriter.AddAttribute( "ref", refText );
+            aWriter.AddAttribute( "pin", pinText );
 
             wxString pinName;
 
-            if( pin->GetName() != "~" ) //  ~ is a char used to code empty strings in libs.
-                pinName = pin->GetName();
+            //  ~ is a char used to code empty strings in libs.
+            if( netNode.m_pin->GetName() != "~" )
+                pinName = netNode.m_pin->GetName();
 
             if( !pinName.IsEmpty() )
-                xnode->AddAttribute( "pinfunction", pinName );
-        }
-    }
-
-    return xnets;
-}
+                aWriter.AddAttribute( "pinfunction", pinName );
 
+            aWriter.EndElement();
+        }
 
-XNODE* NETLIST_EXPORTER_GENERIC::node( const wxString& aName,
-        const wxString& aTextualContent /* = wxEmptyString*/ )
-{
-    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
-
-    if( aTextualContent.Len() > 0 )     // excludes wxEmptyString, the parameter's default value
-        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aTextualContent ) );
+        if( added )
+            aWriter.EndElement();
+    }
 
-    return n;
+    aWriter.EndElement();
 }
 
 
@@ -39,7 +39,7 @@ class SYMBOL_LIB_TABLE;
 #define GENERIC_INTERMEDIATE_NETLIST_EXT wxT( "xml" )
 
 /**
- * A set of bits which control the totality of the tree built by makeRoot()
+ * A set of bits which control the totality of the tree written by writeRoot()
  */
 enum GNL_T
 {
@@ -86,56 +86,48 @@ public:
 #define GNL_ALL     ( GNL_LIBRARIES | GNL_COMPONENTS | GNL_PARTS | GNL_HEADER | GNL_NETS )
 
 protected:
-   /**
-     * A convenience function that creates a new XNODE with an optional textual child.
-     * It also provides some insulation from a possible change in XML library.
-     *
-     * @param aName is the name to associate with a new node of type wxXML_ELEMENT_NODE.
-     * @param aTextualContent is optional, and if given is the text to include in a child
-     *   of the returned node, and has type wxXML_TEXT_NODE.
-     */
-    XNODE* node( const wxString& aName, const wxString& aTextualContent = wxEmptyString );
-
     /**
-     * Build the entire document tree for the generic export.  This is factored
-     * out here so we can write the tree in either S-expression file format
-     * or in XML if we put the tree built here into a wxXmlDocument.
+     * Write the entire document tree for the generic export, in either S-expression or XML
+     * file format, as it is built.
      * @param aCtl - a bitset or-ed together from GNL_ENUM values
-     * @return XNODE* - the root nodes
      */
-    XNODE* makeRoot( unsigned aCtl = GNL_ALL );
+    void writeRoot( XNODE_WRITER& aWriter, unsigned aCtl = GNL_ALL );
 
     /**
-     * @return XNODE* - returns a sub-tree holding all the schematic components.
+     * Write a sub-tree holding all the schematic components.
      */
-    XNODE* makeComponents( unsigned aCtl );
+    void writeComponents( XNODE_WRITER& aWriter, unsigned aCtl );
 
     /**
-     * Fills out a project "design" header into an XML node.
-     * @return XNODE* - the design header
+     * Write the project "design" header.
      */
-    XNODE* makeDesignHeader();
+    void writeDesignHeader( XNODE_WRITER& aWriter );
 
     /**
-     * Fill out an XML node with the unique library parts and returns it.
-     * @return XNODE* - the library parts nodes
+     * Write the unique library parts.
      */
-    XNODE* makeLibParts();
+    void writeLibParts( XNODE_WRITER& aWriter );
 
     /**
-     * Fill out an XML node with a list of nets and returns it.
-     * @return XNODE* - the list of nets nodes
+     * Write the list of nets.
      */
-    XNODE* makeListOfNets( unsigned aCtl );
+    void writeListOfNets( XNODE_WRITER& aWriter, unsigned aCtl );
 
     /**
-     * Fill out an XML node with a list of used libraries and returns it.
-     * Must have called makeGenericLibParts() before this function.
-     * @return XNODE* - the library nodes
+     * Write the list of used libraries.
+     * Must have called writeLibParts() before this function.
      */
-    XNODE* makeLibraries();
+    void writeLibraries( XNODE_WRITER& aWriter );
+
+    void writeComponentFields( XNODE_WRITER& aWriter, SCH_COMPONENT* comp,
+                               SCH_SHEET_PATH* aSheet );
+
+private:
+    /// The units of the components, by lower case reference, in the order of the sheets.
+    /// Built once per export, for the multi-unit components.
+    std::map<wxString, std::vector<std::pair<SCH_COMPONENT*, SCH_SHEET_PATH*>>> m_units;
 
-    void addComponentFields(  XNODE* xcomp, SCH_COMPONENT* comp, SCH_SHEET_PATH* aSheet );
+    SCH_SHEET_LIST m_sheetList;     ///< The sheets of the schematic being exported
 };
 
 #endif
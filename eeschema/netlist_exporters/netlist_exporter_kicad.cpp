@@ -53,7 +53,7 @@ bool NETLIST_EXPORTER_KICAD::WriteNetlist( const wxString& aOutFileName, unsigne
 
 void NETLIST_EXPORTER_KICAD::Format( OUTPUTFORMATTER* aOut, int aCtl )
 {
-    std::unique_ptr<XNODE> xroot( makeRoot( aCtl ) );
+    XNODE_WRITER writer( aOut, XNODE_WRITER::SEXPR );
 
-    xroot->Format( aOut, 0 );
+    writeRoot( writer, aCtl );
 }
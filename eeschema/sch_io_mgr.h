@@ -35,6 +35,7 @@ class SCH_PLUGIN;
 class SCHEMATIC;
 class KIWAY;
 class LIB_PART;
+class LIB_SYMBOL_SUMMARY;
 class PART_LIB;
 class PROPERTIES;
 
@@ -286,6 +287,29 @@ public:
                                      const wxString&   aLibraryPath,
                                      const PROPERTIES* aProperties = NULL );
 
+    /**
+     * Populate a list of the properties shown in the symbol tree of the symbols contained
+     * within the library \a aLibraryPath.
+     *
+     * The default implementation loads the symbols with EnumerateSymbolLib().  A plugin
+     * should override it when it can provide the properties without parsing the symbols.
+     *
+     * @param aSummaries is an array to populate with the properties of the symbols.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *                     or URL containing one or more #LIB_PART objects.
+     *
+     * @param aProperties is an associative array that can be used to tell the plugin anything
+     *                    needed about how to perform with respect to \a aLibraryPath.  The
+     *                    caller continues to own this object (plugin may not delete it), and
+     *                    plugins should expect it to be optionally NULL.
+     *
+     * @throw IO_ERROR if the library cannot be found, the part library cannot be loaded.
+     */
+    virtual void EnumerateSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                           const wxString&   aLibraryPath,
+                                           const PROPERTIES* aProperties = NULL );
+
     /**
      * Load a #LIB_PART object having \a aPartName from the \a aLibraryPath containing
      * a library format that this #SCH_PLUGIN knows about.
@@ -23,6 +23,7 @@
 #include <properties.h>
 
 #include <sch_io_mgr.h>
+#include <lib_symbol_summary.h>
 #include <wx/translation.h>
 
 #define FMT_UNIMPLEMENTED   "Plugin \"%s\" does not implement the \"%s\" function."
@@ -82,6 +83,19 @@ void SCH_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SCH_PLUGIN::EnumerateSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                           const wxString&   aLibraryPath,
+                                           const PROPERTIES* aProperties )
+{
+    std::vector<LIB_PART*> symbols;
+
+    EnumerateSymbolLib( symbols, aLibraryPath, aProperties );
+
+    for( LIB_PART* symbol : symbols )
+        aSummaries.emplace_back( symbol );
+}
+
+
 LIB_PART* SCH_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                   const PROPERTIES* aProperties )
 {
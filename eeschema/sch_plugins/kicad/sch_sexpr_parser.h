@@ -208,6 +208,12 @@ public:
     LIB_PART* ParseSymbol( LIB_PART_MAP& aSymbolLibMap,
                            int aFileVersion = SEXPR_SYMBOL_LIB_FILE_VERSION );
 
+    /**
+     * Return the file version read in the header by ParseLib(), to parse the symbols of the
+     * file with ParseSymbol().
+     */
+    int GetRequiredVersion() const { return m_requiredVersion; }
+
     LIB_ITEM* ParseDrawItem();
 
     /**
@@ -20,12 +20,18 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
 
 // For some reason wxWidgets is built with wxUSE_BASE64 unset so expose the wxWidgets
 // base64 code.
 #define wxUSE_BASE64 1
 #include <wx/base64.h>
+#include <wx/ffile.h>
 #include <wx/mstream.h>
+#include <wx/tokenzr.h>
 #include <advanced_config.h>
 #include <pgm_base.h>
 #include <trace_helpers.h>
@@ -52,6 +58,7 @@
 #include <lib_pin.h>
 #include <lib_polyline.h>
 #include <lib_rectangle.h>
+#include <lib_symbol_summary.h>
 #include <lib_text.h>
 #include <eeschema_id.h>       // for MAX_UNIT_COUNT_PER_PACKAGE definition
 #include <sch_file_versions.h>
@@ -286,7 +293,38 @@ static void formatStroke( OUTPUTFORMATTER* aFormatter, int aNestLevel,
  */
 class SCH_SEXPR_PLUGIN_CACHE
 {
-    static int      m_modHash;      // Keep track of the modification status of the library.
+    /**
+     * The location and the properties of a symbol of the library file which is not parsed
+     * yet.  The symbols are parsed on the first access.
+     */
+    struct SYMBOL_INDEX_ENTRY
+    {
+        size_t   m_offset;      ///< The offset of the symbol in m_fileText.
+        size_t   m_length;
+        unsigned m_line;        ///< The line of the symbol in the file, for the parse errors.
+        wxString m_parent;      ///< The name of the parent of a derived symbol.
+        bool     m_isPower;
+        int      m_unitCount;   ///< The unit count of a root symbol.
+        wxString m_description; ///< The properties shown in the symbol tree.
+        wxString m_keyWords;
+        wxString m_footprint;
+    };
+
+    /**
+     * A symbol of the library file which cannot be parsed.  Its text is saved unchanged and
+     * its error is reported on each load of the symbol.
+     */
+    struct UNPARSED_SYMBOL
+    {
+        size_t      m_offset;   ///< The offset of the symbol in the file, to save it in place.
+        std::string m_text;
+        wxString    m_parent;
+        wxString    m_error;
+    };
+
+    // Keep track of the modification status of the library.  The libraries can be loaded by
+    // worker threads, see LIB_TABLE_PRELOADER.
+    static std::atomic<int> m_modHash;
 
     wxString        m_fileName;     // Absolute path and file name.
     wxFileName      m_libFileName;  // Absolute path and file name is required here.
@@ -298,6 +336,24 @@ class SCH_SEXPR_PLUGIN_CACHE
     int             m_versionMinor;
     SCH_LIB_TYPE    m_libType; // Is this cache a component or symbol library.
 
+    std::map<wxString, SYMBOL_INDEX_ENTRY, LibPartMapSort> m_index;  // Symbols not parsed yet.
+    std::map<wxString, UNPARSED_SYMBOL, LibPartMapSort> m_unparsedSymbols;
+    std::string     m_fileText;     // The library file, until all the symbols are parsed.
+    int             m_fileVersion;
+
+    bool            indexSymbols();
+    LIB_PART*       loadSymbol( const wxString& aName );
+    void            loadAllSymbols();
+
+    /**
+     * Call \a aParsed for the parsed symbols and \a aIndexed for the symbols which are not
+     * parsed yet, in the order of the symbol names.
+     */
+    void            forEachSymbol( const std::function<void( LIB_PART* )>& aParsed,
+                                   const std::function<void( const wxString&,
+                                                             const SYMBOL_INDEX_ENTRY& )>&
+                                           aIndexed ) const;
+
     static FILL_TYPE   parseFillMode( LINE_READER& aReader, const char* aLine,
                                    const char** aOutput );
     LIB_PART*       removeSymbol( LIB_PART* aAlias );
@@ -335,8 +391,30 @@ public:
     /// Save the entire library to file m_libFileName;
     void Save();
 
+    /**
+     * Load the library file.  The symbols are only indexed: each symbol is parsed on the
+     * first access, with LoadSymbol(), or when all the symbols are needed.
+     */
     void Load();
 
+    /**
+     * Return the symbol \a aName, which is parsed if needed, or nullptr if the library does
+     * not contain this symbol.
+     */
+    LIB_PART* LoadSymbol( const wxString& aName );
+
+    /**
+     * Add the names of the symbols to \a aNames, without parsing the symbols.
+     */
+    void GetSymbolNames( wxArrayString& aNames, bool aPowerSymbolsOnly ) const;
+
+    /**
+     * Add the properties shown in the symbol tree of the symbols to \a aSummaries, without
+     * parsing the symbols.
+     */
+    void GetSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                             bool aPowerSymbolsOnly ) const;
+
     void AddSymbol( const LIB_PART* aPart );
 
     void DeleteSymbol( const wxString& aName );
@@ -434,6 +512,7 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
         std::unique_ptr<SCH_SHEET> newSheet = std::make_unique<SCH_SHEET>( aSchematic );
         newSheet->SetFileName( aFileName );
         m_rootSheet = newSheet.get();
+        parseHierarchy( newSheet.get() );
         loadHierarchy( newSheet.get() );
 
         // If we got here, the schematic loaded successfully.
@@ -445,15 +524,137 @@ SCH_SHEET* SCH_SEXPR_PLUGIN::Load( const wxString& aFileName, SCHEMATIC* aSchema
         wxCHECK_MSG( aSchematic->IsValid(), nullptr, "Can't append to a schematic with no root!" );
         m_rootSheet = &aSchematic->Root();
         sheet = aAppendToMe;
+        parseHierarchy( sheet );
         loadHierarchy( sheet );
     }
 
+    m_parsedSheets.clear();
+
     wxASSERT( m_currentPath.size() == 1 );  // only the project path should remain
 
     return sheet;
 }
 
 
+void SCH_SEXPR_PLUGIN::parseHierarchy( SCH_SHEET* aSheet )
+{
+    m_parsedSheets.clear();
+
+    if( aSheet->GetScreen() )
+        return;
+
+    wxFileName rootFileName = aSheet->GetFileName();
+
+    if( !rootFileName.IsAbsolute() )
+        rootFileName.MakeAbsolute( m_currentPath.top() );
+
+    // The translated default field names are cached on their first use: cache them here, in
+    // the main thread, before the items of the worker threads use them.
+    SCH_SHEET::GetDefaultFieldName( SHEETNAME );
+    TEMPLATE_FIELDNAME::GetDefaultFieldName( REFERENCE );
+
+    std::vector<wxString> level = { rootFileName.GetFullPath() };
+
+    // The sub-sheet files are known once their parent file is parsed: parse the hierarchy
+    // level by level.  The files are independent until their screens are linked to the
+    // sheets by loadHierarchy(), in the main thread.
+    while( !level.empty() )
+    {
+        // The map is only modified here, in the main thread
+        std::vector<PARSED_SHEET*> parsedSheets;
+
+        for( const wxString& fileName : level )
+        {
+            PARSED_SHEET& parsed = m_parsedSheets[ fileName ];
+
+            parsed.m_sheet = std::make_unique<SCH_SHEET>( m_schematic );
+            parsedSheets.push_back( &parsed );
+        }
+
+        size_t parallelThreadCount = std::min<size_t>(
+                std::max<size_t>( std::thread::hardware_concurrency(), 1 ), level.size() );
+
+        std::atomic<size_t> nextFile( 0 );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+        auto parse_lambda = [&]() -> size_t
+        {
+            for( size_t ii = nextFile++; ii < level.size(); ii = nextFile++ )
+            {
+                try
+                {
+                    parseSheetFile( level[ii], parsedSheets[ii]->m_sheet.get() );
+                }
+                catch( ... )
+                {
+                    parsedSheets[ii]->m_error = std::current_exception();
+                }
+            }
+
+            return 1;
+        };
+
+        if( parallelThreadCount == 1 )
+        {
+            parse_lambda();
+        }
+        else
+        {
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii] = std::async( std::launch::async, parse_lambda );
+
+            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+                returns[ii].wait();
+        }
+
+        std::vector<wxString> nextLevel;
+
+        for( size_t ii = 0; ii < level.size(); ++ii )
+        {
+            SCH_SCREEN* parsedScreen = parsedSheets[ii]->m_sheet->GetScreen();
+            wxString    path = wxFileName( level[ii] ).GetPath();
+
+            if( !parsedScreen )
+                continue;
+
+            for( SCH_ITEM* item : parsedScreen->Items().OfType( SCH_SHEET_T ) )
+            {
+                wxFileName  fileName = static_cast<SCH_SHEET*>( item )->GetFileName();
+                SCH_SCREEN* screen = nullptr;
+
+                if( !fileName.IsAbsolute() )
+                    fileName.MakeAbsolute( path );
+
+                // Skip the files already parsed, and the ones already loaded in the schematic
+                // a sheet is appended to.
+                if( m_parsedSheets.count( fileName.GetFullPath() ) )
+                    continue;
+
+                m_rootSheet->SearchHierarchy( fileName.GetFullPath(), &screen );
+
+                if( screen )
+                    continue;
+
+                m_parsedSheets[ fileName.GetFullPath() ];
+                nextLevel.push_back( fileName.GetFullPath() );
+            }
+        }
+
+        level = std::move( nextLevel );
+    }
+}
+
+
+void SCH_SEXPR_PLUGIN::parseSheetFile( const wxString& aFileName, SCH_SHEET* aSheet )
+{
+    // Called from the worker threads: only aSheet and its screen may be modified
+    aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+    aSheet->GetScreen()->SetFileName( aFileName );
+
+    loadFile( aFileName, aSheet );
+}
+
+
 // Everything below this comment is recursive.  Modify with care.
 
 void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
@@ -488,12 +689,26 @@ void SCH_SEXPR_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
         }
         else
         {
-            aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
-            aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+            auto parsed = m_parsedSheets.find( fileName.GetFullPath() );
 
             try
             {
-                loadFile( fileName.GetFullPath(), aSheet );
+                if( parsed != m_parsedSheets.end() && parsed->second.m_sheet )
+                {
+                    // Link the screen parsed by parseHierarchy() to the sheet.  The items of the
+                    // screen are its children, so they need no update.
+                    aSheet->SetScreen( parsed->second.m_sheet->GetScreen() );
+                    parsed->second.m_sheet.reset();
+
+                    if( parsed->second.m_error )
+                        std::rethrow_exception( parsed->second.m_error );
+                }
+                else
+                {
+                    aSheet->SetScreen( new SCH_SCREEN( m_schematic ) );
+                    aSheet->GetScreen()->SetFileName( fileName.GetFullPath() );
+                    loadFile( fileName.GetFullPath(), aSheet );
+                }
             }
             catch( const IO_ERROR& ioe )
             {
@@ -1282,7 +1497,7 @@ void SCH_SEXPR_PLUGIN::saveBusAlias( std::shared_ptr<BUS_ALIAS> aAlias, int aNes
 }
 
 
-int SCH_SEXPR_PLUGIN_CACHE::m_modHash = 1;     // starts at 1 and goes up
+std::atomic<int> SCH_SEXPR_PLUGIN_CACHE::m_modHash( 1 );     // starts at 1 and goes up
 
 
 SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFileName ) :
@@ -1294,6 +1509,7 @@ SCH_SEXPR_PLUGIN_CACHE::SCH_SEXPR_PLUGIN_CACHE( const wxString& aFullPathAndFile
     m_versionMajor = -1;
     m_versionMinor = -1;
     m_libType      = SCH_LIB_TYPE::LT_EESCHEMA;
+    m_fileVersion  = SEXPR_SYMBOL_LIB_FILE_VERSION;
 }
 
 
@@ -1427,6 +1643,9 @@ LIB_PART* SCH_SEXPR_PLUGIN_CACHE::removeSymbol( LIB_PART* aPart )
 
 void SCH_SEXPR_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
 {
+    // The aliases of a replaced symbol are updated by removeSymbol()
+    loadAllSymbols();
+
     // aPart is cloned in PART_LIB::AddPart().  The cache takes ownership of aPart.
     wxString name = aPart->GetName();
     LIB_PART_MAP::iterator it = m_symbols.find( name );
@@ -1436,6 +1655,7 @@ void SCH_SEXPR_PLUGIN_CACHE::AddSymbol( const LIB_PART* aPart )
         removeSymbol( it->second );
     }
 
+    m_unparsedSymbols.erase( name );
     m_symbols[ name ] = const_cast< LIB_PART* >( aPart );
     m_isModified = true;
     ++m_modHash;
@@ -1457,11 +1677,38 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading sexpr symbol library file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    wxFFile file( m_libFileName.GetFullPath(), wxT( "rb" ) );
 
-    SCH_SEXPR_PARSER parser( &reader );
+    if( !file.IsOpened() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open library file \"%s\"." ),
+                                          m_libFileName.GetFullPath() ) );
+    }
+
+    m_fileText.resize( file.Length() );
+
+    if( file.Read( &m_fileText[0], m_fileText.size() ) != m_fileText.size() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to read library file \"%s\"." ),
+                                          m_libFileName.GetFullPath() ) );
+    }
+
+    file.Close();
+
+    // The files which cannot be indexed (with escape sequences in the symbol names, for
+    // instance) are fully parsed, which also reports their errors.
+    if( !indexSymbols() )
+    {
+        STRING_LINE_READER reader( m_fileText, m_libFileName.GetFullPath() );
+        SCH_SEXPR_PARSER   parser( &reader );
+
+        m_index.clear();
+        m_fileText.clear();
+        m_fileText.shrink_to_fit();
+
+        parser.ParseLib( m_symbols );
+    }
 
-    parser.ParseLib( m_symbols );
     ++m_modHash;
 
     // Remember the file modification time of library file when the
@@ -1471,6 +1718,480 @@ void SCH_SEXPR_PLUGIN_CACHE::Load()
 }
 
 
+/**
+ * A #STRING_LINE_READER reading a symbol of a library file, which reports the line numbers
+ * of the file.
+ */
+class SYMBOL_LINE_READER : public STRING_LINE_READER
+{
+public:
+    SYMBOL_LINE_READER( const std::string& aSymbol, const wxString& aSource, unsigned aLine ) :
+            STRING_LINE_READER( aSymbol, aSource )
+    {
+        m_lineNum = aLine - 1;
+    }
+};
+
+
+bool SCH_SEXPR_PLUGIN_CACHE::indexSymbols()
+{
+    const std::string& text = m_fileText;
+    size_t             pos = 0;
+    unsigned           line = 1;
+    int                depth = 0;
+    size_t             headerEnd = std::string::npos;
+    bool               inSymbol = false;
+    std::string        atom;
+    wxString           name;
+    SYMBOL_INDEX_ENTRY entry;
+
+    auto skipSpaces =
+            [&]()
+            {
+                while( pos < text.size() && isspace( (unsigned char) text[pos] ) )
+                {
+                    if( text[pos++] == '\n' )
+                        line++;
+                }
+            };
+
+    // Read a symbol, or a quoted string without escape sequence
+    auto readAtom =
+            [&]( std::string& aAtom ) -> bool
+            {
+                skipSpaces();
+
+                if( pos >= text.size() )
+                    return false;
+
+                size_t end;
+
+                if( text[pos] == '"' )
+                {
+                    end = text.find_first_of( "\"\\\n", pos + 1 );
+
+                    if( end == std::string::npos || text[end] != '"' )
+                        return false;
+
+                    aAtom.assign( text, pos + 1, end - pos - 1 );
+                    pos = end + 1;
+                    return true;
+                }
+
+                end = text.find_first_of( " \t\r\n()\"", pos );
+
+                if( end == std::string::npos || end == pos )
+                    return false;
+
+                aAtom.assign( text, pos, end - pos );
+                pos = end;
+                return true;
+            };
+
+    // Read a symbol, or a quoted string with the escape sequences of the parser
+    auto readString =
+            [&]( wxString& aString ) -> bool
+            {
+                skipSpaces();
+
+                if( pos >= text.size() || text[pos] != '"' )
+                {
+                    if( !readAtom( atom ) )
+                        return false;
+
+                    aString = FROM_UTF8( atom.c_str() );
+                    return true;
+                }
+
+                size_t end = pos + 1;
+                bool   escaped = false;
+
+                for( ; end < text.size() && text[end] != '"'; end++ )
+                {
+                    if( text[end] == '\\' )
+                    {
+                        escaped = true;
+                        end++;
+                    }
+
+                    if( end < text.size() && text[end] == '\n' )
+                        return false;
+                }
+
+                if( end >= text.size() )
+                    return false;
+
+                if( escaped )
+                {
+                    DSNLEXER lexer( text.substr( pos, end + 1 - pos ) );
+
+                    lexer.NextTok();
+                    aString = lexer.FromUTF8();
+                }
+                else
+                {
+                    aString = FROM_UTF8( text.substr( pos + 1, end - pos - 1 ).c_str() );
+                }
+
+                pos = end + 1;
+                return true;
+            };
+
+    // Only the names which are not modified by the parser are indexed
+    auto readName =
+            [&]( wxString& aName ) -> bool
+            {
+                LIB_ID id;
+
+                if( !readAtom( atom ) )
+                    return false;
+
+                aName = FROM_UTF8( atom.c_str() );
+
+                return id.Parse( aName, LIB_ID::ID_SCH ) < 0 && id.GetLibNickname().empty()
+                        && id.GetLibItemName().wx_str() == aName;
+            };
+
+    skipSpaces();
+
+    if( pos >= text.size() || text[pos] != '(' )
+        return false;
+
+    pos++;
+    depth = 1;
+
+    if( !readAtom( atom ) || atom != "kicad_symbol_lib" )
+        return false;
+
+    while( pos < text.size() && depth > 0 )
+    {
+        char c = text[pos];
+
+        if( c == '"' )
+        {
+            for( pos++; pos < text.size() && text[pos] != '"'; pos++ )
+            {
+                if( text[pos] == '\\' )
+                    pos++;
+
+                if( pos < text.size() && text[pos] == '\n' )
+                    line++;
+            }
+
+            pos++;
+        }
+        else if( c == '(' )
+        {
+            size_t   start = pos++;
+            unsigned startLine = line;
+
+            depth++;
+
+            if( depth == 2 )
+            {
+                if( !readAtom( atom ) )
+                    return false;
+
+                inSymbol = ( atom == "symbol" );
+
+                if( inSymbol )
+                {
+                    if( headerEnd == std::string::npos )
+                        headerEnd = start;
+
+                    if( !readName( name ) )
+                        return false;
+
+                    entry = { start, 0, startLine, wxEmptyString, false, 1, wxEmptyString,
+                              wxEmptyString, wxEmptyString };
+                }
+                else if( headerEnd != std::string::npos )
+                {
+                    return false;
+                }
+            }
+            else if( depth == 3 && inSymbol )
+            {
+                if( !readAtom( atom ) )
+                    return false;
+
+                if( atom == "extends" )
+                {
+                    if( !readName( entry.m_parent ) )
+                        return false;
+                }
+                else if( atom == "power" )
+                {
+                    entry.m_isPower = true;
+                }
+                else if( atom == "property" )
+                {
+                    wxString propName;
+                    wxString value;
+
+                    if( !readString( propName ) || !readString( value ) )
+                        return false;
+
+                    if( propName == "ki_description" )
+                        entry.m_description = value;
+                    else if( propName == "ki_keywords" )
+                        entry.m_keyWords = value;
+                    else if( propName == "Footprint" )
+                        entry.m_footprint = value;
+                }
+                else if( atom == "symbol" )
+                {
+                    // The unit count is the highest unit of the unit symbols "NAME_UNIT_CONVERT"
+                    long unit;
+
+                    if( !readAtom( atom ) )
+                        return false;
+
+                    wxString unitName = FROM_UTF8( atom.c_str() );
+
+                    if( !unitName.StartsWith( name ) )
+                        return false;
+
+                    wxStringTokenizer tokenizer( unitName.Mid( name.Length() + 1 ), "_" );
+
+                    if( tokenizer.CountTokens() != 2 || !tokenizer.GetNextToken().ToLong( &unit ) )
+                        return false;
+
+                    entry.m_unitCount = std::max( entry.m_unitCount, (int) unit );
+                }
+            }
+        }
+        else if( c == ')' )
+        {
+            pos++;
+
+            if( depth == 2 && inSymbol )
+            {
+                entry.m_length = pos - entry.m_offset;
+
+                if( !m_index.emplace( name, entry ).second )
+                    return false;
+
+                inSymbol = false;
+            }
+
+            depth--;
+        }
+        else
+        {
+            if( c == '\n' )
+                line++;
+
+            pos++;
+        }
+    }
+
+    if( depth != 0 || headerEnd == std::string::npos )
+        return false;
+
+    // The parents must be defined before the derived symbols
+    for( const auto& indexEntry : m_index )
+    {
+        const wxString& parent = indexEntry.second.m_parent;
+
+        if( !parent.IsEmpty() )
+        {
+            auto it = m_index.find( parent );
+
+            if( it == m_index.end() || it->second.m_offset > indexEntry.second.m_offset )
+                return false;
+        }
+    }
+
+    // Read the file version in the header
+    STRING_LINE_READER reader( text.substr( 0, headerEnd ) + ")", m_libFileName.GetFullPath() );
+    SCH_SEXPR_PARSER   parser( &reader );
+    LIB_PART_MAP       noSymbols;
+
+    parser.ParseLib( noSymbols );
+    m_fileVersion = parser.GetRequiredVersion();
+
+    return true;
+}
+
+
+LIB_PART* SCH_SEXPR_PLUGIN_CACHE::loadSymbol( const wxString& aName )
+{
+    auto it = m_index.find( aName );
+
+    if( it == m_index.end() )
+        return nullptr;
+
+    SYMBOL_INDEX_ENTRY entry = it->second;
+    LIB_PART*          symbol = nullptr;
+
+    try
+    {
+        // The parent of a derived symbol is needed to parse it
+        if( !entry.m_parent.IsEmpty() && !m_symbols.count( entry.m_parent ) )
+        {
+            auto unparsedParent = m_unparsedSymbols.find( entry.m_parent );
+
+            if( unparsedParent != m_unparsedSymbols.end() )
+                THROW_IO_ERROR( unparsedParent->second.m_error );
+
+            loadSymbol( entry.m_parent );
+        }
+
+        LOCALE_IO          toggle;     // toggles on, then off, the C locale.
+        SYMBOL_LINE_READER reader( m_fileText.substr( entry.m_offset, entry.m_length ),
+                                   m_libFileName.GetFullPath(), entry.m_line );
+        SCH_SEXPR_PARSER   parser( &reader );
+
+        parser.NeedLEFT();
+        parser.NextTok();
+
+        symbol = parser.ParseSymbol( m_symbols, m_fileVersion );
+        m_symbols[symbol->GetName()] = symbol;
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        // Keep the symbol which cannot be parsed out of the parsed symbols, so the library
+        // can still be listed and saved without it being lost
+        UNPARSED_SYMBOL& unparsed = m_unparsedSymbols[aName];
+
+        unparsed.m_offset = entry.m_offset;
+        unparsed.m_text = m_fileText.substr( entry.m_offset, entry.m_length );
+        unparsed.m_parent = entry.m_parent;
+        unparsed.m_error = ioe.Problem();
+    }
+
+    m_index.erase( aName );
+
+    if( m_index.empty() )
+    {
+        m_fileText.clear();
+        m_fileText.shrink_to_fit();
+    }
+
+    if( !symbol )
+        THROW_IO_ERROR( m_unparsedSymbols[aName].m_error );
+
+    return symbol;
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::loadAllSymbols()
+{
+    while( !m_index.empty() )
+    {
+        wxString name = m_index.begin()->first;
+
+        try
+        {
+            loadSymbol( name );
+        }
+        catch( const IO_ERROR& )
+        {
+            // The error is reported when the symbol itself is loaded
+            wxLogTrace( traceSchLegacyPlugin, "Skipping symbol \"%s\" of library \"%s\".",
+                        name, m_libFileName.GetFullPath() );
+        }
+    }
+}
+
+
+LIB_PART* SCH_SEXPR_PLUGIN_CACHE::LoadSymbol( const wxString& aName )
+{
+    LIB_PART_MAP::const_iterator it = m_symbols.find( aName );
+
+    if( it != m_symbols.end() )
+        return it->second;
+
+    auto unparsed = m_unparsedSymbols.find( aName );
+
+    if( unparsed != m_unparsedSymbols.end() )
+        THROW_IO_ERROR( unparsed->second.m_error );
+
+    return loadSymbol( aName );
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::forEachSymbol(
+        const std::function<void( LIB_PART* )>& aParsed,
+        const std::function<void( const wxString&, const SYMBOL_INDEX_ENTRY& )>& aIndexed ) const
+{
+    // Merge the parsed and the indexed symbols, in the order of the map
+    LibPartMapSort less;
+    auto           parsed = m_symbols.begin();
+    auto           indexed = m_index.begin();
+
+    while( parsed != m_symbols.end() || indexed != m_index.end() )
+    {
+        if( indexed == m_index.end()
+                || ( parsed != m_symbols.end() && less( parsed->first, indexed->first ) ) )
+        {
+            aParsed( parsed->second );
+            ++parsed;
+        }
+        else
+        {
+            aIndexed( indexed->first, indexed->second );
+            ++indexed;
+        }
+    }
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::GetSymbolNames( wxArrayString& aNames,
+                                             bool aPowerSymbolsOnly ) const
+{
+    forEachSymbol(
+            [&]( LIB_PART* aSymbol )
+            {
+                if( !aPowerSymbolsOnly || aSymbol->IsPower() )
+                    aNames.Add( aSymbol->GetName() );
+            },
+            [&]( const wxString& aName, const SYMBOL_INDEX_ENTRY& aEntry )
+            {
+                if( !aPowerSymbolsOnly || aEntry.m_isPower )
+                    aNames.Add( aName );
+            } );
+}
+
+
+void SCH_SEXPR_PLUGIN_CACHE::GetSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                                 bool aPowerSymbolsOnly ) const
+{
+    forEachSymbol(
+            [&]( LIB_PART* aSymbol )
+            {
+                if( !aPowerSymbolsOnly || aSymbol->IsPower() )
+                    aSummaries.emplace_back( aSymbol );
+            },
+            [&]( const wxString& aName, const SYMBOL_INDEX_ENTRY& aEntry )
+            {
+                if( aPowerSymbolsOnly && !aEntry.m_isPower )
+                    return;
+
+                // The units of a derived symbol are the ones of its parent
+                int unitCount = aEntry.m_unitCount;
+
+                if( !aEntry.m_parent.IsEmpty() )
+                {
+                    auto parsedParent = m_symbols.find( aEntry.m_parent );
+                    auto indexedParent = m_index.find( aEntry.m_parent );
+
+                    if( parsedParent != m_symbols.end() )
+                        unitCount = parsedParent->second->GetUnitCount();
+                    else if( indexedParent != m_index.end() )
+                        unitCount = indexedParent->second.m_unitCount;
+                }
+
+                aSummaries.emplace_back( aName, aEntry.m_description,
+                                         LIB_PART::BuildSearchText( aEntry.m_keyWords,
+                                                                    aEntry.m_description,
+                                                                    aEntry.m_footprint ),
+                                         aEntry.m_parent.IsEmpty(), unitCount );
+            } );
+}
+
+
 void SCH_SEXPR_PLUGIN_CACHE::Save()
 {
     if( !m_isModified )
@@ -1478,6 +2199,8 @@ void SCH_SEXPR_PLUGIN_CACHE::Save()
 
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
+    loadAllSymbols();
+
     // Write through symlinks, don't replace them.
     wxFileName fn = GetRealFile();
 
@@ -1509,6 +2232,22 @@ void SCH_SEXPR_PLUGIN_CACHE::Save()
         }
     }
 
+    // The symbols which cannot be parsed are saved unchanged, in the order of the file, after
+    // their parents
+    std::vector<const UNPARSED_SYMBOL*> unparsedSymbols;
+
+    for( const auto& unparsed : m_unparsedSymbols )
+        unparsedSymbols.push_back( &unparsed.second );
+
+    std::sort( unparsedSymbols.begin(), unparsedSymbols.end(),
+               []( const UNPARSED_SYMBOL* aFirst, const UNPARSED_SYMBOL* aSecond )
+               {
+                   return aFirst->m_offset < aSecond->m_offset;
+               } );
+
+    for( const UNPARSED_SYMBOL* unparsed : unparsedSymbols )
+        formatter->Print( 1, "%s\n", unparsed->m_text.c_str() );
+
     formatter->Print( 0, ")\n" );
 
     formatter.reset();
@@ -1982,6 +2721,27 @@ void SCH_SEXPR_PLUGIN_CACHE::saveText( LIB_TEXT* aText,
 
 void SCH_SEXPR_PLUGIN_CACHE::DeleteSymbol( const wxString& aSymbolName )
 {
+    // The aliases of a deleted root symbol are deleted too
+    loadAllSymbols();
+
+    // The symbols which cannot be parsed are only kept to be saved unchanged
+    bool unparsed = m_unparsedSymbols.erase( aSymbolName ) > 0;
+
+    for( auto it = m_unparsedSymbols.begin(); it != m_unparsedSymbols.end(); )
+    {
+        if( it->second.m_parent == aSymbolName )
+            it = m_unparsedSymbols.erase( it );
+        else
+            ++it;
+    }
+
+    if( unparsed )
+    {
+        m_isModified = true;
+        ++m_modHash;
+        return;
+    }
+
     LIB_PART_MAP::iterator it = m_symbols.find( aSymbolName );
 
     if( it == m_symbols.end() )
@@ -2073,13 +2833,7 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( wxArrayString&    aSymbolNameList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
-    const LIB_PART_MAP& symbols = m_cache->m_symbols;
-
-    for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
-    {
-        if( !powerSymbolsOnly || it->second->IsPower() )
-            aSymbolNameList.Add( it->first );
-    }
+    m_cache->GetSymbolNames( aSymbolNameList, powerSymbolsOnly );
 }
 
 
@@ -2095,6 +2849,8 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                               aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
     cacheLib( aLibraryPath );
 
+    m_cache->loadAllSymbols();
+
     const LIB_PART_MAP& symbols = m_cache->m_symbols;
 
     for( LIB_PART_MAP::const_iterator it = symbols.begin();  it != symbols.end();  ++it )
@@ -2105,6 +2861,22 @@ void SCH_SEXPR_PLUGIN::EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SCH_SEXPR_PLUGIN::EnumerateSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                                 const wxString&   aLibraryPath,
+                                                 const PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    m_props = aProperties;
+
+    bool powerSymbolsOnly = ( aProperties &&
+                              aProperties->find( SYMBOL_LIB_TABLE::PropPowerSymsOnly ) != aProperties->end() );
+    cacheLib( aLibraryPath );
+
+    m_cache->GetSymbolSummaries( aSummaries, powerSymbolsOnly );
+}
+
+
 LIB_PART* SCH_SEXPR_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxString& aSymbolName,
                                         const PROPERTIES* aProperties )
 {
@@ -2114,12 +2886,7 @@ LIB_PART* SCH_SEXPR_PLUGIN::LoadSymbol( const wxString& aLibraryPath, const wxSt
 
     cacheLib( aLibraryPath );
 
-    LIB_PART_MAP::const_iterator it = m_cache->m_symbols.find( aSymbolName );
-
-    if( it == m_cache->m_symbols.end() )
-        return nullptr;
-
-    return it->second;
+    return m_cache->LoadSymbol( aSymbolName );
 }
 
 
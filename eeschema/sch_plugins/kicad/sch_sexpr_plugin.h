@@ -22,6 +22,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <exception>
+#include <map>
 #include <memory>
 #include <sch_io_mgr.h>
 #include <sch_file_versions.h>
@@ -104,6 +106,9 @@ public:
     void EnumerateSymbolLib( std::vector<LIB_PART*>& aSymbolList,
                              const wxString&   aLibraryPath,
                              const PROPERTIES* aProperties = nullptr ) override;
+    void EnumerateSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                   const wxString&   aLibraryPath,
+                                   const PROPERTIES* aProperties = nullptr ) override;
     LIB_PART* LoadSymbol( const wxString& aLibraryPath, const wxString& aAliasName,
                            const PROPERTIES* aProperties = nullptr ) override;
     void SaveSymbol( const wxString& aLibraryPath, const LIB_PART* aSymbol,
@@ -127,6 +132,13 @@ public:
     static void FormatPart( LIB_PART* aPart, OUTPUTFORMATTER& aFormatter );
 
 private:
+    /**
+     * Parse the distinct sheet files of the hierarchy of \a aSheet, the files of each level
+     * of the hierarchy in parallel, in the detached sheets of #m_parsedSheets.
+     */
+    void parseHierarchy( SCH_SHEET* aSheet );
+    void parseSheetFile( const wxString& aFileName, SCH_SHEET* aSheet );
+
     void loadHierarchy( SCH_SHEET* aSheet );
     void loadFile( const wxString& aFileName, SCH_SHEET* aSheet );
 
@@ -159,6 +171,15 @@ protected:
     OUTPUTFORMATTER*     m_out;        ///< The output formatter for saving SCH_SCREEN objects.
     SCH_SEXPR_PLUGIN_CACHE* m_cache;
 
+    struct PARSED_SHEET
+    {
+        std::unique_ptr<SCH_SHEET> m_sheet;   ///< Detached sheet owning the parsed screen.
+        std::exception_ptr         m_error;   ///< The parse error, if any.
+    };
+
+    /// The sheet files parsed by parseHierarchy(), by full file name.
+    std::map<wxString, PARSED_SHEET> m_parsedSheets;
+
     /// initialize PLUGIN like a constructor would.
     void init( SCHEMATIC* aSchematic, const PROPERTIES* aProperties = nullptr );
 };
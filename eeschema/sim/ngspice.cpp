@@ -230,6 +230,35 @@ vector<double> NGSPICE::GetPhasePlot( const string& aName, int aMaxLen )
 }
 
 
+int NGSPICE::GetPlotValues( const string& aName, size_t aFrom, vector<COMPLEX>& aData )
+{
+    std::lock_guard<std::mutex> lock( m_streamLock );
+    auto                        it = m_streamedVectors.find( streamedVectorName( aName ) );
+
+    if( it == m_streamedVectors.end() )
+        return -1;
+
+    const std::deque<COMPLEX>& values = it->second;
+
+    if( aFrom >= values.size() )
+        return 0;
+
+    aData.insert( aData.end(), values.begin() + aFrom, values.end() );
+
+    return values.size() - aFrom;
+}
+
+
+void NGSPICE::SetStreamedVectors( const vector<string>& aNames )
+{
+    std::lock_guard<std::mutex> lock( m_streamLock );
+    m_streamedNames.clear();
+
+    for( const string& name : aNames )
+        m_streamedNames.insert( streamedVectorName( name ) );
+}
+
+
 bool NGSPICE::LoadNetlist( const string& aNetlist )
 {
     LOCALE_IO c_locale;       // ngspice works correctly only with C locale
@@ -259,6 +288,15 @@ bool NGSPICE::LoadNetlist( const string& aNetlist )
 bool NGSPICE::Run()
 {
     LOCALE_IO c_locale;               // ngspice works correctly only with C locale
+
+    {
+        // The values of the previous simulation must not be appended to the new traces
+        // before SendInitData is received
+        std::lock_guard<std::mutex> lock( m_streamLock );
+        m_streamedVectors.clear();
+        m_streamedOrder.clear();
+    }
+
     return Command( "bg_run" );     // bg_* commands execute in a separate thread
 }
 
@@ -393,7 +431,8 @@ void NGSPICE::init_dll()
     m_ngSpice_AllVecs = (ngSpice_AllVecs) m_dll.GetSymbol( "ngSpice_AllVecs" );
     m_ngSpice_Running = (ngSpice_Running) m_dll.GetSymbol( "ngSpice_running" ); // it is not a typo
 
-    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, NULL, NULL, &cbBGThreadRunning, this );
+    m_ngSpice_Init( &cbSendChar, &cbSendStat, &cbControlledExit, &cbSendData, &cbSendInitData,
+                    &cbBGThreadRunning, this );
 
     // Load a custom spinit file, to fix the problem with loading .cm files
     // Switch to the executable directory, so the relative paths are correct
@@ -565,6 +604,73 @@ int NGSPICE::cbControlledExit( int status, bool immediate, bool exit_upon_quit,
 }
 
 
+int NGSPICE::cbSendData( pvecvaluesall vectors, int count, int id, void* user )
+{
+    // Called from the simulation thread for each computed point
+    NGSPICE*                    sim = reinterpret_cast<NGSPICE*>( user );
+    std::lock_guard<std::mutex> lock( sim->m_streamLock );
+
+    if( vectors->veccount != (int) sim->m_streamedOrder.size() )
+        return 0;
+
+    for( int i = 0; i < vectors->veccount; i++ )
+    {
+        const vecvalues* value = vectors->vecsa[i];
+
+        if( sim->m_streamedOrder[i] )
+        {
+            sim->m_streamedOrder[i]->emplace_back( value->creal,
+                                                   value->is_complex ? value->cimag : 0.0 );
+        }
+    }
+
+    return 0;
+}
+
+
+int NGSPICE::cbSendInitData( pvecinfoall vectors, int id, void* user )
+{
+    // Called from the simulation thread when an analysis starts
+    NGSPICE*                    sim = reinterpret_cast<NGSPICE*>( user );
+    std::lock_guard<std::mutex> lock( sim->m_streamLock );
+
+    sim->m_streamedVectors.clear();
+    sim->m_streamedOrder.clear();
+
+    for( int i = 0; i < vectors->veccount; i++ )
+    {
+        std::string name = streamedVectorName( vectors->vecs[i]->vecname );
+
+        // Only the plotted vectors are buffered, the others are read when the analysis ends
+        if( sim->m_streamedNames.count( name ) )
+            sim->m_streamedOrder.push_back( &sim->m_streamedVectors[name] );
+        else
+            sim->m_streamedOrder.push_back( nullptr );
+    }
+
+    return 0;
+}
+
+
+string NGSPICE::streamedVectorName( const string& aName )
+{
+    string name( aName );
+    std::transform( name.begin(), name.end(), name.begin(), ::tolower );
+
+    // ngspice names the vectors of the node voltages after the nodes, and the vectors of
+    // the currents after the branches of the sources
+    if( name.size() > 3 && name.back() == ')' )
+    {
+        if( name.compare( 0, 2, "v(" ) == 0 )
+            return name.substr( 2, name.size() - 3 );
+        else if( name.compare( 0, 2, "i(" ) == 0 )
+            return name.substr( 2, name.size() - 3 ) + "#branch";
+    }
+
+    return name;
+}
+
+
 void NGSPICE::validate()
 {
     if( m_error )
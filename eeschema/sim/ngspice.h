@@ -30,6 +30,11 @@
 #include <wx/dynlib.h>
 #include <ngspice/sharedspice.h>
 
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+
 class wxDynamicLibrary;
 
 class NGSPICE : public SPICE_SIMULATOR {
@@ -77,6 +82,13 @@ public:
     ///> @copydoc SPICE_SIMULATOR::GetPhasePlot()
     std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) override;
 
+    ///> @copydoc SPICE_SIMULATOR::GetPlotValues()
+    int GetPlotValues( const std::string& aName, size_t aFrom,
+                       std::vector<COMPLEX>& aData ) override;
+
+    ///> @copydoc SPICE_SIMULATOR::SetStreamedVectors()
+    void SetStreamedVectors( const std::vector<std::string>& aNames ) override;
+
     ///> @copydoc SPICE_SIMULATOR::GetNetlist()
     virtual const std::string GetNetlist() const override;
 
@@ -124,6 +136,11 @@ private:
     static int cbSendStat( char* what, int id, void* user );
     static int cbBGThreadRunning( bool is_running, int id, void* user );
     static int cbControlledExit( int status, bool immediate, bool exit_upon_quit, int id, void* user );
+    static int cbSendData( pvecvaluesall vectors, int count, int id, void* user );
+    static int cbSendInitData( pvecinfoall vectors, int id, void* user );
+
+    ///> Returns the name of a vector in the streamed vectors (e.g. "out" for V(out))
+    static std::string streamedVectorName( const std::string& aName );
 
     // Assures ngspice is in a valid state and reinitializes it if need be
     void validate();
@@ -136,6 +153,20 @@ private:
 
     ///> current netlist
     std::string m_netlist;
+
+    ///> Values of the vectors received from the simulation thread, with the streamed names.
+    ///> std::deque is used as a chunked buffer: the values are never moved when appending.
+    std::map<std::string, std::deque<COMPLEX>> m_streamedVectors;
+
+    ///> The streamed names of the vectors to buffer
+    std::set<std::string> m_streamedNames;
+
+    ///> The streamed vectors, in the order of the values sent by ngspice, or nullptr for the
+    ///> vectors which are not buffered
+    std::vector<std::deque<COMPLEX>*> m_streamedOrder;
+
+    ///> Protects the streamed vectors
+    std::mutex m_streamLock;
 };
 
 #endif /* NGSPICE_H */
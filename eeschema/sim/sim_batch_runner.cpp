@@ -0,0 +1,535 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "sim_batch_runner.h"
+
+#include <locale_io.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/intl.h>
+#include <wx/process.h>
+#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+
+wxDEFINE_EVENT( EVT_SIM_BATCH_PROGRESS, wxCommandEvent );
+wxDEFINE_EVENT( EVT_SIM_BATCH_FINISHED, wxCommandEvent );
+
+
+/// The console version of ngspice, searched in the PATH
+#ifdef __WINDOWS__
+static const wxChar NGSPICE_EXECUTABLE[] = wxT( "ngspice_con" );
+#else
+static const wxChar NGSPICE_EXECUTABLE[] = wxT( "ngspice" );
+#endif
+
+
+/**
+ * An ngspice process running a variant of the simulation.  The process deletes itself when
+ * it terminates, after it notified its runner.
+ */
+class SIM_BATCH_PROCESS : public wxProcess
+{
+public:
+    SIM_BATCH_PROCESS( SIM_BATCH_RUNNER* aRunner, size_t aRun ) :
+        m_runner( aRunner ),
+        m_run( aRun ),
+        m_pid( 0 )
+    {
+    }
+
+    void OnTerminate( int aPid, int aStatus ) override
+    {
+        if( m_runner )
+            m_runner->onProcessEnd( this, aStatus );
+
+        RemoveFiles();
+        delete this;
+    }
+
+    void RemoveFiles()
+    {
+        for( const wxString& file : { m_netlistFile, m_rawFile, m_logFile } )
+        {
+            if( !file.IsEmpty() && wxFileExists( file ) )
+                wxRemoveFile( file );
+        }
+    }
+
+    SIM_BATCH_RUNNER* m_runner;         ///< null once the process is cancelled
+    size_t            m_run;
+    long              m_pid;
+    wxString          m_netlistFile;
+    wxString          m_rawFile;
+    wxString          m_logFile;
+};
+
+
+static bool readFile( const wxString& aFileName, std::string& aData )
+{
+    if( !wxFileExists( aFileName ) )
+        return false;
+
+    wxFFile file( aFileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    aData.resize( (size_t) file.Length() );
+
+    return aData.empty() || file.Read( &aData[0], aData.size() ) == aData.size();
+}
+
+
+SIM_BATCH_RUNNER::SIM_BATCH_RUNNER( const std::string& aNetlist,
+                                    const std::vector<wxString>& aVectors ) :
+    m_netlist( aNetlist ),
+    m_vectors( aVectors ),
+    m_nextRun( 0 ),
+    m_doneCount( 0 ),
+    m_maxProcesses( 1 ),
+    m_complex( false ),
+    m_listener( nullptr )
+{
+}
+
+
+SIM_BATCH_RUNNER::~SIM_BATCH_RUNNER()
+{
+    Cancel();
+}
+
+
+void SIM_BATCH_RUNNER::AddParam( const wxString& aSpiceName, const SPICE_VALUE& aMin,
+                                 const SPICE_VALUE& aMax )
+{
+    m_params.push_back( { aSpiceName, aMin, aMax } );
+}
+
+
+void SIM_BATCH_RUNNER::CreateSweepRuns( int aSteps )
+{
+    m_runs.clear();
+
+    if( aSteps < 1 )
+        return;
+
+    size_t count = 1;
+
+    for( size_t ii = 0; ii < m_params.size(); ++ii )
+        count *= aSteps;
+
+    for( size_t ii = 0; ii < count; ++ii )
+    {
+        RUN    run;
+        size_t index = ii;
+
+        // The first parameter varies the fastest
+        for( const PARAM& param : m_params )
+        {
+            int    step = index % aSteps;
+            double ratio = aSteps > 1 ? (double) step / ( aSteps - 1 ) : 0.5;
+            double min = param.m_min.ToDouble();
+
+            run.m_values.emplace_back( min + ( param.m_max.ToDouble() - min ) * ratio );
+            index /= aSteps;
+        }
+
+        m_runs.push_back( std::move( run ) );
+    }
+}
+
+
+void SIM_BATCH_RUNNER::CreateMonteCarloRuns( int aCount, unsigned aSeed )
+{
+    m_runs.clear();
+
+    std::mt19937                           rng( aSeed );
+    std::uniform_real_distribution<double> ratio( 0.0, 1.0 );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        RUN run;
+
+        for( const PARAM& param : m_params )
+        {
+            double min = param.m_min.ToDouble();
+
+            run.m_values.emplace_back( min + ( param.m_max.ToDouble() - min ) * ratio( rng ) );
+        }
+
+        m_runs.push_back( std::move( run ) );
+    }
+}
+
+
+std::string SIM_BATCH_RUNNER::GetRunNetlist( size_t aRun, const wxString& aRawFile ) const
+{
+    // The control block is inserted in place of the final .end
+    size_t      end = m_netlist.rfind( "\n.end" );
+    std::string netlist = m_netlist.substr( 0, end == std::string::npos ? m_netlist.size()
+                                                                        : end + 1 );
+    const RUN&  run = m_runs.at( aRun );
+
+    netlist += ".control\n";
+
+    for( size_t ii = 0; ii < m_params.size(); ++ii )
+    {
+        /// @todo no ngspice hardcoding
+        netlist += "alter @" + m_params[ii].m_spiceName.ToStdString() + "="
+                   + run.m_values[ii].ToSpiceString().ToStdString() + "\n";
+    }
+
+    netlist += "run\n";
+    netlist += "set filetype=ascii\n";
+    netlist += "write \"" + aRawFile.ToStdString() + "\"";
+
+    for( const wxString& vector : m_vectors )
+        netlist += " " + vector.ToStdString();
+
+    netlist += "\n.endc\n";
+    netlist += ".end\n";
+
+    return netlist;
+}
+
+
+void SIM_BATCH_RUNNER::Start( wxEvtHandler* aListener, int aProcesses )
+{
+    Cancel();
+
+    m_listener = aListener;
+    m_maxProcesses = aProcesses > 0 ? aProcesses
+                                    : std::max( std::thread::hardware_concurrency(), 1u );
+    m_nextRun = 0;
+    m_doneCount = 0;
+    m_complex = false;
+
+    for( RUN& run : m_runs )
+    {
+        run.m_vectors.clear();
+        run.m_error.clear();
+        run.m_done = false;
+    }
+
+    startRuns();
+}
+
+
+void SIM_BATCH_RUNNER::Cancel()
+{
+    for( SIM_BATCH_PROCESS* process : m_processes )
+    {
+        // The process deletes itself when it terminates
+        process->m_runner = nullptr;
+        wxProcess::Kill( process->m_pid, wxSIGKILL, wxKILL_CHILDREN );
+    }
+
+    m_processes.clear();
+    m_nextRun = m_runs.size();
+    m_listener = nullptr;
+}
+
+
+void SIM_BATCH_RUNNER::startRuns()
+{
+    while( m_processes.size() < m_maxProcesses && m_nextRun < m_runs.size() )
+        startRun( m_nextRun++ );
+
+    if( m_processes.empty() && m_nextRun >= m_runs.size() )
+        notify( EVT_SIM_BATCH_FINISHED, -1 );
+}
+
+
+void SIM_BATCH_RUNNER::startRun( size_t aRun )
+{
+    wxString netlistFile = wxFileName::CreateTempFileName( "kicad_sim" );
+
+    if( netlistFile.IsEmpty() )
+    {
+        finishRun( aRun, _( "Cannot create a temporary file." ) );
+        return;
+    }
+
+    SIM_BATCH_PROCESS* process = new SIM_BATCH_PROCESS( this, aRun );
+
+    process->m_netlistFile = netlistFile;
+    process->m_rawFile = netlistFile + ".raw";
+    process->m_logFile = netlistFile + ".log";
+
+    std::string netlist = GetRunNetlist( aRun, process->m_rawFile );
+    wxFFile     file( netlistFile, "wb" );
+
+    if( !file.IsOpened() || !file.Write( netlist.data(), netlist.size() ) || !file.Close() )
+    {
+        process->RemoveFiles();
+        delete process;
+        finishRun( aRun, wxString::Format( _( "Cannot write the netlist file %s." ),
+                                           netlistFile ) );
+        return;
+    }
+
+    wxString command = wxString::Format( "%s -b -o \"%s\" \"%s\"", NGSPICE_EXECUTABLE,
+                                         process->m_logFile, process->m_netlistFile );
+
+    // The process leads its own group, so Cancel() also kills its children, and only them
+    process->m_pid = wxExecute( command,
+                                wxEXEC_ASYNC | wxEXEC_HIDE_CONSOLE | wxEXEC_MAKE_GROUP_LEADER,
+                                process );
+
+    if( process->m_pid == 0 )
+    {
+        // The process object is not used by wxWidgets if the command could not be run
+        process->RemoveFiles();
+        delete process;
+        finishRun( aRun, wxString::Format( _( "Cannot run %s." ), NGSPICE_EXECUTABLE ) );
+        return;
+    }
+
+    m_processes.push_back( process );
+}
+
+
+void SIM_BATCH_RUNNER::onProcessEnd( SIM_BATCH_PROCESS* aProcess, int aStatus )
+{
+    m_processes.erase( std::remove( m_processes.begin(), m_processes.end(), aProcess ),
+                       m_processes.end() );
+
+    RUN&        run = m_runs[aProcess->m_run];
+    std::string data;
+    bool        complex = false;
+    wxString    error;
+
+    if( !readFile( aProcess->m_rawFile, data )
+            || !ParseRawData( data, run.m_vectors, complex )
+            || run.m_vectors.size() != m_vectors.size() + 1 )
+    {
+        run.m_vectors.clear();
+
+        // Report the errors printed by ngspice
+        std::string log;
+
+        if( readFile( aProcess->m_logFile, log ) )
+        {
+            wxStringTokenizer lines( wxString::FromUTF8( log.c_str() ), "\r\n" );
+
+            while( lines.HasMoreTokens() )
+            {
+                wxString line = lines.GetNextToken();
+
+                if( line.Lower().Contains( "error" ) )
+                    error += ( error.IsEmpty() ? "" : "\n" ) + line;
+            }
+        }
+
+        if( error.IsEmpty() )
+            error = wxString::Format( _( "ngspice exited with status %d." ), aStatus );
+    }
+    else
+    {
+        m_complex |= complex;
+    }
+
+    finishRun( aProcess->m_run, error );
+    startRuns();
+}
+
+
+void SIM_BATCH_RUNNER::finishRun( size_t aRun, const wxString& aError )
+{
+    m_runs[aRun].m_error = aError;
+    m_runs[aRun].m_done = true;
+    m_doneCount++;
+
+    notify( EVT_SIM_BATCH_PROGRESS, (int) aRun );
+}
+
+
+void SIM_BATCH_RUNNER::notify( const wxEventType& aType, int aRun )
+{
+    if( !m_listener )
+        return;
+
+    wxCommandEvent* event = new wxCommandEvent( aType );
+    event->SetInt( aRun );
+    event->SetEventObject( this );
+    wxQueueEvent( m_listener, event );
+}
+
+
+bool SIM_BATCH_RUNNER::WriteCsv( const wxString& aFileName, const wxString& aScaleName ) const
+{
+    LOCALE_IO     toggle;
+    const wxChar  SEPARATOR = ';';
+    wxFFile       out( aFileName, "wb" );
+
+    if( !out.IsOpened() )
+        return false;
+
+    wxString line = "Run";
+
+    for( const PARAM& param : m_params )
+        line << SEPARATOR << param.m_spiceName;
+
+    line << SEPARATOR << aScaleName;
+
+    for( const wxString& vector : m_vectors )
+    {
+        if( m_complex )
+            line << SEPARATOR << vector << " mag" << SEPARATOR << vector << " phase";
+        else
+            line << SEPARATOR << vector;
+    }
+
+    out.Write( line + "\r\n" );
+
+    for( size_t ii = 0; ii < m_runs.size(); ++ii )
+    {
+        const RUN& run = m_runs[ii];
+
+        if( run.m_vectors.empty() )
+            continue;
+
+        wxString prefix = wxString::Format( "%d", (int) ii + 1 );
+
+        for( const SPICE_VALUE& value : run.m_values )
+            prefix << SEPARATOR << value.ToSpiceString();
+
+        for( size_t point = 0; point < run.m_vectors[0].size(); ++point )
+        {
+            line = prefix;
+            line << SEPARATOR << wxString::Format( "%.10g", run.m_vectors[0][point].real() );
+
+            for( size_t vector = 1; vector < run.m_vectors.size(); ++vector )
+            {
+                const COMPLEX& value = run.m_vectors[vector][point];
+
+                if( m_complex )
+                {
+                    line << SEPARATOR << wxString::Format( "%.10g", std::abs( value ) )
+                         << SEPARATOR << wxString::Format( "%.10g", std::arg( value ) );
+                }
+                else
+                {
+                    line << SEPARATOR << wxString::Format( "%.10g", value.real() );
+                }
+            }
+
+            out.Write( line + "\r\n" );
+        }
+    }
+
+    return out.Close();
+}
+
+
+bool SIM_BATCH_RUNNER::ParseRawData( const std::string& aData,
+                                     std::vector<std::vector<COMPLEX>>& aVectors,
+                                     bool& aComplex )
+{
+    LOCALE_IO toggle;       // strtod() depends on the locale
+
+    long   variables = -1;
+    long   points = -1;
+    bool   values = false;
+    size_t pos = 0;
+
+    aVectors.clear();
+    aComplex = false;
+
+    // The header lines, until the values
+    while( pos < aData.size() && !values )
+    {
+        size_t      eol = std::min( aData.find( '\n', pos ), aData.size() );
+        const char* line = aData.c_str() + pos;
+
+        if( !strncmp( line, "Flags:", 6 ) )
+            aComplex = aData.substr( pos, eol - pos ).find( "complex" ) != std::string::npos;
+        else if( !strncmp( line, "No. Variables:", 14 ) )
+            variables = strtol( line + 14, nullptr, 10 );
+        else if( !strncmp( line, "No. Points:", 11 ) )
+            points = strtol( line + 11, nullptr, 10 );
+        else if( !strncmp( line, "Values:", 7 ) )
+            values = true;
+
+        pos = eol + 1;
+    }
+
+    if( !values || variables <= 0 || points < 0 )
+        return false;
+
+    aVectors.resize( variables );
+
+    for( std::vector<COMPLEX>& vector : aVectors )
+        vector.reserve( points );
+
+    // Each point is its index, then the value of each variable, as "re,im" if complex
+    const char* p = aData.c_str() + std::min( pos, aData.size() );
+    char*       end;
+
+    for( long point = 0; point < points; ++point )
+    {
+        strtol( p, &end, 10 );
+
+        if( end == p )
+            return false;
+
+        p = end;
+
+        for( std::vector<COMPLEX>& vector : aVectors )
+        {
+            double re = strtod( p, &end );
+            double im = 0.0;
+
+            if( end == p )
+                return false;
+
+            p = end;
+
+            if( aComplex )
+            {
+                if( *p != ',' )
+                    return false;
+
+                im = strtod( p + 1, &end );
+
+                if( end == p + 1 )
+                    return false;
+
+                p = end;
+            }
+
+            vector.emplace_back( re, im );
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,184 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SIM_BATCH_RUNNER_H
+#define SIM_BATCH_RUNNER_H
+
+#include "spice_simulator.h"
+#include "spice_value.h"
+
+#include <string>
+#include <vector>
+
+#include <wx/event.h>
+#include <wx/string.h>
+
+class SIM_BATCH_PROCESS;
+
+
+/**
+ * Sent to the listener of a #SIM_BATCH_RUNNER when a run is finished.  The int of the event
+ * is the index of the run.
+ */
+wxDECLARE_EVENT( EVT_SIM_BATCH_PROGRESS, wxCommandEvent );
+
+/**
+ * Sent to the listener of a #SIM_BATCH_RUNNER when all the runs are finished.
+ */
+wxDECLARE_EVENT( EVT_SIM_BATCH_FINISHED, wxCommandEvent );
+
+
+/**
+ * Run variants of a simulation, for sweeps of parameter values and Monte Carlo analyses.
+ *
+ * The variants are the netlist of the simulation, with a control block which alters the
+ * values of the parameters, runs the simulation and writes the selected vectors in a raw
+ * file.  The ngspice shared library can only run one simulation at a time, so the variants
+ * are run by ngspice processes, as many at once as there are cores.
+ *
+ * The processes are managed from the main thread, by their termination events.
+ */
+class SIM_BATCH_RUNNER : public wxEvtHandler
+{
+public:
+    ///> A parameter of the runs: the value of a device, altered with "alter @name=value"
+    struct PARAM
+    {
+        wxString    m_spiceName;
+        SPICE_VALUE m_min;
+        SPICE_VALUE m_max;
+    };
+
+    struct RUN
+    {
+        ///> Values of the parameters, in the order of the parameters
+        std::vector<SPICE_VALUE> m_values;
+
+        ///> Scale of the simulation, then the selected vectors
+        std::vector<std::vector<COMPLEX>> m_vectors;
+
+        ///> Empty if the run succeeded
+        wxString m_error;
+
+        bool m_done = false;
+    };
+
+    /**
+     * @param aNetlist is the netlist of the simulation, ended by ".end".
+     * @param aVectors are the vectors to save, as ngspice names them.
+     */
+    SIM_BATCH_RUNNER( const std::string& aNetlist, const std::vector<wxString>& aVectors );
+
+    ///> Kills the running processes
+    ~SIM_BATCH_RUNNER();
+
+    void AddParam( const wxString& aSpiceName, const SPICE_VALUE& aMin, const SPICE_VALUE& aMax );
+
+    /**
+     * Create the runs of a sweep: all the combinations of \a aSteps values of each parameter,
+     * evenly spaced from its minimum to its maximum.
+     */
+    void CreateSweepRuns( int aSteps );
+
+    /**
+     * Create the runs of a Monte Carlo analysis: the value of each parameter is uniformly
+     * distributed between its minimum and its maximum.
+     *
+     * @param aSeed makes the runs reproducible.
+     */
+    void CreateMonteCarloRuns( int aCount, unsigned aSeed );
+
+    const std::vector<PARAM>& GetParams() const { return m_params; }
+
+    const std::vector<RUN>& GetRuns() const { return m_runs; }
+
+    const std::vector<wxString>& GetVectors() const { return m_vectors; }
+
+    ///> @return true if the vectors of the runs are complex
+    bool IsComplex() const { return m_complex; }
+
+    /**
+     * @return the netlist of the run \a aRun, which writes the vectors in \a aRawFile.
+     */
+    std::string GetRunNetlist( size_t aRun, const wxString& aRawFile ) const;
+
+    /**
+     * Start the runs.  \a aListener receives the EVT_SIM_BATCH_PROGRESS and
+     * EVT_SIM_BATCH_FINISHED events.
+     *
+     * @param aProcesses is the maximum number of ngspice processes, or 0 for the number of
+     * cores.
+     */
+    void Start( wxEvtHandler* aListener, int aProcesses = 0 );
+
+    ///> Kill the running processes and forget the pending runs; no event is sent anymore
+    void Cancel();
+
+    bool IsRunning() const { return !m_processes.empty(); }
+
+    ///> @return the count of finished runs, including the failed ones
+    size_t GetDoneCount() const { return m_doneCount; }
+
+    /**
+     * Write the runs in a CSV file: one row per point of each run, with the parameter
+     * values, the scale and the vectors.  Complex values are written as magnitude and phase.
+     */
+    bool WriteCsv( const wxString& aFileName, const wxString& aScaleName ) const;
+
+    /**
+     * Read the vectors of the first plot of an ASCII raw file, as written by ngspice.
+     *
+     * @param aVectors receives the vectors, the scale first.
+     * @param aComplex is set if the values are complex (AC analysis).
+     * @return false if the data is not a valid raw file.
+     */
+    static bool ParseRawData( const std::string& aData,
+                              std::vector<std::vector<COMPLEX>>& aVectors, bool& aComplex );
+
+private:
+    friend class SIM_BATCH_PROCESS;
+
+    ///> Start the pending runs until m_maxProcesses processes are running
+    void startRuns();
+
+    void startRun( size_t aRun );
+
+    void onProcessEnd( SIM_BATCH_PROCESS* aProcess, int aStatus );
+
+    void finishRun( size_t aRun, const wxString& aError );
+
+    void notify( const wxEventType& aType, int aRun );
+
+    std::string                     m_netlist;
+    std::vector<wxString>           m_vectors;
+    std::vector<PARAM>              m_params;
+    std::vector<RUN>                m_runs;
+    size_t                          m_nextRun;
+    size_t                          m_doneCount;
+    size_t                          m_maxProcesses;
+    bool                            m_complex;
+    std::vector<SIM_BATCH_PROCESS*> m_processes;
+    wxEvtHandler*                   m_listener;
+};
+
+#endif  // SIM_BATCH_RUNNER_H
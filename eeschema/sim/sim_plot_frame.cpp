@@ -25,6 +25,7 @@
  */
 
 #include <wx/stc/stc.h>
+#include <wx/numdlg.h>
 
 #include <sch_edit_frame.h>
 #include <eeschema_id.h>
@@ -38,6 +39,7 @@
 #include <pgm_base.h>
 #include "sim_plot_frame.h"
 #include "sim_plot_panel.h"
+#include "sim_batch_runner.h"
 #include "spice_simulator.h"
 #include "spice_reporter.h"
 #include <menus_helpers.h>
@@ -46,6 +48,15 @@
 #include <tools/ee_actions.h>
 #include <eeschema_settings.h>
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+///> Interval of the updates of the transient plots during the simulation, in ms
+static const int SIM_REFRESH_INTERVAL = 250;
+
+
 SIM_PLOT_TYPE operator|( SIM_PLOT_TYPE aFirst, SIM_PLOT_TYPE aSecond )
 {
     int res = (int) aFirst | (int) aSecond;
@@ -121,6 +132,8 @@ wxString SIM_PLOT_FRAME::m_savedWorkbooksPath;
 SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
         : SIM_PLOT_FRAME_BASE( aParent ),
           m_lastSimPlot( nullptr ),
+          m_streamedPlot( nullptr ),
+          m_batchPlot( nullptr ),
           m_welcomePanel( nullptr ),
           m_plotNumber( 0 )
 {
@@ -171,6 +184,11 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Connect( EVT_SIM_STARTED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimStarted ), NULL, this );
     Connect( EVT_SIM_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onSimFinished ), NULL, this );
     Connect( EVT_SIM_CURSOR_UPDATE, wxCommandEventHandler( SIM_PLOT_FRAME::onCursorUpdate ), NULL, this );
+    Connect( EVT_SIM_BATCH_PROGRESS, wxCommandEventHandler( SIM_PLOT_FRAME::onBatchProgress ), NULL, this );
+    Connect( EVT_SIM_BATCH_FINISHED, wxCommandEventHandler( SIM_PLOT_FRAME::onBatchFinished ), NULL, this );
+
+    m_refreshTimer.SetOwner( this );
+    Bind( wxEVT_TIMER, &SIM_PLOT_FRAME::onRefreshTimer, this, m_refreshTimer.GetId() );
 
     // Toolbar buttons
     m_toolSimulate = m_toolBar->AddTool( ID_SIM_RUN, _( "Run/Stop Simulation" ),
@@ -203,6 +221,18 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onShowNetlist, this, m_showNetlist->GetId() );
     Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSettings,    this, m_settings->GetId() );
 
+    // Batch runs of the tuned values, after the Tune menu item
+    size_t tunePos = 0;
+    m_simulationMenu->FindChildItem( m_tuneValue->GetId(), &tunePos );
+
+    m_sweepTuners = m_simulationMenu->Insert( tunePos + 1, wxID_ANY, _( "Sweep Tuned Values..." ),
+            _( "Run the simulation for combinations of values of the tuned components" ) );
+    m_monteCarlo = m_simulationMenu->Insert( tunePos + 2, wxID_ANY, _( "Monte Carlo Runs..." ),
+            _( "Run the simulation for random values of the tuned components" ) );
+
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onSweepTuners, this, m_sweepTuners->GetId() );
+    Bind( wxEVT_COMMAND_MENU_SELECTED, &SIM_PLOT_FRAME::onMonteCarlo,  this, m_monteCarlo->GetId() );
+
     m_toolBar->Realize();
 
     m_welcomePanel = new SIM_PANEL_BASE( ST_UNKNOWN, m_plotNotebook, wxID_ANY );
@@ -229,6 +259,7 @@ SIM_PLOT_FRAME::SIM_PLOT_FRAME( KIWAY* aKiway, wxWindow* aParent )
 
 SIM_PLOT_FRAME::~SIM_PLOT_FRAME()
 {
+    m_refreshTimer.Stop();
     m_simulator->SetReporter( nullptr );
     delete m_reporter;
     delete m_signalsIconColorList;
@@ -458,6 +489,7 @@ void SIM_PLOT_FRAME::StartSimulation( const wxString& aSimCommand )
     m_simulator->LoadNetlist( formatter.GetString() );
     updateTuners();
     applyTuners();
+    setStreamedVectors();
     m_simulator->Run();
 }
 
@@ -791,6 +823,93 @@ bool SIM_PLOT_FRAME::updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL*
 }
 
 
+int SIM_PLOT_FRAME::appendPlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL* aPanel )
+{
+    TRACE* trace = aPanel->GetTrace( aDescriptor.GetTitle() );
+
+    if( !trace )
+        return -1;
+
+    wxString spiceVector = m_exporter->ComponentToVector(
+            aDescriptor.GetName(), aDescriptor.GetType(), aDescriptor.GetParam() );
+    wxString xAxisName( m_simulator->GetXAxis( ST_TRANSIENT ) );
+
+    // Read only the values which are not plotted yet
+    size_t               from = trace->GetDataX().size();
+    std::vector<COMPLEX> data_x, data_y;
+
+    if( m_simulator->GetPlotValues( (const char*) xAxisName.c_str(), from, data_x ) < 0
+            || m_simulator->GetPlotValues( (const char*) spiceVector.c_str(), from, data_y ) < 0 )
+    {
+        return -1;
+    }
+
+    // A point can be received between the two reads: it will be appended by the next update
+    size_t              count = std::min( data_x.size(), data_y.size() );
+    std::vector<double> xs( count ), ys( count );
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        xs[i] = data_x[i].real();
+        ys[i] = data_y[i].real();
+    }
+
+    trace->AppendData( xs, ys );
+
+    return count;
+}
+
+
+void SIM_PLOT_FRAME::setStreamedVectors()
+{
+    // The other vectors are read when the simulation ends, see onSimFinished()
+    std::vector<std::string> names;
+    SIM_PLOT_PANEL*          plotPanel = CurrentPlot();
+
+    if( plotPanel && plotPanel->GetType() == ST_TRANSIENT
+            && m_exporter->GetSimType() == ST_TRANSIENT )
+    {
+        names.push_back( m_simulator->GetXAxis( ST_TRANSIENT ) );
+
+        for( const std::pair<const wxString, TRACE_DESC>& trace : m_plots[plotPanel].m_traces )
+        {
+            wxString spiceVector = m_exporter->ComponentToVector( trace.second.GetName(),
+                                                                  trace.second.GetType(),
+                                                                  trace.second.GetParam() );
+            names.push_back( (const char*) spiceVector.c_str() );
+        }
+    }
+
+    m_simulator->SetStreamedVectors( names );
+}
+
+
+/**
+ * The position and the scale of the axes of a plot
+ */
+static std::vector<double> plotView( const mpWindow* aPlotWin )
+{
+    return { aPlotWin->GetPosX(), aPlotWin->GetPosY(), aPlotWin->GetScaleX(),
+             aPlotWin->GetScaleY() };
+}
+
+
+void SIM_PLOT_FRAME::fitStreamedPlot( SIM_PLOT_PANEL* aPanel )
+{
+    mpWindow* plotWin = aPanel->GetPlotWin();
+
+    if( m_streamedView.empty() || plotView( plotWin ) == m_streamedView )
+    {
+        plotWin->Fit();
+        m_streamedView = plotView( plotWin );
+    }
+    else
+    {
+        plotWin->UpdateAll();
+    }
+}
+
+
 void SIM_PLOT_FRAME::updateSignalList()
 {
     m_signals->ClearAll();
@@ -896,6 +1015,136 @@ void SIM_PLOT_FRAME::applyTuners()
 }
 
 
+void SIM_PLOT_FRAME::runBatch( bool aMonteCarlo )
+{
+    if( m_batchRunner && m_batchRunner->IsRunning() )
+    {
+        if( IsOK( this, _( "Cancel the running batch of simulations?" ) ) )
+        {
+            m_batchRunner->Cancel();
+            m_simConsole->AppendText( _( "Batch cancelled.\n" ) );
+        }
+
+        return;
+    }
+
+    SIM_PLOT_PANEL*  plotPanel = CurrentPlot();
+    STRING_FORMATTER formatter;
+
+    if( !plotPanel || m_plots[plotPanel].m_traces.empty() )
+    {
+        DisplayInfoMessage( this, _( "Add signals to the plot first." ) );
+        return;
+    }
+
+    if( !m_settingsDlg )
+        m_settingsDlg = new DIALOG_SIM_SETTINGS( this );
+
+    updateNetlistExporter();
+    m_exporter->SetSimCommand( m_plots[plotPanel].m_simCommand );
+
+    if( !m_exporter->Format( &formatter, m_settingsDlg->GetNetlistOptions() ) )
+    {
+        DisplayError( this, _( "There were errors during netlist export, aborted." ) );
+        return;
+    }
+
+    if( m_exporter->GetSimType() != plotPanel->GetType() )
+    {
+        DisplayInfoMessage( this, _( "Run the simulation of the current plot first." ) );
+        return;
+    }
+
+    updateTuners();
+
+    if( m_tuners.empty() )
+    {
+        DisplayInfoMessage( this, _( "The batch runs vary the values of the tuned components "
+                                     "within the ranges of their tuners: tune components "
+                                     "first." ) );
+        return;
+    }
+
+    long count;
+
+    if( aMonteCarlo )
+    {
+        count = wxGetNumberFromUser( _( "Random values of the tuned components:" ),
+                                     _( "Runs:" ), _( "Monte Carlo Runs" ), 50, 1, 10000, this );
+    }
+    else
+    {
+        count = wxGetNumberFromUser( _( "Values of each tuned component:" ), _( "Values:" ),
+                                     _( "Sweep Tuned Values" ), 3, 2, 100, this );
+    }
+
+    if( count < 0 )
+        return;
+
+    double runs = aMonteCarlo ? count : std::pow( (double) count, (double) m_tuners.size() );
+
+    if( runs > 1000 && !IsOK( this, wxString::Format( _( "Run %.0f simulations?" ), runs ) ) )
+        return;
+
+    // The vectors of the traces, once each (the AC traces share their vector)
+    std::vector<wxString> vectors;
+
+    m_batchDescs.clear();
+
+    for( const std::pair<const wxString, TRACE_DESC>& trace : m_plots[plotPanel].m_traces )
+    {
+        wxString vector = m_exporter->ComponentToVector( trace.second.GetName(),
+                trace.second.GetType(), trace.second.GetParam() );
+        auto     it = std::find( vectors.begin(), vectors.end(), vector );
+
+        if( it == vectors.end() )
+            it = vectors.insert( vectors.end(), vector );
+
+        m_batchDescs.emplace_back( trace.second, it - vectors.begin() );
+    }
+
+    m_batchRunner.reset( new SIM_BATCH_RUNNER( formatter.GetString(), vectors ) );
+
+    for( TUNER_SLIDER* tuner : m_tuners )
+        m_batchRunner->AddParam( tuner->GetSpiceName(), tuner->GetMin(), tuner->GetMax() );
+
+    if( aMonteCarlo )
+        m_batchRunner->CreateMonteCarloRuns( count, std::random_device()() );
+    else
+        m_batchRunner->CreateSweepRuns( count );
+
+    removeBatchTraces( plotPanel );
+    m_batchPlot = plotPanel;
+
+    m_simConsole->Clear();
+    m_simConsole->AppendText( wxString::Format( _( "Running %d simulations...\n" ),
+                                                (int) m_batchRunner->GetRuns().size() ) );
+
+    m_batchRunner->Start( this );
+}
+
+
+void SIM_PLOT_FRAME::removeBatchTraces( SIM_PLOT_PANEL* aPanel )
+{
+    auto plot = m_plots.find( aPanel );
+
+    if( plot == m_plots.end() || plot->second.m_batchTraces.empty() )
+        return;
+
+    for( const wxString& name : plot->second.m_batchTraces )
+    {
+        if( aPanel->TraceShown( name ) )
+            aPanel->DeleteTrace( name );
+    }
+
+    plot->second.m_batchTraces.clear();
+    aPanel->GetPlotWin()->Fit();
+
+    wxCommandEvent dummy;
+    onCursorUpdate( dummy );
+}
+
+
 bool SIM_PLOT_FRAME::loadWorkbook( const wxString& aPath )
 {
     m_plots.clear();
@@ -1234,6 +1483,9 @@ void SIM_PLOT_FRAME::onPlotClose( wxAuiNotebookEvent& event )
     SIM_PANEL_BASE* plotPanel =
             dynamic_cast<SIM_PANEL_BASE*>( m_plotNotebook->GetPage( idx ) );
 
+    if( plotPanel == m_streamedPlot )
+        m_streamedPlot = nullptr;
+
     m_plots.erase( plotPanel );
     updateSignalList();
     wxCommandEvent dummy;
@@ -1408,6 +1660,18 @@ void SIM_PLOT_FRAME::onShowNetlist( wxCommandEvent& event )
 }
 
 
+void SIM_PLOT_FRAME::onSweepTuners( wxCommandEvent& event )
+{
+    runBatch( false );
+}
+
+
+void SIM_PLOT_FRAME::onMonteCarlo( wxCommandEvent& event )
+{
+    runBatch( true );
+}
+
+
 void SIM_PLOT_FRAME::doCloseWindow()
 {
     SaveSettings( config() );
@@ -1473,11 +1737,32 @@ void SIM_PLOT_FRAME::onSimStarted( wxCommandEvent& aEvent )
 {
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_stop_xpm ) );
     SetCursor( wxCURSOR_ARROWWAIT );
+
+    // The transient plots are redrawn from the values received during the simulation
+    SIM_PLOT_PANEL* plotPanel = CurrentPlot();
+
+    if( plotPanel )
+        removeBatchTraces( plotPanel );
+
+    m_streamedPlot = nullptr;
+    m_streamedView.clear();
+
+    if( plotPanel && plotPanel->GetType() == ST_TRANSIENT
+            && m_exporter->GetSimType() == ST_TRANSIENT )
+    {
+        for( const std::pair<const wxString, TRACE*>& trace : plotPanel->GetTraces() )
+            trace.second->SetData( std::vector<double>(), std::vector<double>() );
+
+        m_streamedPlot = plotPanel;
+        m_refreshTimer.Start( SIM_REFRESH_INTERVAL );
+    }
 }
 
 
 void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 {
+    m_refreshTimer.Stop();
+
     m_toolBar->SetToolNormalBitmap( ID_SIM_RUN, KiBitmap( sim_run_xpm ) );
     SetCursor( wxCURSOR_ARROW );
 
@@ -1494,6 +1779,22 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
     if( IsSimulationRunning() )
         return;
 
+    // Only the traces cleared when the simulation started received the streamed values
+    SIM_PLOT_PANEL* streamedPlot = m_streamedPlot;
+    m_streamedPlot = nullptr;
+
+    if( streamedPlot && streamedPlot != plotPanelWindow )
+    {
+        // The streamed panel is no longer the current one: it only misses the last values
+        for( const std::pair<const wxString, TRACE_DESC>& trace : m_plots[streamedPlot].m_traces )
+        {
+            if( appendPlot( trace.second, streamedPlot ) < 0 )
+                updatePlot( trace.second, streamedPlot );
+        }
+
+        fitStreamedPlot( streamedPlot );
+    }
+
     // If there are any signals plotted, update them
     if( SIM_PANEL_BASE::IsPlottable( simType ) )
     {
@@ -1504,7 +1805,11 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 
         for( auto it = traceMap.begin(); it != traceMap.end(); /* iteration occurs in the loop */)
         {
-            if( !updatePlot( it->second, plotPanel ) )
+            // The streamed transient plots only miss the last values
+            bool appended = plotPanel == streamedPlot && appendPlot( it->second, plotPanel ) >= 0
+                            && !plotPanel->GetTrace( it->first )->GetDataX().empty();
+
+            if( !appended && !updatePlot( it->second, plotPanel ) )
             {
                 removePlot( it->first, false );
                 it = traceMap.erase( it );       // remove a plot that does not exist anymore
@@ -1516,7 +1821,12 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
         }
 
         updateSignalList();
-        plotPanel->GetPlotWin()->UpdateAll();
+
+        if( plotPanel == streamedPlot )
+            fitStreamedPlot( plotPanel );
+        else
+            plotPanel->GetPlotWin()->UpdateAll();
+
         plotPanel->ResetScales();
     }
     else if( simType == ST_OP )
@@ -1548,6 +1858,128 @@ void SIM_PLOT_FRAME::onSimFinished( wxCommandEvent& aEvent )
 }
 
 
+void SIM_PLOT_FRAME::onRefreshTimer( wxTimerEvent& aEvent )
+{
+    // The values are streamed to the panel cleared when the simulation started, even if
+    // another panel was selected since
+    SIM_PLOT_PANEL* plotPanel = m_streamedPlot;
+
+    if( !plotPanel )
+        return;
+
+    bool updated = false;
+
+    for( const std::pair<const wxString, TRACE_DESC>& trace : m_plots[plotPanel].m_traces )
+        updated |= appendPlot( trace.second, plotPanel ) > 0;
+
+    if( updated )
+        fitStreamedPlot( plotPanel );
+}
+
+
+void SIM_PLOT_FRAME::onBatchProgress( wxCommandEvent& aEvent )
+{
+    // The events of a cancelled batch may still be queued
+    if( !m_batchRunner || aEvent.GetEventObject() != m_batchRunner.get() )
+        return;
+
+    const std::vector<SIM_BATCH_RUNNER::RUN>& runs = m_batchRunner->GetRuns();
+    const SIM_BATCH_RUNNER::RUN&              run = runs.at( aEvent.GetInt() );
+
+    wxString msg = wxString::Format( _( "Run %d of %d:" ), aEvent.GetInt() + 1, (int) runs.size() );
+
+    for( size_t ii = 0; ii < run.m_values.size(); ++ii )
+    {
+        msg += wxString::Format( " %s=%s", m_batchRunner->GetParams()[ii].m_spiceName,
+                                 run.m_values[ii].ToSpiceString() );
+    }
+
+    if( !run.m_error.IsEmpty() )
+        msg += ": " + run.m_error;
+
+    m_simConsole->AppendText( msg + "\n" );
+    m_simConsole->SetInsertionPointEnd();
+}
+
+
+void SIM_PLOT_FRAME::onBatchFinished( wxCommandEvent& aEvent )
+{
+    if( !m_batchRunner || aEvent.GetEventObject() != m_batchRunner.get() )
+        return;
+
+    // The plot may have been closed during the runs
+    if( m_plots.find( m_batchPlot ) == m_plots.end() )
+        return;
+
+    const std::vector<SIM_BATCH_RUNNER::RUN>& runs = m_batchRunner->GetRuns();
+    std::vector<wxString>&                    batchTraces = m_plots[m_batchPlot].m_batchTraces;
+    int                                       failed = 0;
+
+    for( size_t ii = 0; ii < runs.size(); ++ii )
+    {
+        const std::vector<std::vector<COMPLEX>>& vectors = runs[ii].m_vectors;
+
+        if( vectors.empty() )
+        {
+            failed++;
+            continue;
+        }
+
+        std::vector<double> data_x( vectors[0].size() );
+        std::vector<double> data_y( vectors[0].size() );
+
+        for( size_t jj = 0; jj < data_x.size(); ++jj )
+            data_x[jj] = vectors[0][jj].real();
+
+        for( const std::pair<TRACE_DESC, size_t>& desc : m_batchDescs )
+        {
+            const std::vector<COMPLEX>& values = vectors[desc.second + 1];
+            SIM_PLOT_TYPE               type = desc.first.GetType();
+
+            for( size_t jj = 0; jj < data_y.size(); ++jj )
+            {
+                if( type & SPT_AC_MAG )
+                    data_y[jj] = std::abs( values[jj] );
+                else if( type & SPT_AC_PHASE )
+                    data_y[jj] = std::arg( values[jj] );
+                else
+                    data_y[jj] = values[jj].real();
+            }
+
+            wxString name = wxString::Format( _( "%s (run %d)" ), desc.first.GetTitle(),
+                                              (int) ii + 1 );
+
+            if( m_batchPlot->AddTrace( name, (int) data_x.size(), data_x.data(), data_y.data(),
+                                       type ) )
+                batchTraces.push_back( name );
+        }
+    }
+
+    m_batchPlot->GetPlotWin()->Fit();
+
+    m_simConsole->AppendText( wxString::Format( _( "%d simulations finished, %d failed.\n" ),
+                                                (int) runs.size(), failed ) );
+    m_simConsole->SetInsertionPointEnd();
+
+    if( failed == (int) runs.size()
+            || !IsOK( this, _( "Save the results of the runs in a CSV file?" ) ) )
+    {
+        return;
+    }
+
+    wxFileDialog saveDlg( this, _( "Save Batch Results" ), "", "",
+                          CsvFileWildcard(), wxFD_SAVE | wxFD_OVERWRITE_PROMPT );
+
+    if( saveDlg.ShowModal() == wxID_CANCEL )
+        return;
+
+    wxString scaleName = m_simulator->GetXAxis( m_batchPlot->GetType() );
+
+    if( !m_batchRunner->WriteCsv( saveDlg.GetPath(), scaleName ) )
+        DisplayError( this, wxString::Format( _( "Cannot write %s." ), saveDlg.GetPath() ) );
+}
+
+
 void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
 {
     if( IsSimulationRunning() )
@@ -1565,6 +1997,7 @@ void SIM_PLOT_FRAME::onSimUpdate( wxCommandEvent& aEvent )
         m_simConsole->Clear();
         // Do not export netlist, it is already stored in the simulator
         applyTuners();
+        setStreamedVectors();
         m_simulator->Run();
     }
 }
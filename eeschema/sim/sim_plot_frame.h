@@ -41,10 +41,12 @@
 #include <dialogs/dialog_sim_settings.h>
 
 #include <wx/event.h>
+#include <wx/timer.h>
 
 #include <list>
 #include <memory>
 #include <map>
+#include <vector>
 
 class SCH_EDIT_FRAME;
 class SCH_COMPONENT;
@@ -56,6 +58,7 @@ class NETLIST_EXPORTER_PSPICE_SIM;
 #include "sim_panel_base.h"
 
 class SIM_THREAD_REPORTER;
+class SIM_BATCH_RUNNER;
 class TUNER_SLIDER;
 
 
@@ -252,6 +255,29 @@ private:
      */
     bool updatePlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL* aPanel );
 
+    /**
+     * @brief Appends to a transient plot the values received from the simulator since its
+     * last update, so the plot is updated while the simulation runs.
+     * @param aDescriptor contains the plot description.
+     * @param aPanel is the panel that displays the plot.
+     * @return The count of appended points, or -1 if the panel does not contain the plot or
+     * the simulator does not stream its values: it must then be updated with updatePlot().
+     */
+    int appendPlot( const TRACE_DESC& aDescriptor, SIM_PLOT_PANEL* aPanel );
+
+    /**
+     * @brief Sets the vectors streamed by the next simulation: the ones of the traces of the
+     * current transient plot, which is updated while the simulation runs.
+     */
+    void setStreamedVectors();
+
+    /**
+     * @brief Fits the streamed plot to its traces, unless the user zoomed or moved it since
+     * its last fit: the plot is then only redrawn.
+     * @param aPanel is the panel that received the streamed values.
+     */
+    void fitStreamedPlot( SIM_PLOT_PANEL* aPanel );
+
     /**
      * @brief Updates the list of currently plotted signals.
      */
@@ -268,6 +294,18 @@ private:
      */
     void applyTuners();
 
+    /**
+     * @brief Runs the simulation of the current plot for several values of the tuned components,
+     * in parallel ngspice processes. The traces of the runs are overlaid on the plot.
+     * @param aMonteCarlo selects random values within the tuner ranges, instead of a sweep.
+     */
+    void runBatch( bool aMonteCarlo );
+
+    /**
+     * @brief Removes the traces of the batch runs from a plot.
+     */
+    void removeBatchTraces( SIM_PLOT_PANEL* aPanel );
+
     /**
      * @brief Loads plot settings from a file.
      * @param aPath is the file name.
@@ -327,6 +365,8 @@ private:
     void onProbe( wxCommandEvent& event );
     void onTune( wxCommandEvent& event );
     void onShowNetlist( wxCommandEvent& event );
+    void onSweepTuners( wxCommandEvent& event );
+    void onMonteCarlo( wxCommandEvent& event );
 
     void doCloseWindow() override;
 
@@ -335,6 +375,9 @@ private:
     void onSimReport( wxCommandEvent& aEvent );
     void onSimStarted( wxCommandEvent& aEvent );
     void onSimFinished( wxCommandEvent& aEvent );
+    void onRefreshTimer( wxTimerEvent& aEvent );
+    void onBatchProgress( wxCommandEvent& aEvent );
+    void onBatchFinished( wxCommandEvent& aEvent );
 
     // adjust the sash dimension of splitter windows after reading
     // the config settings
@@ -349,6 +392,10 @@ private:
     wxToolBarToolBase* m_toolTune;
     wxToolBarToolBase* m_toolSettings;
 
+    // Batch run menu items
+    wxMenuItem* m_sweepTuners;
+    wxMenuItem* m_monteCarlo;
+
     SCH_EDIT_FRAME* m_schematicFrame;
     std::unique_ptr<NETLIST_EXPORTER_PSPICE_SIM> m_exporter;
     std::shared_ptr<SPICE_SIMULATOR> m_simulator;
@@ -363,6 +410,9 @@ private:
 
         ///> Spice directive used to execute the simulation
         wxString m_simCommand;
+
+        ///> Traces of the batch runs overlaid on the plot
+        std::vector<wxString> m_batchTraces;
     };
 
     ///> Map of plot panels and associated data
@@ -400,6 +450,23 @@ private:
     ///> Panel that was used as the most recent one for simulations
     SIM_PLOT_PANEL* m_lastSimPlot;
 
+    ///> Panel whose transient traces receive the values streamed by the running simulation
+    SIM_PLOT_PANEL* m_streamedPlot;
+
+    ///> View of the streamed plot after its last fit (position and scale of the axes), empty
+    ///> before the first fit
+    std::vector<double> m_streamedView;
+
+    ///> Updates the transient plots while the simulation runs
+    wxTimer m_refreshTimer;
+
+    ///> Runs the sweeps and Monte Carlo analyses
+    std::unique_ptr<SIM_BATCH_RUNNER> m_batchRunner;
+
+    ///> Panel of the batch runs, and its traces with the index of their vector in the runs
+    SIM_PLOT_PANEL* m_batchPlot;
+    std::vector<std::pair<TRACE_DESC, size_t>> m_batchDescs;
+
     ///> imagelists uset to add a small coloured icon to signal names
     ///> and cursors name, the same color as the corresponding signal traces
     wxImageList* m_signalsIconColorList;
@@ -113,6 +113,19 @@ public:
         mpFXYVector::SetData( aX, aY );
     }
 
+    /**
+     * @brief Appends points to the trace, while its simulation is running.
+     * @param aX are the X axis values.
+     * @param aY are the Y axis values.
+     */
+    void AppendData( const std::vector<double>& aX, const std::vector<double>& aY ) override
+    {
+        if( m_cursor )
+            m_cursor->Update();
+
+        mpFXYVector::AppendData( aX, aY );
+    }
+
     const std::vector<double>& GetDataX() const
     {
         return m_xs;
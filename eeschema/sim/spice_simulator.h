@@ -145,6 +145,31 @@ public:
      */
     virtual std::vector<double> GetPhasePlot( const std::string& aName, int aMaxLen = -1 ) = 0;
 
+    /**
+     * @brief Appends the values of a vector received from the simulation in progress (or the
+     * last one), starting at a given index. It allows to update a plot during the simulation,
+     * reading only the values received since the previous update.
+     * @param aName is the vector named in Spice convention (e.g. V(3), I(R1)).
+     * @param aFrom is the index of the first value to return.
+     * @param aData receives the values.
+     * @return The count of appended values, or -1 if the simulator does not stream this
+     * vector: it must then be read with GetPlot().
+     */
+    virtual int GetPlotValues( const std::string& aName, size_t aFrom,
+                               std::vector<COMPLEX>& aData )
+    {
+        return -1;
+    }
+
+    /**
+     * @brief Sets the vectors streamed by the next simulations, to be read with GetPlotValues()
+     * while they run. The values of the other vectors are not buffered.
+     * @param aNames are the vectors named in Spice convention (e.g. V(3), I(R1)).
+     */
+    virtual void SetStreamedVectors( const std::vector<std::string>& aNames )
+    {
+    }
+
     /**
      * @brief Returns current SPICE netlist used by the simulator.
      * @return The netlist.
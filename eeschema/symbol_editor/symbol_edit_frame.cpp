@@ -34,6 +34,7 @@
 #include <kiway_express.h>
 #include <symbol_edit_frame.h>
 #include <symbol_library_manager.h>
+#include <lib_table_preloader.h>
 #include <lib_text.h>
 #include <symbol_editor_settings.h>
 #include <pgm_base.h>
@@ -212,6 +213,13 @@ SYMBOL_EDIT_FRAME::SYMBOL_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
     KIPLATFORM::APP::SetShutdownBlockReason( this, _( "Library changes are unsaved" ) );
 
+    // Follow the libraries reloaded in the background
+    m_libraryUpdatePending = false;
+    Bind( EDA_EVT_LIBRARY_UPDATED, &SYMBOL_EDIT_FRAME::onLibraryUpdated, this );
+
+    if( Pgm().GetLibraryPreloader() )
+        Pgm().GetLibraryPreloader()->AddListener( this );
+
     // Ensure the window is on top
     Raise();
 }
@@ -219,6 +227,9 @@ SYMBOL_EDIT_FRAME::SYMBOL_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
 
 SYMBOL_EDIT_FRAME::~SYMBOL_EDIT_FRAME()
 {
+    if( Pgm().GetLibraryPreloader() )
+        Pgm().GetLibraryPreloader()->RemoveListener( this );
+
     // Shutdown all running tools
     if( m_toolManager )
         m_toolManager->ShutdownAllTools();
@@ -911,6 +922,22 @@ void SYMBOL_EDIT_FRAME::SyncLibraries( bool aShowProgress )
 }
 
 
+void SYMBOL_EDIT_FRAME::onLibraryUpdated( wxCommandEvent& aEvent )
+{
+    // Several libraries are often modified together: sync them once for all of them
+    if( m_libraryUpdatePending )
+        return;
+
+    m_libraryUpdatePending = true;
+
+    CallAfter( [this]()
+               {
+                   m_libraryUpdatePending = false;
+                   SyncLibraries( false );
+               } );
+}
+
+
 void SYMBOL_EDIT_FRAME::RegenerateLibraryTree()
 {
     LIB_ID target = getTargetLibId();
@@ -509,6 +509,12 @@ private:
     ///> Renames LIB_PART aliases to avoid conflicts before adding a component to a library
     void ensureUniqueName( LIB_PART* aPart, const wxString& aLibrary );
 
+    ///> Resynchronizes the libraries when they are modified on disk, after the libraries were
+    ///> reloaded in the background.
+    void onLibraryUpdated( wxCommandEvent& aEvent );
+
+    bool m_libraryUpdatePending;    ///< a library sync is queued by onLibraryUpdated()
+
     DECLARE_EVENT_TABLE()
 };
 
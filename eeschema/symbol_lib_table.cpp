@@ -31,6 +31,7 @@
 #include <systemdirsappend.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
+#include <lib_symbol_summary.h>
 
 #define OPT_SEP     '|'         ///< options separator character
 
@@ -70,6 +71,8 @@ void SYMBOL_LIB_TABLE_ROW::SetType( const wxString& aType )
 
 bool SYMBOL_LIB_TABLE_ROW::Refresh()
 {
+    std::lock_guard<std::recursive_mutex> lock( GetPluginLock() );
+
     if( !plugin )
     {
         wxArrayString dummyList;
@@ -85,6 +88,23 @@ bool SYMBOL_LIB_TABLE_ROW::Refresh()
 }
 
 
+void SYMBOL_LIB_TABLE_ROW::Preload( bool aFirstLoad )
+{
+    if( !plugin )
+        plugin.set( SCH_IO_MGR::FindPlugin( type ) );
+    else if( aFirstLoad )
+        return;
+
+    // Enumerating the symbol names loads the library cache of the plugin; the symbols of
+    // the libraries which are indexed are only parsed when used
+    wxArrayString names;
+
+    SetLoaded( false );
+    plugin->EnumerateSymbolLib( names, GetFullURI( true ), GetProperties() );
+    SetLoaded( true );
+}
+
+
 SYMBOL_LIB_TABLE::SYMBOL_LIB_TABLE( SYMBOL_LIB_TABLE* aFallBackTable ) :
     LIB_TABLE( aFallBackTable )
 {
@@ -269,6 +289,7 @@ int SYMBOL_LIB_TABLE::GetModifyHash()
             continue;
         }
 
+        std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
         hash += row->plugin->GetModifyHash();
     }
 
@@ -283,6 +304,7 @@ void SYMBOL_LIB_TABLE::EnumerateSymbolLib( const wxString& aNickname, wxArrayStr
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     wxString options = row->GetOptions();
 
@@ -306,6 +328,8 @@ SYMBOL_LIB_TABLE_ROW* SYMBOL_LIB_TABLE::FindRow( const wxString& aNickname )
     if( !row )
         return nullptr;
 
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
+
     // We've been 'lazy' up until now, but it cannot be deferred any longer,
     // instantiate a PLUGIN of the proper kind if it is not already in this
     // SYMBOL_LIB_TABLE_ROW.
@@ -321,6 +345,7 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */  );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     wxString options = row->GetOptions();
 
@@ -348,6 +373,32 @@ void SYMBOL_LIB_TABLE::LoadSymbolLib( std::vector<LIB_PART*>& aSymbolList,
 }
 
 
+void SYMBOL_LIB_TABLE::LoadSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                                            const wxString& aNickname, bool aPowerSymbolsOnly )
+{
+    SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
+    wxCHECK( row && row->plugin, /* void */  );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
+
+    wxString options = row->GetOptions();
+
+    if( aPowerSymbolsOnly )
+        row->SetOptions( row->GetOptions() + " " + PropPowerSymsOnly );
+
+    row->SetLoaded( false );
+    row->plugin->EnumerateSymbolSummaries( aSummaries, row->GetFullURI( true ),
+                                           row->GetProperties() );
+    row->SetLoaded( true );
+
+    if( aPowerSymbolsOnly )
+        row->SetOptions( options );
+
+    // Only the table knows the library nickname, see LoadSymbolLib()
+    for( LIB_SYMBOL_SUMMARY& summary : aSummaries )
+        summary.SetLibNickname( row->GetNickName() );
+}
+
+
 LIB_PART* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxString& aSymbolName )
 {
     SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
@@ -355,6 +406,8 @@ LIB_PART* SYMBOL_LIB_TABLE::LoadSymbol( const wxString& aNickname, const wxStrin
     if( !row || !row->plugin )
         return nullptr;
 
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
+
     LIB_PART* part = row->plugin->LoadSymbol( row->GetFullURI( true ), aSymbolName,
                                               row->GetProperties() );
 
@@ -382,6 +435,7 @@ SYMBOL_LIB_TABLE::SAVE_T SYMBOL_LIB_TABLE::SaveSymbol( const wxString& aNickname
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, SAVE_SKIPPED );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
 
     if( !aOverwrite )
     {
@@ -408,6 +462,7 @@ void SYMBOL_LIB_TABLE::DeleteSymbol( const wxString& aNickname, const wxString&
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     return row->plugin->DeleteSymbol( row->GetFullURI( true ), aSymbolName,
                                       row->GetProperties() );
 }
@@ -417,6 +472,7 @@ bool SYMBOL_LIB_TABLE::IsSymbolLibWritable( const wxString& aNickname )
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, false );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     return row->plugin->IsSymbolLibWritable( row->GetFullURI( true ) );
 }
 
@@ -424,6 +480,7 @@ bool SYMBOL_LIB_TABLE::IsSymbolLibLoaded( const wxString& aNickname )
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row, false );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     return row->GetIsLoaded();
 }
 
@@ -432,6 +489,7 @@ void SYMBOL_LIB_TABLE::DeleteSymbolLib( const wxString& aNickname )
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->DeleteSymbolLib( row->GetFullURI( true ), row->GetProperties() );
 }
 
@@ -440,6 +498,7 @@ void SYMBOL_LIB_TABLE::CreateSymbolLib( const wxString& aNickname )
 {
     const SYMBOL_LIB_TABLE_ROW* row = FindRow( aNickname );
     wxCHECK( row && row->plugin, /* void */ );
+    std::lock_guard<std::recursive_mutex> lock( row->GetPluginLock() );
     row->plugin->CreateSymbolLib( row->GetFullURI( true ), row->GetProperties() );
 }
 
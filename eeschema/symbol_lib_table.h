@@ -82,6 +82,8 @@ public:
      */
     bool Refresh();
 
+    void Preload( bool aFirstLoad ) override;
+
 protected:
     SYMBOL_LIB_TABLE_ROW( const SYMBOL_LIB_TABLE_ROW& aRow ) :
         LIB_TABLE_ROW( aRow ),
@@ -168,6 +170,19 @@ public:
     void LoadSymbolLib( std::vector<LIB_PART*>& aAliasList, const wxString& aNickname,
                         bool aPowerSymbolsOnly = false );
 
+    /**
+     * Return the properties shown in the symbol tree of the symbols of the library given by
+     * @a aNickname, which are not parsed when the plugin does not need to.
+     *
+     * @param aSummaries is a reference to an array for the properties of the symbols.
+     * @param aNickname is a locator for the "library", it is a "name" in LIB_TABLE_ROW.
+     * @param aPowerSymbolsOnly is a flag to enumerate only power symbols.
+     *
+     * @throw IO_ERROR if the library cannot be found or loaded.
+     */
+    void LoadSymbolSummaries( std::vector<LIB_SYMBOL_SUMMARY>& aSummaries,
+                              const wxString& aNickname, bool aPowerSymbolsOnly = false );
+
     /**
      * Load a #LIB_PART having @a aName from the library given by @a aNickname.
      *
@@ -26,6 +26,7 @@
 #include <eda_pattern_match.h>
 #include <symbol_lib_table.h>
 #include <class_libentry.h>
+#include <lib_symbol_summary.h>
 #include <generate_alias_info.h>
 
 #include <symbol_tree_model_adapter.h>
@@ -93,13 +94,15 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibraries( const std::vector<wxString>& aNick
 
 void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 {
-    bool                        onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
-    std::vector<LIB_PART*>      symbols;
-    std::vector<LIB_TREE_ITEM*> comp_list;
+    bool                            onlyPowerSymbols = ( GetFilter() == CMP_FILTER_POWER );
+    std::vector<LIB_SYMBOL_SUMMARY> symbols;
+    std::vector<LIB_TREE_ITEM*>     comp_list;
 
+    // The tree only needs the properties of the symbols, which the libraries can provide
+    // without parsing them
     try
     {
-        m_libs->LoadSymbolLib( symbols, aLibNickname, onlyPowerSymbols );
+        m_libs->LoadSymbolSummaries( symbols, aLibNickname, onlyPowerSymbols );
     }
     catch( const IO_ERROR& ioe )
     {
@@ -111,7 +114,9 @@ void SYMBOL_TREE_MODEL_ADAPTER::AddLibrary( wxString const& aLibNickname )
 
     if( symbols.size() > 0 )
     {
-        comp_list.assign( symbols.begin(), symbols.end() );
+        for( LIB_SYMBOL_SUMMARY& symbol : symbols )
+            comp_list.push_back( &symbol );
+
         DoAddLibrary( aLibNickname, m_libs->GetDescription( aLibNickname ), comp_list, false );
     }
 }
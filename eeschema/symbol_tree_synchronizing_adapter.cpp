@@ -187,6 +187,7 @@ void SYMBOL_TREE_SYNCHRONIZING_ADAPTER::updateLibrary( LIB_TREE_NODE_LIB& aLibNo
     }
 
     aLibNode.AssignIntrinsicRanks();
+    m_searchIndex.Clear();
     m_libHashes[aLibNode.m_Name] = m_libMgr->GetLibraryHash( aLibNode.m_Name );
 }
 
@@ -197,6 +198,7 @@ LIB_TREE_NODE::PTR_VECTOR::iterator SYMBOL_TREE_SYNCHRONIZING_ADAPTER::deleteLib
     LIB_TREE_NODE* node = aLibNodeIt->get();
     m_libHashes.erase( node->m_Name );
     auto it = m_tree.m_Children.erase( aLibNodeIt );
+    m_searchIndex.Clear();
     return it;
 }
 
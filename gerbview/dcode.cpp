@@ -86,6 +86,64 @@ void D_CODE::Clear_D_CODE_Data()
     m_Rotation   = 0.0;
     m_EdgesCount = 0;
     m_Polygon.RemoveAllContours();
+    m_macroShapeCache.clear();
+}
+
+
+const D_CODE::MACRO_SHAPE_CACHE_ENTRY& D_CODE::getMacroShapeCacheEntry(
+        const GERBER_DRAW_ITEM* aParent )
+{
+    // The draw transform (GERBER_DRAW_ITEM::GetABPosition) is affine: its linear part
+    // is fully defined by the image of 2 axis probes.  Use a large probe to catch
+    // small scale differences.
+    const int probe = 1000000;
+
+    VECTOR2I origin( aParent->GetABPosition( wxPoint( 0, 0 ) ) );
+    VECTOR2I axisA = VECTOR2I( aParent->GetABPosition( wxPoint( probe, 0 ) ) ) - origin;
+    VECTOR2I axisB = VECTOR2I( aParent->GetABPosition( wxPoint( 0, probe ) ) ) - origin;
+
+    for( const MACRO_SHAPE_CACHE_ENTRY& entry : m_macroShapeCache )
+    {
+        if( entry.m_axisA == axisA && entry.m_axisB == axisB
+                && entry.m_unitsMetric == aParent->m_UnitsMetric )
+            return entry;
+    }
+
+    MACRO_SHAPE_CACHE_ENTRY entry;
+    entry.m_axisA = axisA;
+    entry.m_axisB = axisB;
+    entry.m_unitsMetric = aParent->m_UnitsMetric;
+    entry.m_origin = origin;
+    entry.m_shape = *GetMacro()->GetApertureMacroShape( aParent, wxPoint( 0, 0 ) );
+    entry.m_bbox = GetMacro()->GetBoundingBox();
+
+    m_macroShapeCache.push_back( std::move( entry ) );
+
+    return m_macroShapeCache.back();
+}
+
+
+const SHAPE_POLY_SET& D_CODE::GetMacroShape( const GERBER_DRAW_ITEM* aParent, VECTOR2I& aOffset )
+{
+    const MACRO_SHAPE_CACHE_ENTRY& entry = getMacroShapeCacheEntry( aParent );
+
+    aOffset = VECTOR2I( aParent->GetABPosition( aParent->m_Start ) ) - entry.m_origin;
+
+    return entry.m_shape;
+}
+
+
+EDA_RECT D_CODE::GetMacroShapeBoundingBox( const GERBER_DRAW_ITEM* aParent )
+{
+    VECTOR2I offset;
+    const MACRO_SHAPE_CACHE_ENTRY& entry = getMacroShapeCacheEntry( aParent );
+
+    offset = VECTOR2I( aParent->GetABPosition( aParent->m_Start ) ) - entry.m_origin;
+
+    EDA_RECT bbox = entry.m_bbox;
+    bbox.Move( wxPoint( offset.x, offset.y ) );
+
+    return bbox;
 }
 
 
@@ -30,10 +30,12 @@
 #ifndef _DCODE_H_
 #define _DCODE_H_
 
+#include <deque>
 #include <vector>
 
 #include <gal/color4d.h>
 #include <geometry/shape_poly_set.h>
+#include <eda_rect.h>
 
 using KIGFX::COLOR4D;
 
@@ -90,6 +92,25 @@ private:
      */
     std::vector<double>   m_am_params;
 
+    /**
+     * A flashed aperture macro shape, evaluated once for a given draw transform.
+     * Items flashed with this D_CODE and the same transform have the same shape, only
+     * translated.
+     */
+    struct MACRO_SHAPE_CACHE_ENTRY
+    {
+        VECTOR2I       m_axisA;         ///< image of the X axis probe by the draw transform
+        VECTOR2I       m_axisB;         ///< image of the Y axis probe by the draw transform
+        bool           m_unitsMetric;   ///< units used to evaluate the macro
+        VECTOR2I       m_origin;        ///< position of the shape origin, in draw coordinates
+        SHAPE_POLY_SET m_shape;         ///< the shape, flashed at m_origin
+        EDA_RECT       m_bbox;          ///< the bounding box of m_shape
+    };
+
+    std::deque<MACRO_SHAPE_CACHE_ENTRY> m_macroShapeCache;
+
+    const MACRO_SHAPE_CACHE_ENTRY& getMacroShapeCacheEntry( const GERBER_DRAW_ITEM* aParent );
+
 public:
     wxSize                m_Size;           ///< Horizontal and vertical dimensions.
     APERTURE_T            m_Shape;          ///< shape ( Line, rectangle, circle , oval .. )
@@ -122,6 +143,7 @@ public:
     void AppendParam( double aValue )
     {
         m_am_params.push_back( aValue );
+        m_macroShapeCache.clear();
     }
 
     /**
@@ -151,11 +173,32 @@ public:
     void SetMacro( APERTURE_MACRO* aMacro )
     {
         m_Macro = aMacro;
+        m_macroShapeCache.clear();
     }
 
 
     APERTURE_MACRO* GetMacro() const { return m_Macro; }
 
+    /**
+     * Function GetMacroShape
+     * returns the shape of an item flashed with this aperture macro D_CODE.
+     * Evaluating an aperture macro (parameters, primitives, polygon booleans) is expensive,
+     * so the shape is evaluated only once for each draw transform (rotation, scale, mirroring,
+     * units) used by the flashed items, and then only translated.
+     * @param aParent = the flashed GERBER_DRAW_ITEM
+     * @param aOffset = filled with the translation to apply to the returned shape to get
+     * the actual shape of aParent
+     * @return the cached shape
+     */
+    const SHAPE_POLY_SET& GetMacroShape( const GERBER_DRAW_ITEM* aParent, VECTOR2I& aOffset );
+
+    /**
+     * Function GetMacroShapeBoundingBox
+     * @return the bounding box of an item flashed with this aperture macro D_CODE.
+     * @see GetMacroShape
+     */
+    EDA_RECT GetMacroShapeBoundingBox( const GERBER_DRAW_ITEM* aParent );
+
     /**
      * Function ShowApertureType
      * returns a character string telling what type of aperture type \a aType is.
@@ -93,6 +93,10 @@ void GERBVIEW_FRAME::OnSelectHighlightChoice( wxCommandEvent& event )
 {
     auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( GetCanvas()->GetView()->GetPainter() )->GetSettings();
 
+    wxString prevNet = settings->m_netHighlightString;
+    wxString prevComponent = settings->m_componentHighlightString;
+    wxString prevAttribute = settings->m_attributeHighlightString;
+
     switch( event.GetId() )
     {
     case ID_GBR_AUX_TOOLBAR_PCB_CMP_CHOICE:
@@ -109,11 +113,50 @@ void GERBVIEW_FRAME::OnSelectHighlightChoice( wxCommandEvent& event )
 
     }
 
-    GetCanvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
+    UpdateHighlightedItems( prevNet, prevComponent, prevAttribute );
     GetCanvas()->Refresh();
 }
 
 
+void GERBVIEW_FRAME::UpdateHighlightedItems( const wxString& aPrevNet,
+                                             const wxString& aPrevComponent,
+                                             const wxString& aPrevAttribute )
+{
+    KIGFX::VIEW* view = GetCanvas()->GetView();
+    auto settings = static_cast<KIGFX::GERBVIEW_PAINTER*>( view->GetPainter() )->GetSettings();
+
+    // In the GERBER_FILE_IMAGE::ITEM_ATTRIBUTE order
+    const wxString prevValues[] = { aPrevNet, aPrevComponent, aPrevAttribute };
+    const wxString values[] = { settings->m_netHighlightString,
+                                settings->m_componentHighlightString,
+                                settings->m_attributeHighlightString };
+
+    std::vector<GERBER_DRAW_ITEM*> items;
+
+    for( unsigned layer = 0; layer < GetImagesList()->ImagesMaxCount(); ++layer )
+    {
+        GERBER_FILE_IMAGE* gerber = GetImagesList()->GetGbrImage( layer );
+
+        if( gerber == NULL )    // Graphic layer not yet used
+            continue;
+
+        for( int ii = 0; ii < GERBER_FILE_IMAGE::ATTRIBUTE_COUNT; ++ii )
+        {
+            if( values[ii] == prevValues[ii] )
+                continue;
+
+            auto attribute = static_cast<GERBER_FILE_IMAGE::ITEM_ATTRIBUTE>( ii );
+
+            gerber->QueryItemsByAttribute( attribute, prevValues[ii], items );
+            gerber->QueryItemsByAttribute( attribute, values[ii], items );
+        }
+    }
+
+    for( GERBER_DRAW_ITEM* item : items )
+        view->Update( item, KIGFX::COLOR );
+}
+
+
 void GERBVIEW_FRAME::OnSelectActiveDCode( wxCommandEvent& event )
 {
     GERBER_FILE_IMAGE* gerber_image = GetGbrImage( GetActiveLayer() );
@@ -241,7 +241,8 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName,
+                                         EXCELLON_IMAGE* aPreloadedImage )
 {
     wxString msg;
     int layerId = GetActiveLayer();      // current layer used in GerbView
@@ -252,10 +253,23 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
     if( gerber_layer )
         Erase_Current_DrawLayer( false );
 
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    EXCELLON_IMAGE* drill_layer;
+    bool success;
 
-    // Read the Excellon drill file:
-    bool success = drill_layer->LoadFile( aFullFileName );
+    if( aPreloadedImage )
+    {
+        // The file was already read (in a worker thread): just move it to the active layer
+        drill_layer = aPreloadedImage;
+        drill_layer->m_GraphicLayer = layerId;
+        success = drill_layer->m_InUse;
+    }
+    else
+    {
+        drill_layer = new EXCELLON_IMAGE( layerId );
+
+        // Read the Excellon drill file:
+        success = drill_layer->LoadFile( aFullFileName );
+    }
 
     if( !success )
     {
@@ -664,8 +678,7 @@ bool EXCELLON_IMAGE::Execute_Drill_Command( char*& text )
                     return false;
                 }
 
-                gbritem = new GERBER_DRAW_ITEM( this );
-                AddItemToList( gbritem );
+                gbritem = CreateItem();
 
                 if( m_SlotOn )  // Oblong hole
                 {
@@ -898,7 +911,7 @@ void EXCELLON_IMAGE::FinishRouteCommand()
 
     for( size_t ii = 1; ii < m_RoutePositions.size(); ii++ )
     {
-        GERBER_DRAW_ITEM* gbritem = new GERBER_DRAW_ITEM( this );
+        GERBER_DRAW_ITEM* gbritem = CreateItem();
 
         if( m_RoutePositions[ii].m_rmode == 0 )     // linear routing
         {
@@ -925,8 +938,6 @@ void EXCELLON_IMAGE::FinishRouteCommand()
                          false );
         }
 
-        AddItemToList( gbritem );
-
         StepAndRepeatItem( *gbritem );
     }
 
@@ -213,6 +213,54 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
     // Create progress dialog (only used if more than 1 file to load
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
 
+    if( aFilenameList.GetCount() > 1 )
+    {
+        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                        _( "Loading Gerber files..." ), 2, false );
+    }
+
+    // Files are independent: read them all in parallel, each one in a detached image.
+    // Images are then added to layers in the list order, from the main thread.
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> preloaded( aFilenameList.GetCount() );
+    std::vector<GERBER_FILE_IMAGE*>                 toLoad;
+    std::vector<wxString>                           toLoadNames;
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        filename = aFilenameList[ii];
+
+        if( !filename.IsAbsolute() )
+            filename.SetPath( aPath );
+
+        // Missing files and job files are reported when adding images to layers
+        if( !filename.FileExists() )
+            continue;
+
+        if( aFileType && (*aFileType)[ii] == 1 )
+            preloaded[ii] = std::make_unique<EXCELLON_IMAGE>( layer );
+        else if( filename.GetExt() != GerberJobFileExtension.c_str() )
+            preloaded[ii] = std::make_unique<GERBER_FILE_IMAGE>( layer );
+        else
+            continue;
+
+        toLoad.push_back( preloaded[ii].get() );
+        toLoadNames.push_back( filename.GetFullPath() );
+    }
+
+    if( progress )
+    {
+        progress->Report( wxString::Format( _( "Reading %zu files" ), toLoad.size() ) );
+        progress->SetMaxProgress( toLoad.size() );
+    }
+
+    GERBER_FILE_IMAGE_LIST::LoadFiles( toLoad, toLoadNames, progress.get() );
+
+    if( progress )
+    {
+        progress->AdvancePhase();
+        progress->SetMaxProgress( aFilenameList.GetCount() );
+    }
+
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
         filename = aFilenameList[ii];
@@ -234,15 +282,7 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
 
         m_lastFileName = filename.GetFullPath();
 
-        if( !progress && ( aFilenameList.GetCount() > 1 ) )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
-                                            aFilenameList.GetCount(), m_lastFileName ) );
-        }
-        else if( progress )
+        if( progress )
         {
             progress->Report( wxString::Format( _("Loading %u/%zu %s" ), ii+1,
                                             aFilenameList.GetCount(), m_lastFileName ) );
@@ -253,10 +293,17 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
 
         visibility[ layer ] = true;
 
+        bool loaded = false;
+
         if( aFileType && (*aFileType)[ii] == 1 )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            EXCELLON_IMAGE* drill = static_cast<EXCELLON_IMAGE*>( preloaded[ii].release() );
+
+            if( Read_EXCELLON_File( m_lastFileName, drill ) )
+            {
+                UpdateFileHistory( m_lastFileName, &m_drillFileHistory );
+                loaded = true;
+            }
         }
         else
         {
@@ -270,30 +317,34 @@ bool GERBVIEW_FRAME::LoadListOfGerberAndDrillFiles( const wxString& aPath,
                 success = false;
                 reporter.Report( txt, RPT_SEVERITY_ERROR );
             }
-            else if( Read_GERBER_File( filename.GetFullPath() ) )
+            else if( Read_GERBER_File( m_lastFileName, preloaded[ii].release() ) )
             {
                 UpdateFileHistory( m_lastFileName );
+                loaded = true;
+            }
+        }
+
+        if( loaded )
+        {
+            layer = getNextAvailableLayer( layer );
 
-                layer = getNextAvailableLayer( layer );
+            if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+            {
+                success = false;
+                reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
+                // Report the name of not loaded files:
+                ii += 1;
+                while( ii < aFilenameList.GetCount() )
                 {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, RPT_SEVERITY_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, RPT_SEVERITY_ERROR );
-                    }
-                    break;
+                    filename = aFilenameList[ii++];
+                    wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                    reporter.Report( txt, RPT_SEVERITY_ERROR );
                 }
-
-                SetActiveLayer( layer, false );
+                break;
             }
+
+            SetActiveLayer( layer, false );
         }
 
         if( progress )
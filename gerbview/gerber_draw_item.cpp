@@ -37,6 +37,10 @@
 
 #include <wx/msgdlg.h>
 
+// In case the item has a very tiny width defined, allow it to be selected
+static const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
 {
@@ -51,6 +55,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_mirrorB       = false;
     m_drawScale.x   = m_drawScale.y = 1.0;
     m_lyrRotation   = 0;
+    m_boundingBoxValid = false;
 
     if( m_GerberImageFile )
         SetLayerParameters();
@@ -219,6 +224,8 @@ void GERBER_DRAW_ITEM::SetLayerParameters()
     // Rotation from RO command:
     m_lyrRotation = m_GerberImageFile->m_LocalRotation;
     m_LayerNegative = m_GerberImageFile->GetLayerParams().m_LayerNegative;
+
+    ClearCachedBoundingBox();
 }
 
 
@@ -279,7 +286,7 @@ D_CODE* GERBER_DRAW_ITEM::GetDcodeDescr() const
 }
 
 
-const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
+EDA_RECT GERBER_DRAW_ITEM::getXYBoundingBox() const
 {
     // return a rectangle which is (pos,dim) in nature.  therefore the +1
     EDA_RECT bbox( m_Start, wxSize( 1, 1 ) );
@@ -368,10 +375,8 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     {
         if( code )
         {
-            // Update the shape drawings and the bounding box coordiantes:
-            code->GetMacro()->GetApertureMacroShape( this, m_Start );
-            // now the bounding box is valid:
-            bbox = code->GetMacro()->GetBoundingBox();
+            // The macro shape is evaluated once per D_CODE and draw transform:
+            bbox = code->GetMacroShapeBoundingBox( this );
         }
         break;
     }
@@ -407,6 +412,17 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
         break;
     }
 
+    return bbox;
+}
+
+
+const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
+{
+    if( m_boundingBoxValid )
+        return m_boundingBox;
+
+    EDA_RECT bbox = getXYBoundingBox();
+
     // calculate the corners coordinates in current gerber axis orientations
     wxPoint org = GetABPosition( bbox.GetOrigin() );
     wxPoint end = GetABPosition( bbox.GetEnd() );
@@ -416,10 +432,49 @@ const EDA_RECT GERBER_DRAW_ITEM::GetBoundingBox() const
     bbox.SetEnd( end );
     bbox.Normalize();
 
+    m_boundingBox = bbox;
+    m_boundingBoxValid = true;
+
     return bbox;
 }
 
 
+void GERBER_DRAW_ITEM::ClearCachedBoundingBox()
+{
+    if( m_GerberImageFile )
+        m_GerberImageFile->ClearItemsIndex();
+
+    m_boundingBoxValid = false;
+}
+
+
+const EDA_RECT GERBER_DRAW_ITEM::GetHitTestBoundingBox() const
+{
+    // Aperture macro shapes are hit tested in AB axis, from the cached macro shape
+    if( m_Shape == GBR_SPOT_MACRO && GetDcodeDescr() )
+    {
+        EDA_RECT bbox = GetDcodeDescr()->GetMacroShapeBoundingBox( this );
+        bbox.Inflate( 1 );
+        return bbox;
+    }
+
+    // Other shapes are hit tested in XY axis, with a tolerance up to the item size
+    EDA_RECT bbox = getXYBoundingBox();
+    int      margin = std::max( std::max( m_Size.x, m_Size.y ), MIN_HIT_TEST_RADIUS );
+
+    bbox.Inflate( margin );
+
+    // The XY to AB transform can include any rotation: use the 4 corners
+    EDA_RECT abBox( GetABPosition( bbox.GetOrigin() ), wxSize( 0, 0 ) );
+    abBox.Merge( GetABPosition( bbox.GetEnd() ) );
+    abBox.Merge( GetABPosition( wxPoint( bbox.GetX(), bbox.GetBottom() ) ) );
+    abBox.Merge( GetABPosition( wxPoint( bbox.GetRight(), bbox.GetY() ) ) );
+    abBox.Inflate( 1 );
+
+    return abBox;
+}
+
+
 void GERBER_DRAW_ITEM::MoveAB( const wxPoint& aMoveVector )
 {
     wxPoint xymove = GetXYPosition( aMoveVector );
@@ -429,6 +484,7 @@ void GERBER_DRAW_ITEM::MoveAB( const wxPoint& aMoveVector )
     m_ArcCentre += xymove;
 
     m_Polygon.Move( VECTOR2I( xymove ) );
+    ClearCachedBoundingBox();
 }
 
 
@@ -439,6 +495,7 @@ void GERBER_DRAW_ITEM::MoveXY( const wxPoint& aMoveVector )
     m_ArcCentre += aMoveVector;
 
     m_Polygon.Move( VECTOR2I( aMoveVector ) );
+    ClearCachedBoundingBox();
 }
 
 
@@ -786,24 +843,18 @@ BITMAP_DEF GERBER_DRAW_ITEM::GetMenuImage() const
 
 bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
 {
-    // In case the item has a very tiny width defined, allow it to be selected
-    const int MIN_HIT_TEST_RADIUS = Millimeter2iu( 0.01 );
-
     // calculate aRefPos in XY gerber axis:
     wxPoint ref_pos = GetXYPosition( aRefPos );
 
-    SHAPE_POLY_SET poly;
-
     switch( m_Shape )
     {
     case GBR_POLYGON:
-        poly = m_Polygon;
-        return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
+        return m_Polygon.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
 
     case GBR_SPOT_POLY:
-        poly = GetDcodeDescr()->m_Polygon;
-        poly.Move( VECTOR2I( m_Start ) );
-        return poly.Contains( VECTOR2I( ref_pos ), 0, aAccuracy );
+        // The D_CODE polygon is relative to the flash position: move the test point
+        // instead of the polygon
+        return GetDcodeDescr()->m_Polygon.Contains( VECTOR2I( ref_pos - m_Start ), 0, aAccuracy );
 
     case GBR_SPOT_RECT:
         return GetBoundingBox().Contains( aRefPos );
@@ -879,9 +930,13 @@ bool GERBER_DRAW_ITEM::HitTest( const wxPoint& aRefPos, int aAccuracy ) const
         }
 
     case GBR_SPOT_MACRO:
-        // Aperture macro polygons are already in absolute coordinates
-        auto p = GetDcodeDescr()->GetMacro()->GetApertureMacroShape( this, m_Start );
-        return p->Contains( VECTOR2I( aRefPos ), -1, aAccuracy );
+    {
+        // Aperture macro polygons are already in absolute coordinates.  The cached shape
+        // must be moved to the item position: move the test point instead.
+        VECTOR2I offset;
+        const SHAPE_POLY_SET& shape = GetDcodeDescr()->GetMacroShape( this, offset );
+        return shape.Contains( VECTOR2I( aRefPos ) - offset, -1, aAccuracy );
+    }
     }
 
     // TODO: a better analyze of the shape (perhaps create a D_CODE::HitTest for flashed items)
@@ -964,7 +1019,7 @@ double GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
         switch( m_Shape )
         {
         case GBR_SPOT_MACRO:
-            size = GetDcodeDescr()->GetMacro()->GetBoundingBox().GetWidth();
+            size = GetDcodeDescr()->GetMacroShapeBoundingBox( this ).GetWidth();
             break;
 
         case GBR_ARC:
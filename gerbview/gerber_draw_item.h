@@ -117,6 +117,9 @@ private:
                                             ///< (dcode). Stored in each item, because %TO is
                                             ///< a dynamic object attribute
 
+    mutable EDA_RECT m_boundingBox;         // cached GetBoundingBox() value
+    mutable bool     m_boundingBoxValid;    // false if m_boundingBox must be recalculated
+
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
     ~GERBER_DRAW_ITEM();
@@ -195,7 +198,12 @@ public:
      * This function exists mainly to satisfy the virtual GetPosition() in parent class
      */
     wxPoint GetPosition() const override                { return m_Start; }
-    void SetPosition( const wxPoint& aPos ) override    {  m_Start = aPos; }
+
+    void SetPosition( const wxPoint& aPos ) override
+    {
+        m_Start = aPos;
+        ClearCachedBoundingBox();
+    }
 
     /**
      * Function GetABPosition
@@ -229,8 +237,29 @@ public:
      */
     D_CODE* GetDcodeDescr() const;
 
+    /**
+     * Function GetBoundingBox
+     * The bounding box is calculated on the first call, and cached until the item is moved
+     * or its layer parameters change.  Code modifying the item shape members directly after
+     * this first call must call ClearCachedBoundingBox().
+     */
     const EDA_RECT GetBoundingBox() const override;
 
+    /**
+     * Function ClearCachedBoundingBox
+     * forces the next GetBoundingBox() call to recalculate the bounding box, and the
+     * spatial index of the gerber image to be rebuilt.
+     */
+    void ClearCachedBoundingBox();
+
+    /**
+     * Function GetHitTestBoundingBox
+     * @return a rectangle (in AB axis) containing all the positions for which HitTest()
+     * can return true.  It is larger than GetBoundingBox(), to include the hit test tolerance,
+     * and is used to index the items for selection.
+     */
+    const EDA_RECT GetHitTestBoundingBox() const;
+
     void Print( wxDC* aDC, const wxPoint& aOffset, GBR_DISPLAY_OPTIONS* aOptions );
 
     /**
@@ -302,6 +331,13 @@ public:
 
     ///> @copydoc EDA_ITEM::GetMenuImage()
     BITMAP_DEF GetMenuImage() const override;
+
+private:
+    /**
+     * @return the bounding box of the shape in XY (gerber file) axis, before the
+     * AB axis transform.
+     */
+    EDA_RECT getXYBoundingBox() const;
 };
 
 
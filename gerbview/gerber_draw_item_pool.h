@@ -0,0 +1,136 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef GERBER_DRAW_ITEM_POOL_H
+#define GERBER_DRAW_ITEM_POOL_H
+
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <gerber_draw_item.h>
+
+/**
+ * GERBER_DRAW_ITEM_POOL is the storage of the GERBER_DRAW_ITEMs of a GERBER_FILE_IMAGE.
+ *
+ * A gerber file can contain hundreds of thousands of flashes and segments. Instead of
+ * allocating each item on the heap, items are constructed in place inside contiguous blocks.
+ * Blocks grow geometrically, so small files do not waste memory and large files need only
+ * a few allocations.
+ *
+ * Items never move once created (the GAL view and the selection tools keep pointers to them),
+ * and they are all destroyed at once, when the pool is cleared or destroyed.
+ */
+class GERBER_DRAW_ITEM_POOL
+{
+public:
+    GERBER_DRAW_ITEM_POOL() :
+        m_usedInLastBlock( 0 ),
+        m_count( 0 )
+    {
+    }
+
+    ~GERBER_DRAW_ITEM_POOL()
+    {
+        Clear();
+    }
+
+    GERBER_DRAW_ITEM_POOL( const GERBER_DRAW_ITEM_POOL& ) = delete;
+    GERBER_DRAW_ITEM_POOL& operator=( const GERBER_DRAW_ITEM_POOL& ) = delete;
+
+    /**
+     * Construct a new item inside the pool.
+     * @param aArgs are the GERBER_DRAW_ITEM constructor arguments.
+     * @return the new item, owned by the pool.
+     */
+    template <typename... ARGS>
+    GERBER_DRAW_ITEM* Create( ARGS&&... aArgs )
+    {
+        if( m_blocks.empty() || m_usedInLastBlock == m_blocks.back().m_capacity )
+            newBlock();
+
+        BLOCK&            block = m_blocks.back();
+        GERBER_DRAW_ITEM* item  = new( block.m_items + m_usedInLastBlock )
+                                  GERBER_DRAW_ITEM( std::forward<ARGS>( aArgs )... );
+
+        m_usedInLastBlock++;
+        m_count++;
+
+        return item;
+    }
+
+    /**
+     * Destroy all items and release the memory.
+     */
+    void Clear()
+    {
+        for( size_t ii = 0; ii < m_blocks.size(); ++ii )
+        {
+            BLOCK& block = m_blocks[ii];
+            size_t used  = ( ii == m_blocks.size() - 1 ) ? m_usedInLastBlock : block.m_capacity;
+
+            for( size_t jj = 0; jj < used; ++jj )
+                block.m_items[jj].~GERBER_DRAW_ITEM();
+
+            ::operator delete( block.m_items );
+        }
+
+        m_blocks.clear();
+        m_usedInLastBlock = 0;
+        m_count = 0;
+    }
+
+    size_t size() const { return m_count; }
+
+private:
+    ///> Capacity of the first block, and the max capacity of a block
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+    static constexpr size_t MAX_BLOCK_SIZE = 8192;
+
+    struct BLOCK
+    {
+        GERBER_DRAW_ITEM* m_items;
+        size_t            m_capacity;
+    };
+
+    void newBlock()
+    {
+        size_t capacity = MIN_BLOCK_SIZE;
+
+        if( !m_blocks.empty() )
+            capacity = m_blocks.back().m_capacity * 2;
+
+        if( capacity > MAX_BLOCK_SIZE )
+            capacity = MAX_BLOCK_SIZE;
+
+        void* mem = ::operator new( capacity * sizeof( GERBER_DRAW_ITEM ) );
+        m_blocks.push_back( { static_cast<GERBER_DRAW_ITEM*>( mem ), capacity } );
+        m_usedInLastBlock = 0;
+    }
+
+    std::vector<BLOCK> m_blocks;
+    size_t             m_usedInLastBlock;
+    size_t             m_count;
+};
+
+#endif  // GERBER_DRAW_ITEM_POOL_H
@@ -93,6 +93,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
+    m_indexedItemsCount = 0;
 
     ResetDefaultValues();
 
@@ -104,10 +105,9 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 {
 
-    for( auto item : GetItems() )
-        delete item;
-
+    m_itemsIndex.reset();
     m_drawings.clear();
+    m_itemPool.Clear();
 
     for( unsigned ii = 0; ii < arrayDim( m_Aperture_List ); ii++ )
     {
@@ -118,6 +118,84 @@ GERBER_FILE_IMAGE::~GERBER_FILE_IMAGE()
 }
 
 
+void GERBER_FILE_IMAGE::buildItemsIndex()
+{
+    if( m_itemsIndex && m_indexedItemsCount == m_drawings.size() )
+        return;
+
+    m_itemsIndex = std::make_unique<ITEMS_INDEX>();
+
+    for( std::map<wxString, std::vector<size_t>>& attributeIndex : m_attributesIndex )
+        attributeIndex.clear();
+
+    for( size_t ii = 0; ii < m_drawings.size(); ++ii )
+    {
+        GERBER_DRAW_ITEM* item = m_drawings[ii];
+        EDA_RECT          bbox = item->GetHitTestBoundingBox();
+        const int         mmin[2] = { bbox.GetX(), bbox.GetY() };
+        const int         mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_itemsIndex->Insert( mmin, mmax, ii );
+
+        const GBR_NETLIST_METADATA& netAttributes = item->GetNetAttributes();
+
+        if( !netAttributes.m_Netname.IsEmpty() )
+            m_attributesIndex[NET_ATTRIBUTE][netAttributes.m_Netname].push_back( ii );
+
+        if( !netAttributes.m_Cmpref.IsEmpty() )
+            m_attributesIndex[COMPONENT_ATTRIBUTE][netAttributes.m_Cmpref].push_back( ii );
+
+        D_CODE* dcode = item->GetDcodeDescr();
+
+        if( dcode && !dcode->m_AperFunction.IsEmpty() )
+            m_attributesIndex[APERTURE_ATTRIBUTE][dcode->m_AperFunction].push_back( ii );
+    }
+
+    m_indexedItemsCount = m_drawings.size();
+}
+
+
+void GERBER_FILE_IMAGE::QueryItems( const wxPoint& aPosition,
+                                    std::vector<GERBER_DRAW_ITEM*>& aItems )
+{
+    buildItemsIndex();
+
+    std::vector<size_t> found;
+    const int           pos[2] = { aPosition.x, aPosition.y };
+
+    m_itemsIndex->Search( pos, pos,
+            [&found]( const size_t& aIndex ) -> bool
+            {
+                found.push_back( aIndex );
+                return true;
+            } );
+
+    // Keep the drawing order, which is the order used by the collectors
+    std::sort( found.begin(), found.end() );
+
+    for( size_t index : found )
+        aItems.push_back( m_drawings[index] );
+}
+
+
+void GERBER_FILE_IMAGE::QueryItemsByAttribute( ITEM_ATTRIBUTE aAttribute, const wxString& aValue,
+                                               std::vector<GERBER_DRAW_ITEM*>& aItems )
+{
+    if( aValue.IsEmpty() )
+        return;
+
+    buildItemsIndex();
+
+    auto it = m_attributesIndex[aAttribute].find( aValue );
+
+    if( it == m_attributesIndex[aAttribute].end() )
+        return;
+
+    for( size_t index : it->second )
+        aItems.push_back( m_drawings[index] );
+}
+
+
 D_CODE* GERBER_FILE_IMAGE::GetDCODEOrCreate( int aDCODE, bool aCreateIfNoExist )
 {
     unsigned ndx = aDCODE - FIRST_DCODE;
@@ -308,14 +386,13 @@ void GERBER_FILE_IMAGE::StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem )
             if( jj == 0 && ii == 0 )
                 continue;
 
-            GERBER_DRAW_ITEM* dupItem = new GERBER_DRAW_ITEM( aItem );
+            GERBER_DRAW_ITEM* dupItem = CreateItem( aItem );
             wxPoint           move_vector;
             move_vector.x = scaletoIU( ii * GetLayerParams().m_StepForRepeat.x,
                                    GetLayerParams().m_StepForRepeatMetric );
             move_vector.y = scaletoIU( jj * GetLayerParams().m_StepForRepeat.y,
                                    GetLayerParams().m_StepForRepeatMetric );
             dupItem->MoveXY( move_vector );
-            AddItemToList( dupItem );
         }
     }
 }
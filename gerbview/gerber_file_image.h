@@ -25,11 +25,16 @@
 #ifndef GERBER_FILE_IMAGE_H
 #define GERBER_FILE_IMAGE_H
 
+#include <map>
+#include <memory>
 #include <vector>
 #include <set>
 
+#include <geometry/rtree.h>
+
 #include <dcode.h>
 #include <gerber_draw_item.h>
+#include <gerber_draw_item_pool.h>
 #include <am_primitive.h>
 #include <gbr_netlist_metadata.h>
 
@@ -113,7 +118,34 @@ class GERBER_FILE_IMAGE : public EDA_ITEM
     bool               m_Exposure;                          ///< whether an aperture macro tool is flashed on or off
 
     GERBER_LAYER       m_GBRLayerParams;                    // hold params for the current gerber layer
-    GERBER_DRAW_ITEMS  m_drawings;                              // linked list of Gerber Items to draw
+    GERBER_DRAW_ITEMS  m_drawings;                              // list of Gerber Items to draw
+    GERBER_DRAW_ITEM_POOL m_itemPool;                           // storage of the items in m_drawings
+
+public:
+    /// The item attributes which can be highlighted, see QueryItemsByAttribute()
+    enum ITEM_ATTRIBUTE
+    {
+        NET_ATTRIBUTE,          ///< the net name of the item
+        COMPONENT_ATTRIBUTE,    ///< the component reference of the item
+        APERTURE_ATTRIBUTE,     ///< the aperture function of the item D_CODE
+        ATTRIBUTE_COUNT
+    };
+
+private:
+    typedef RTree<size_t, int, 2, double> ITEMS_INDEX;
+
+    std::unique_ptr<ITEMS_INDEX> m_itemsIndex;                  // spatial index of m_drawings, by item
+                                                                // position in m_drawings, built on demand
+    std::map<wxString, std::vector<size_t>> m_attributesIndex[ATTRIBUTE_COUNT];
+                                                                // items positions in m_drawings, by
+                                                                // attribute value, built with m_itemsIndex
+    size_t             m_indexedItemsCount;                     // count of items in m_itemsIndex
+
+    /**
+     * Build the spatial and attributes indexes of the items if they do not exist, or if new
+     * items were added since they were built.
+     */
+    void buildItemsIndex();
 
 public:
     bool               m_InUse;                                 // true if this image is currently in use
@@ -284,12 +316,56 @@ public:
     int GetItemsCount() { return m_drawings.size(); }
 
     /**
-     * Add a new GERBER_DRAW_ITEM item to the drawings list
-     * @param aItem is the GERBER_DRAW_ITEM to add to list
+     * Create a new GERBER_DRAW_ITEM owned by this image, and add it to the drawings list
+     * @return the new item
+     */
+    GERBER_DRAW_ITEM* CreateItem()
+    {
+        m_drawings.push_back( m_itemPool.Create( this ) );
+        return m_drawings.back();
+    }
+
+    /**
+     * Create a copy of a GERBER_DRAW_ITEM owned by this image, and add it to the drawings list
+     * @param aSource is the item to duplicate
+     * @return the new item
+     */
+    GERBER_DRAW_ITEM* CreateItem( const GERBER_DRAW_ITEM& aSource )
+    {
+        m_drawings.push_back( m_itemPool.Create( aSource ) );
+        return m_drawings.back();
+    }
+
+    /**
+     * Function QueryItems
+     * collects the items which can be hit at a given position, using a spatial index of the
+     * items hit test areas.  The index is built on the first call, and rebuilt if new items
+     * were added since.
+     * @param aPosition is the reference position, in AB axis
+     * @param aItems is filled with the candidate items, in the m_drawings order.  The caller
+     * must still use GERBER_DRAW_ITEM::HitTest() for an exact test.
+     */
+    void QueryItems( const wxPoint& aPosition, std::vector<GERBER_DRAW_ITEM*>& aItems );
+
+    /**
+     * Function QueryItemsByAttribute
+     * collects the items having a given attribute value, using the index built with the
+     * spatial index of QueryItems().
+     * @param aAttribute is the attribute to test
+     * @param aValue is the attribute value.  Nothing is collected for an empty value.
+     * @param aItems is filled with the items, in the m_drawings order
+     */
+    void QueryItemsByAttribute( ITEM_ATTRIBUTE aAttribute, const wxString& aValue,
+                                std::vector<GERBER_DRAW_ITEM*>& aItems );
+
+    /**
+     * Function ClearItemsIndex
+     * forces the indexes of the items to be rebuilt on the next query.  Called when an item
+     * is moved.
      */
-    void AddItemToList( GERBER_DRAW_ITEM* aItem )
+    void ClearItemsIndex()
     {
-        m_drawings.push_back( aItem );
+        m_itemsIndex.reset();
     }
 
     /**
@@ -31,9 +31,16 @@
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
+#include <excellon_image.h>
+#include <locale_io.h>
 #include <X2_gerber_attributes.h>
+#include <widgets/progress_reporter.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <map>
+#include <thread>
 
 
 // The global image list:
@@ -245,3 +252,64 @@ std::unordered_map<int, int> GERBER_FILE_IMAGE_LIST::SortImagesByZOrder()
 
     return tab_lyr;
 }
+
+
+void GERBER_FILE_IMAGE_LIST::LoadFiles( const std::vector<GERBER_FILE_IMAGE*>& aImages,
+                                        const std::vector<wxString>& aFilenames,
+                                        PROGRESS_REPORTER* aReporter )
+{
+    wxCHECK_RET( aImages.size() == aFilenames.size(), "Images and filenames count mismatch" );
+
+    if( aImages.empty() )
+        return;
+
+    // Switch to the C locale once, here, in the main thread: the LOCALE_IO used by the
+    // readers in the worker threads are then only reference counted.
+    LOCALE_IO toggleIo;
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 1 ), aImages.size() );
+
+    std::atomic<size_t> nextImage( 0 );
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    auto load_lambda = [&]() -> size_t
+    {
+        for( size_t ii = nextImage++; ii < aImages.size(); ii = nextImage++ )
+        {
+            EXCELLON_IMAGE* drill = dynamic_cast<EXCELLON_IMAGE*>( aImages[ii] );
+
+            if( drill )
+                drill->LoadFile( aFilenames[ii] );
+            else
+                aImages[ii]->LoadGerberFile( aFilenames[ii] );
+
+            if( aReporter )
+                aReporter->AdvanceProgress();
+        }
+
+        return 1;
+    };
+
+    if( parallelThreadCount == 1 )
+        load_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, load_lambda );
+
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+
+            do
+            {
+                if( aReporter )
+                    aReporter->KeepRefreshing();
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
+        }
+    }
+}
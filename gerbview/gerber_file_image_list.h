@@ -32,6 +32,7 @@
 #include <gerber_draw_item.h>
 #include <am_primitive.h>
 
+class PROGRESS_REPORTER;
 /* gerber files have different parameters to define units and how items must be plotted.
  *  some are for the entire file, and other can change along a file.
  *  In Gerber world:
@@ -118,6 +119,23 @@ public:
      * @return a mapping of old to new layer index
      */
     std::unordered_map<int, int> SortImagesByZOrder();
+
+    /**
+     * Read a set of Gerber and Excellon files into detached images, using a pool of
+     * worker threads (one file per thread at a time).
+     * aImages[ii] is loaded from aFilenames[ii]. EXCELLON_IMAGE items are read as
+     * NC drill files, other items as Gerber files.
+     * The images are not added to any list: this must be done by the caller, from the
+     * main thread.  On return, GERBER_FILE_IMAGE::m_InUse is true for successfully read images.
+     *
+     * @param aImages is the list of images to fill
+     * @param aFilenames is the list of full filenames to read
+     * @param aReporter is an optional progress reporter, advanced once per file.  Must be
+     * set to the right max progress by the caller.  Refreshed from the calling thread.
+     */
+    static void LoadFiles( const std::vector<GERBER_FILE_IMAGE*>& aImages,
+                           const std::vector<wxString>& aFilenames,
+                           PROGRESS_REPORTER* aReporter = nullptr );
 };
 
 #endif  // ifndef GERBER_FILE_IMAGE_LIST_H
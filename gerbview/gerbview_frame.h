@@ -41,6 +41,7 @@ class GERBER_LAYER_WIDGET;
 class GBR_LAYER_BOX_SELECTOR;
 class GERBER_DRAW_ITEM;
 class GERBER_FILE_IMAGE;
+class EXCELLON_IMAGE;
 class GERBER_FILE_IMAGE_LIST;
 class REPORTER;
 class SELECTION;
@@ -391,6 +392,16 @@ public:
     /// Handles the changing of the highlighted component/net/attribute
     void OnSelectHighlightChoice( wxCommandEvent& event );
 
+    /**
+     * Function UpdateHighlightedItems
+     * updates the colors of the items whose highlight changes, from the previous highlighted
+     * net, component and aperture attribute to the ones of the current render settings.
+     * The items are found from the attributes index of their gerber image, so only the items
+     * of the previous and the new highlighted values are updated.
+     */
+    void UpdateHighlightedItems( const wxString& aPrevNet, const wxString& aPrevComponent,
+                                 const wxString& aPrevAttribute );
+
     /**
      * Function OnSelectActiveDCode
      * Selects the active DCode for the current active layer.
@@ -468,7 +479,16 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * Load a Gerber file on the active layer, replacing the previous data if any.
+     * @param GERBER_FullFileName is the full filename of the file
+     * @param aPreloadedImage (optional) is an image already read from GERBER_FullFileName.
+     * It is then only added to the active layer, and the frame takes its ownership.
+     * @return true if the file was loaded.
+     */
+    bool Read_GERBER_File( const wxString& GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aPreloadedImage = nullptr );
 
     /**
      * function LoadExcellonFiles
@@ -479,7 +499,16 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
+
+    /**
+     * Load a NC drill file on the active layer, replacing the previous data if any.
+     * @param aFullFileName is the full filename of the file
+     * @param aPreloadedImage (optional) is an image already read from aFullFileName.
+     * It is then only added to the active layer, and the frame takes its ownership.
+     * @return true if the file was loaded.
+     */
+    bool Read_EXCELLON_File( const wxString& aFullFileName,
+                             EXCELLON_IMAGE* aPreloadedImage = nullptr );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
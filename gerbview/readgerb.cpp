@@ -37,7 +37,8 @@
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                       GERBER_FILE_IMAGE* aPreloadedImage )
 {
     wxString msg;
 
@@ -50,11 +51,23 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    bool success;
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    if( aPreloadedImage )
+    {
+        // The file was already read (in a worker thread): just move it to the active layer
+        gerber = aPreloadedImage;
+        gerber->m_GraphicLayer = layer;
+        success = gerber->m_InUse;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
+
+        // Read the gerber file. The image will be added only if it can be read
+        // to avoid broken data.
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -111,8 +124,10 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
+
+// size of the stdio buffer used to read a gerber file (files are read sequentially,
+// so a large buffer avoids a lot of small reads)
+#define GERBER_FILE_BUFZ ( 1 << 20 )
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -131,6 +146,13 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 
     m_FileName = aFullFileName;
 
+    // A large buffer to store one line.  Not static: several files can be read
+    // at the same time, each one in its own thread.
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char* lineBuffer = buffer.data();
+
+    setvbuf( m_Current_File, nullptr, _IOFBF, GERBER_FILE_BUFZ );
+
     LOCALE_IO toggleIo;
 
     wxString msg;
@@ -153,6 +153,10 @@ int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
     const auto& selection = m_toolMgr->GetTool<GERBVIEW_SELECTION_TOOL>()->GetSelection();
     GERBER_DRAW_ITEM* item = nullptr;
 
+    wxString prevNet = settings->m_netHighlightString;
+    wxString prevComponent = settings->m_componentHighlightString;
+    wxString prevAttribute = settings->m_attributeHighlightString;
+
     if( selection.Size() == 1 )
     {
         item = static_cast<GERBER_DRAW_ITEM*>( selection[0] );
@@ -191,7 +195,7 @@ int GERBVIEW_CONTROL::HighlightControl( const TOOL_EVENT& aEvent )
         }
     }
 
-    canvas()->GetView()->UpdateAllItems( KIGFX::COLOR );
+    m_frame->UpdateHighlightedItems( prevNet, prevComponent, prevAttribute );
     canvas()->Refresh();
 
     return 0;
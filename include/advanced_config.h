@@ -152,6 +152,12 @@ public:
      */
     bool m_SkipBoundingBoxOnFpLoad;
 
+    /**
+     * Load the symbol and footprint libraries in the background when the library tables
+     * are loaded, and poll their files to reload the modified libraries.  On by default.
+     */
+    bool m_PreloadLibraries;
+
 private:
     ADVANCED_CFG();
 
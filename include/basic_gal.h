@@ -165,6 +165,8 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+/// basic_gal holds the text attributes and the callback of the current text: each thread
+/// has its own instance, so texts can be converted to segments from several threads
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
@@ -35,6 +35,7 @@
 
 #include <list>
 #include <map>
+#include <utility>
 #include <vector>
 #include <wx/string.h>
 
@@ -58,6 +59,9 @@ private:
     PROJECT*               m_project;
     wxString               m_curProjDir;
 
+    /// the messages which could not be shown yet, as message and caption pairs
+    std::vector<std::pair<wxString, wxString>> m_pendingMessages;
+
     /**
      * Function createPathList
      * builds the path list using available information such as
@@ -104,6 +108,14 @@ private:
      */
     void checkEnvVarPath( const wxString& aPath );
 
+    /**
+     * Function showMessage
+     * shows a message box, or keeps the message for ShowPendingMessages() if the
+     * calling thread is not the main thread: the paths of the 3D models are resolved
+     * by the threads which load them
+     */
+    void showMessage( const wxString& aMessage, const wxString& aCaption );
+
 public:
     FILENAME_RESOLVER();
 
@@ -129,6 +141,14 @@ public:
      */
     bool SetProject( PROJECT* aProject, bool* flgChanged = NULL );
 
+    /**
+     * Function ShowPendingMessages
+     * shows the messages of the errors found by the other threads, for example while
+     * the 3D models are loaded in parallel.  Does nothing if the calling thread is not
+     * the main thread.
+     */
+    void ShowPendingMessages();
+
     wxString GetProjectDir( void );
 
     /**
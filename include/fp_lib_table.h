@@ -76,6 +76,13 @@ public:
      */
     void SetType( const wxString& aType ) override;
 
+    void Preload( bool aFirstLoad ) override;
+
+    /**
+     * The timestamp of the plugin, which covers all the footprint files of the library.
+     */
+    long long GetLibraryTimestamp() const override;
+
 protected:
     FP_LIB_TABLE_ROW( const FP_LIB_TABLE_ROW& aRow ) :
         LIB_TABLE_ROW( aRow ),
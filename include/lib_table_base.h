@@ -30,6 +30,7 @@
 #include <boost/noncopyable.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <memory>
+#include <mutex>
 #include <project.h>
 #include <properties.h>
 #include <richio.h>
@@ -42,6 +43,7 @@ class LIB_TABLE_LEXER;
 class LIB_ID;
 class LIB_TABLE_ROW;
 class LIB_TABLE_GRID;
+class LIB_TABLE_PRELOADER;
 class IO_ERROR;
 
 
@@ -187,6 +189,30 @@ public:
         return do_clone();
     }
 
+    /**
+     * Load the library in the cache of the plugin of this row, or reload it if its files
+     * were modified.  This is used by the #LIB_TABLE_PRELOADER, with the plugin lock of the
+     * row held.
+     *
+     * @param aFirstLoad is true for the first loads, which run on worker threads: the
+     *                   library is then only loaded when its plugin was not used yet, since
+     *                   a reload of the plugin cache could delete items in use.
+     * @throw IO_ERROR if the library cannot be loaded.
+     */
+    virtual void Preload( bool aFirstLoad ) {}
+
+    /**
+     * Return a timestamp of the library files, which changes when the library is modified.
+     * The default is the modification time of the file or the directory of the URI.
+     */
+    virtual long long GetLibraryTimestamp() const;
+
+    /**
+     * Return the lock held by the library tables during the calls to the plugin of this row,
+     * which may also be used by the preloading threads.
+     */
+    std::recursive_mutex& GetPluginLock() const { return m_pluginLock; }
+
 protected:
     LIB_TABLE_ROW( const LIB_TABLE_ROW& aRow ) :
         nickName( aRow.nickName ),
@@ -226,6 +252,8 @@ private:
     bool              m_loaded = false;   ///< Whether the LIB_TABLE_ROW is loaded
 
     std::unique_ptr< PROPERTIES > properties;
+
+    mutable std::recursive_mutex  m_pluginLock;
 };
 
 
@@ -278,6 +306,7 @@ class LIB_TABLE : public PROJECT::_ELEM
 {
     friend class PANEL_FP_LIB_TABLE;
     friend class LIB_TABLE_GRID;
+    friend class LIB_TABLE_PRELOADER;
 
 public:
 
@@ -322,6 +351,7 @@ public:
     /// Delete all rows.
     void Clear()
     {
+        forgetPreload();
         rows.clear();
         nickIndex.clear();
     }
@@ -436,6 +466,7 @@ public:
         {
             if( *iter == *aRow )
             {
+                forgetPreload();
                 rows.erase( iter, iter + 1 );
                 return true;
             }
@@ -519,6 +550,11 @@ protected:
             reindex();
     }
 
+    /**
+     * Stop the preloading of this table before its rows are deleted.
+     */
+    void forgetPreload();
+
     LIB_TABLE_ROWS rows;
 
     /// this is a non-owning index into the LIB_TABLE_ROWS table
@@ -531,6 +567,9 @@ protected:
     INDEX nickIndex;
 
     LIB_TABLE* fallBack;
+
+    /// the preloader of the libraries of this table, if the table is preloaded
+    LIB_TABLE_PRELOADER* m_preloader;
 };
 
 #endif  // _LIB_TABLE_BASE_H_
@@ -0,0 +1,161 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef LIB_TABLE_PRELOADER_H
+#define LIB_TABLE_PRELOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wx/event.h>
+#include <wx/timer.h>
+
+class LIB_TABLE;
+class LIB_TABLE_ROW;
+
+
+/**
+ * Sent to the listeners of the #LIB_TABLE_PRELOADER when a library is loaded for the
+ * first time.  The string of the event is the library nickname and its client data is
+ * the LIB_TABLE.
+ */
+wxDECLARE_EVENT( EDA_EVT_LIBRARY_PRELOADED, wxCommandEvent );
+
+/**
+ * Sent to the listeners of the #LIB_TABLE_PRELOADER when a library was reloaded because
+ * its files were modified.
+ */
+wxDECLARE_EVENT( EDA_EVT_LIBRARY_UPDATED, wxCommandEvent );
+
+
+/**
+ * Load the libraries of the library tables in the background.
+ *
+ * The libraries of the registered tables are loaded in the caches of their plugins by a
+ * pool of worker threads, so the frames do not wait for the libraries on their first
+ * access.  The workers only load the libraries whose plugin was not used yet, with the C
+ * locale of their own thread.  The files of the loaded libraries are then polled, and only
+ * the modified libraries are reloaded, on the main thread: a reload deletes the symbols or
+ * the footprints of the plugin cache, which the frames may be using.
+ *
+ * The preloader is owned by PGM_BASE, unless the PreloadLibraries advanced config is
+ * cleared; the library tables are registered by the kifaces.  The calls to the plugin of a
+ * row are serialized by the plugin lock of the row, so a frame only waits for a library
+ * while this library is being loaded.
+ *
+ * All the methods must be called from the main thread, and the events are sent from the
+ * main thread.
+ */
+class LIB_TABLE_PRELOADER : public wxEvtHandler
+{
+public:
+    LIB_TABLE_PRELOADER();
+    ~LIB_TABLE_PRELOADER();
+
+    /**
+     * Load the enabled libraries of \a aTable (but not the ones of its fallback table) in
+     * the background.  The new rows of a table already registered are added.
+     */
+    void Preload( LIB_TABLE* aTable );
+
+    /**
+     * Stop the preloading of \a aTable, waiting for the libraries being loaded.  This is
+     * called by the table before its rows are deleted.
+     */
+    void Forget( LIB_TABLE* aTable );
+
+    /**
+     * @return true if the library \a aNickname of \a aTable was loaded by the preloader.
+     */
+    bool IsLibraryReady( LIB_TABLE* aTable, const wxString& aNickname );
+
+    /**
+     * Compare the timestamps of the loaded libraries with the ones of their files, and
+     * reload the modified libraries.  This is called periodically by a timer.
+     */
+    void CheckLibraries();
+
+    /**
+     * Add an event handler which receives the EDA_EVT_LIBRARY_PRELOADED and
+     * EDA_EVT_LIBRARY_UPDATED events.
+     */
+    void AddListener( wxEvtHandler* aListener );
+
+    void RemoveListener( wxEvtHandler* aListener );
+
+private:
+    struct LIBRARY
+    {
+        LIB_TABLE_ROW* m_row;
+        wxString       m_nickname;
+        long long      m_timestamp;     ///< timestamp of the files when loaded
+        bool           m_ready;
+    };
+
+    enum JOB_TYPE
+    {
+        LOAD_JOB,       ///< load the library
+        CHECK_JOB       ///< compare the timestamp of the library files
+    };
+
+    struct JOB
+    {
+        JOB_TYPE   m_type;
+        LIB_TABLE* m_table;
+        size_t     m_library;           ///< index in the libraries of m_table
+    };
+
+    void queueLoad( LIB_TABLE* aTable, size_t aLibrary );
+
+    void startWorkers();
+
+    void stopWorkers();
+
+    void worker();
+
+    void runJob( const JOB& aJob );
+
+    void onPollTimer( wxTimerEvent& aEvent );
+
+    void onLibraryChanged( LIB_TABLE* aTable, size_t aLibrary );
+
+    void notify( const wxEventType& aType, LIB_TABLE* aTable, const wxString& aNickname );
+
+    std::mutex                                 m_lock;      ///< protects the members below
+    std::condition_variable                    m_jobQueued;
+    std::condition_variable                    m_jobDone;
+    std::map<LIB_TABLE*, std::vector<LIBRARY>> m_tables;
+    std::deque<JOB>                            m_jobs;
+    std::map<LIB_TABLE*, int>                  m_running;   ///< running jobs per table
+    bool                                       m_quit;
+
+    std::vector<std::thread>   m_workers;
+    std::vector<wxEvtHandler*> m_listeners;
+    wxTimer                    m_pollTimer;
+};
+
+#endif  // LIB_TABLE_PRELOADER_H
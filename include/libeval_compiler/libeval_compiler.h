@@ -24,8 +24,11 @@
 #include <cstddef>
 #include <functional>
 #include <map>
+#include <memory>
+#include <new>
 #include <string>
-#include <stack>
+#include <type_traits>
+#include <vector>
 
 #include <base_units.h>
 #include <wx/intl.h>
@@ -241,6 +244,15 @@ public:
             m_valueStr = val.m_valueStr;
     }
 
+    void Set( VALUE&& val )
+    {
+        m_type = val.m_type;
+        m_valueDbl = val.m_valueDbl;
+
+        if( m_type == VT_STRING )
+            m_valueStr = std::move( val.m_valueStr );
+    }
+
 private:
     VAR_TYPE_T  m_type;
     double      m_valueDbl;
@@ -262,14 +274,30 @@ public:
 class CONTEXT
 {
 public:
+    CONTEXT() :
+        m_pooledValues( 0 ),
+        m_stackSize( 0 )
+    {}
+
+    CONTEXT( const CONTEXT& ) = delete;
+    CONTEXT& operator=( const CONTEXT& ) = delete;
+
     virtual ~CONTEXT()
     {
+        for( size_t i = 0; i < m_pooledValues; i++ )
+            reinterpret_cast<VALUE*>( &m_valuePool[i] )->~VALUE();
+
         for( VALUE* value : m_ownedValues )
             delete value;
     }
 
     VALUE* AllocValue()
     {
+        // The first values are stored in the context, so the evaluation of most expressions
+        // does not allocate memory
+        if( m_pooledValues < VALUE_POOL_SIZE )
+            return new( &m_valuePool[m_pooledValues++] ) VALUE();
+
         VALUE* value = new VALUE();
         m_ownedValues.push_back( value );
         return value;
@@ -277,25 +305,35 @@ public:
 
     void Push( VALUE* v )
     {
-        m_stack.push( v );
+        if( m_stackSize < STACK_SIZE )
+            m_stack[m_stackSize] = v;
+        else
+            m_stackOverflow.push_back( v );
+
+        m_stackSize++;
     }
 
     VALUE* Pop()
     {
-        if( m_stack.size() == 0 )
+        if( m_stackSize == 0 )
         {
             ReportError( _( "Malformed expression" ) );
             return AllocValue();
         }
 
-        VALUE* value = m_stack.top();
-        m_stack.pop();
+        m_stackSize--;
+
+        if( m_stackSize < STACK_SIZE )
+            return m_stack[m_stackSize];
+
+        VALUE* value = m_stackOverflow.back();
+        m_stackOverflow.pop_back();
         return value;
     }
 
     int SP() const
     {
-        return m_stack.size();
+        return m_stackSize;
     };
 
     void SetErrorCallback( std::function<void( const wxString& aMessage, int aOffset )> aCallback )
@@ -308,14 +346,41 @@ public:
     const ERROR_STATUS& GetError() const { return m_errorStatus; }
 
 private:
-    std::vector<VALUE*> m_ownedValues;
-    std::stack<VALUE*>  m_stack;
+    static constexpr size_t VALUE_POOL_SIZE = 16;
+    static constexpr size_t STACK_SIZE = 16;
+
+    std::aligned_storage<sizeof( VALUE ), alignof( VALUE )>::type
+                        m_valuePool[VALUE_POOL_SIZE];
+    size_t              m_pooledValues;
+    std::vector<VALUE*> m_ownedValues;      ///< the values allocated once the pool is full
+
+    VALUE*              m_stack[STACK_SIZE];
+    std::vector<VALUE*> m_stackOverflow;    ///< the stack entries above STACK_SIZE
+    size_t              m_stackSize;
+
     ERROR_STATUS        m_errorStatus;
 
     std::function<void( const wxString& aMessage, int aOffset )> m_errorCallback;
 };
 
 
+/**
+ * An instruction of the program run by UCODE::Run(): the op code of a UOP, with its operand
+ * resolved to a direct pointer.
+ */
+struct UINSTR
+{
+    int op;
+
+    union
+    {
+        VALUE*   value;     ///< TR_UOP_PUSH_VALUE: the value (owned by the UOP or the UCODE)
+        VAR_REF* ref;       ///< TR_UOP_PUSH_VAR
+        UOP*     uop;       ///< TR_OP_METHOD_CALL
+    };
+};
+
+
 class UCODE
 {
 public:
@@ -324,8 +389,15 @@ public:
     void AddOp( UOP* uop )
     {
         m_ucode.push_back(uop);
+        m_program.clear();
     }
 
+    /**
+     * Build the flat program run by Run() from the UOP list, and fold the operations on
+     * constant values. It is called by the compiler once the UOP list is complete.
+     */
+    void BuildProgram();
+
     VALUE* Run( CONTEXT* ctx );
     wxString Dump() const;
 
@@ -341,7 +413,9 @@ public:
 
 protected:
 
-    std::vector<UOP*> m_ucode;
+    std::vector<UOP*>                   m_ucode;
+    std::vector<UINSTR>                 m_program;
+    std::vector<std::unique_ptr<VALUE>> m_constants;    ///< the results of the folded ops
 };
 
 
@@ -376,6 +450,8 @@ public:
     wxString Format() const;
 
 private:
+    friend class UCODE;
+
     int                      m_op;
 
     FUNC_CALL_REF            m_func;
@@ -25,8 +25,13 @@
 #define LOCALE_IO_H
 
 #include <atomic>
+#include <clocale>
 #include <string>
 
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
 class wxLocale;
 
 /**
@@ -51,6 +56,32 @@ private:
     // (the locale can be set by user, and is not always the system locale)
     std::string m_user_locale;
     wxLocale*   m_wxLocale;
+    bool        m_threadLocale;     // true inside a THREAD_LOCALE_IO, which is kept
+};
+
+
+/**
+ * Set the "C" locale of the calling thread only, within a scope.
+ *
+ * This is the LOCALE_IO of the worker threads, which must not change the locale of the
+ * application: the other threads keep their locale, and the LOCALE_IO instantiated in the
+ * scope of a THREAD_LOCALE_IO do nothing.
+ */
+class THREAD_LOCALE_IO
+{
+public:
+    THREAD_LOCALE_IO();
+    ~THREAD_LOCALE_IO();
+
+private:
+#if defined( _WIN32 )
+    int         m_threadConfig;     // The previous _configthreadlocale() mode
+    std::string m_previousLocale;
+#else
+    locale_t    m_cLocale;
+    locale_t    m_previousLocale;
+#endif
+    bool        m_nested;
 };
 
 #endif
\ No newline at end of file
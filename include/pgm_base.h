@@ -45,6 +45,7 @@ class wxMenu;
 class wxWindow;
 
 class COMMON_SETTINGS;
+class LIB_TABLE_PRELOADER;
 class SETTINGS_MANAGER;
 
 /**
@@ -176,6 +177,15 @@ public:
 
     VTBL_ENTRY COMMON_SETTINGS* GetCommonSettings() const;
 
+    /**
+     * Return the background loader of the library tables, shared by the kifaces, or nullptr
+     * before InitPgm() or when the PreloadLibraries advanced config is cleared.
+     */
+    VTBL_ENTRY LIB_TABLE_PRELOADER* GetLibraryPreloader() const
+    {
+        return m_lib_preloader.get();
+    }
+
     VTBL_ENTRY void SetEditorName( const wxString& aFileName );
 
     /**
@@ -347,6 +357,8 @@ protected:
 
     std::unique_ptr<SETTINGS_MANAGER> m_settings_manager;
 
+    std::unique_ptr<LIB_TABLE_PRELOADER> m_lib_preloader;
+
     /// prevents multiple instances of a program from being run at the same time.
     wxSingleInstanceChecker* m_pgm_checker;
 
@@ -121,6 +121,16 @@ KICAD_PLUGIN_EXPORT char const* GetFileFilter( int aIndex );
  */
 KICAD_PLUGIN_EXPORT bool CanRender( void );
 
+/**
+ * Function IsReentrant
+ *
+ * This function is optional: the models of a plugin which does not export it are loaded one
+ * at a time.
+ *
+ * @return true if Load() can be called by several threads at the same time
+ */
+KICAD_PLUGIN_EXPORT bool IsReentrant( void );
+
 /**
  * reads a model file and creates a generic display structure
  *
@@ -297,8 +297,26 @@ private:
 };
 
 
+/**
+ * Direct getter of the property values of type T, without the wxAny conversion of
+ * PROPERTY_BASE::getter(); it is implemented by the PROPERTY of type T.
+ */
+template<typename T>
+class PROPERTY_VALUE_GETTER
+{
+public:
+    virtual ~PROPERTY_VALUE_GETTER() {}
+
+    /**
+     * @param aObject is the object, already cast to the property owner type (see
+     *                PROPERTY_MANAGER::TypeCast()).
+     */
+    virtual T GetValue( void* aObject ) const = 0;
+};
+
+
 template<typename Owner, typename T, typename Base = Owner>
-class PROPERTY : public PROPERTY_BASE
+class PROPERTY : public PROPERTY_BASE, public PROPERTY_VALUE_GETTER<typename std::decay<T>::type>
 {
 public:
     typedef typename std::decay<T>::type BASE_TYPE;
@@ -372,6 +390,11 @@ protected:
         return res;
     }
 
+    BASE_TYPE GetValue( void* obj ) const override
+    {
+        return (*m_getter)( reinterpret_cast<Owner*>( obj ) );
+    }
+
     ///> Set method
     std::unique_ptr<SETTER_BASE<Owner, T>> m_setter;
 
@@ -120,6 +120,17 @@ public:
         return const_cast<void*>( TypeCast( (const void*) aSource, aBase, aTarget ) );
     }
 
+    /**
+     * Resolves the conversion made by TypeCast() for all the objects of a type, for the code
+     * casting many objects of the same types (e.g. the expression evaluator).
+     *
+     * @param aBase is the source type identifier (obtained using TYPE_HASH()).
+     * @param aTarget is the desired type identifier (obtained using TYPE_HASH()).
+     * @param aCast receives the converter to apply, or nullptr if the pointer is unchanged.
+     * @return false if TypeCast() returns nullptr for these types.
+     */
+    bool ResolveTypeCast( TYPE_ID aBase, TYPE_ID aTarget, const TYPE_CAST_BASE** aCast ) const;
+
     /**
      * Registers a property.
      *
@@ -182,6 +182,14 @@ extern const wxChar* const traceSchSheetPaths;
  */
 extern const wxChar* const traceEnvVars;
 
+/**
+ * Flag to enable debug output of the background loading of the libraries.
+ *
+ * Use "KICAD_LIB_PRELOAD" to enable.
+ *
+ */
+extern const wxChar* const traceLibPreload;
+
 ///@}
 
 /**
@@ -78,6 +78,7 @@
 
 
 #include <deque>
+#include <functional>
 
 #include <algorithm>
 
@@ -580,6 +581,52 @@ protected:
     DECLARE_DYNAMIC_CLASS( mpFY )
 };
 
+/** Min/max pyramid of a set of values, to decimate the large traces to the screen resolution.
+ *  Each level holds the minimum and the maximum of blocks of values, the size of the blocks
+ *  doubling at each level, so the extrema of any range of values are found in O(log N).
+ *  The values are not copied: they are passed again to the queries.
+ */
+class WXDLLIMPEXP_MATHPLOT mpMinMaxPyramid
+{
+public:
+    /** Build the pyramid of aValues.
+     */
+    void Build( const std::vector<double>& aValues );
+
+    /** Update the pyramid after values were appended to aValues: only the new blocks are
+     *  computed.
+     */
+    void Extend( const std::vector<double>& aValues );
+
+    void Clear();
+
+    /** Get the extrema of the values aBegin .. aEnd - 1 (aBegin < aEnd).
+     *  @param aValues the values the pyramid was built from
+     */
+    void GetMinMax( const std::vector<double>& aValues, size_t aBegin, size_t aEnd,
+                    double& aMin, double& aMax ) const;
+
+    /** Decimate the points of a locus to the pixel columns startPx .. endPx.
+     *  The X values must be sorted, and the pyramid built from the Y values.  Each pixel
+     *  column is reduced to its first point, followed by its minimum and maximum points when
+     *  it has more than 2 points, so the plotted polyline and vertical segments are the ones
+     *  of the full locus, with a cost proportional to the screen width.
+     *  @param aToPixelX, aToPixelY the (monotonic) conversions of the values to pixels
+     *  @param aPoints returns the pixel coordinates of the points to plot
+     */
+    void Decimate( const std::vector<double>& aXs, const std::vector<double>& aYs,
+                   const std::function<wxCoord( double )>& aToPixelX,
+                   const std::function<wxCoord( double )>& aToPixelY,
+                   wxCoord startPx, wxCoord endPx, std::vector<wxPoint>& aPoints ) const;
+
+private:
+    ///< Values of the blocks of the first level (the ends of the ranges are read directly)
+    static constexpr size_t BLOCK_SIZE = 16;
+
+    std::vector<std::vector<double>> m_mins;
+    std::vector<std::vector<double>> m_maxs;
+};
+
 /** Abstract base class providing plot and labeling functionality for a locus plot F:N->X,Y.
  *  Locus argument N is assumed to be in range 0 .. MAX_N, and implicitly derived by enumerating
  *  all locus values. Override mpFXY::Rewind and mpFXY::GetNextXY to implement a locus.
@@ -609,6 +656,17 @@ public:
 
     virtual size_t GetCount() = 0;
 
+    /** Get the points to plot in continuous mode between the startPx and endPx columns,
+     *  decimated to the screen resolution (see mpMinMaxPyramid::Decimate).
+     *  The default implementation does not decimate the locus.
+     *  @return false if the points are not decimated: they are then read with GetNextXY
+     */
+    virtual bool GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                                     std::vector<wxPoint>& aPoints )
+    {
+        return false;
+    }
+
     /** Layer plot handler.
      *  This implementation will plot the locus in the visible area and
      *  put a label according to the alignment specified.
@@ -1579,6 +1637,12 @@ public:
      */
     virtual void SetData( const std::vector<double>& xs, const std::vector<double>& ys );
 
+    /** Appends points to the internal data, for the traces updated while they are computed.
+     *  Both vectors MUST be of the same length. This method DOES NOT refresh the mpWindow; do it manually.
+     * @sa SetData
+     */
+    virtual void AppendData( const std::vector<double>& xs, const std::vector<double>& ys );
+
     /** Clears all the data, leaving the layer empty.
      * @sa SetData
      */
@@ -1597,6 +1661,11 @@ protected:
      */
     double m_minX, m_maxX, m_minY, m_maxY;
 
+    /** The min/max pyramid of m_ys, built at SetData when m_xs is sorted.
+     */
+    mpMinMaxPyramid m_yPyramid;
+    bool            m_sortedX;
+
     /** Rewind value enumeration with mpFXY::GetNextXY.
      *  Overridden in this implementation.
      */
@@ -1611,6 +1680,11 @@ protected:
 
     size_t GetCount() override;
 
+    /** Decimate the data with the pyramid of the Y values, when the X values are sorted.
+     */
+    bool GetDecimatedPoints( mpWindow& w, wxCoord startPx, wxCoord endPx,
+                             std::vector<wxPoint>& aPoints ) override;
+
 public:
     /** Returns the actual minimum X data (loaded in SetData).
      */
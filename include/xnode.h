@@ -34,6 +34,9 @@
 
 #include <wx/xml/xml.h>
 
+#include <string>
+#include <vector>
+
 
 /**
  * XNODE
@@ -97,4 +100,71 @@ public:
 
 };
 
+
+/**
+ * XNODE_WRITER
+ * writes the document tree an XNODE would hold while it is built, without building it.
+ *
+ * The output is the one of XNODE::Format() for the S-expression format, and the one of
+ * wxXmlDocument::Save() with an indentation of 2 for the XML format.  Only the elements
+ * holding either a text or other elements can be written, as in the exported documents.
+ */
+class XNODE_WRITER
+{
+public:
+    enum FORMAT
+    {
+        SEXPR,
+        XML
+    };
+
+    /**
+     * @param aOut is the formatter to write to.  For the XML format, it must not translate
+     *  the line ends to be identical to wxXmlDocument::Save().
+     */
+    XNODE_WRITER( OUTPUTFORMATTER* aOut, FORMAT aFormat );
+
+    /**
+     * Start a child element of the current element, or the root element.
+     * @throw IO_ERROR if a system error writing the output, such as a full disk.
+     */
+    void StartElement( const char* aName );
+
+    /**
+     * Add an attribute to the current element, which must not have children yet.
+     */
+    void AddAttribute( const char* aName, const wxString& aValue );
+
+    /**
+     * Add a text child to the current element, after its attributes.  Nothing is written
+     * if \a aText is empty, as an empty XNODE text is not added to the tree.
+     */
+    void AddText( const wxString& aText );
+
+    /**
+     * End the current element.
+     */
+    void EndElement();
+
+    /**
+     * Write a child element holding only \a aText.
+     */
+    void AddElement( const char* aName, const wxString& aText = wxEmptyString );
+
+private:
+    ///> Escape the XML special characters of aText
+    std::string escape( const wxString& aText, bool aAttribute ) const;
+
+    struct ELEMENT
+    {
+        std::string m_name;
+        bool        m_hasChildren;
+        bool        m_lastChildIsText;
+    };
+
+    OUTPUTFORMATTER*     m_out;
+    FORMAT               m_format;
+    std::vector<ELEMENT> m_elements;     ///< The open elements, the root first
+};
+
 #endif  // XNODE_H_
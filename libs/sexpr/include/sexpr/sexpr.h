@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include "sexpr/isexprable.h"
+#include "sexpr/sexpr_arena.h"
 #include "sexpr/sexpr_exception.h"
 
 
@@ -39,12 +40,39 @@ namespace SEXPR
         SEXPR_TYPE_ATOM_SYMBOL,
     };
 
-    typedef std::vector< class SEXPR * > SEXPR_VECTOR;
+    typedef std::vector< class SEXPR *, SEXPR_ALLOCATOR< class SEXPR * > > SEXPR_VECTOR;
+
+    /**
+     * A view of the text of a string or a symbol atom, that is not necessarily null
+     * terminated (the text of the atoms of a SEXPR_DOCUMENT is a view of the source).
+     */
+    struct SEXPR_TEXT
+    {
+        const char* m_data;
+        size_t      m_length;
+
+        std::string ToString() const { return std::string( m_data, m_length ); }
+
+        bool operator==( const std::string& aOther ) const
+        {
+            return aOther.compare( 0, std::string::npos, m_data, m_length ) == 0;
+        }
+
+        bool operator==( const char* aOther ) const
+        {
+            return std::char_traits<char>::length( aOther ) == m_length
+                   && std::char_traits<char>::compare( aOther, m_data, m_length ) == 0;
+        }
+
+        bool operator!=( const std::string& aOther ) const { return !( *this == aOther ); }
+        bool operator!=( const char* aOther ) const { return !( *this == aOther ); }
+    };
 
     class SEXPR
     {
     protected:
         SEXPR_TYPE m_type;
+        bool m_inArena;     ///< the text or the children are stored in a SEXPR_ARENA
         SEXPR( SEXPR_TYPE aType, size_t aLineNumber );
         SEXPR( SEXPR_TYPE aType );
         size_t m_lineNumber;
@@ -66,6 +94,12 @@ namespace SEXPR
         double GetDouble() const;
         std::string const & GetString() const;
         std::string const & GetSymbol() const;
+
+        /**
+         * @return a view of the text of a string or a symbol atom. Unlike GetString() and
+         *         GetSymbol(), it never copies the text of the atoms of a SEXPR_DOCUMENT.
+         */
+        SEXPR_TEXT GetText() const;
         SEXPR_LIST* GetList();
         std::string AsString( size_t aLevel = 0) const;
         size_t GetLineNumber() const { return m_lineNumber; }
@@ -115,6 +149,36 @@ namespace SEXPR
             SEXPR( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL, aLineNumber ), m_value( aValue ) {};
     };
 
+    /**
+     * A string or a symbol atom of a SEXPR_DOCUMENT.
+     *
+     * The text is a view of the document source. It is copied to a string of the arena
+     * only when GetString() or GetSymbol() is called, so the returned reference stays valid
+     * as long as the document; this copy is not thread safe.
+     */
+    struct SEXPR_TEXT_REF : public SEXPR
+    {
+        SEXPR_TEXT           m_text;
+        SEXPR_ARENA*         m_arena;
+        mutable std::string* m_string;
+
+        SEXPR_TEXT_REF( SEXPR_TYPE aType, const char* aData, size_t aLength,
+                        SEXPR_ARENA* aArena, int aLineNumber ) :
+            SEXPR( aType, aLineNumber ), m_text{ aData, aLength }, m_arena( aArena ),
+            m_string( nullptr )
+        {
+            m_inArena = true;
+        }
+
+        std::string const & GetValue() const
+        {
+            if( !m_string )
+                m_string = m_arena->CreateString( m_text.m_data, m_text.m_length );
+
+            return *m_string;
+        }
+    };
+
     struct _OUT_STRING
     {
         bool _Symbol;
@@ -246,6 +310,18 @@ namespace SEXPR
         SEXPR_LIST( int aLineNumber ) :
             SEXPR( SEXPR_TYPE::SEXPR_TYPE_LIST, aLineNumber), m_inStreamChild( 0 ) {};
 
+        /**
+         * Create a list of a SEXPR_DOCUMENT: the children are allocated in aArena, and are
+         * not deleted with the list.
+         */
+        SEXPR_LIST( SEXPR_ARENA* aArena, int aLineNumber ) :
+            SEXPR( SEXPR_TYPE::SEXPR_TYPE_LIST, aLineNumber ),
+            m_children( SEXPR_ALLOCATOR<SEXPR*>( aArena ) ),
+            m_inStreamChild( 0 )
+        {
+            m_inArena = true;
+        }
+
         template <typename... Args>
         SEXPR_LIST( const Args&... args ) :
             SEXPR( SEXPR_TYPE::SEXPR_TYPE_LIST ), m_inStreamChild( 0 )
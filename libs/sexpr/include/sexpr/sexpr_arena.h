@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEXPR_ARENA_H_
+#define SEXPR_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace SEXPR
+{
+    /**
+     * A bump allocator for the nodes of a SEXPR_DOCUMENT.
+     *
+     * The memory is allocated in large blocks and is only released with the arena: the
+     * destructors of the objects created in the arena are not called. The only exception
+     * is the strings created with CreateString(), which are destroyed with the arena.
+     */
+    class SEXPR_ARENA
+    {
+    public:
+        SEXPR_ARENA( size_t aBlockSize = 64 * 1024 ) :
+            m_pos( nullptr ), m_end( nullptr ), m_blockSize( aBlockSize ), m_allocated( 0 )
+        {
+        }
+
+        ~SEXPR_ARENA();
+
+        SEXPR_ARENA( const SEXPR_ARENA& ) = delete;
+        SEXPR_ARENA& operator=( const SEXPR_ARENA& ) = delete;
+
+        void* Allocate( size_t aSize, size_t aAlign = alignof( std::max_align_t ) )
+        {
+            char* pos = reinterpret_cast<char*>(
+                    ( reinterpret_cast<uintptr_t>( m_pos ) + aAlign - 1 ) & ~( aAlign - 1 ) );
+
+            if( !m_pos || pos + aSize > m_end )
+                return allocateBlock( aSize, aAlign );
+
+            m_pos = pos + aSize;
+            return pos;
+        }
+
+        template <typename T, typename... Args>
+        T* Create( Args&&... aArgs )
+        {
+            return new( Allocate( sizeof( T ), alignof( T ) ) ) T( std::forward<Args>( aArgs )... );
+        }
+
+        /**
+         * Create a std::string owned by the arena (it is destroyed with the arena).
+         */
+        std::string* CreateString( const char* aData, size_t aLength );
+
+        /// @return the memory allocated for the blocks, in bytes
+        size_t GetAllocatedSize() const { return m_allocated; }
+
+    private:
+        void* allocateBlock( size_t aSize, size_t aAlign );
+
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        std::vector<std::string*>            m_strings;
+        char*                                m_pos;
+        char*                                m_end;
+        size_t                               m_blockSize;    ///< size of the next block
+        size_t                               m_allocated;
+    };
+
+
+    /**
+     * The allocator of the SEXPR_VECTOR: the vectors of the nodes created in an arena are
+     * allocated in this arena, the other ones with the default allocator.
+     */
+    template <typename T>
+    class SEXPR_ALLOCATOR
+    {
+    public:
+        typedef T value_type;
+
+        SEXPR_ALLOCATOR( SEXPR_ARENA* aArena = nullptr ) noexcept : m_arena( aArena ) {}
+
+        template <typename U>
+        SEXPR_ALLOCATOR( const SEXPR_ALLOCATOR<U>& aOther ) noexcept : m_arena( aOther.m_arena )
+        {
+        }
+
+        T* allocate( size_t aCount )
+        {
+            if( m_arena )
+                return static_cast<T*>( m_arena->Allocate( aCount * sizeof( T ), alignof( T ) ) );
+
+            return static_cast<T*>( ::operator new( aCount * sizeof( T ) ) );
+        }
+
+        void deallocate( T* aPtr, size_t ) noexcept
+        {
+            // the arena memory is released with the arena
+            if( !m_arena )
+                ::operator delete( aPtr );
+        }
+
+        template <typename U>
+        bool operator==( const SEXPR_ALLOCATOR<U>& aOther ) const noexcept
+        {
+            return m_arena == aOther.m_arena;
+        }
+
+        template <typename U>
+        bool operator!=( const SEXPR_ALLOCATOR<U>& aOther ) const noexcept
+        {
+            return m_arena != aOther.m_arena;
+        }
+
+        SEXPR_ARENA* m_arena;
+    };
+}
+
+#endif
@@ -27,6 +27,35 @@
 
 namespace SEXPR
 {
+    /**
+     * A S-expression tree read by PARSER::ParseDocument().
+     *
+     * All the nodes are allocated in the arena of the document, and the string and symbol
+     * atoms are views of the source text, kept by the document: the tree is released with
+     * the document at once, and its nodes must not be deleted.
+     */
+    class SEXPR_DOCUMENT
+    {
+    public:
+        /// @return the root of the tree, or nullptr if the source has no expression
+        SEXPR* GetRoot() const { return m_root; }
+
+        const std::string& GetText() const { return m_text; }
+
+        const SEXPR_ARENA& GetArena() const { return m_arena; }
+
+    private:
+        friend class PARSER;
+
+        SEXPR_DOCUMENT( std::string&& aText ) : m_text( std::move( aText ) ), m_root( nullptr )
+        {
+        }
+
+        std::string m_text;
+        SEXPR_ARENA m_arena;
+        SEXPR*      m_root;
+    };
+
     class PARSER
     {
     public:
@@ -36,9 +65,18 @@ namespace SEXPR
         std::unique_ptr<SEXPR> ParseFromFile( const std::string& aFilename );
         static std::string GetFileContents( const std::string &aFilename );
 
+        /**
+         * Parse aString like Parse(), in a SEXPR_DOCUMENT: the tree is built without a
+         * copy of the text and with only a few allocations, so it is much faster to build
+         * and to release for large inputs.
+         */
+        std::unique_ptr<SEXPR_DOCUMENT> ParseDocument( std::string aString );
+        std::unique_ptr<SEXPR_DOCUMENT> ParseDocumentFromFile( const std::string& aFilename );
+
     private:
         std::unique_ptr<SEXPR> parseString(
                 const std::string& aString, std::string::const_iterator& it );
+        SEXPR* parseDocument( SEXPR_DOCUMENT& aDocument );
         static const std::string whitespaceCharacters;
         int m_lineNumber;
     };
@@ -26,12 +26,12 @@
 namespace SEXPR
 {
     SEXPR::SEXPR( SEXPR_TYPE aType, size_t aLineNumber ) :
-        m_type( aType ), m_lineNumber( aLineNumber )
+        m_type( aType ), m_inArena( false ), m_lineNumber( aLineNumber )
     {
     }
 
     SEXPR::SEXPR(SEXPR_TYPE aType) :
-        m_type( aType ), m_lineNumber( 1 )
+        m_type( aType ), m_inArena( false ), m_lineNumber( 1 )
     {
     }
 
@@ -84,6 +84,9 @@ namespace SEXPR
             throw INVALID_TYPE_EXCEPTION("SEXPR is not a string type!");
         }
 
+        if( m_inArena )
+            return static_cast< SEXPR_TEXT_REF const * >(this)->GetValue();
+
         return static_cast< SEXPR_STRING const * >(this)->m_value;
     }
 
@@ -134,9 +137,29 @@ namespace SEXPR
             throw INVALID_TYPE_EXCEPTION( err_msg );
         }
 
+        if( m_inArena )
+            return static_cast< SEXPR_TEXT_REF const * >(this)->GetValue();
+
         return static_cast< SEXPR_SYMBOL const * >(this)->m_value;
     }
 
+    SEXPR_TEXT SEXPR::GetText() const
+    {
+        if( m_type != SEXPR_TYPE::SEXPR_TYPE_ATOM_STRING
+                && m_type != SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL )
+        {
+            throw INVALID_TYPE_EXCEPTION("SEXPR is not a string or a symbol type!");
+        }
+
+        if( m_inArena )
+            return static_cast< SEXPR_TEXT_REF const * >(this)->m_text;
+
+        const std::string& value = IsString() ? static_cast< SEXPR_STRING const * >(this)->m_value
+                                              : static_cast< SEXPR_SYMBOL const * >(this)->m_value;
+
+        return SEXPR_TEXT{ value.data(), value.size() };
+    }
+
 
     SEXPR_LIST* SEXPR::GetList()
     {
@@ -165,7 +188,7 @@ namespace SEXPR
 
             SEXPR_VECTOR const* list = GetChildren();
 
-            for( std::vector<SEXPR *>::const_iterator it = list->begin(); it != list->end(); ++it )
+            for( SEXPR_VECTOR::const_iterator it = list->begin(); it != list->end(); ++it )
             {
                 result += (*it)->AsString( aLevel );
 
@@ -204,9 +227,13 @@ namespace SEXPR
 
     SEXPR_LIST::~SEXPR_LIST()
     {
-        for( auto child : m_children )
+        // the children of a list of a SEXPR_DOCUMENT are owned by the document arena
+        if( !m_inArena )
         {
-            delete child;
+            for( auto child : m_children )
+            {
+                delete child;
+            }
         }
 
         m_children.clear();
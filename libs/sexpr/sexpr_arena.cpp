@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sexpr/sexpr_arena.h"
+
+#include <algorithm>
+
+namespace SEXPR
+{
+    // the block size doubles with each block, up to this size
+    static const size_t MAX_BLOCK_SIZE = 16 * 1024 * 1024;
+
+    SEXPR_ARENA::~SEXPR_ARENA()
+    {
+        using std::string;
+
+        for( string* str : m_strings )
+            str->~string();
+    }
+
+    void* SEXPR_ARENA::allocateBlock( size_t aSize, size_t aAlign )
+    {
+        size_t size = aSize + aAlign;
+
+        if( m_pos && size > m_blockSize / 4 )
+        {
+            // A large allocation gets its own block, so the free space of the current
+            // block is not lost
+            m_blocks.emplace_back( new char[size] );
+            m_allocated += size;
+
+            uintptr_t block = reinterpret_cast<uintptr_t>( m_blocks.back().get() );
+            return reinterpret_cast<void*>( ( block + aAlign - 1 ) & ~( aAlign - 1 ) );
+        }
+
+        size_t blockSize = std::max( m_blockSize, size );
+
+        m_blocks.emplace_back( new char[blockSize] );
+        m_allocated += blockSize;
+        m_pos = m_blocks.back().get();
+        m_end = m_pos + blockSize;
+        m_blockSize = std::min( 2 * m_blockSize, MAX_BLOCK_SIZE );
+
+        return Allocate( aSize, aAlign );
+    }
+
+    std::string* SEXPR_ARENA::CreateString( const char* aData, size_t aLength )
+    {
+        std::string* str = Create<std::string>( aData, aLength );
+        m_strings.push_back( str );
+
+        return str;
+    }
+}
@@ -18,8 +18,10 @@
 
 #include "sexpr/sexpr_parser.h"
 #include "sexpr/sexpr_exception.h"
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>     /* strtod */
+#include <cstring>
 #include <iterator>
 #include <stdexcept>
 
@@ -55,6 +57,19 @@ namespace SEXPR
         return parseString( str, it );
     }
 
+    std::unique_ptr<SEXPR_DOCUMENT> PARSER::ParseDocument( std::string aString )
+    {
+        std::unique_ptr<SEXPR_DOCUMENT> document( new SEXPR_DOCUMENT( std::move( aString ) ) );
+        document->m_root = parseDocument( *document );
+
+        return document;
+    }
+
+    std::unique_ptr<SEXPR_DOCUMENT> PARSER::ParseDocumentFromFile( const std::string& aFileName )
+    {
+        return ParseDocument( GetFileContents( aFileName ) );
+    }
+
     std::string PARSER::GetFileContents( const std::string &aFileName )
     {
         std::string str;
@@ -193,4 +208,142 @@ namespace SEXPR
 
         return nullptr;
     }
+
+    static inline bool isWhitespace( char aChar )
+    {
+        switch( aChar )
+        {
+        case ' ': case '\t': case '\n': case '\r': case '\b': case '\f': case '\v':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static inline bool isNumberChar( char aChar )
+    {
+        return ( aChar >= '0' && aChar <= '9' ) || aChar == '.';
+    }
+
+    SEXPR* PARSER::parseDocument( SEXPR_DOCUMENT& aDocument )
+    {
+        // Same grammar as parseString(), without recursion: the lists being read are kept
+        // in openLists, and their children in children until the list is closed, so the
+        // children vectors are allocated in the arena only once, at their final size
+        SEXPR_ARENA& arena = aDocument.m_arena;
+        const char*  pos = aDocument.m_text.data();
+        const char*  end = pos + aDocument.m_text.size();
+
+        std::vector<SEXPR*>                          children;
+        std::vector<std::pair<SEXPR_LIST*, size_t>> openLists;
+
+        auto closeList =
+                [&]() -> SEXPR*
+                {
+                    SEXPR_LIST* list = openLists.back().first;
+                    auto        first = children.begin() + openLists.back().second;
+
+                    list->m_children.assign( first, children.end() );
+                    children.erase( first, children.end() );
+                    openLists.pop_back();
+
+                    return list;
+                };
+
+        while( pos < end )
+        {
+            SEXPR* node;
+
+            if( isWhitespace( *pos ) )
+            {
+                if( *pos == '\n' )
+                    m_lineNumber++;
+
+                ++pos;
+                continue;
+            }
+            else if( *pos == '(' )
+            {
+                openLists.emplace_back( arena.Create<SEXPR_LIST>( &arena, m_lineNumber ),
+                                        children.size() );
+                ++pos;
+                continue;
+            }
+            else if( *pos == ')' )
+            {
+                if( openLists.empty() )
+                    return nullptr;
+
+                node = closeList();
+                ++pos;
+            }
+            else if( *pos == '"' )
+            {
+                const char* start = pos + 1;
+                const char* closing = start;
+
+                // find the closing quote character, be sure it is not escaped
+                while( ( closing = static_cast<const char*>(
+                                 memchr( closing, '"', end - closing ) ) ) != nullptr
+                        && closing[-1] == '\\' )
+                {
+                    ++closing;
+                }
+
+                if( !closing )
+                    throw PARSE_EXCEPTION( "missing closing quote" );
+
+                node = arena.Create<SEXPR_TEXT_REF>( SEXPR_TYPE::SEXPR_TYPE_ATOM_STRING, start,
+                                                     closing - start, &arena, m_lineNumber );
+                pos = closing + 1;
+            }
+            else
+            {
+                const char* start = pos;
+
+                while( pos < end && !isWhitespace( *pos ) && *pos != '(' && *pos != ')' )
+                    ++pos;
+
+                if( pos == end )
+                    throw PARSE_EXCEPTION( "format error" );
+
+                const char* digits = ( *start == '-' && pos - start > 1 ) ? start + 1 : start;
+
+                if( std::all_of( digits, pos, isNumberChar ) )
+                {
+                    // the token is followed by a separator, so the conversion stops there
+                    if( std::find( digits, pos, '.' ) != pos )
+                        node = arena.Create<SEXPR_DOUBLE>( strtod( start, nullptr ),
+                                                           m_lineNumber );
+                    else
+                        node = arena.Create<SEXPR_INTEGER>( strtoll( start, nullptr, 0 ),
+                                                            m_lineNumber );
+                }
+                else
+                {
+                    node = arena.Create<SEXPR_TEXT_REF>( SEXPR_TYPE::SEXPR_TYPE_ATOM_SYMBOL,
+                                                         start, pos - start, &arena,
+                                                         m_lineNumber );
+                }
+            }
+
+            if( openLists.empty() )
+                return node;
+
+            children.push_back( node );
+        }
+
+        // Like parseString(), accept the lists not closed at the end of the text
+        while( !openLists.empty() )
+        {
+            SEXPR* list = closeList();
+
+            if( openLists.empty() )
+                return list;
+
+            children.push_back( list );
+        }
+
+        return nullptr;
+    }
 }
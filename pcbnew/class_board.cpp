@@ -64,6 +64,7 @@ BOARD::BOARD() :
         m_project( nullptr ),
         m_designSettings( new BOARD_DESIGN_SETTINGS( nullptr, "board.design_settings" ) ),
         m_NetInfo( this ),
+        m_areaCache( nullptr ),
         m_LegacyDesignSettingsLoaded( false ),
         m_LegacyNetclassesLoaded( false )
 {
@@ -52,6 +52,7 @@ class SHAPE_POLY_SET;
 class CONNECTIVITY_DATA;
 class COMPONENT;
 class PROJECT;
+class PCB_EXPR_AREA_CACHE;
 
 // Forward declare endpoint from class_track.h
 enum ENDPOINT_T : int;
@@ -231,6 +232,8 @@ private:
 
     std::vector<BOARD_LISTENER*> m_listeners;
 
+    PCB_EXPR_AREA_CACHE*    m_areaCache;            // the cache of the area tests, during DRC
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) = delete;
@@ -292,6 +295,16 @@ public:
 
     MARKERS& Markers() { return m_markers; }
 
+    /**
+     * Set the cache used by the insideArea() and insideCourtyard() rule functions. It is set
+     * by the DRC engine for the duration of a run, when the zones and the footprints are not
+     * modified; the functions do not cache their results otherwise.
+     *
+     * @param aCache is the cache (not owned by the board), or nullptr
+     */
+    void SetAreaCache( PCB_EXPR_AREA_CACHE* aCache ) { m_areaCache = aCache; }
+    PCB_EXPR_AREA_CACHE* GetAreaCache() const { return m_areaCache; }
+
     /**
      * The groups must maintain the following invariants. These are checked by
      * GroupsSanityCheck():
@@ -47,6 +47,7 @@
 #include <widgets/wx_grid.h>
 #include <confirm.h>
 #include <lib_table_grid.h>
+#include <lib_table_preloader.h>
 #include <wildcards_and_files_ext.h>
 #include <pgm_base.h>
 #include <pcb_edit_frame.h>
@@ -925,6 +926,9 @@ bool PANEL_FP_LIB_TABLE::TransferDataFromWindow()
             m_global->rows.transfer( m_global->rows.end(), global_model()->rows.begin(),
                                      global_model()->rows.end(), global_model()->rows );
             m_global->reindex();
+
+            if( Pgm().GetLibraryPreloader() )
+                Pgm().GetLibraryPreloader()->Preload( m_global );
         }
 
         if( project_model() && *project_model() != *m_project )
@@ -935,6 +939,9 @@ bool PANEL_FP_LIB_TABLE::TransferDataFromWindow()
             m_project->rows.transfer( m_project->rows.end(), project_model()->rows.begin(),
                                       project_model()->rows.end(), project_model()->rows );
             m_project->reindex();
+
+            if( Pgm().GetLibraryPreloader() )
+                Pgm().GetLibraryPreloader()->Preload( m_project );
         }
 
         return true;
@@ -31,6 +31,7 @@
 #include <drc/drc_rule_condition.h>
 #include <drc/drc_test_provider.h>
 #include <class_track.h>
+#include <pcb_expr_evaluator.h>
 
 void drcPrintDebugMessage( int level, const wxString& msg, const char *function, int line )
 {
@@ -627,6 +628,34 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
 }
 
 
+namespace
+{
+
+/**
+ * Set the area cache of a board for the lifetime of the guard, and reset it when a test
+ * provider throws as well as when the run ends
+ */
+class AREA_CACHE_GUARD
+{
+public:
+    AREA_CACHE_GUARD( BOARD* aBoard, PCB_EXPR_AREA_CACHE* aCache ) :
+            m_board( aBoard )
+    {
+        m_board->SetAreaCache( aCache );
+    }
+
+    ~AREA_CACHE_GUARD()
+    {
+        m_board->SetAreaCache( nullptr );
+    }
+
+private:
+    BOARD* m_board;
+};
+
+} // namespace
+
+
 void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aTestFootprints )
 {
     m_userUnits = aUnits;
@@ -667,18 +696,28 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         module->BuildPolyCourtyards();
     }
 
-    for( DRC_TEST_PROVIDER* provider : m_testProviders )
+    // The zones and the footprints are not modified during the run, so the results of the
+    // insideArea() and insideCourtyard() rule functions can be cached
+    PCB_EXPR_AREA_CACHE areaCache( m_board );
+
     {
-        if( !provider->IsEnabled() )
-            continue;
+        AREA_CACHE_GUARD areaCacheGuard( m_board, &areaCache );
 
-        drc_dbg( 0, "Running test provider: '%s'\n", provider->GetName() );
+        for( DRC_TEST_PROVIDER* provider : m_testProviders )
+        {
+            if( !provider->IsEnabled() )
+                continue;
+
+            drc_dbg( 0, "Running test provider: '%s'\n", provider->GetName() );
 
-        ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
+            ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
 
-        if( !provider->Run() )
-            break;
+            if( !provider->Run() )
+                break;
+        }
     }
+
+    ReportAux( areaCache.FormatStats() );
 }
 
 
@@ -21,6 +21,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <thread>
+
 #include <common.h>
 #include <class_board.h>
 #include <pcb_shape.h>
@@ -556,6 +563,89 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearances( )
 }
 
 
+namespace
+{
+
+/**
+ * The segments of a smoothed zone outline, with an R-tree of their bounding boxes
+ */
+struct ZONE_SEGMENTS
+{
+    std::vector<SEG>           segments;
+    RTree<int, int, 2, double> tree;
+};
+
+
+/**
+ * A pair of zones to test on a layer, and the results of the test (computed by the worker
+ * threads, and reported by the main thread in the original order)
+ */
+struct ZONE_PAIR_TEST
+{
+    size_t                 ref;
+    size_t                 test;
+    DRC_CONSTRAINT         constraint;
+    int                    clearance;
+    bool                   tested = false;  ///< false if the test was cancelled
+
+    std::vector<wxPoint>   refCornersInTest;
+    std::vector<wxPoint>   testCornersInRef;
+    std::map<wxPoint, int> conflictPoints;
+};
+
+
+/**
+ * Run aFunc( i ) for i in [0, aCount) on all the cores.
+ *
+ * The main thread reports the count of done items with aReportProgress while it waits; when
+ * it returns false, aCancelled is set and the worker threads stop taking new items (aFunc can
+ * also test aCancelled to stop a long item).
+ *
+ * @return false if the run was cancelled
+ */
+bool parallelFor( size_t aCount, std::atomic<bool>& aCancelled,
+                  const std::function<void( size_t )>& aFunc,
+                  const std::function<bool( size_t aDone )>& aReportProgress )
+{
+    std::atomic<size_t> next( 0 );
+    std::atomic<size_t> done( 0 );
+    std::atomic<size_t> threadsFinished( 0 );
+
+    size_t parallelThreadCount = std::min<size_t>(
+            std::max<size_t>( std::thread::hardware_concurrency(), 2 ), aCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        std::thread t = std::thread(
+                [&]()
+                {
+                    for( size_t i = next.fetch_add( 1 ); i < aCount && !aCancelled;
+                            i = next.fetch_add( 1 ) )
+                    {
+                        aFunc( i );
+                        done++;
+                    }
+
+                    threadsFinished++;
+                } );
+
+        t.detach();
+    }
+
+    while( threadsFinished < parallelThreadCount )
+    {
+        if( !aCancelled && !aReportProgress( done.load() ) )
+            aCancelled = true;
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    return !aCancelled;
+}
+
+} // namespace
+
+
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
 {
     const int delta = 50;  // This is the number of tests between 2 calls to the progress bar
@@ -566,11 +656,15 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
     if( m_board->GetBoardPolygonOutlines( buffer ) )
         boardOutline = &buffer;
 
-    for( int layer_id = F_Cu; layer_id <= B_Cu; ++layer_id )
+    std::atomic<bool> cancelled( false );
+
+    for( int layer_id = F_Cu; layer_id <= B_Cu && !cancelled; ++layer_id )
     {
         PCB_LAYER_ID layer = static_cast<PCB_LAYER_ID>( layer_id );
         std::vector<SHAPE_POLY_SET> smoothed_polys;
+        std::vector<BOX2I>          bboxes;
         smoothed_polys.resize( m_zones.size() );
+        bboxes.resize( m_zones.size() );
 
         // Skip over layers not used on the current board
         if( !m_board->IsLayerEnabled( layer ) )
@@ -579,14 +673,35 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
         for( size_t ii = 0; ii < m_zones.size(); ii++ )
         {
             if( m_zones[ii]->IsOnLayer( layer ) )
+            {
                 m_zones[ii]->BuildSmoothedPoly( smoothed_polys[ii], layer, boardOutline );
+                bboxes[ii] = smoothed_polys[ii].BBox();
+            }
         }
 
+        // Select the zone pairs to test: the pairs whose outlines are farther apart than the
+        // clearance have no violation
+        std::vector<ZONE_PAIR_TEST> pairs;
+        std::vector<bool>           zoneIsTested( m_zones.size(), false );
+
+        // The progress of a layer is split between the selection of the pairs, the indexing
+        // of the outlines and the test of the pairs
+        auto reportLayerProgress =
+                [&]( int aStep, size_t aDone, size_t aCount ) -> bool
+                {
+                    double step = aStep + (double) aDone / std::max<size_t>( aCount, 1 );
+
+                    return m_drcEngine->ReportProgress( ( layer_id + step / 3.0 ) / B_Cu );
+                };
+
         // iterate through all areas
         for( size_t ia = 0; ia < m_zones.size(); ia++ )
         {
-            if( !reportProgress( layer_id * m_zones.size() + ia, B_Cu * m_zones.size(), delta ) )
+            if( ( ia % delta ) == 0 && !reportLayerProgress( 0, ia, m_zones.size() ) )
+            {
+                cancelled = true;
                 break;
+            }
 
             ZONE_CONTAINER* zoneRef = m_zones[ia];
 
@@ -618,6 +733,16 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 if( zoneRef->GetIsRuleArea() != zoneToTest->GetIsRuleArea() )
                     continue;
 
+                // test the bounding boxes with the largest clearance the rules can return (the
+                // local clearances of the zones override the rules)
+                BOX2I refBox = bboxes[ia];
+                refBox.Inflate( std::max( { m_largestClearance,
+                                            zoneRef->GetLocalClearance( nullptr ),
+                                            zoneToTest->GetLocalClearance( nullptr ), 1 } ) );
+
+                if( !refBox.Intersects( bboxes[ia2] ) )
+                    continue;
+
                 // Examine a candidate zone: compare zoneToTest to zoneRef
 
                 // Get clearance used in zone to zone test.
@@ -632,108 +757,200 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 if( zoneRef->GetIsRuleArea() ) // fixme: really?
                     zone2zoneClearance = 1;
 
-                // test for some corners of zoneRef inside zoneToTest
-                for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
-                {
-                    VECTOR2I currentVertex = *iterator;
-                    wxPoint pt( currentVertex.x, currentVertex.y );
+                refBox = bboxes[ia];
+                refBox.Inflate( std::max( zone2zoneClearance, 0 ) );
 
-                    if( smoothed_polys[ia2].Contains( currentVertex ) )
-                    {
-                        std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                        drce->SetItems( zoneRef, zoneToTest );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
+                if( !refBox.Intersects( bboxes[ia2] ) )
+                    continue;
 
-                        reportViolation( drce, pt );
-                    }
-                }
+                ZONE_PAIR_TEST pair;
+                pair.ref = ia;
+                pair.test = ia2;
+                pair.constraint = constraint;
+                pair.clearance = zone2zoneClearance;
+                pairs.push_back( std::move( pair ) );
 
-                // test for some corners of zoneToTest inside zoneRef
-                for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+                zoneIsTested[ia] = true;
+                zoneIsTested[ia2] = true;
+            }
+        }
+
+        // Index the segments of the outlines of the zones to test
+        std::vector<std::unique_ptr<ZONE_SEGMENTS>> zoneSegments( m_zones.size() );
+
+        parallelFor( cancelled ? 0 : m_zones.size(), cancelled,
+                [&]( size_t ii )
                 {
-                    VECTOR2I currentVertex = *iterator;
-                    wxPoint pt( currentVertex.x, currentVertex.y );
+                    if( !zoneIsTested[ii] )
+                        return;
+
+                    auto segments = std::make_unique<ZONE_SEGMENTS>();
+
+                    for( auto it = smoothed_polys[ii].CIterateSegmentsWithHoles(); it; it++ )
+                        segments->segments.push_back( *it );
 
-                    if( smoothed_polys[ia].Contains( currentVertex ) )
+                    for( size_t jj = 0; jj < segments->segments.size(); jj++ )
                     {
-                        std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
-                        drce->SetItems( zoneToTest, zoneRef );
-                        drce->SetViolatingRule( constraint.GetParentRule() );
+                        const SEG& seg = segments->segments[jj];
+                        const int  mmin[2] = { std::min( seg.A.x, seg.B.x ),
+                                               std::min( seg.A.y, seg.B.y ) };
+                        const int  mmax[2] = { std::max( seg.A.x, seg.B.x ),
+                                               std::max( seg.A.y, seg.B.y ) };
 
-                        reportViolation( drce, pt );
+                        segments->tree.Insert( mmin, mmax, (int) jj );
                     }
-                }
 
-                // Iterate through all the segments of refSmoothedPoly
-                std::map<wxPoint, int> conflictPoints;
+                    zoneSegments[ii] = std::move( segments );
+                },
+                [&]( size_t aDone )
+                {
+                    return reportLayerProgress( 1, aDone, m_zones.size() );
+                } );
 
-                for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
+        // Test the zone pairs
+        parallelFor( cancelled ? 0 : pairs.size(), cancelled,
+                [&]( size_t ii )
                 {
-                    // Build ref segment
-                    SEG refSegment = *refIt;
+                    ZONE_PAIR_TEST&       pair = pairs[ii];
+                    const SHAPE_POLY_SET& refPoly = smoothed_polys[pair.ref];
+                    const SHAPE_POLY_SET& testPoly = smoothed_polys[pair.test];
 
-                    // Iterate through all the segments in smoothed_polys[ia2]
-                    for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
+                    // test for some corners of zoneRef inside zoneToTest
+                    for( auto iterator = refPoly.CIterateWithHoles(); iterator; iterator++ )
                     {
-                        // Build test segment
-                        SEG testSegment = *testIt;
-                        wxPoint pt;
-
-                        int ax1, ay1, ax2, ay2;
-                        ax1 = refSegment.A.x;
-                        ay1 = refSegment.A.y;
-                        ax2 = refSegment.B.x;
-                        ay2 = refSegment.B.y;
-
-                        int bx1, by1, bx2, by2;
-                        bx1 = testSegment.A.x;
-                        by1 = testSegment.A.y;
-                        bx2 = testSegment.B.x;
-                        by2 = testSegment.B.y;
-
-                        int d = GetClearanceBetweenSegments( bx1, by1, bx2, by2,
-                                                             0,
-                                                             ax1, ay1, ax2, ay2,
-                                                             0,
-                                                             zone2zoneClearance,
-                                                             &pt.x, &pt.y );
-
-                        if( d < zone2zoneClearance )
+                        VECTOR2I currentVertex = *iterator;
+
+                        if( bboxes[pair.test].Contains( currentVertex )
+                                && testPoly.Contains( currentVertex ) )
                         {
-                            if( conflictPoints.count( pt ) )
-                                conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
-                            else
-                                conflictPoints[ pt ] = d;
+                            pair.refCornersInTest.emplace_back( currentVertex.x, currentVertex.y );
                         }
                     }
-                }
-
-                for( const std::pair<const wxPoint, int>& conflict : conflictPoints )
-                {
-                    int       actual = conflict.second;
-                    std::shared_ptr<DRC_ITEM> drce;
 
-                    if( actual <= 0 )
+                    // test for some corners of zoneToTest inside zoneRef
+                    for( auto iterator = testPoly.CIterateWithHoles(); iterator; iterator++ )
                     {
-                        drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                        VECTOR2I currentVertex = *iterator;
+
+                        if( bboxes[pair.ref].Contains( currentVertex )
+                                && refPoly.Contains( currentVertex ) )
+                        {
+                            pair.testCornersInRef.emplace_back( currentVertex.x, currentVertex.y );
+                        }
                     }
-                    else
-                    {
-                        drce = DRC_ITEM::Create( DRCE_CLEARANCE );
 
-                        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                      constraint.GetName(),
-                                      MessageTextFromValue( userUnits(), zone2zoneClearance ),
-                                      MessageTextFromValue( userUnits(), conflict.second ) );
+                    // Test the segments of refPoly against the segments of testPoly closer than
+                    // the clearance to their bounding box (the farther ones are rejected by
+                    // GetClearanceBetweenSegments)
+                    const ZONE_SEGMENTS& testSegments = *zoneSegments[pair.test];
+                    int                  clearance = std::max( pair.clearance, 0 );
 
-                        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+                    for( const SEG& refSegment : zoneSegments[pair.ref]->segments )
+                    {
+                        if( cancelled )
+                            return;
+
+                        const SEG& seg = refSegment;
+                        const int  mmin[2] = { std::min( seg.A.x, seg.B.x ) - clearance,
+                                               std::min( seg.A.y, seg.B.y ) - clearance };
+                        const int  mmax[2] = { std::max( seg.A.x, seg.B.x ) + clearance,
+                                               std::max( seg.A.y, seg.B.y ) + clearance };
+
+                        auto visit =
+                                [&]( int aIndex ) -> bool
+                                {
+                                    const SEG& testSegment = testSegments.segments[aIndex];
+                                    wxPoint    pt;
+
+                                    int d = GetClearanceBetweenSegments( testSegment.A.x,
+                                                                         testSegment.A.y,
+                                                                         testSegment.B.x,
+                                                                         testSegment.B.y,
+                                                                         0,
+                                                                         refSegment.A.x,
+                                                                         refSegment.A.y,
+                                                                         refSegment.B.x,
+                                                                         refSegment.B.y,
+                                                                         0,
+                                                                         pair.clearance,
+                                                                         &pt.x, &pt.y );
+
+                                    if( d < pair.clearance )
+                                    {
+                                        auto it = pair.conflictPoints.find( pt );
+
+                                        if( it != pair.conflictPoints.end() )
+                                            it->second = std::min( it->second, d );
+                                        else
+                                            pair.conflictPoints[ pt ] = d;
+                                    }
+
+                                    return true;
+                                };
+
+                        testSegments.tree.Search( mmin, mmax, visit );
                     }
 
-                    drce->SetItems( zoneRef, zoneToTest );
-                    drce->SetViolatingRule( constraint.GetParentRule() );
+                    pair.tested = true;
+                },
+                [&]( size_t aDone )
+                {
+                    return reportLayerProgress( 2, aDone, pairs.size() );
+                } );
+
+        // Report the violations, in the order of the sequential test (when the test is
+        // cancelled, the violations of the pairs already tested are reported)
+        for( const ZONE_PAIR_TEST& pair : pairs )
+        {
+            if( !pair.tested )
+                continue;
+
+            ZONE_CONTAINER* zoneRef = m_zones[pair.ref];
+            ZONE_CONTAINER* zoneToTest = m_zones[pair.test];
+
+            for( const wxPoint& pt : pair.refCornersInTest )
+            {
+                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                drce->SetItems( zoneRef, zoneToTest );
+                drce->SetViolatingRule( pair.constraint.GetParentRule() );
+
+                reportViolation( drce, pt );
+            }
+
+            for( const wxPoint& pt : pair.testCornersInRef )
+            {
+                std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                drce->SetItems( zoneToTest, zoneRef );
+                drce->SetViolatingRule( pair.constraint.GetParentRule() );
+
+                reportViolation( drce, pt );
+            }
+
+            for( const std::pair<const wxPoint, int>& conflict : pair.conflictPoints )
+            {
+                int       actual = conflict.second;
+                std::shared_ptr<DRC_ITEM> drce;
+
+                if( actual <= 0 )
+                {
+                    drce = DRC_ITEM::Create( DRCE_ZONES_INTERSECT );
+                }
+                else
+                {
+                    drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+
+                    m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                                  pair.constraint.GetName(),
+                                  MessageTextFromValue( userUnits(), pair.clearance ),
+                                  MessageTextFromValue( userUnits(), conflict.second ) );
 
-                    reportViolation( drce, conflict.first );
+                    drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
                 }
+
+                drce->SetItems( zoneRef, zoneToTest );
+                drce->SetViolatingRule( pair.constraint.GetParentRule() );
+
+                reportViolation( drce, conflict.first );
             }
         }
     }
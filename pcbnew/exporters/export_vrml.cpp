@@ -26,7 +26,11 @@
 
 #include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
 #include <vector>
 #include <wx/dir.h>
 
@@ -39,6 +43,7 @@
 #include "class_track.h"
 #include "class_zone.h"
 #include "convert_to_biu.h"
+#include "export_vrml_board.h"
 #include <filename_resolver.h>
 #include "plugins/3dapi/ifsg_all.h"
 #include "streamwrapper.h"
@@ -136,6 +141,44 @@ enum VRML_COLOR_INDEX
 static VRML_COLOR colors[VRML_COLOR_LAST];
 static SGNODE* sgmaterial[VRML_COLOR_LAST] = { NULL };
 
+
+/**
+ * The copper or tin shape of a pad or a via on one side of the board: it is tesselated
+ * once, at the origin, and shared by all the pads and vias which have the same shape.
+ */
+struct VRML_PADSTACK
+{
+    VRML_LAYER          m_shape;
+    VRML_LAYER          m_holes;        // the drill hole, cut in the shape
+    VRML_COLOR_INDEX    m_color;
+    bool                m_top;          // true for a top side shape
+    bool                m_valid;        // false if the tesselation failed
+    int                 m_index;        // to name the shape in the legacy (inline) output
+    bool                m_written;      // the shape is already defined in the legacy output
+    SGNODE*             m_sgShape;      // the shared node of the scenegraph output
+
+    VRML_PADSTACK() :
+            m_color( VRML_COLOR_TRACK ),
+            m_top( true ),
+            m_valid( false ),
+            m_index( 0 ),
+            m_written( false ),
+            m_sgShape( NULL )
+    {
+    }
+};
+
+
+/**
+ * A pad or a via written as a padstack instance: only its transform is written.
+ */
+struct VRML_PADSTACK_INSTANCE
+{
+    VRML_PADSTACK*  m_padstack;
+    SGPOINT         m_translation;      // in VRML world units (offsets included)
+    double          m_angle;            // rotation around the Z axis, in radians
+};
+
 class MODEL_VRML
 {
 private:
@@ -158,7 +201,17 @@ public:
 
     std::list< SGNODE* > m_components;
 
+    // shared padstacks, by shape key, and their instances
+    std::map< std::string, std::unique_ptr<VRML_PADSTACK> > m_padstacks;
+    std::vector< VRML_PADSTACK_INSTANCE >                   m_padstackInstances;
+
+    // model files already written in the legacy output, and the index of their Inline node
+    std::map< wxString, int > m_inlineModels;
+
+    VRML_EXPORT_STATS m_stats;
+
     bool m_plainPCB;
+    bool m_shareInstances;    // write identical pads, vias and models as shared instances
 
     double m_minLineWidth;    // minimum width of a VRML line segment
 
@@ -194,6 +247,7 @@ public:
                 0.0f, 0.0f, 0.8f, 0.0f, 0.8f );
 
         m_plainPCB = false;
+        m_shareInstances = false;
         SetOffset( 0.0, 0.0 );
         m_text_layer = F_Cu;
         m_text_width = 1;
@@ -222,8 +276,11 @@ public:
             }
 
             m_components.clear();
-            m_OutputPCB.Destroy();
         }
+
+        // the cached models are detached, the rest of the scenegraph (which owns the
+        // shared padstack shapes) belongs to this export
+        m_OutputPCB.Destroy();
     }
 
     VRML_COLOR& GetColor( VRML_COLOR_INDEX aIndex )
@@ -296,8 +353,30 @@ static bool GetLayer( MODEL_VRML& aModel, LAYER_NUM layer, VRML_LAYER** vlayer )
 static void create_vrml_shell( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
                                VRML_LAYER* layer, double top_z, double bottom_z );
 
-static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
-                               VRML_LAYER* layer, double aHeight, bool aTopPlane );
+static SGNODE* create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+                                  VRML_LAYER* layer, double aHeight, bool aTopPlane );
+
+static void write_material( std::ostream& aOut_file, VRML_COLOR& aColor, const char* aIndent )
+{
+    aOut_file << aIndent << "diffuseColor " << std::setprecision(3);
+    aOut_file << aColor.diffuse_red << " ";
+    aOut_file << aColor.diffuse_grn << " ";
+    aOut_file << aColor.diffuse_blu << "\n";
+
+    aOut_file << aIndent << "specularColor ";
+    aOut_file << aColor.spec_red << " ";
+    aOut_file << aColor.spec_grn << " ";
+    aOut_file << aColor.spec_blu << "\n";
+
+    aOut_file << aIndent << "emissiveColor ";
+    aOut_file << aColor.emit_red << " ";
+    aOut_file << aColor.emit_grn << " ";
+    aOut_file << aColor.emit_blu << "\n";
+
+    aOut_file << aIndent << "ambientIntensity " << aColor.ambient << "\n";
+    aOut_file << aIndent << "transparency " << aColor.transp << "\n";
+    aOut_file << aIndent << "shininess " << aColor.shiny << "\n";
+}
 
 static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
                                 VRML_LAYER* aLayer, bool aPlane, bool aTop,
@@ -349,24 +428,7 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
             switch( marker_found )
             {
             case 1:    // Material marker
-                aOut_file << "              diffuseColor " << std::setprecision(3);
-                aOut_file << aColor.diffuse_red << " ";
-                aOut_file << aColor.diffuse_grn << " ";
-                aOut_file << aColor.diffuse_blu << "\n";
-
-                aOut_file << "              specularColor ";
-                aOut_file << aColor.spec_red << " ";
-                aOut_file << aColor.spec_grn << " ";
-                aOut_file << aColor.spec_blu << "\n";
-
-                aOut_file << "              emissiveColor ";
-                aOut_file << aColor.emit_red << " ";
-                aOut_file << aColor.emit_grn << " ";
-                aOut_file << aColor.emit_blu << "\n";
-
-                aOut_file << "              ambientIntensity " << aColor.ambient << "\n";
-                aOut_file << "              transparency " << aColor.transp << "\n";
-                aOut_file << "              shininess " << aColor.shiny << "\n";
+                write_material( aOut_file, aColor, "              " );
                 break;
 
             case 2:
@@ -399,6 +461,95 @@ static void write_triangle_bag( std::ostream& aOut_file, VRML_COLOR& aColor,
 }
 
 
+// write the pads and vias which are padstack instances: the shape of a padstack is
+// written by its first instance, and the next ones only write a transform
+static void write_padstack_instances( MODEL_VRML& aModel, OSTREAM* aOutputFile )
+{
+    for( const VRML_PADSTACK_INSTANCE& instance : aModel.m_padstackInstances )
+    {
+        VRML_PADSTACK* padstack = instance.m_padstack;
+
+        if( !padstack->m_valid )
+            continue;
+
+        if( USE_INLINES )
+        {
+            std::ostream& out = *aOutputFile;
+
+            out << "Transform {\n";
+
+            // only write a rotation if it is >= 0.1 deg
+            if( std::abs( instance.m_angle ) > 0.0001745 )
+            {
+                out << "  rotation 0 0 1 " << std::setprecision( 5 ) << instance.m_angle
+                    << "\n";
+            }
+
+            out << "  translation " << std::setprecision( PRECISION );
+            out << instance.m_translation.x << " ";
+            out << instance.m_translation.y << " ";
+            out << instance.m_translation.z << "\n";
+            out << "  children [\n";
+
+            if( padstack->m_written )
+            {
+                out << "    USE PADSTACK_" << padstack->m_index << "\n";
+            }
+            else
+            {
+                out << "    DEF PADSTACK_" << padstack->m_index << " Shape {\n";
+                out << "      appearance Appearance {\n";
+                out << "        material Material {\n";
+                write_material( out, aModel.GetColor( padstack->m_color ), "          " );
+                out << "        }\n";
+                out << "      }\n";
+                out << "      geometry IndexedFaceSet {\n";
+                out << "        solid TRUE\n";
+                out << "        coord Coordinate {\n";
+                out << "          point [\n";
+                padstack->m_shape.WriteVertices( 0.0, out, PRECISION );
+                out << "\n          ]\n";
+                out << "        }\n";
+                out << "        coordIndex [\n";
+                padstack->m_shape.WriteIndices( padstack->m_top, out );
+                out << "\n        ]\n";
+                out << "      }\n";
+                out << "    }\n";
+
+                padstack->m_written = true;
+            }
+
+            out << "  ]\n}\n";
+        }
+        else
+        {
+            IFSG_TRANSFORM tx( aModel.m_OutputPCB.GetRawPtr() );
+
+            // only write a rotation if it is >= 0.1 deg
+            if( std::abs( instance.m_angle ) > 0.0001745 )
+                tx.SetRotation( SGVECTOR( 0.0, 0.0, 1.0 ), instance.m_angle );
+
+            tx.SetTranslation( instance.m_translation );
+
+            if( padstack->m_sgShape )
+            {
+                tx.AddRefNode( padstack->m_sgShape );
+            }
+            else
+            {
+                padstack->m_sgShape = create_vrml_plane( tx, padstack->m_color,
+                                                         &padstack->m_shape, 0.0,
+                                                         padstack->m_top );
+
+                // the shape is empty: do not try again with the next instances
+                if( !padstack->m_sgShape )
+                    padstack->m_valid = false;
+            }
+        }
+    }
+}
+
+
 static void write_layers( MODEL_VRML& aModel, BOARD* aPcb, const char* aFileName,
                           OSTREAM* aOutputFile )
 {
@@ -490,6 +641,9 @@ static void write_layers( MODEL_VRML& aModel, BOARD* aPcb, const char* aFileName
                            false );
     }
 
+    // shared pads and vias
+    write_padstack_instances( aModel, aOutputFile );
+
     // VRML_LAYER PTH;
     aModel.m_plated_holes.Tesselate( NULL, true );
 
@@ -883,6 +1037,89 @@ static void export_vrml_board( MODEL_VRML& aModel, BOARD* aPcb )
 }
 
 
+// return the shared padstack of a shape key, or create it: aBuilder draws the shape
+// and its drill hole at the origin. Return NULL if the shape cannot be tesselated (the
+// pad or via is then drawn on the copper layers, as when the padstacks are not shared).
+static VRML_PADSTACK* get_padstack(
+        MODEL_VRML& aModel, const std::string& aKey, VRML_COLOR_INDEX aColor, bool aTop,
+        const std::function<void( VRML_LAYER& aShape, VRML_LAYER& aHoles )>& aBuilder )
+{
+    std::string key = aKey + ( aTop ? " top " : " bot " ) + std::to_string( aColor );
+    auto        it = aModel.m_padstacks.find( key );
+
+    if( it != aModel.m_padstacks.end() )
+        return it->second->m_valid ? it->second.get() : NULL;
+
+    std::unique_ptr<VRML_PADSTACK> padstack( new VRML_PADSTACK );
+    padstack->m_color = aColor;
+    padstack->m_top = aTop;
+    padstack->m_index = aModel.m_stats.m_Padstacks;
+
+    aBuilder( padstack->m_shape, padstack->m_holes );
+
+    if( padstack->m_holes.GetNContours() > 0 )
+        padstack->m_valid = padstack->m_shape.Tesselate( &padstack->m_holes );
+    else
+        padstack->m_valid = padstack->m_shape.Tesselate( NULL );
+
+    if( padstack->m_valid )
+        aModel.m_stats.m_Padstacks++;
+
+    VRML_PADSTACK* ret = padstack->m_valid ? padstack.get() : NULL;
+    aModel.m_padstacks[key] = std::move( padstack );
+
+    return ret;
+}
+
+
+// add an instance of a shared padstack at the board position aX, aY (already scaled)
+static void add_padstack_instance( MODEL_VRML& aModel, VRML_PADSTACK* aPadstack,
+                                   double aX, double aY, double aAngle )
+{
+    VRML_PADSTACK_INSTANCE instance;
+
+    // the same heights as the copper and tin layers in write_layers()
+    double tin_offset = 0.0;
+
+    if( aPadstack->m_color == VRML_COLOR_TIN )
+        tin_offset = Millimeter2iu( ART_OFFSET / 2.0 ) * BOARD_SCALE;
+
+    double z = aPadstack->m_top ? aModel.GetLayerZ( F_Cu ) + tin_offset
+                                : aModel.GetLayerZ( B_Cu ) - tin_offset;
+
+    instance.m_padstack = aPadstack;
+    instance.m_translation = SGPOINT( aX + aModel.m_tx, -aY - aModel.m_ty, z );
+    instance.m_angle = aAngle;
+
+    aModel.m_padstackInstances.push_back( instance );
+    aModel.m_stats.m_PadstackInstances++;
+}
+
+
+// add a round (via) padstack instance; return false if it must be drawn on the copper layer
+static bool share_round_padstack( MODEL_VRML& aModel, double x, double y, double r,
+                                  double hole, bool aTop )
+{
+    std::ostringstream key;
+    key << std::setprecision( 17 ) << "round " << r << " " << hole;
+
+    VRML_PADSTACK* padstack = get_padstack( aModel, key.str(), VRML_COLOR_TRACK, aTop,
+            [&]( VRML_LAYER& aShape, VRML_LAYER& aHoles )
+            {
+                aShape.AddCircle( 0.0, 0.0, r );
+
+                if( hole > 0 )
+                    aHoles.AddCircle( 0.0, 0.0, hole, true );
+            } );
+
+    if( !padstack )
+        return false;
+
+    add_padstack_instance( aModel, padstack, x, y, 0.0 );
+    return true;
+}
+
+
 static void export_round_padstack( MODEL_VRML& aModel, BOARD* pcb,
                                    double x, double y, double r,
                                    LAYER_NUM bottom_layer, LAYER_NUM top_layer,
@@ -903,7 +1140,12 @@ static void export_round_padstack( MODEL_VRML& aModel, BOARD* pcb,
 
     while( true )
     {
-        if( layer == B_Cu )
+        if( ( layer == B_Cu || layer == F_Cu ) && aModel.m_shareInstances
+                && share_round_padstack( aModel, x, y, r, hole, layer == F_Cu ) )
+        {
+            // the via copper is a shared padstack instance
+        }
+        else if( layer == B_Cu )
         {
             aModel.m_bot_copper.AddCircle( x, -y, r );
 
@@ -1110,10 +1352,14 @@ static void export_vrml_edge_module( MODEL_VRML& aModel, FP_SHAPE* aOutline, MOD
 }
 
 
-static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_PAD* aPad )
+// draw the shape of a pad; when aAtOrigin is true, it is drawn at the origin and not
+// rotated, for a shared padstack
+static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_PAD* aPad,
+                                  bool aAtOrigin = false )
 {
     // The (maybe offset) pad position
-    wxPoint pad_pos = aPad->ShapePos();
+    wxPoint pad_pos = aAtOrigin ? wxPoint( 0, 0 ) : aPad->ShapePos();
+    double  pad_orient = aAtOrigin ? 0.0 : aPad->GetOrientation();
     double  pad_x   = pad_pos.x * BOARD_SCALE;
     double  pad_y   = pad_pos.y * BOARD_SCALE;
     wxSize  pad_delta = aPad->GetDelta();
@@ -1136,7 +1382,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
     case PAD_SHAPE_OVAL:
 
         if( !aTinLayer->AddSlot( pad_x, -pad_y, pad_w * 2.0, pad_h * 2.0,
-                                 aPad->GetOrientation()/10.0, false ) )
+                                 pad_orient/10.0, false ) )
             throw( std::runtime_error( aTinLayer->GetError() ) );
 
         break;
@@ -1159,7 +1405,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 
         // Close polygon
         cornerList.push_back( cornerList[0] );
-        if( !aTinLayer->AddPolygon( cornerList, pad_x, -pad_y, aPad->GetOrientation() ) )
+        if( !aTinLayer->AddPolygon( cornerList, pad_x, -pad_y, pad_orient ) )
             throw( std::runtime_error( aTinLayer->GetError() ) );
 
         break;
@@ -1183,7 +1429,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
             // Close polygon
             cornerList.push_back( cornerList[0] );
 
-            if( !aTinLayer->AddPolygon( cornerList, pad_x, -pad_y, aPad->GetOrientation() ) )
+            if( !aTinLayer->AddPolygon( cornerList, pad_x, -pad_y, pad_orient ) )
                 throw( std::runtime_error( aTinLayer->GetError() ) );
         }
 
@@ -1210,7 +1456,7 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 
         for( int i = 0; i < 4; i++ )
         {
-            RotatePoint( &coord[i * 2], &coord[i * 2 + 1], aPad->GetOrientation() );
+            RotatePoint( &coord[i * 2], &coord[i * 2 + 1], pad_orient );
             coord[i * 2] += pad_x;
             coord[i * 2 + 1] += pad_y;
         }
@@ -1243,6 +1489,67 @@ static void export_vrml_padshape( MODEL_VRML& aModel, VRML_LAYER* aTinLayer, D_P
 }
 
 
+// add a pad instance of a shared padstack on one side; return false if the pad must be
+// drawn on the copper or tin layer
+static bool share_pad( MODEL_VRML& aModel, D_PAD* aPad, bool aTop, bool aTin )
+{
+    // custom shapes are not shared: their key would be the list of primitives
+    if( aPad->GetShape() == PAD_SHAPE_CUSTOM )
+        return false;
+
+    bool          pth = aPad->GetAttribute() != PAD_ATTRIB_NPTH;
+    const wxSize& size = aPad->GetSize();
+    const wxSize& delta = aPad->GetDelta();
+    const wxSize& drill = aPad->GetDrillSize();
+    const wxPoint& offset = aPad->GetOffset();
+
+    // everything which changes the shape drawn by export_vrml_padshape() and the hole
+    std::ostringstream key;
+    key << "pad " << aPad->GetShape() << " " << size.x << " " << size.y << " "
+        << delta.x << " " << delta.y << " " << aPad->GetRoundRectCornerRadius() << " "
+        << offset.x << " " << offset.y << " " << aPad->GetDrillShape() << " "
+        << drill.x << " " << drill.y << " " << pth;
+
+    VRML_PADSTACK* padstack = get_padstack( aModel, key.str(),
+            aTin ? VRML_COLOR_TIN : VRML_COLOR_TRACK, aTop,
+            [&]( VRML_LAYER& aShape, VRML_LAYER& aHoles )
+            {
+                export_vrml_padshape( aModel, &aShape, aPad, true );
+
+                double hole_drill_w = (double) drill.x * BOARD_SCALE / 2.0;
+                double hole_drill_h = (double) drill.y * BOARD_SCALE / 2.0;
+                double hole_drill   = std::min( hole_drill_w, hole_drill_h );
+                double plating      = pth ? PLATE_OFFSET : 0.0;
+
+                // the hole is at the pad position, i.e. at -offset from the shape position
+                double hole_x = -offset.x * BOARD_SCALE;
+                double hole_y = -offset.y * BOARD_SCALE;
+
+                if( hole_drill <= 0 )
+                    return;
+
+                if( aPad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG )
+                {
+                    aHoles.AddSlot( hole_x, -hole_y, hole_drill_w * 2.0 + plating,
+                                    hole_drill_h * 2.0 + plating, 0.0, true );
+                }
+                else
+                {
+                    aHoles.AddCircle( hole_x, -hole_y, hole_drill + plating, true );
+                }
+            } );
+
+    if( !padstack )
+        return false;
+
+    wxPoint pad_pos = aPad->ShapePos();
+
+    add_padstack_instance( aModel, padstack, pad_pos.x * BOARD_SCALE, pad_pos.y * BOARD_SCALE,
+                           DECIDEG2RAD( aPad->GetOrientation() ) );
+    return true;
+}
+
+
 static void export_vrml_pad( MODEL_VRML& aModel, BOARD* aPcb, D_PAD* aPad )
 {
     double  hole_drill_w    = (double) aPad->GetDrillSize().x * BOARD_SCALE / 2.0;
@@ -1304,14 +1611,18 @@ static void export_vrml_pad( MODEL_VRML& aModel, BOARD* aPcb, D_PAD* aPad )
     // The pad proper, on the selected layers
     LSET layer_mask = aPad->GetLayerSet();
 
-    if( layer_mask[B_Cu] )
+    if( layer_mask[B_Cu]
+            && !( aModel.m_shareInstances
+                  && share_pad( aModel, aPad, false, layer_mask[B_Mask] ) ) )
     {
         if( layer_mask[B_Mask] )
             export_vrml_padshape( aModel, &aModel.m_bot_tin, aPad );
         else
             export_vrml_padshape( aModel, &aModel.m_bot_copper, aPad );
     }
-    if( layer_mask[F_Cu] )
+    if( layer_mask[F_Cu]
+            && !( aModel.m_shareInstances
+                  && share_pad( aModel, aPad, true, layer_mask[F_Mask] ) ) )
     {
         if( layer_mask[F_Mask] )
             export_vrml_padshape( aModel, &aModel.m_top_tin, aPad );
@@ -1397,6 +1708,10 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
     for( D_PAD* pad : aModule->Pads() )
         export_vrml_pad( aModel, aPcb, pad );
 
+    // No 3D model cache: only the board is exported
+    if( !cache )
+        return;
+
     bool isFlipped = aModule->GetLayer() == B_Cu;
 
     // Export the object VRML model(s)
@@ -1467,40 +1782,55 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
 
         if( USE_INLINES )
         {
-            wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
+            // With shared instances, the model file is checked and copied once, and its
+            // first Inline node is reused by the next instances
+            auto prevInline = aModel.m_inlineModels.find( sM->m_Filename );
+            bool reuseInline = aModel.m_shareInstances
+                               && prevInline != aModel.m_inlineModels.end();
+
             wxFileName dstFile;
-            dstFile.SetPath( SUBDIR_3D );
-            dstFile.SetName( srcFile.GetName() );
-            dstFile.SetExt( "wrl"  );
 
-            // copy the file if necessary
-            wxDateTime srcModTime = srcFile.GetModificationTime();
-            wxDateTime destModTime = srcModTime;
+            if( !reuseInline )
+            {
+                wxFileName srcFile = cache->GetResolver()->ResolvePath( sM->m_Filename );
+                dstFile.SetPath( SUBDIR_3D );
+                dstFile.SetName( srcFile.GetName() );
+                dstFile.SetExt( "wrl"  );
 
-            destModTime.SetToCurrent();
+                // copy the file if necessary
+                wxDateTime srcModTime = srcFile.GetModificationTime();
+                wxDateTime destModTime = srcModTime;
 
-            if( dstFile.FileExists() )
-                destModTime = dstFile.GetModificationTime();
+                destModTime.SetToCurrent();
 
-            if( srcModTime != destModTime )
-            {
-                wxString fileExt = srcFile.GetExt();
-                fileExt.LowerCase();
+                if( dstFile.FileExists() )
+                    destModTime = dstFile.GetModificationTime();
 
-                // copy VRML models and use the scenegraph library to
-                // translate other model types
-                if( fileExt == "wrl" )
+                if( srcModTime != destModTime )
                 {
-                    if( !wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() ) )
-                        continue;
-                }
-                else
-                {
-                    if( !S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d, USE_DEFS, true ) )
+                    wxString fileExt = srcFile.GetExt();
+                    fileExt.LowerCase();
+
+                    // copy VRML models and use the scenegraph library to
+                    // translate other model types
+                    bool copied;
+
+                    if( fileExt == "wrl" )
+                        copied = wxCopyFile( srcFile.GetFullPath(), dstFile.GetFullPath() );
+                    else
+                        copied = S3D::WriteVRML( dstFile.GetFullPath().ToUTF8(), true, mod3d,
+                                                 USE_DEFS, true );
+
+                    if( !copied )
+                    {
+                        ++sM;
                         continue;
+                    }
                 }
             }
 
+            aModel.m_stats.m_ModelInstances++;
+
             (*aOutputFile) << "Transform {\n";
 
             // only write a rotation if it is >= 0.1 deg
@@ -1520,7 +1850,25 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             (*aOutputFile) << sM->m_Scale.y << " ";
             (*aOutputFile) << sM->m_Scale.z << "\n";
 
-            (*aOutputFile) << "  children [\n    Inline {\n      url \"";
+            if( reuseInline )
+            {
+                (*aOutputFile) << "  children [\n    USE MODEL_" << prevInline->second << "\n";
+                (*aOutputFile) << "  ]\n  }\n";
+                ++sM;
+                continue;
+            }
+
+            (*aOutputFile) << "  children [\n    ";
+
+            if( aModel.m_shareInstances )
+            {
+                int index = (int) aModel.m_inlineModels.size();
+                aModel.m_inlineModels[sM->m_Filename] = index;
+                (*aOutputFile) << "DEF MODEL_" << index << " ";
+            }
+
+            aModel.m_stats.m_Models++;
+            (*aOutputFile) << "Inline {\n      url \"";
 
             if( USE_RELPATH )
             {
@@ -1547,9 +1895,13 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
             modelShape->SetTranslation( trans );
             modelShape->SetScale( SGPOINT( sM->m_Scale.x, sM->m_Scale.y, sM->m_Scale.z ) );
 
+            // the model scenegraph is always shared by its instances
+            aModel.m_stats.m_ModelInstances++;
+
             if( NULL == S3D::GetSGNodeParent( mod3d ) )
             {
                 aModel.m_components.push_back( mod3d );
+                aModel.m_stats.m_Models++;
                 modelShape->AddChildNode( mod3d );
             }
             else
@@ -1564,22 +1916,20 @@ static void export_vrml_module( MODEL_VRML& aModel, BOARD* aPcb,
 }
 
 
-bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMtoWRMLunit,
-                                      bool aExport3DFiles, bool aUseRelativePaths,
-                                      bool aUsePlainPCB, const wxString& a3D_Subdir,
-                                      double aXRef, double aYRef )
+bool ExportBoardToVRML( BOARD* aPcb, S3D_CACHE* a3DCache, COMMIT* aCommit,
+                        const wxString& aFullFileName, double aMMtoWRMLunit,
+                        bool aExport3DFiles, bool aUseRelativePaths, bool aUsePlainPCB,
+                        const wxString& a3D_Subdir, double aXRef, double aYRef,
+                        bool aShareInstances, wxString& aErrorMsg, VRML_EXPORT_STATS* aStats )
 {
-    BOARD*          pcb = GetBoard();
+    BOARD*          pcb = aPcb;
     bool            ok  = true;
-    BOARD_COMMIT    commit( this );     // We may need to modify the board (for instance to
-                                        // fill zones), so make sure we can revert.
 
     USE_INLINES = aExport3DFiles;
     USE_DEFS = true;
     USE_RELPATH = aUseRelativePaths;
 
-    cache = Prj().Get3DCacheManager();
-    PROJ_DIR = Prj().GetProjectPath();
+    cache = a3DCache;
     SUBDIR_3D = a3D_Subdir;
     MODEL_VRML model3d;
     model_vrml = &model3d;
@@ -1598,6 +1948,7 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
 
     // plain PCB or else PCB with copper and silkscreen
     model3d.m_plainPCB = aUsePlainPCB;
+    model3d.m_shareInstances = aShareInstances;
 
     try
     {
@@ -1616,7 +1967,7 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
 
         // Export zone fills
         if( !aUsePlainPCB )
-            export_vrml_zones( model3d, pcb, &commit );
+            export_vrml_zones( model3d, pcb, aCommit );
 
         if( USE_INLINES )
         {
@@ -1677,12 +2028,38 @@ bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMt
         }
     }
     catch( const std::exception& e )
+    {
+        aErrorMsg = FROM_UTF8( e.what() );
+        ok = false;
+    }
+
+    if( aStats )
+        *aStats = model3d.m_stats;
+
+    return ok;
+}
+
+
+bool PCB_EDIT_FRAME::ExportVRML_File( const wxString& aFullFileName, double aMMtoWRMLunit,
+                                      bool aExport3DFiles, bool aUseRelativePaths,
+                                      bool aUsePlainPCB, const wxString& a3D_Subdir,
+                                      double aXRef, double aYRef )
+{
+    BOARD_COMMIT    commit( this );     // We may need to modify the board (for instance to
+                                        // fill zones), so make sure we can revert.
+    wxString        errorMsg;
+
+    PROJ_DIR = Prj().GetProjectPath();
+
+    bool ok = ExportBoardToVRML( GetBoard(), Prj().Get3DCacheManager(), &commit, aFullFileName,
+                                 aMMtoWRMLunit, aExport3DFiles, aUseRelativePaths, aUsePlainPCB,
+                                 a3D_Subdir, aXRef, aYRef, true, errorMsg );
+
+    if( !ok )
     {
         wxString msg;
-        msg << _( "IDF Export Failed:\n" ) << FROM_UTF8( e.what() );
+        msg << _( "IDF Export Failed:\n" ) << errorMsg;
         wxMessageBox( msg );
-
-        ok = false;
     }
 
     commit.Revert();
@@ -1717,7 +2094,9 @@ static SGNODE* getSGColor( VRML_COLOR_INDEX colorIdx )
 }
 
 
-static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
+// create the scenegraph of a plane under PcbOutput, and return its node (or NULL if
+// the layer is empty)
+static SGNODE* create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX colorID,
     VRML_LAYER* layer, double top_z, bool aTopPlane )
 {
     std::vector< double > vertices;
@@ -1725,7 +2104,7 @@ static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
 
     if( !( *layer ).Get2DTriangles( vertices, idxPlane, top_z, aTopPlane ) )
     {
-        return;
+        return NULL;
     }
 
     if( ( idxPlane.size() % 3 ) )
@@ -1772,6 +2151,8 @@ static void create_vrml_plane( IFSG_TRANSFORM& PcbOutput, VRML_COLOR_INDEX color
         else
             shape.AddRefNode( modelColor );
     }
+
+    return tx0.GetRawPtr();
 }
 
 
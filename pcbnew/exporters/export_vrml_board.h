@@ -0,0 +1,76 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file export_vrml_board.h
+ * the VRML board exporter, without the edit frame (used by PCB_EDIT_FRAME::ExportVRML_File
+ * and by the qa tools)
+ */
+
+#ifndef EXPORT_VRML_BOARD_H
+#define EXPORT_VRML_BOARD_H
+
+#include <wx/string.h>
+
+class BOARD;
+class COMMIT;
+class S3D_CACHE;
+
+
+/**
+ * Counters of a VRML export
+ */
+struct VRML_EXPORT_STATS
+{
+    int m_PadstackInstances = 0;    ///< pads and vias written as a shared padstack instance
+    int m_Padstacks = 0;            ///< distinct shared padstacks
+    int m_ModelInstances = 0;       ///< 3D model instances
+    int m_Models = 0;               ///< distinct 3D models written in the output
+};
+
+
+/**
+ * Function ExportBoardToVRML
+ * creates the VRML file of a board. See PCB_EDIT_FRAME::ExportVRML_File for the
+ * description of the common parameters.
+ *
+ * @param aPcb is the board to export
+ * @param a3DCache is the 3D model cache, or NULL to export the board without the models
+ * @param aCommit is the commit used when zones must be filled; it can be NULL, and then
+ *                the zones are filled directly
+ * @param aShareInstances is true to write the identical pads and vias as instances of a
+ *                        shared padstack, and the identical models (when they are copied
+ *                        to a3D_Subdir) as instances of a single Inline node, with DEF/USE.
+ *                        When false the pads and vias are merged in the copper layers.
+ * @param aErrorMsg receives the error message when the export fails
+ * @param aStats if not NULL, receives the counters of the export
+ * @return true if OK
+ */
+bool ExportBoardToVRML( BOARD* aPcb, S3D_CACHE* a3DCache, COMMIT* aCommit,
+                        const wxString& aFullFileName, double aMMtoWRMLunit,
+                        bool aExport3DFiles, bool aUseRelativePaths, bool aUsePlainPCB,
+                        const wxString& a3D_Subdir, double aXRef, double aYRef,
+                        bool aShareInstances, wxString& aErrorMsg,
+                        VRML_EXPORT_STATS* aStats = nullptr );
+
+#endif  // EXPORT_VRML_BOARD_H
@@ -50,6 +50,7 @@
 #include <kiface_i.h>
 #include <kiplatform/app.h>
 #include <kiway.h>
+#include <lib_table_preloader.h>
 #include <panel_hotkeys_editor.h>
 #include <pcb_draw_panel_gal.h>
 #include <pcb_edit_frame.h>
@@ -119,6 +120,7 @@ FOOTPRINT_EDIT_FRAME::FOOTPRINT_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
     m_AboutTitle = "ModEdit";
     m_selLayerBox = nullptr;
     m_settings = nullptr;
+    m_libraryUpdatePending = false;
 
     // Give an icon
     wxIcon icon;
@@ -277,6 +279,12 @@ FOOTPRINT_EDIT_FRAME::FOOTPRINT_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
     // Default shutdown reason until a file is loaded
     KIPLATFORM::APP::SetShutdownBlockReason( this, _( "Footprint changes are unsaved" ) );
 
+    // Follow the libraries reloaded in the background
+    Bind( EDA_EVT_LIBRARY_UPDATED, &FOOTPRINT_EDIT_FRAME::onLibraryUpdated, this );
+
+    if( Pgm().GetLibraryPreloader() )
+        Pgm().GetLibraryPreloader()->AddListener( this );
+
     // Ensure the window is on top
     Raise();
     Show( true );
@@ -285,6 +293,9 @@ FOOTPRINT_EDIT_FRAME::FOOTPRINT_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent,
 
 FOOTPRINT_EDIT_FRAME::~FOOTPRINT_EDIT_FRAME()
 {
+    if( Pgm().GetLibraryPreloader() )
+        Pgm().GetLibraryPreloader()->RemoveListener( this );
+
     // Shutdown all running tools
     if( m_toolManager )
         m_toolManager->ShutdownAllTools();
@@ -823,6 +834,22 @@ void FOOTPRINT_EDIT_FRAME::SyncLibraryTree( bool aProgress )
 }
 
 
+void FOOTPRINT_EDIT_FRAME::onLibraryUpdated( wxCommandEvent& aEvent )
+{
+    // Several libraries are often modified together: sync the tree once for all of them
+    if( m_libraryUpdatePending )
+        return;
+
+    m_libraryUpdatePending = true;
+
+    CallAfter( [this]()
+               {
+                   m_libraryUpdatePending = false;
+                   SyncLibraryTree( false );
+               } );
+}
+
+
 void FOOTPRINT_EDIT_FRAME::RegenerateLibraryTree()
 {
     LIB_ID target = GetTargetFPID();
@@ -356,6 +356,14 @@ protected:
     void editFootprintProperties( MODULE* aFootprint );
 
     void setupUIConditions() override;
+
+    /**
+     * Resynchronize the library tree when libraries are modified on disk, after the
+     * libraries were reloaded in the background.
+     */
+    void onLibraryUpdated( wxCommandEvent& aEvent );
+
+    bool m_libraryUpdatePending;    ///< a library tree sync is queued by onLibraryUpdated()
 };
 
 #endif      // FOOTPRINT_EDIT_FRAME_H
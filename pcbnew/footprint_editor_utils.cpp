@@ -350,6 +350,7 @@ void FOOTPRINT_EDIT_FRAME::editFootprintProperties( MODULE* aModule )
                             // from file therefore not yet in tree.
     {
         static_cast<LIB_TREE_NODE_LIB_ID*>( treeItem.GetID() )->Update( &footprintInfo );
+        m_adapter->InvalidateSearchIndex();
         m_treePane->GetLibTree()->RefreshLibTree();
     }
 
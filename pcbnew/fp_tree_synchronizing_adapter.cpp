@@ -143,6 +143,7 @@ void FP_TREE_SYNCHRONIZING_ADAPTER::updateLibrary( LIB_TREE_NODE_LIB& aLibNode )
         aLibNode.AddItem( footprint );
 
     aLibNode.AssignIntrinsicRanks();
+    m_searchIndex.Clear();
     m_libMap.insert( aLibNode.m_Name );
 }
 
@@ -153,6 +154,7 @@ LIB_TREE_NODE::PTR_VECTOR::iterator FP_TREE_SYNCHRONIZING_ADAPTER::deleteLibrary
     LIB_TREE_NODE* node = aLibNodeIt->get();
     m_libMap.erase( node->m_Name );
     auto it = m_tree.m_Children.erase( aLibNodeIt );
+    m_searchIndex.Clear();
     return it;
 }
 
@@ -46,11 +46,80 @@
 #include <connectivity/connectivity_data.h>
 #include <reporter.h>
 
+#include <unordered_set>
+
 #include "board_netlist_updater.h"
 
 #include <pcb_edit_frame.h>
 
 
+void BOARD_NETLIST_INDEX::Build( BOARD* aBoard )
+{
+    m_modulesByReference.clear();
+    m_modulesByPath.clear();
+    m_firstModules.clear();
+    m_pads.clear();
+    m_nets.clear();
+
+    for( MODULE* footprint : aBoard->Modules() )
+    {
+        m_modulesByReference[ footprint->GetReference().Lower() ].push_back( footprint );
+        m_modulesByPath[ footprint->GetPath().AsString() ].push_back( footprint );
+
+        // Only the pads of the first footprint of a reference can be found
+        if( m_firstModules.emplace( footprint->GetReference(), footprint ).second )
+        {
+            for( D_PAD* pad : footprint->Pads() )
+                m_pads.emplace( std::make_pair( footprint->GetReference(), pad->GetName() ), pad );
+        }
+    }
+
+    for( NETINFO_ITEM* net : aBoard->GetNetInfo() )
+        m_nets[ net->GetNetname() ] = net;
+}
+
+
+const std::vector<MODULE*>& BOARD_NETLIST_INDEX::FindModulesByReference(
+        const wxString& aReference ) const
+{
+    auto it = m_modulesByReference.find( aReference.Lower() );
+
+    return it != m_modulesByReference.end() ? it->second : m_noModules;
+}
+
+
+const std::vector<MODULE*>& BOARD_NETLIST_INDEX::FindModulesByPath( const KIID_PATH& aPath ) const
+{
+    auto it = m_modulesByPath.find( aPath.AsString() );
+
+    return it != m_modulesByPath.end() ? it->second : m_noModules;
+}
+
+
+MODULE* BOARD_NETLIST_INDEX::FindModule( const wxString& aReference ) const
+{
+    auto it = m_firstModules.find( aReference );
+
+    return it != m_firstModules.end() ? it->second : nullptr;
+}
+
+
+D_PAD* BOARD_NETLIST_INDEX::FindPad( const wxString& aReference, const wxString& aPadName ) const
+{
+    auto it = m_pads.find( std::make_pair( aReference, aPadName ) );
+
+    return it != m_pads.end() ? it->second : nullptr;
+}
+
+
+NETINFO_ITEM* BOARD_NETLIST_INDEX::FindNet( const wxString& aNetName ) const
+{
+    auto it = m_nets.find( aNetName );
+
+    return it != m_nets.end() ? it->second : nullptr;
+}
+
+
 BOARD_NETLIST_UPDATER::BOARD_NETLIST_UPDATER( PCB_EDIT_FRAME* aFrame, BOARD* aBoard ) :
     m_frame( aFrame ),
     m_commit( aFrame ),
@@ -354,10 +423,21 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE* aPcbComponent
     MODULE* copy = m_commit.GetStatus( aPcbComponent ) ? nullptr : (MODULE*) aPcbComponent->Clone();
     bool changed = false;
 
+    // Index the nets of the component by pin name, as COMPONENT::GetNet() does a linear search
+    static const COMPONENT_NET noNet;
+    std::unordered_map<wxString, const COMPONENT_NET*, WXSTRING_HASH> pinNets;
+
+    for( unsigned ii = 0; ii < aNewComponent->GetNetCount(); ii++ )
+    {
+        const COMPONENT_NET& net = aNewComponent->GetNet( ii );
+        pinNets.emplace( net.GetPinName(), &net );
+    }
+
     // At this point, the component footprint is updated.  Now update the nets.
     for( D_PAD* pad : aPcbComponent->Pads() )
     {
-        const COMPONENT_NET& net = aNewComponent->GetNet( pad->GetName() );
+        auto                 pinNet = pinNets.find( pad->GetName() );
+        const COMPONENT_NET& net = pinNet != pinNets.end() ? *pinNet->second : noNet;
 
         wxString pinFunction;
 
@@ -411,7 +491,7 @@ bool BOARD_NETLIST_UPDATER::updateComponentPadConnections( MODULE* aPcbComponent
         else                                 // New footprint pad has a net.
         {
             const wxString& netName = net.GetNetName();
-            NETINFO_ITEM* netinfo = m_board->FindNet( netName );
+            NETINFO_ITEM* netinfo = m_index.FindNet( netName );
 
             if( netinfo && !m_isDryRun )
                 netinfo->SetIsCurrent( true );
@@ -533,7 +613,7 @@ bool BOARD_NETLIST_UPDATER::updateCopperZoneNets( NETLIST& aNetlist )
 
                 if( !m_isDryRun )
                 {
-                    NETINFO_ITEM* netinfo = m_board->FindNet( updatedNetname );
+                    NETINFO_ITEM* netinfo = m_index.FindNet( updatedNetname );
 
                     if( !netinfo )
                         netinfo = m_addedNets[updatedNetname];
@@ -593,7 +673,7 @@ bool BOARD_NETLIST_UPDATER::updateCopperZoneNets( NETLIST& aNetlist )
 
                 if( !m_isDryRun )
                 {
-                    NETINFO_ITEM* netinfo = m_board->FindNet( updatedNetname );
+                    NETINFO_ITEM* netinfo = m_index.FindNet( updatedNetname );
 
                     if( !netinfo )
                         netinfo = m_addedNets[ updatedNetname ];
@@ -624,15 +704,27 @@ bool BOARD_NETLIST_UPDATER::deleteUnusedComponents( NETLIST& aNetlist )
     wxString msg;
     const COMPONENT* component;
 
+    // Index the components, as NETLIST::GetComponentBy...() do linear searches
+    std::unordered_map<wxString, const COMPONENT*, WXSTRING_HASH> components;
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ii++ )
+    {
+        component = aNetlist.GetComponent( ii );
+
+        if( m_lookupByTimestamp )
+            components.emplace( component->GetPath().AsString(), component );
+        else
+            components.emplace( component->GetReference(), component );
+    }
+
     for( MODULE* module : m_board->Modules() )
     {
         if( ( module->GetAttributes() & MOD_BOARD_ONLY ) > 0 )
             continue;
 
-        if( m_lookupByTimestamp )
-            component = aNetlist.GetComponentByPath( module->GetPath() );
-        else
-            component = aNetlist.GetComponentByReference( module->GetReference() );
+        auto it = components.find( m_lookupByTimestamp ? module->GetPath().AsString()
+                                                       : module->GetReference() );
+        component = it != components.end() ? it->second : nullptr;
 
         if( component == NULL || component->GetProperties().count( "exclude_from_board" ) )
         {
@@ -668,6 +760,15 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
 
     std::vector<D_PAD*> padlist = m_board->GetPads();
 
+    // The nets of the copper zones, which connect the pads as well
+    std::unordered_set<wxString, WXSTRING_HASH> zoneNets;
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+    {
+        if( zone->IsOnCopperLayer() && !zone->GetIsRuleArea() )
+            zoneNets.insert( zone->GetNetname() );
+    }
+
     // Sort pads by netlist name
     std::sort( padlist.begin(), padlist.end(), [ this ]( D_PAD* a, D_PAD* b ) -> bool
                                                {
@@ -685,21 +786,8 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
             {
                 // First, see if we have a copper zone attached to this pad.
                 // If so, this is not really a single pad net
-
-                for( ZONE_CONTAINER* zone : m_board->Zones() )
-                {
-                    if( !zone->IsOnCopperLayer() )
-                        continue;
-
-                    if( zone->GetIsRuleArea() )
-                        continue;
-
-                    if( zone->GetNetname() == getNetname( previouspad ) )
-                    {
-                        count++;
-                        break;
-                    }
-                }
+                if( zoneNets.count( getNetname( previouspad ) ) )
+                    count++;
 
                 if( count == 1 )    // Really one pad, and nothing else
                 {
@@ -708,7 +796,10 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
                     m_reporter->Report( msg, RPT_SEVERITY_ACTION );
 
                     if( !m_isDryRun )
+                    {
+                        m_commit.Modify( previouspad );
                         previouspad->SetNetCode( NETINFO_LIST::UNCONNECTED );
+                    }
                     else
                         cacheNetname( previouspad, wxEmptyString );
                 }
@@ -729,7 +820,10 @@ bool BOARD_NETLIST_UPDATER::deleteSinglePadNets()
     if( count == 1 )
     {
         if( !m_isDryRun )
+        {
+            m_commit.Modify( previouspad );
             previouspad->SetNetCode( NETINFO_LIST::UNCONNECTED );
+        }
         else
             cacheNetname( previouspad, wxEmptyString );
     }
@@ -751,7 +845,7 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
     for( int i = 0; i < (int) aNetlist.GetCount(); i++ )
     {
         const COMPONENT* component = aNetlist.GetComponent( i );
-        MODULE* footprint = m_board->FindModuleByReference( component->GetReference() );
+        MODULE* footprint = m_index.FindModule( component->GetReference() );
 
         if( footprint == NULL )    // It can be missing in partial designs
             continue;
@@ -762,7 +856,7 @@ bool BOARD_NETLIST_UPDATER::testConnectivity( NETLIST& aNetlist )
             const COMPONENT_NET& net = component->GetNet( jj );
             padname = net.GetPinName();
 
-            if( footprint->FindPadByName( padname ) )
+            if( m_index.FindPad( component->GetReference(), padname ) )
                 continue;   // OK, pad found
 
             // not found: bad footprint, report error
@@ -785,10 +879,12 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
     m_errorCount = 0;
     m_warningCount = 0;
     m_newFootprintsCount = 0;
-    MODULE* lastPreexistingFootprint = m_board->Modules().empty() ? NULL : m_board->Modules().back();
 
     cacheCopperZoneConnections();
 
+    // The footprints added or replaced by the update are only added to the board by the commit
+    m_index.Build( m_board );
+
     if( !m_isDryRun )
     {
         m_board->SetStatus( 0 );
@@ -813,39 +909,24 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
                     component->GetFPID().Format().wx_str() );
         m_reporter->Report( msg, RPT_SEVERITY_INFO );
 
-        for( auto footprint : m_board->Modules() )
+        const std::vector<MODULE*>& footprints =
+                m_lookupByTimestamp ? m_index.FindModulesByPath( component->GetPath() )
+                                    : m_index.FindModulesByReference( component->GetReference() );
+
+        for( MODULE* footprint : footprints )
         {
-            bool     match = false;
+            tmp = footprint;
 
-            if( footprint )
-            {
-                if( m_lookupByTimestamp )
-                    match = footprint->GetPath() == component->GetPath();
-                else
-                    match = footprint->GetReference().CmpNoCase( component->GetReference() ) == 0;
-            }
+            if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
+                tmp = replaceComponent( aNetlist, footprint, component );
 
-            if( match )
+            if( tmp )
             {
-                tmp = footprint;
-
-                if( m_replaceFootprints && component->GetFPID() != footprint->GetFPID() )
-                    tmp = replaceComponent( aNetlist, footprint, component );
-
-                if( tmp )
-                {
-                    updateComponentParameters( tmp, component );
-                    updateComponentPadConnections( tmp, component );
-                }
-
-                matchCount++;
+                updateComponentParameters( tmp, component );
+                updateComponentPadConnections( tmp, component );
             }
 
-            if( footprint == lastPreexistingFootprint )
-            {
-                // No sense going through the newly-created footprints: end of loop
-                break;
-            }
+            matchCount++;
         }
 
         if( matchCount == 0 )
@@ -873,10 +954,10 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
 
     if( !m_isDryRun )
     {
-        m_board->GetConnectivity()->Build( m_board );
+        // The references of the footprints may have been updated
+        m_index.Build( m_board );
         testConnectivity( aNetlist );
 
-        // Now the connectivity data is rebuilt, we can delete single pads nets
         if( m_deleteSinglePadNets )
             deleteSinglePadNets();
 
@@ -891,6 +972,8 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
         }
 
         m_board->GetNetInfo().RemoveUnusedNets();
+
+        // The connectivity is updated once, incrementally, with the changed items
         m_commit.Push( _( "Update netlist" ) );
     }
     else if( m_deleteSinglePadNets && !m_newFootprintsCount )
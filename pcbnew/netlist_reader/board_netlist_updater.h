@@ -39,9 +39,65 @@ class REPORTER;
 class NETLIST;
 class COMPONENT;
 class MODULE;
+class D_PAD;
+class NETINFO_ITEM;
+class KIID_PATH;
 class PCB_EDIT_FRAME;
 
 #include <board_commit.h>
+#include <hashtables.h>
+
+#include <unordered_map>
+#include <vector>
+
+
+/**
+ * BOARD_NETLIST_INDEX
+ * indexes the footprints, pads and nets of a board by name.
+ *
+ * The index is built once per netlist update, so the components of the netlist are matched
+ * without searching the whole board for each of them.  The items added to the board after
+ * the index is built are not indexed.
+ */
+class BOARD_NETLIST_INDEX
+{
+public:
+    void Build( BOARD* aBoard );
+
+    ///> Returns the footprints of reference aReference (case insensitive), in the board order
+    const std::vector<MODULE*>& FindModulesByReference( const wxString& aReference ) const;
+
+    ///> Returns the footprints of the symbol aPath, in the board order
+    const std::vector<MODULE*>& FindModulesByPath( const KIID_PATH& aPath ) const;
+
+    ///> Returns the first footprint of reference aReference, like BOARD::FindModuleByReference()
+    MODULE* FindModule( const wxString& aReference ) const;
+
+    ///> Returns the pad aPadName of FindModule( aReference ), like MODULE::FindPadByName()
+    D_PAD* FindPad( const wxString& aReference, const wxString& aPadName ) const;
+
+    ///> Returns the net aNetName, like BOARD::FindNet()
+    NETINFO_ITEM* FindNet( const wxString& aNetName ) const;
+
+private:
+    struct PAD_KEY_HASH
+    {
+        std::size_t operator()( const std::pair<wxString, wxString>& aKey ) const
+        {
+            return WXSTRING_HASH()( aKey.first ) * 31 + WXSTRING_HASH()( aKey.second );
+        }
+    };
+
+    typedef std::unordered_map<wxString, std::vector<MODULE*>, WXSTRING_HASH> MODULES_MAP;
+
+    MODULES_MAP m_modulesByReference;       ///< by lower case reference
+    MODULES_MAP m_modulesByPath;            ///< by KIID_PATH::AsString()
+    std::unordered_map<wxString, MODULE*, WXSTRING_HASH> m_firstModules;
+    std::unordered_map<std::pair<wxString, wxString>, D_PAD*, PAD_KEY_HASH> m_pads;
+    std::unordered_map<wxString, NETINFO_ITEM*, WXSTRING_HASH> m_nets;
+    std::vector<MODULE*> m_noModules;
+};
+
 
 /**
  * BOARD_NETLIST_UPDATER
@@ -162,6 +218,7 @@ private:
     std::map< D_PAD*, wxString > m_padPinFunctions;
     std::vector<MODULE*> m_addedComponents;
     std::map<wxString, NETINFO_ITEM*> m_addedNets;
+    BOARD_NETLIST_INDEX m_index;        // the board items before the update
 
     bool m_deleteSinglePadNets;
     bool m_deleteUnusedComponents;
@@ -34,6 +34,7 @@
 #include <3d_viewer/eda_3d_viewer.h>          // To include VIEWER3D_FRAMENAME
 #include <footprint_editor_settings.h>
 #include <fp_lib_table.h>
+#include <lib_table_preloader.h>
 #include <pcbnew_id.h>
 #include <class_board.h>
 #include <class_module.h>
@@ -133,6 +134,9 @@ FP_LIB_TABLE* PROJECT::PcbFootprintLibs()
             DisplayErrorMessage( nullptr, _( "Error loading project footprint libraries" ),
                                  ioe.What() );
         }
+
+        if( Pgm().GetLibraryPreloader() )
+            Pgm().GetLibraryPreloader()->Preload( tbl );
     }
 
     return tbl;
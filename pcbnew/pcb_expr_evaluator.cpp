@@ -22,6 +22,7 @@
  */
 
 
+#include <algorithm>
 #include <cstdio>
 #include <memory>
 #include <class_board.h>
@@ -154,6 +155,8 @@ static void insideCourtyard( LIBEVAL::CONTEXT* aCtx, void* self )
     if( !item )
         return;
 
+    PCB_EXPR_AREA_CACHE* cache = item->GetBoard() ? item->GetBoard()->GetAreaCache() : nullptr;
+
     if( arg->AsString() == "A" )
     {
         footprint = dynamic_cast<MODULE*>( context->GetItem( 0 ) );
@@ -162,6 +165,10 @@ static void insideCourtyard( LIBEVAL::CONTEXT* aCtx, void* self )
     {
         footprint = dynamic_cast<MODULE*>( context->GetItem( 1 ) );
     }
+    else if( cache )
+    {
+        footprint = cache->FindFootprint( arg->AsString() );
+    }
     else
     {
         for( MODULE* candidate : item->GetBoard()->Modules() )
@@ -176,20 +183,39 @@ static void insideCourtyard( LIBEVAL::CONTEXT* aCtx, void* self )
 
     if( footprint )
     {
-        SHAPE_POLY_SET footprintCourtyard;
+        auto insideFootprintCourtyard =
+                [&]( bool& aCacheable ) -> bool
+                {
+                    SHAPE_POLY_SET footprintCourtyard;
 
-        if( footprint->IsFlipped() )
-            footprintCourtyard = footprint->GetPolyCourtyardBack();
-        else
-            footprintCourtyard = footprint->GetPolyCourtyardFront();
+                    if( footprint->IsFlipped() )
+                        footprintCourtyard = footprint->GetPolyCourtyardBack();
+                    else
+                        footprintCourtyard = footprint->GetPolyCourtyardFront();
 
-        SHAPE_POLY_SET testPoly;
+                    SHAPE_POLY_SET testPoly;
 
-        item->TransformShapeWithClearanceToPolygon( testPoly, context->GetLayer(), 0,
-                                                    ARC_LOW_DEF, ERROR_INSIDE );
-        testPoly.BooleanIntersection( footprintCourtyard, SHAPE_POLY_SET::PM_FAST );
+                    item->TransformShapeWithClearanceToPolygon( testPoly, context->GetLayer(), 0,
+                                                                ARC_LOW_DEF, ERROR_INSIDE );
+                    testPoly.BooleanIntersection( footprintCourtyard, SHAPE_POLY_SET::PM_FAST );
+
+                    return testPoly.OutlineCount() > 0;
+                };
+
+        bool inside;
+
+        if( cache )
+        {
+            inside = cache->Test( true, item, footprint, cache->GetCourtyardBox( footprint ),
+                                  context->GetLayer(), insideFootprintCourtyard );
+        }
+        else
+        {
+            bool cacheable = true;
+            inside = insideFootprintCourtyard( cacheable );
+        }
 
-        if( testPoly.OutlineCount() )
+        if( inside )
             result->Set( 1.0 );
     }
 }
@@ -217,15 +243,13 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
     if( !item )
         return;
 
-    auto insideZone =
-            [&]( ZONE_CONTAINER* zone ) -> bool
-            {
-                if( !zone )
-                    return false;
-
-                if( !zone->GetCachedBoundingBox().Intersects( item->GetBoundingBox() ) )
-                    return false;
+    PCB_EXPR_AREA_CACHE* cache = item->GetBoard() ? item->GetBoard()->GetAreaCache() : nullptr;
 
+    // The exact test, once the bounding boxes are known to intersect.  The results are not
+    // cached when an error is reported, so it is reported for each evaluation.
+    auto testZone =
+            [&]( ZONE_CONTAINER* zone, bool& aCacheable ) -> bool
+            {
                 if( item->GetFlags() & HOLE_PROXY )
                 {
                     if( item->Type() == PCB_PAD_T )
@@ -253,6 +277,7 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                     if( ( footprint->GetFlags() & MALFORMED_COURTYARD ) != 0 )
                     {
                         aCtx->ReportError( _( "Footprint's courtyard is not a single, closed shape." ) );
+                        aCacheable = false;
                         return false;
                     }
 
@@ -263,6 +288,7 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                         if( courtyard.OutlineCount() == 0 )
                         {
                             aCtx->ReportError( _( "Footprint has no front courtyard." ) );
+                            aCacheable = false;
                             return false;
                         }
                         else
@@ -278,6 +304,7 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                         if( courtyard.OutlineCount() == 0 )
                         {
                             aCtx->ReportError( _( "Footprint has no back courtyard." ) );
+                            aCacheable = false;
                             return false;
                         }
                         else
@@ -295,6 +322,29 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                 return zone->Outline()->Collide( shape.get() );
             };
 
+    auto insideZone =
+            [&]( ZONE_CONTAINER* zone ) -> bool
+            {
+                if( !zone )
+                    return false;
+
+                if( cache )
+                {
+                    return cache->Test( false, item, zone, zone->GetCachedBoundingBox(),
+                                        context->GetLayer(),
+                                        [&]( bool& aCacheable )
+                                        {
+                                            return testZone( zone, aCacheable );
+                                        } );
+                }
+
+                if( !zone->GetCachedBoundingBox().Intersects( item->GetBoundingBox() ) )
+                    return false;
+
+                bool cacheable = true;
+                return testZone( zone, cacheable );
+            };
+
     if( arg->AsString() == "A" )
     {
         if( insideZone( dynamic_cast<ZONE_CONTAINER*>( context->GetItem( 0 ) ) ) )
@@ -309,6 +359,14 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
     {
         KIID target( arg->AsString() );
 
+        if( cache )
+        {
+            if( insideZone( cache->FindZone( target ) ) )
+                result->Set( 1.0 );
+
+            return;
+        }
+
         for( ZONE_CONTAINER* candidate : item->GetBoard()->Zones() )
         {
             // Only a single zone can match the UUID; exit once we find a match whether
@@ -338,6 +396,22 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
             }
         }
     }
+    else if( cache )  // Match on zone name, among the zones near the item
+    {
+        std::vector<ZONE_CONTAINER*> candidates;
+
+        cache->QueryZones( item->GetBoundingBox(), candidates );
+
+        for( ZONE_CONTAINER* candidate : candidates )
+        {
+            // Many zones can match the name; exit only when we find an "inside"
+            if( candidate->GetZoneName().Matches( arg->AsString() ) && insideZone( candidate ) )
+            {
+                result->Set( 1.0 );
+                return;
+            }
+        }
+    }
     else  // Match on zone name
     {
         for( ZONE_CONTAINER* candidate : item->GetBoard()->Zones() )
@@ -527,6 +601,203 @@ public:
 };
 
 
+/**
+ * @return the bounding box of the courtyard of a footprint, on its side of the board
+ */
+static EDA_RECT courtyardBox( MODULE* aFootprint )
+{
+    const SHAPE_POLY_SET& courtyard = aFootprint->IsFlipped() ? aFootprint->GetPolyCourtyardBack()
+                                                              : aFootprint->GetPolyCourtyardFront();
+    BOX2I                 bbox = courtyard.BBox();
+
+    return EDA_RECT( wxPoint( bbox.GetX(), bbox.GetY() ),
+                     wxSize( bbox.GetWidth(), bbox.GetHeight() ) );
+}
+
+
+PCB_EXPR_AREA_CACHE::PCB_EXPR_AREA_CACHE( BOARD* aBoard ) :
+        m_tests( 0 ),
+        m_bboxRejects( 0 ),
+        m_hits( 0 ),
+        m_exactTests( 0 )
+{
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+        m_zones.push_back( { zone, (int) m_zones.size() } );
+
+    for( MODULE* module : aBoard->Modules() )
+    {
+        for( ZONE_CONTAINER* zone : module->Zones() )
+            m_zones.push_back( { zone, (int) m_zones.size() } );
+
+        m_footprints.push_back( module );
+        m_courtyardBoxes[ module ] = courtyardBox( module );
+    }
+
+    // m_zones is complete: its items can be referenced by the tree
+    for( INDEXED_ZONE& indexed : m_zones )
+    {
+        EDA_RECT box = indexed.m_zone->GetCachedBoundingBox();
+        box.Normalize();
+
+        const int mmin[2] = { box.GetX(), box.GetY() };
+        const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+        m_zoneTree.Insert( mmin, mmax, &indexed );
+
+        // the first zone is the one found by a search in the board order
+        m_zonesByUuid.emplace( indexed.m_zone->m_Uuid, indexed.m_zone );
+    }
+}
+
+
+void PCB_EXPR_AREA_CACHE::QueryZones( const EDA_RECT& aBox, std::vector<ZONE_CONTAINER*>& aZones )
+{
+    EDA_RECT box = aBox;
+    box.Normalize();
+
+    const int mmin[2] = { box.GetX(), box.GetY() };
+    const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+    std::vector<INDEXED_ZONE*> found;
+
+    auto visit =
+            [&]( INDEXED_ZONE* aZone ) -> bool
+            {
+                found.push_back( aZone );
+                return true;
+            };
+
+    m_zoneTree.Search( mmin, mmax, visit );
+
+    std::sort( found.begin(), found.end(),
+               []( const INDEXED_ZONE* a, const INDEXED_ZONE* b )
+               {
+                   return a->m_order < b->m_order;
+               } );
+
+    // the zones outside the box are tests rejected by their bounding box; the others are
+    // counted by Test()
+    long rejects = (long) ( m_zones.size() - found.size() );
+
+    m_tests += rejects;
+    m_bboxRejects += rejects;
+
+    for( INDEXED_ZONE* indexed : found )
+        aZones.push_back( indexed->m_zone );
+}
+
+
+ZONE_CONTAINER* PCB_EXPR_AREA_CACHE::FindZone( const KIID& aUuid ) const
+{
+    auto it = m_zonesByUuid.find( aUuid );
+
+    return it != m_zonesByUuid.end() ? it->second : nullptr;
+}
+
+
+MODULE* PCB_EXPR_AREA_CACHE::FindFootprint( const wxString& aPattern )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    auto it = m_footprintsByPattern.find( aPattern );
+
+    if( it != m_footprintsByPattern.end() )
+        return it->second;
+
+    MODULE* footprint = nullptr;
+
+    for( MODULE* candidate : m_footprints )
+    {
+        if( candidate->GetReference().Matches( aPattern ) )
+        {
+            footprint = candidate;
+            break;
+        }
+    }
+
+    m_footprintsByPattern[ aPattern ] = footprint;
+    return footprint;
+}
+
+
+EDA_RECT PCB_EXPR_AREA_CACHE::GetCourtyardBox( MODULE* aFootprint ) const
+{
+    auto it = m_courtyardBoxes.find( aFootprint );
+
+    return it != m_courtyardBoxes.end() ? it->second : courtyardBox( aFootprint );
+}
+
+
+bool PCB_EXPR_AREA_CACHE::Test( bool aCourtyard, BOARD_ITEM* aItem, BOARD_ITEM* aArea,
+                                const EDA_RECT& aAreaBox, PCB_LAYER_ID aLayer,
+                                const std::function<bool( bool& aCacheable )>& aTest )
+{
+    m_tests++;
+
+    if( !aAreaBox.Intersects( aItem->GetBoundingBox() ) )
+    {
+        m_bboxRejects++;
+        return false;
+    }
+
+    TEST_KEY                  key( aItem, aArea, aLayer, ( aItem->GetFlags() & HOLE_PROXY ) != 0 );
+    std::map<TEST_KEY, bool>& results = aCourtyard ? m_courtyardResults : m_areaResults;
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        auto it = results.find( key );
+
+        if( it != results.end() )
+        {
+            m_hits++;
+            return it->second;
+        }
+    }
+
+    m_exactTests++;
+
+    bool cacheable = true;
+    bool result = aTest( cacheable );
+
+    if( cacheable )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        results[ key ] = result;
+    }
+
+    return result;
+}
+
+
+wxString PCB_EXPR_AREA_CACHE::FormatStats() const
+{
+    return wxString::Format( "insideArea()/insideCourtyard() cache: %ld tests, %ld bounding box "
+                             "rejections, %ld cache hits, %ld exact tests",
+                             m_tests.load(), m_bboxRejects.load(), m_hits.load(),
+                             m_exactTests.load() );
+}
+
+
+void PCB_EXPR_VAR_REF::AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop )
+{
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+    PROPERTY_ACCESSOR accessor;
+
+    accessor.m_property = prop;
+
+    // Without a cast to the property owner the values are read with the INSPECTABLE methods,
+    // which return the default value
+    if( propMgr.ResolveTypeCast( type_hash, prop->OwnerHash(), &accessor.m_cast ) )
+    {
+        accessor.m_intGetter = dynamic_cast<PROPERTY_VALUE_GETTER<int>*>( prop );
+        accessor.m_stringGetter = dynamic_cast<PROPERTY_VALUE_GETTER<wxString>*>( prop );
+    }
+
+    m_matchingTypes[type_hash] = accessor;
+}
+
+
 LIBEVAL::VALUE PCB_EXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
 {
     if( m_itemIndex == 2 )
@@ -548,19 +819,35 @@ LIBEVAL::VALUE PCB_EXPR_VAR_REF::GetValue( LIBEVAL::CONTEXT* aCtx )
     }
     else
     {
+        const PROPERTY_ACCESSOR& accessor = it->second;
+
+        // the object as seen by the property getters (converted like in INSPECTABLE::Get())
+        void* object = static_cast<INSPECTABLE*>( item );
+
+        if( accessor.m_cast )
+            object = ( *accessor.m_cast )( object );
+
         if( m_type == LIBEVAL::VT_NUMERIC )
-            return LIBEVAL::VALUE( (double) item->Get<int>( it->second ) );
+        {
+            if( accessor.m_intGetter )
+                return LIBEVAL::VALUE( (double) accessor.m_intGetter->GetValue( object ) );
+
+            return LIBEVAL::VALUE( (double) item->Get<int>( accessor.m_property ) );
+        }
         else
         {
             wxString str;
 
             if( !m_isEnum )
             {
-                str = item->Get<wxString>( it->second );
+                if( accessor.m_stringGetter )
+                    str = accessor.m_stringGetter->GetValue( object );
+                else
+                    str = item->Get<wxString>( accessor.m_property );
             }
             else
             {
-                const wxAny& any = item->Get( it->second );
+                const wxAny& any = item->Get( accessor.m_property );
                 any.GetAs<wxString>( &str );
             }
 
@@ -25,15 +25,27 @@
 #ifndef __PCB_EXPR_EVALUATOR_H
 #define __PCB_EXPR_EVALUATOR_H
 
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <unordered_map>
 
+#include <eda_rect.h>
+#include <kiid.h>
+#include <layers_id_colors_and_visibility.h>
 #include <property.h>
 #include <property_mgr.h>
+#include <geometry/rtree.h>
 
 #include <libeval_compiler/libeval_compiler.h>
 
 
+class BOARD;
 class BOARD_ITEM;
+class MODULE;
+class ZONE_CONTAINER;
 
 class PCB_EXPR_VAR_REF;
 
@@ -99,23 +111,114 @@ public:
     void SetType( LIBEVAL::VAR_TYPE_T type ) { m_type = type; }
     LIBEVAL::VAR_TYPE_T GetType() const override { return m_type; }
 
-    void AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop )
-    {
-        m_matchingTypes[type_hash] = prop;
-    }
+    void AddAllowedClass( TYPE_ID type_hash, PROPERTY_BASE* prop );
 
     virtual LIBEVAL::VALUE GetValue( LIBEVAL::CONTEXT* aCtx ) override;
 
     BOARD_ITEM* GetObject( const LIBEVAL::CONTEXT* aCtx ) const;
 
 private:
-    std::unordered_map<TYPE_ID, PROPERTY_BASE*> m_matchingTypes;
+    /**
+     * The access to the property of a class, resolved when the expression is compiled so the
+     * evaluation does not look up the type casts and does not convert the values to wxAny.
+     */
+    struct PROPERTY_ACCESSOR
+    {
+        PROPERTY_BASE*                          m_property = nullptr;
+        const TYPE_CAST_BASE*                   m_cast = nullptr;
+        const PROPERTY_VALUE_GETTER<int>*       m_intGetter = nullptr;
+        const PROPERTY_VALUE_GETTER<wxString>*  m_stringGetter = nullptr;
+    };
+
+    std::unordered_map<TYPE_ID, PROPERTY_ACCESSOR> m_matchingTypes;
     int                                         m_itemIndex;
     LIBEVAL::VAR_TYPE_T                         m_type;
     bool                                        m_isEnum;
 };
 
 
+/**
+ * The cache of the insideArea() and insideCourtyard() rule functions during a DRC run (see
+ * BOARD::SetAreaCache()).
+ *
+ * It holds an R-tree of the zones, the courtyard boxes of the footprints, and the results of
+ * the exact tests of the items against the zones and the courtyards.  The bounding boxes are
+ * compared first; the exact test is only run when they intersect, once for each item, area
+ * and layer.
+ */
+class PCB_EXPR_AREA_CACHE
+{
+public:
+    PCB_EXPR_AREA_CACHE( BOARD* aBoard );
+
+    /**
+     * Get the zones (of the board and of the footprints) whose bounding box intersects a box,
+     * in the order of the board zones followed by the footprint zones.
+     */
+    void QueryZones( const EDA_RECT& aBox, std::vector<ZONE_CONTAINER*>& aZones );
+
+    /**
+     * @return the zone with a UUID, or nullptr
+     */
+    ZONE_CONTAINER* FindZone( const KIID& aUuid ) const;
+
+    /**
+     * @return the first footprint whose reference matches a pattern, or nullptr
+     */
+    MODULE* FindFootprint( const wxString& aPattern );
+
+    /**
+     * @return the bounding box of the courtyard of a footprint, on its side of the board
+     */
+    EDA_RECT GetCourtyardBox( MODULE* aFootprint ) const;
+
+    /**
+     * Test an item against an area (a zone or a footprint courtyard).
+     *
+     * The test is rejected if the bounding boxes do not intersect; the result of the exact test
+     * is cached otherwise.
+     *
+     * @param aCourtyard is true for the tests of insideCourtyard()
+     * @param aAreaBox is the bounding box of the area
+     * @param aTest is the exact test; it can clear its parameter when its result must not be
+     *              cached (when it reported an error)
+     */
+    bool Test( bool aCourtyard, BOARD_ITEM* aItem, BOARD_ITEM* aArea, const EDA_RECT& aAreaBox,
+               PCB_LAYER_ID aLayer, const std::function<bool( bool& aCacheable )>& aTest );
+
+    /**
+     * @return the statistics of the cache, for the DRC log
+     */
+    wxString FormatStats() const;
+
+private:
+    struct INDEXED_ZONE
+    {
+        ZONE_CONTAINER* m_zone;
+        int             m_order;    ///< index in the board and footprint zone order
+    };
+
+    ///> item, area, layer, and HOLE_PROXY flag of the item
+    typedef std::tuple<BOARD_ITEM*, BOARD_ITEM*, int, bool> TEST_KEY;
+
+    std::vector<INDEXED_ZONE>                m_zones;
+    RTree<INDEXED_ZONE*, int, 2, double>     m_zoneTree;
+    std::map<KIID, ZONE_CONTAINER*>          m_zonesByUuid;
+    std::map<MODULE*, EDA_RECT>              m_courtyardBoxes;
+    std::vector<MODULE*>                     m_footprints;
+
+    std::mutex                               m_mutex;       ///< for the maps below
+    std::map<wxString, MODULE*>              m_footprintsByPattern;
+    std::map<TEST_KEY, bool>                 m_areaResults;
+    std::map<TEST_KEY, bool>                 m_courtyardResults;
+
+    std::atomic<long>                        m_tests;
+    std::atomic<long>                        m_bboxRejects;
+    std::atomic<long>                        m_hits;
+    std::atomic<long>                        m_exactTests;
+};
+
+
 class PCB_EXPR_BUILTIN_FUNCTIONS
 {
 public:
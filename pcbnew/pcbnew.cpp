@@ -48,6 +48,7 @@
 #include <class_board.h>
 #include <class_draw_panel_gal.h>
 #include <fp_lib_table.h>
+#include <lib_table_preloader.h>
 #include <footprint_edit_frame.h>
 #include <footprint_viewer_frame.h>
 #include <footprint_wizard_frame.h>
@@ -371,6 +372,10 @@ bool IFACE::OnKifaceStart( PGM_BASE* aProgram, int aCtlBits )
         }
     }
 
+    // Load the libraries of the global table in the background
+    if( aProgram->GetLibraryPreloader() )
+        aProgram->GetLibraryPreloader()->Preload( &GFootprintTable );
+
 #if defined( KICAD_SCRIPTING )
     scriptingSetup();
 #endif
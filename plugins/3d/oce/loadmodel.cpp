@@ -22,8 +22,11 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <cstring>
@@ -44,10 +47,12 @@
 
 #include <AIS_Shape.hxx>
 
+#include <IGESControl_Controller.hxx>
 #include <IGESControl_Reader.hxx>
 #include <IGESCAFControl_Reader.hxx>
 #include <Interface_Static.hxx>
 
+#include <STEPControl_Controller.hxx>
 #include <STEPControl_Reader.hxx>
 #include <STEPCAFControl_Reader.hxx>
 
@@ -86,6 +91,14 @@
 // 30 deg (12 faces per circle) = 0.52359878
 #define USER_ANGLE (0.52359878)
 
+// The models are loaded by several threads.  The documents are created by the XCAF application,
+// which is shared: they are created and closed under s_appLock.  The translation parameters
+// are shared too: they are the ones of the STEP files, set once, and the IGES files, which
+// need a different precision mode, are read alone under s_paramLock.
+static std::mutex              s_appLock;
+static std::shared_timed_mutex s_paramLock;
+static std::once_flag          s_paramInit;
+
 typedef std::map< Standard_Real, SGNODE* > COLORMAP;
 typedef std::map< std::string, SGNODE* >   FACEMAP;
 typedef std::map< std::string, std::vector< SGNODE* > > NODEMAP;
@@ -393,8 +406,26 @@ void addItems( SGNODE* parent, std::vector< SGNODE* >* lp )
 }
 
 
+/**
+ * Register the translation parameters and set the ones of the STEP files
+ */
+static void initParameters()
+{
+    IGESControl_Controller::Init();
+    STEPControl_Controller::Init();
+
+    // Enable user-defined shape precision
+    Interface_Static::SetIVal( "read.precision.mode", 1 );
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    Interface_Static::SetRVal( "read.precision.val", USER_PREC );
+}
+
+
 bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    std::unique_lock<std::shared_timed_mutex> lock( s_paramLock );
+
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
     reader.PrintCheckLoad( Standard_False, IFSelect_ItemsByEntity );
@@ -411,7 +442,12 @@ bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
     reader.SetNameMode(false);  // don't use IGES label names
     reader.SetLayerMode(false); // ignore LAYER data
 
-    if ( !reader.Transfer( m_doc ) )
+    bool transferred = reader.Transfer( m_doc );
+
+    // Restore the precision mode of the STEP files
+    Interface_Static::SetIVal( "read.precision.mode", 1 );
+
+    if ( !transferred )
         return false;
 
     // are there any shapes to translate?
@@ -424,20 +460,16 @@ bool readIGES( Handle(TDocStd_Document)& m_doc, const char* fname )
 
 bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 {
+    // The translation parameters of the STEP files are set once by initParameters(): the
+    // STEP files are read in parallel
+    std::shared_lock<std::shared_timed_mutex> lock( s_paramLock );
+
     STEPCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
@@ -445,6 +477,7 @@ bool readSTEP( Handle(TDocStd_Document)& m_doc, const char* fname )
 
     if ( !reader.Transfer( m_doc ) )
     {
+        std::lock_guard<std::mutex> appLock( s_appLock );
         m_doc->Close();
         return false;
     }
@@ -462,10 +495,10 @@ bool readSTEPZ( Handle(TDocStd_Document)& m_doc, const char* aFileName )
     wxFileName fname( wxString::FromUTF8Unchecked( aFileName ) );
     wxFileInputStream ifile( fname.GetFullPath() );
 
-    wxFileName outFile( fname );
-
-    outFile.SetPath( wxStandardPaths::Get().GetTempDir() );
-    outFile.SetExt( "STEP" );
+    // The temporary file is unique: the same model can be expanded by several threads
+    wxFileName outFile( wxFileName::CreateTempFileName( wxStandardPaths::Get().GetTempDir()
+                                                        + wxFileName::GetPathSeparator()
+                                                        + fname.GetName() ) );
 
     wxFileOffset size = ifile.GetLength();
 
@@ -512,8 +545,14 @@ SCENEGRAPH* LoadModel( char const* filename )
 {
     DATA data;
 
-    Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
-    m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    std::call_once( s_paramInit, initParameters );
+
+    {
+        std::lock_guard<std::mutex> lock( s_appLock );
+        Handle(XCAFApp_Application) m_app = XCAFApp_Application::GetApplication();
+        m_app->NewDocument( "MDTV-XCAF", data.m_doc );
+    }
+
     FormatType modelFmt = fileType( filename );
 
     switch( modelFmt )
@@ -626,7 +665,7 @@ bool processSolid( const TopoDS_Shape& shape, DATA& data, SGNODE* parent,
     // Search the whole model first to make sure something exists (may or may not have color)
     if( !data.m_assy->Search( shape, label ) )
     {
-        static int i = 0;
+        static std::atomic<int> i( 0 );
         std::ostringstream ostr;
         ostr << "KMISC_" << i++;
         partID = ostr.str();
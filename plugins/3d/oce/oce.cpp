@@ -125,6 +125,13 @@ bool CanRender( void )
 }
 
 
+bool IsReentrant( void )
+{
+    // the shared OCC state is locked by LoadModel()
+    return true;
+}
+
+
 SCENEGRAPH* Load( char const* aFileName )
 {
     if( NULL == aFileName )
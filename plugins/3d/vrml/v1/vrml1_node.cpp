@@ -29,6 +29,7 @@
 #include <cctype>
 #include <iostream>
 #include <algorithm>
+#include <mutex>
 #include <sstream>
 #include <wx/log.h>
 
@@ -84,7 +85,9 @@ WRL1NODE* NAMEREGISTER::FindName( const std::string& aName )
 
 typedef std::pair< std::string, WRL1NODES > NODEITEM;
 typedef std::map< std::string, WRL1NODES > NODEMAP;
+// the nodes are built by the threads loading the models: the table is filled once
 static NODEMAP nodenames;
+static std::once_flag nodenamesInit;
 
 #if defined( DEBUG_VRML1 ) && ( DEBUG_VRML1 > 2 )
 std::string WRL1NODE::tabs = "";
@@ -97,44 +100,45 @@ WRL1NODE::WRL1NODE( NAMEREGISTER* aDictionary )
     m_Type = WRL1_END;
     m_dictionary = aDictionary;
 
-    if( nodenames.empty() )
-    {
-        nodenames.insert( NODEITEM( "AsciiText", WRL1_ASCIITEXT ) );
-        nodenames.insert( NODEITEM( "Cone", WRL1_CONE ) );
-        nodenames.insert( NODEITEM( "Coordinate3", WRL1_COORDINATE3 ) );
-        nodenames.insert( NODEITEM( "Cube", WRL1_CUBE ) );
-        nodenames.insert( NODEITEM( "Cylinder", WRL1_CYLINDER ) );
-        nodenames.insert( NODEITEM( "DirectionalLight", WRL1_DIRECTIONALLIGHT ) );
-        nodenames.insert( NODEITEM( "FontStyle", WRL1_FONTSTYLE ) );
-        nodenames.insert( NODEITEM( "Group", WRL1_GROUP ) );
-        nodenames.insert( NODEITEM( "IndexedFaceSet", WRL1_INDEXEDFACESET ) );
-        nodenames.insert( NODEITEM( "IndexedLineSet", WRL1_INDEXEDLINESET ) );
-        nodenames.insert( NODEITEM( "Info", WRL1_INFO ) );
-        nodenames.insert( NODEITEM( "LOD", WRL1_LOD ) );
-        nodenames.insert( NODEITEM( "Material", WRL1_MATERIAL ) );
-        nodenames.insert( NODEITEM( "MaterialBinding", WRL1_MATERIALBINDING ) );
-        nodenames.insert( NODEITEM( "MatrixTransform", WRL1_MATRIXTRANSFORM ) );
-        nodenames.insert( NODEITEM( "Normal", WRL1_NORMAL ) );
-        nodenames.insert( NODEITEM( "NormalBinding", WRL1_NORMALBINDING ) );
-        nodenames.insert( NODEITEM( "OrthographicCamera", WRL1_ORTHOCAMERA ) );
-        nodenames.insert( NODEITEM( "PerspectiveCamera", WRL1_PERSPECTIVECAMERA ) );
-        nodenames.insert( NODEITEM( "PointLight", WRL1_POINTLIGHT ) );
-        nodenames.insert( NODEITEM( "PointSet", WRL1_POINTSET ) );
-        nodenames.insert( NODEITEM( "Rotation", WRL1_ROTATION ) );
-        nodenames.insert( NODEITEM( "Scale", WRL1_SCALE ) );
-        nodenames.insert( NODEITEM( "Separator", WRL1_SEPARATOR ) );
-        nodenames.insert( NODEITEM( "ShapeHints", WRL1_SHAPEHINTS ) );
-        nodenames.insert( NODEITEM( "Sphere", WRL1_SPHERE ) );
-        nodenames.insert( NODEITEM( "SpotLight", WRL1_SPOTLIGHT ) );
-        nodenames.insert( NODEITEM( "Switch", WRL1_SWITCH ) );
-        nodenames.insert( NODEITEM( "Texture2", WRL1_TEXTURE2 ) );
-        nodenames.insert( NODEITEM( "Testure2Transform", WRL1_TEXTURE2TRANSFORM ) );
-        nodenames.insert( NODEITEM( "TextureCoordinate2", WRL1_TEXTURECOORDINATE2 ) );
-        nodenames.insert( NODEITEM( "Transform", WRL1_TRANSFORM ) );
-        nodenames.insert( NODEITEM( "Translation", WRL1_TRANSLATION ) );
-        nodenames.insert( NODEITEM( "WWWAnchor", WRL1_WWWANCHOR ) );
-        nodenames.insert( NODEITEM( "WWWInline", WRL1_WWWINLINE ) );
-    }
+    std::call_once( nodenamesInit,
+            []()
+            {
+                nodenames.insert( NODEITEM( "AsciiText", WRL1_ASCIITEXT ) );
+                nodenames.insert( NODEITEM( "Cone", WRL1_CONE ) );
+                nodenames.insert( NODEITEM( "Coordinate3", WRL1_COORDINATE3 ) );
+                nodenames.insert( NODEITEM( "Cube", WRL1_CUBE ) );
+                nodenames.insert( NODEITEM( "Cylinder", WRL1_CYLINDER ) );
+                nodenames.insert( NODEITEM( "DirectionalLight", WRL1_DIRECTIONALLIGHT ) );
+                nodenames.insert( NODEITEM( "FontStyle", WRL1_FONTSTYLE ) );
+                nodenames.insert( NODEITEM( "Group", WRL1_GROUP ) );
+                nodenames.insert( NODEITEM( "IndexedFaceSet", WRL1_INDEXEDFACESET ) );
+                nodenames.insert( NODEITEM( "IndexedLineSet", WRL1_INDEXEDLINESET ) );
+                nodenames.insert( NODEITEM( "Info", WRL1_INFO ) );
+                nodenames.insert( NODEITEM( "LOD", WRL1_LOD ) );
+                nodenames.insert( NODEITEM( "Material", WRL1_MATERIAL ) );
+                nodenames.insert( NODEITEM( "MaterialBinding", WRL1_MATERIALBINDING ) );
+                nodenames.insert( NODEITEM( "MatrixTransform", WRL1_MATRIXTRANSFORM ) );
+                nodenames.insert( NODEITEM( "Normal", WRL1_NORMAL ) );
+                nodenames.insert( NODEITEM( "NormalBinding", WRL1_NORMALBINDING ) );
+                nodenames.insert( NODEITEM( "OrthographicCamera", WRL1_ORTHOCAMERA ) );
+                nodenames.insert( NODEITEM( "PerspectiveCamera", WRL1_PERSPECTIVECAMERA ) );
+                nodenames.insert( NODEITEM( "PointLight", WRL1_POINTLIGHT ) );
+                nodenames.insert( NODEITEM( "PointSet", WRL1_POINTSET ) );
+                nodenames.insert( NODEITEM( "Rotation", WRL1_ROTATION ) );
+                nodenames.insert( NODEITEM( "Scale", WRL1_SCALE ) );
+                nodenames.insert( NODEITEM( "Separator", WRL1_SEPARATOR ) );
+                nodenames.insert( NODEITEM( "ShapeHints", WRL1_SHAPEHINTS ) );
+                nodenames.insert( NODEITEM( "Sphere", WRL1_SPHERE ) );
+                nodenames.insert( NODEITEM( "SpotLight", WRL1_SPOTLIGHT ) );
+                nodenames.insert( NODEITEM( "Switch", WRL1_SWITCH ) );
+                nodenames.insert( NODEITEM( "Texture2", WRL1_TEXTURE2 ) );
+                nodenames.insert( NODEITEM( "Testure2Transform", WRL1_TEXTURE2TRANSFORM ) );
+                nodenames.insert( NODEITEM( "TextureCoordinate2", WRL1_TEXTURECOORDINATE2 ) );
+                nodenames.insert( NODEITEM( "Transform", WRL1_TRANSFORM ) );
+                nodenames.insert( NODEITEM( "Translation", WRL1_TRANSLATION ) );
+                nodenames.insert( NODEITEM( "WWWAnchor", WRL1_WWWANCHOR ) );
+                nodenames.insert( NODEITEM( "WWWInline", WRL1_WWWINLINE ) );
+            } );
 
     return;
 }
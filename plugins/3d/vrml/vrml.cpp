@@ -34,20 +34,23 @@
 
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
-#include "richio.h"
 #include "vrml1_base.h"
 #include "vrml2_base.h"
 #include "wrlproc.h"
 #include "x3d.h"
 #include <clocale>
+#include <memory>
 #include <wx/filename.h>
-#include <wx/stdpaths.h>
 #include <wx/string.h>
 #include <wx/wfstream.h>
 #include <wx/log.h>
 
 #include <decompress.hpp>
 
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
 
 #define PLUGIN_VRML_MAJOR 1
 #define PLUGIN_VRML_MINOR 3
@@ -139,94 +142,96 @@ bool CanRender( void )
 }
 
 
+bool IsReentrant( void )
+{
+    // the models are loaded in parallel by the 3D cache
+    return true;
+}
+
+
+// Switch the numeric locale of the calling thread only: the models are loaded by several
+// threads, and the locale of the process is the one of the user interface
 class LOCALESWITCH
 {
+#if defined( _WIN32 )
+    int         m_threadConfig;
     // Store the user locale name, to restore this locale later, in dtor
     std::string m_locale;
+#else
+    locale_t    m_cLocale;
+    locale_t    m_locale;
+#endif
 
 public:
     LOCALESWITCH()
     {
+#if defined( _WIN32 )
+        m_threadConfig = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
         m_locale = setlocale( LC_NUMERIC, 0 );
         setlocale( LC_NUMERIC, "C" );
+#else
+        m_cLocale = newlocale( LC_NUMERIC_MASK, "C", duplocale( LC_GLOBAL_LOCALE ) );
+        m_locale = uselocale( m_cLocale );
+#endif
     }
 
     ~LOCALESWITCH()
     {
+#if defined( _WIN32 )
         setlocale( LC_NUMERIC, m_locale.c_str() );
+        _configthreadlocale( m_threadConfig );
+#else
+        uselocale( m_locale );
+        freelocale( m_cLocale );
+#endif
     }
 };
 
 
 SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
 {
-    FILE_LINE_READER* modelFile = NULL;
     SCENEGRAPH* scene = NULL;
-    wxString filename = aFileName;
-    wxFileName tmpfilename;
+    std::unique_ptr<WRLPROC> procPtr;
 
     if( aFileName.Upper().EndsWith( "WRZ" ) )
     {
         wxFileInputStream ifile( aFileName );
-        tmpfilename = wxFileName( aFileName );
-
-        tmpfilename.SetPath( wxStandardPaths::Get().GetTempDir() );
-        tmpfilename.SetExt( "WRL" );
 
         wxFileOffset size = ifile.GetLength();
 
         if( size == wxInvalidOffset )
             return nullptr;
 
-        {
-            wxFileOutputStream ofile( tmpfilename.GetFullPath() );
-
-            if( !ofile.IsOk() )
-                return nullptr;
-
-            char *buffer = new char[size];
+        char *buffer = new char[size];
 
-            ifile.Read( buffer, size);
-            std::string expanded;
-
-            try
-            {
-                expanded = gzip::decompress( buffer, size );
-            }
-            catch(...)
-            {
-                delete[] buffer;
-                return nullptr;
-            }
+        ifile.Read( buffer, size);
+        std::string expanded;
 
+        try
+        {
+            expanded = gzip::decompress( buffer, size );
+        }
+        catch(...)
+        {
             delete[] buffer;
-
-            ofile.Write( expanded.data(), expanded.size() );
-            ofile.Close();
+            return nullptr;
         }
 
-        filename = tmpfilename.GetFullPath();
-    }
+        delete[] buffer;
 
-    try
-    {
-        // set the max char limit to 8MB; if a VRML file contains
-        // longer lines then perhaps it shouldn't be used
-        modelFile = new FILE_LINE_READER( filename, 0, 8388608 );
+        // the decompressed text is parsed directly; the inline files are relative
+        // to the compressed file
+        procPtr.reset( new WRLPROC( std::move( expanded ), aFileName ) );
     }
-    catch( IO_ERROR & )
+    else
     {
-        wxLogError( wxS( " * " ) + _( "[INFO] load failed: input line too long\n" ) );
-        return NULL;
+        // the file is mapped rather than read, so the long lines of the large models
+        // are not copied
+        procPtr.reset( new WRLPROC( aFileName ) );
     }
 
-
     // VRML file processor
-    WRLPROC proc( modelFile );
-
-    // Cleanup our temporary file
-    if( tmpfilename.IsOk() )
-        wxRemoveFile( tmpfilename.GetFullPath() );
+    WRLPROC& proc = *procPtr;
 
     if( proc.GetVRMLType() == VRML_V1 )
     {
@@ -271,9 +276,6 @@ SCENEGRAPH* LoadVRML( const wxString& aFileName, bool useInline )
         delete bp;
     }
 
-    if( NULL != modelFile )
-        delete modelFile;
-
     // DEBUG: WRITE OUT VRML2 FILE TO CONFIRM STRUCTURE
     #if ( defined( DEBUG_VRML1 ) && DEBUG_VRML1 > 3 ) \
         || ( defined( DEBUG_VRML2 ) && DEBUG_VRML2 > 3 )
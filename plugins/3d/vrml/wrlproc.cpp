@@ -21,49 +21,295 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/string.h>
 #include <wx/log.h>
 #include "wrlproc.h"
 
-#define GETLINE do {\
-    try { \
-        char* cp = m_file->ReadLine(); \
-        if( NULL == cp ) { \
-            m_eof = true; \
-            m_buf.clear(); \
-        } else { \
-            m_buf = cp; \
-            m_bufpos = 0; \
-        } \
-        m_fileline = m_file->LineNumber(); \
-    } catch( ... ) { \
-        m_error = " * [INFO] input line too long"; \
-        m_eof = true; \
-        m_buf.clear(); \
-    } } while( 0 )
-
-
-WRLPROC::WRLPROC( LINE_READER* aLineReader )
+
+/**
+ * The text of the file being parsed: the mapped file, or the text of a decompressed file
+ */
+struct WRLDATA
+{
+    std::unique_ptr<boost::interprocess::mapped_region> m_region;
+    std::string                                         m_text;
+};
+
+
+/**
+ * Parse a float from a token without any allocation and independently of the locale. The
+ * token must be a complete number: an optional sign, digits with an optional decimal point,
+ * and an optional exponent. The value is computed in double precision from at most 19
+ * significant digits, so it can differ from a correctly rounded conversion in the last bit
+ * of the float.
+ */
+static bool parseFloat( const char* aText, size_t aLength, float& aValue )
+{
+    // the powers of 10 which are exact in a double
+    static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                    1e20, 1e21, 1e22 };
+    const int maxPow10 = 22;
+    const int maxDigits = 19;   // the significant digits which fit in the 64 bit mantissa
+
+    const char* cp = aText;
+    const char* end = aText + aLength;
+    bool negative = false;
+
+    if( cp < end && ( '+' == *cp || '-' == *cp ) )
+        negative = ( '-' == *cp++ );
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    for( ; cp < end && *cp >= '0' && *cp <= '9'; ++cp )
+    {
+        hasDigits = true;
+
+        if( digits < maxDigits )
+        {
+            mantissa = mantissa * 10 + ( *cp - '0' );
+
+            if( mantissa )
+                ++digits;
+        }
+        else
+        {
+            ++exponent;
+        }
+    }
+
+    if( cp < end && '.' == *cp )
+    {
+        for( ++cp; cp < end && *cp >= '0' && *cp <= '9'; ++cp )
+        {
+            hasDigits = true;
+
+            if( digits < maxDigits )
+            {
+                mantissa = mantissa * 10 + ( *cp - '0' );
+                --exponent;
+
+                if( mantissa )
+                    ++digits;
+            }
+        }
+    }
+
+    if( !hasDigits )
+        return false;
+
+    if( cp < end && ( 'e' == *cp || 'E' == *cp ) )
+    {
+        ++cp;
+        bool negativeExp = false;
+
+        if( cp < end && ( '+' == *cp || '-' == *cp ) )
+            negativeExp = ( '-' == *cp++ );
+
+        if( cp == end || *cp < '0' || *cp > '9' )
+            return false;
+
+        int exp = 0;
+
+        for( ; cp < end && *cp >= '0' && *cp <= '9'; ++cp )
+        {
+            if( exp < 100000 )
+                exp = exp * 10 + ( *cp - '0' );
+        }
+
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    if( cp != end )
+        return false;
+
+    double value = (double) mantissa;
+
+    if( mantissa && exponent )
+    {
+        if( exponent > 0 && exponent <= maxPow10 )
+            value *= pow10[exponent];
+        else if( exponent < 0 && exponent >= -maxPow10 )
+            value /= pow10[-exponent];
+        else
+            value *= std::pow( 10.0, exponent );
+    }
+
+    // the values which round to FLT_MAX are accepted
+    if( value >= (double) FLT_MAX + std::ldexp( 1.0, 103 ) )
+        return false;
+
+    aValue = (float) ( negative ? -value : value );
+    return true;
+}
+
+
+/**
+ * Parse an int from a token without any allocation: an optional sign and decimal digits,
+ * or "0x" and hexadecimal digits (VRML is case sensitive but the case is not enforced here).
+ */
+static bool parseInt( const char* aText, size_t aLength, int& aValue )
+{
+    const char* cp = aText;
+    const char* end = aText + aLength;
+    bool negative = false;
+
+    if( cp < end && ( '+' == *cp || '-' == *cp ) )
+        negative = ( '-' == *cp++ );
+
+    if( end - cp > 2 && '0' == cp[0] && ( 'x' == cp[1] || 'X' == cp[1] ) )
+    {
+        // hexadecimal values are 32 bit patterns (i.e. SFImage pixels)
+        uint64_t value = 0;
+
+        for( cp += 2; cp < end; ++cp )
+        {
+            int digit;
+
+            if( *cp >= '0' && *cp <= '9' )
+                digit = *cp - '0';
+            else if( *cp >= 'a' && *cp <= 'f' )
+                digit = *cp - 'a' + 10;
+            else if( *cp >= 'A' && *cp <= 'F' )
+                digit = *cp - 'A' + 10;
+            else
+                return false;
+
+            value = value * 16 + digit;
+
+            if( value > UINT32_MAX )
+                return false;
+        }
+
+        aValue = (int) (uint32_t) value;
+
+        if( negative )
+            aValue = -aValue;
+
+        return true;
+    }
+
+    if( cp == end )
+        return false;
+
+    int64_t value = 0;
+
+    for( ; cp < end; ++cp )
+    {
+        if( *cp < '0' || *cp > '9' )
+            return false;
+
+        value = value * 10 + ( *cp - '0' );
+
+        if( value > (int64_t) INT_MAX + 1 )
+            return false;
+    }
+
+    if( negative )
+        value = -value;
+
+    if( value > INT_MAX )
+        return false;
+
+    aValue = (int) value;
+    return true;
+}
+
+
+WRLPROC::WRLPROC( const wxString& aFileName )
+{
+    using namespace boost::interprocess;
+
+    m_data.reset( new WRLDATA );
+    m_textPos = nullptr;
+    m_textEnd = nullptr;
+
+    // file_mapping only takes a narrow file name, which Windows does not read as UTF-8:
+    // the files with a non ASCII name are read instead of mapped
+#ifdef _WIN32
+    bool canMap = aFileName.IsAscii();
+#else
+    bool canMap = true;
+#endif
+
+    if( canMap )
+    {
+        try
+        {
+            file_mapping mapping( aFileName.ToUTF8(), read_only );
+            m_data->m_region.reset( new mapped_region( mapping, read_only ) );
+            m_textPos = static_cast<const char*>( m_data->m_region->get_address() );
+            m_textEnd = m_textPos + m_data->m_region->get_size();
+        }
+        catch( const interprocess_exception& e )
+        {
+            wxLogTrace( MASK_VRML, " * [INFO] cannot map file '%s': %s\n", aFileName,
+                        e.what() );
+
+            m_data->m_region.reset();
+        }
+    }
+
+    if( !m_textPos )
+    {
+        // a file which cannot be read (or an empty one) is rejected as an invalid VRML file
+        wxFFile file( aFileName, "rb" );
+        wxFileOffset length = file.IsOpened() ? file.Length() : 0;
+
+        if( length > 0 )
+        {
+            m_data->m_text.resize( length );
+
+            if( file.Read( &m_data->m_text[0], length ) != (size_t) length )
+            {
+                wxLogTrace( MASK_VRML, " * [INFO] cannot read file '%s'\n", aFileName );
+                m_data->m_text.clear();
+            }
+        }
+
+        m_textPos = m_data->m_text.data();
+        m_textEnd = m_textPos + m_data->m_text.size();
+    }
+
+    init( aFileName );
+}
+
+
+WRLPROC::WRLPROC( std::string&& aText, const wxString& aFileName )
+{
+    m_data.reset( new WRLDATA );
+    m_data->m_text = std::move( aText );
+    m_textPos = m_data->m_text.data();
+    m_textEnd = m_textPos + m_data->m_text.size();
+
+    init( aFileName );
+}
+
+
+void WRLPROC::init( const wxString& aFileName )
 {
     m_fileVersion = VRML_INVALID;
     m_eof = false;
     m_fileline = 0;
     m_bufpos = 0;
-    m_file = aLineReader;
-
-    if( NULL == aLineReader )
-    {
-        m_eof = true;
-        return;
-    }
 
     m_error.clear();
-    wxString tname = m_file->GetSource();
-    m_filename = tname.ToUTF8();
-    wxFileName fn( tname );
+    m_filename = aFileName.ToUTF8();
+    wxFileName fn( aFileName );
 
     if( fn.IsRelative() )
         fn.Normalize();
@@ -71,12 +317,17 @@ WRLPROC::WRLPROC( LINE_READER* aLineReader )
     m_filedir = fn.GetPathWithSep().ToUTF8();
 
     m_buf.clear();
-    GETLINE;
+    readLine();
 
     if( m_eof )
+    {
+        m_error = "not a valid VRML file: '";
+        m_error.append( m_filename );
+        m_error.append( 1, '\'' );
         return;
+    }
 
-    if( m_buf.compare( 0, 16, "#VRML V1.0 ascii"  ) == 0 )
+    if( m_buf.size() >= 16 && !strncmp( m_buf.data(), "#VRML V1.0 ascii", 16 ) )
     {
         m_fileVersion = VRML_V1;
         // nothing < 0x20, and no:
@@ -89,7 +340,7 @@ WRLPROC::WRLPROC( LINE_READER* aLineReader )
         return;
     }
 
-    if( m_buf.compare( 0, 15, "#VRML V2.0 utf8" ) == 0 )
+    if( m_buf.size() >= 15 && !strncmp( m_buf.data(), "#VRML V2.0 utf8", 15 ) )
     {
         m_fileVersion = VRML_V2;
         // nothing < 0x20, and no:
@@ -130,11 +381,38 @@ WRLPROC::~WRLPROC()
 }
 
 
+void WRLPROC::readLine( void )
+{
+    m_bufpos = 0;
+
+    if( m_textPos >= m_textEnd )
+    {
+        m_eof = true;
+        m_buf.clear();
+        return;
+    }
+
+    const char* eol = (const char*) memchr( m_textPos, '\n', m_textEnd - m_textPos );
+    const char* next = eol ? eol + 1 : m_textEnd;
+
+    if( !eol )
+        eol = m_textEnd;
+
+    // strip the EOL characters
+    while( eol > m_textPos && '\r' == eol[-1] )
+        --eol;
+
+    m_buf.assign( m_textPos, eol - m_textPos );
+    m_textPos = next;
+    ++m_fileline;
+}
+
+
 bool WRLPROC::getRawLine( void )
 {
     m_error.clear();
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -149,29 +427,20 @@ bool WRLPROC::getRawLine( void )
     if( m_eof )
         return false;
 
-    GETLINE;
+    readLine();
 
     if( m_eof && m_buf.empty() )
         return false;
 
-    // strip the EOL characters
-    while( !m_buf.empty() && ( *m_buf.rbegin() == '\r' || *m_buf.rbegin() == '\n' ) )
-        m_buf.erase( --m_buf.end() );
-
     if( VRML_V1 == m_fileVersion && !m_buf.empty() )
     {
-        std::string::iterator sS = m_buf.begin();
-        std::string::iterator eS = m_buf.end();
-
-        while( sS != eS )
+        for( size_t i = 0; i < m_buf.size(); ++i )
         {
-            if( ((*sS) & 0x80) )
+            if( ( m_buf[i] & 0x80 ) )
             {
                 m_error = " non-ASCII character sequence in VRML1 file";
                 return false;
             }
-
-            ++sS;
         }
     }
 
@@ -181,7 +450,7 @@ bool WRLPROC::getRawLine( void )
 
 bool WRLPROC::EatSpace( void )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -235,9 +504,26 @@ const char* WRLPROC::GetParentDir( void )
 
 bool WRLPROC::ReadGlob( std::string& aGlob )
 {
-    aGlob.clear();
+    const char* glob;
+    size_t length;
 
-    if( !m_file )
+    if( !readGlob( glob, length ) )
+    {
+        aGlob.clear();
+        return false;
+    }
+
+    aGlob.assign( glob, length );
+    return true;
+}
+
+
+bool WRLPROC::readGlob( const char*& aGlob, size_t& aLength )
+{
+    aGlob = nullptr;
+    aLength = 0;
+
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -256,32 +542,88 @@ bool WRLPROC::ReadGlob( std::string& aGlob )
     }
 
     size_t ssize = m_buf.size();
+    size_t start = m_bufpos;
 
     while( m_bufpos < ssize && m_buf[m_bufpos] > 0x20 )
     {
         if( ',' == m_buf[m_bufpos] )
         {
             // the comma is a special instance of blank space
+            aGlob = m_buf.data() + start;
+            aLength = m_bufpos - start;
             ++m_bufpos;
             return true;
         }
 
         if( '{' == m_buf[m_bufpos] || '}' == m_buf[m_bufpos]
             || '[' == m_buf[m_bufpos] || ']' == m_buf[m_bufpos] )
-            return true;
+            break;
 
-        aGlob.append( 1, m_buf[m_bufpos++] );
+        ++m_bufpos;
     }
 
+    aGlob = m_buf.data() + start;
+    aLength = m_bufpos - start;
     return true;
 }
 
 
+size_t WRLPROC::countListItems( void )
+{
+    // the list is read from the file text, which goes on after the current line
+    const char* cp = m_buf.data() + m_bufpos;
+    size_t count = 0;
+    bool inToken = false;
+
+    if( !m_buf.data() )
+        return 0;
+
+    while( cp < m_textEnd )
+    {
+        char c = *cp;
+
+        if( ']' == c )
+            return count;
+
+        if( '[' == c || '{' == c || '}' == c || '"' == c )
+            return 0;
+
+        if( '#' == c )
+        {
+            const char* eol = (const char*) memchr( cp, '\n', m_textEnd - cp );
+
+            if( !eol )
+                return 0;
+
+            cp = eol;
+            inToken = false;
+            continue;
+        }
+
+        if( c > 0x20 && ',' != c )
+        {
+            if( !inToken )
+                ++count;
+
+            inToken = true;
+        }
+        else
+        {
+            inToken = false;
+        }
+
+        ++cp;
+    }
+
+    return 0;
+}
+
+
 bool WRLPROC::ReadName( std::string& aName )
 {
     aName.clear();
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -358,7 +700,7 @@ bool WRLPROC::ReadName( std::string& aName )
 
 bool WRLPROC::DiscardNode( void )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -481,7 +823,7 @@ bool WRLPROC::DiscardNode( void )
 
 bool WRLPROC::DiscardList( void )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -606,7 +948,7 @@ bool WRLPROC::ReadString( std::string& aSFString )
     // In VRML2 all strings must be quoted
     aSFString.clear();
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -756,7 +1098,7 @@ bool WRLPROC::ReadSFBool( bool& aSFBool )
 
 bool WRLPROC::ReadSFColor( WRLVEC3F& aSFColor )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -788,7 +1130,7 @@ bool WRLPROC::ReadSFColor( WRLVEC3F& aSFColor )
 
 bool WRLPROC::ReadSFFloat( float& aSFFloat )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -811,9 +1153,10 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
             break;
     }
 
-    std::string tmp;
+    const char* glob;
+    size_t length;
 
-    if( !ReadGlob( tmp ) )
+    if( !readGlob( glob, length ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -826,11 +1169,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
         return false;
     }
 
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFFloat;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseFloat( glob, length, aSFFloat ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -849,7 +1188,7 @@ bool WRLPROC::ReadSFFloat( float& aSFFloat )
 
 bool WRLPROC::ReadSFInt( int& aSFInt32 )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -871,9 +1210,10 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
             break;
     }
 
-    std::string tmp;
+    const char* glob;
+    size_t length;
 
-    if( !ReadGlob( tmp ) )
+    if( !readGlob( glob, length ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -886,21 +1226,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
         return false;
     }
 
-    if( std::string::npos != tmp.find( "0x" ) )
-    {
-        // Rules: "0x" + "0-9, A-F" - VRML is case sensitive but in
-        // this instance we do no enforce case.
-        std::stringstream sstr;
-        sstr << std::hex << tmp;
-        sstr >> aSFInt32;
-        return true;
-    }
-
-    std::istringstream istr;
-    istr.str( tmp );
-    istr >> aSFInt32;
-
-    if( istr.fail() || !istr.eof() )
+    if( !parseInt( glob, length, aSFInt32 ) )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -919,7 +1245,7 @@ bool WRLPROC::ReadSFInt( int& aSFInt32 )
 
 bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -945,12 +1271,13 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             break;
     }
 
-    std::string tmp;
+    const char* glob;
+    size_t length;
     float trot[4];
 
     for( int i = 0; i < 4; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlob( glob, length ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -963,11 +1290,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> trot[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( glob, length, trot[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -993,7 +1316,7 @@ bool WRLPROC::ReadSFRotation( WRLROTATION& aSFRotation )
 
 bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1017,13 +1340,14 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             break;
     }
 
-    std::string tmp;
+    const char* glob;
+    size_t length;
 
     float tcol[2];
 
     for( int i = 0; i < 2; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlob( glob, length ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1036,11 +1360,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
             return false;
         }
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( glob, length, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1064,7 +1384,7 @@ bool WRLPROC::ReadSFVec2f( WRLVEC2F& aSFVec2f )
 
 bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1089,13 +1409,14 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
             break;
     }
 
-    std::string tmp;
+    const char* glob;
+    size_t length;
 
     float tcol[3];
 
     for( int i = 0; i < 3; ++i )
     {
-        if( !ReadGlob( tmp ) )
+        if( !readGlob( glob, length ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1115,11 +1436,7 @@ bool WRLPROC::ReadSFVec3f( WRLVEC3F& aSFVec3f )
         if( ',' == m_buf[m_bufpos] )
             Pop();
 
-        std::istringstream istr;
-        istr.str( tmp );
-        istr >> tcol[i];
-
-        if( istr.fail() || !istr.eof() )
+        if( !parseFloat( glob, length, tcol[i] ) )
         {
             std::ostringstream ostr;
             ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
@@ -1148,7 +1465,7 @@ bool WRLPROC::ReadMFString( std::vector< std::string >& aMFString )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1267,7 +1584,7 @@ bool WRLPROC::ReadMFColor( std::vector< WRLVEC3F >& aMFColor )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1323,6 +1640,8 @@ bool WRLPROC::ReadMFColor( std::vector< WRLVEC3F >& aMFColor )
     }
 
     ++m_bufpos;
+    // count the values of the list first, to allocate the array only once
+    aMFColor.reserve( countListItems() / 3 );
 
     while( true )
     {
@@ -1379,7 +1698,7 @@ bool WRLPROC::ReadMFFloat( std::vector< float >& aMFFloat )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1435,6 +1754,7 @@ bool WRLPROC::ReadMFFloat( std::vector< float >& aMFFloat )
     }
 
     ++m_bufpos;
+    aMFFloat.reserve( countListItems() );
 
     while( true )
     {
@@ -1491,7 +1811,7 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1547,6 +1867,7 @@ bool WRLPROC::ReadMFInt( std::vector< int >& aMFInt32 )
     }
 
     ++m_bufpos;
+    aMFInt32.reserve( countListItems() );
 
     while( true )
     {
@@ -1603,7 +1924,7 @@ bool WRLPROC::ReadMFRotation( std::vector< WRLROTATION >& aMFRotation )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1659,6 +1980,7 @@ bool WRLPROC::ReadMFRotation( std::vector< WRLROTATION >& aMFRotation )
     }
 
     ++m_bufpos;
+    aMFRotation.reserve( countListItems() / 4 );
 
     while( true )
     {
@@ -1715,7 +2037,7 @@ bool WRLPROC::ReadMFVec2f( std::vector< WRLVEC2F >& aMFVec2f )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1771,6 +2093,7 @@ bool WRLPROC::ReadMFVec2f( std::vector< WRLVEC2F >& aMFVec2f )
     }
 
     ++m_bufpos;
+    aMFVec2f.reserve( countListItems() / 2 );
 
     while( true )
     {
@@ -1827,7 +2150,7 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
     size_t fileline = m_fileline;
     size_t linepos = m_bufpos;
 
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return false;
@@ -1883,6 +2206,7 @@ bool WRLPROC::ReadMFVec3f( std::vector< WRLVEC3F >& aMFVec3f )
     }
 
     ++m_bufpos;
+    aMFVec3f.reserve( countListItems() / 3 );
 
     while( true )
     {
@@ -1950,7 +2274,7 @@ std::string WRLPROC::GetError( void )
 
 bool WRLPROC::GetFilePosData( size_t& line, size_t& column )
 {
-    if( !m_file )
+    if( !m_data )
     {
         line = 0;
         column = 0;
@@ -1966,19 +2290,19 @@ bool WRLPROC::GetFilePosData( size_t& line, size_t& column )
 
 std::string WRLPROC::GetFileName( void )
 {
-    if( !m_file )
+    if( !m_data )
     {
         m_error = "no open file";
         return "";
     }
 
-    return std::string( m_file->GetSource().ToUTF8() );
+    return m_filename;
 }
 
 
 char WRLPROC::Peek( void )
 {
-    if( !m_file )
+    if( !m_data )
     {
         std::ostringstream ostr;
         ostr << __FILE__ << ":" << __FUNCTION__ << ":" << __LINE__ << "\n";
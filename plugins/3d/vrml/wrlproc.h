@@ -30,18 +30,60 @@
 #ifndef WRLPROC_H
 #define WRLPROC_H
 
-#include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
-#include "richio.h"
+#include <wx/string.h>
+
 #include "wrltypes.h"
 
+struct WRLDATA;
+
+
+/**
+ * A line of the file being parsed: a view of the file text, without the EOL characters.
+ * As with a std::string, the character at size() (and past it) reads as '\0'.
+ */
+class WRLLINE
+{
+public:
+    WRLLINE() : m_text( nullptr ), m_size( 0 ) {}
+
+    void assign( const char* aText, size_t aSize )
+    {
+        m_text = aText;
+        m_size = aSize;
+    }
+
+    void clear()
+    {
+        m_text = nullptr;
+        m_size = 0;
+    }
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    const char* data() const { return m_text; }
+
+    char operator[]( size_t aIndex ) const
+    {
+        return aIndex < m_size ? m_text[aIndex] : '\0';
+    }
+
+private:
+    const char* m_text;
+    size_t      m_size;
+};
+
+
 class WRLPROC
 {
 private:
-    LINE_READER* m_file;
-    std::string m_buf;          // string being parsed
+    std::unique_ptr<WRLDATA> m_data;    // the file text (mapped or decompressed)
+    const char* m_textPos;      // start of the next line in the file text
+    const char* m_textEnd;      // end of the file text
+    WRLLINE m_buf;              // line being parsed
     bool m_eof;
     unsigned int m_fileline;
     unsigned int m_bufpos;
@@ -52,14 +94,32 @@ private:
     std::string m_filename;     // current file
     std::string m_filedir;      // parent directory of the file
 
+    // read the file header and set up the file version
+    void init( const wxString& aFileName );
+
+    // readLine moves m_buf to the next line of the file text, or sets m_eof
+    void readLine( void );
+
     // getRawLine reads a single non-blank line and in the case of a VRML1 file
     // it checks for invalid characters (bit 8 set). If m_buf is not empty and
     // not completely parsed the function returns 'true'. The file position
     // parameters are updated as appropriate.
     bool getRawLine( void );
 
+    // readGlob is ReadGlob without a copy: aGlob points to the token in the file text
+    bool readGlob( const char*& aGlob, size_t& aLength );
+
+    // countListItems returns the number of values in the list starting at the current
+    // position (just after its '['), to reserve the arrays before they are read; it
+    // returns 0 if the list is not a plain list of numbers
+    size_t countListItems( void );
+
 public:
-    WRLPROC( LINE_READER* aLineReader );
+    // map the file aFileName, or read it if it cannot be mapped
+    WRLPROC( const wxString& aFileName );
+    // parse the text aText (i.e. a decompressed file); aFileName is the name of the
+    // original file, used for the messages and to locate the inline files
+    WRLPROC( std::string&& aText, const wxString& aFileName );
     ~WRLPROC();
 
     bool eof( void );
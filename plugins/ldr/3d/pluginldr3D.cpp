@@ -43,6 +43,7 @@ KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
     m_getNFilters = NULL;
     m_getFileFilter = NULL;
     m_canRender = NULL;
+    m_isReentrant = NULL;
     m_load = NULL;
 
     return;
@@ -94,6 +95,10 @@ bool KICAD_PLUGIN_LDR_3D::Open( const wxString& aFullFileName )
     LINK_ITEM( m_canRender, PLUGIN_3D_CAN_RENDER, "CanRender" );
     LINK_ITEM( m_load, PLUGIN_3D_LOAD, "Load" );
 
+    // Optional: wxDynamicLibrary::GetSymbol() reports an error for the missing symbols
+    if( m_PluginLoader.HasSymbol( wxT( "IsReentrant" ) ) )
+        LINK_ITEM( m_isReentrant, PLUGIN_3D_IS_REENTRANT, "IsReentrant" );
+
     #ifdef DEBUG
         bool fail = false;
 
@@ -249,6 +254,7 @@ void KICAD_PLUGIN_LDR_3D::Close( void )
     m_getNFilters = NULL;
     m_getFileFilter = NULL;
     m_canRender = NULL;
+    m_isReentrant = NULL;
     m_load = NULL;
     close();
 
@@ -398,6 +404,11 @@ char const* KICAD_PLUGIN_LDR_3D::GetFileFilter( int aIndex )
 
 bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 {
+    // An open plugin is called without touching the loader state: the reentrant plugins are
+    // called by several threads at once
+    if( ok && NULL != m_canRender )
+        return m_canRender();
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -426,8 +437,24 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 }
 
 
+bool KICAD_PLUGIN_LDR_3D::IsReentrant( void )
+{
+    if( !ok && !reopen() )
+        return false;
+
+    // IsReentrant is optional: the plugins which do not export it are not reentrant
+    if( NULL == m_isReentrant )
+        return false;
+
+    return m_isReentrant();
+}
+
+
 SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 {
+    if( ok && NULL != m_load )
+        return m_load( aFileName );
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -45,6 +45,8 @@ typedef char const* (*PLUGIN_3D_GET_FILE_FILTER) ( int aIndex );
 
 typedef bool (*PLUGIN_3D_CAN_RENDER) ( void );
 
+typedef bool (*PLUGIN_3D_IS_REENTRANT) ( void );
+
 typedef SCENEGRAPH* (*PLUGIN_3D_LOAD) ( char const* aFileName );
 
 
@@ -57,6 +59,7 @@ private:
     PLUGIN_3D_GET_N_FILTERS         m_getNFilters;
     PLUGIN_3D_GET_FILE_FILTER       m_getFileFilter;
     PLUGIN_3D_CAN_RENDER            m_canRender;
+    PLUGIN_3D_IS_REENTRANT          m_isReentrant;  // optional
     PLUGIN_3D_LOAD                  m_load;
 
 public:
@@ -84,6 +87,12 @@ public:
 
     bool CanRender( void );
 
+    /**
+     * @return true if the models can be loaded by several threads at the same time: CanRender(),
+     * Load() and GetPluginInfo() are then thread safe
+     */
+    bool IsReentrant( void );
+
     SCENEGRAPH* Load( char const* aFileName );
 };
 
@@ -0,0 +1,250 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for LIB_TREE_SEARCH_INDEX: the scores of the searches with the index must be
+ * the same as the scores without it
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_tree_model.h>
+
+#include <eda_pattern_match.h>
+
+#include <wx/tokenzr.h>
+
+
+/**
+ * A library item with a name and a search text
+ */
+class TEST_LIB_TREE_ITEM : public LIB_TREE_ITEM
+{
+public:
+    TEST_LIB_TREE_ITEM( const wxString& aLib, const wxString& aName, const wxString& aText ) :
+            m_lib( aLib ), m_name( aName ), m_text( aText )
+    {
+    }
+
+    LIB_ID GetLibId() const override { return LIB_ID( m_lib, m_name ); }
+
+    wxString GetName() const override { return m_name; }
+    wxString GetLibNickname() const override { return m_lib; }
+
+    wxString GetDescription() override { return m_text; }
+    wxString GetSearchText() override { return m_text; }
+
+private:
+    wxString m_lib;
+    wxString m_name;
+    wxString m_text;
+};
+
+
+class LIB_TREE_SEARCH_FIXTURE
+{
+public:
+    LIB_TREE_SEARCH_FIXTURE()
+    {
+        const std::vector<std::pair<wxString, std::vector<TEST_LIB_TREE_ITEM>>> libs = {
+            { "Device", {
+                    { "Device", "R", "R res resistor" },
+                    { "Device", "R_Small", "R res resistor small" },
+                    { "Device", "C", "C cap capacitor" },
+                    { "Device", "C_Polarized", "C cap capacitor electrolytic" },
+                    { "Device", "L", "L inductor choke coil" },
+                    { "Device", "Crystal", "crystal quartz resonator" },
+            } },
+            { "Regulator_Linear", {
+                    { "Regulator_Linear", "LM7805_TO220", "LM7805 voltage regulator 5V "
+                                                          "vout=5 iout:1.5" },
+                    { "Regulator_Linear", "AMS1117-3.3", "AMS1117 LDO regulator 3.3V "
+                                                         "vout=3.3 iout:1" },
+                    { "Regulator_Linear", "LM317_TO220", "LM317 adjustable regulator" },
+            } },
+            { "Resistor_SMD", {
+                    { "Resistor_SMD", "R_0603_1608Metric", "resistor 0603 SMD" },
+                    { "Resistor_SMD", "R_0805_2012Metric", "resistor 0805 SMD" },
+            } },
+        };
+
+        for( const auto& lib : libs )
+        {
+            for( LIB_TREE_NODE_ROOT* tree : { &m_tree, &m_indexedTree } )
+            {
+                LIB_TREE_NODE_LIB& libNode = tree->AddLib( lib.first, wxEmptyString );
+
+                for( TEST_LIB_TREE_ITEM item : lib.second )
+                    libNode.AddItem( &item );
+            }
+        }
+    }
+
+    /**
+     * Search aSearch in both trees, without and with the index
+     */
+    void Search( const wxString& aSearch )
+    {
+        std::vector<wxString> terms;
+        wxStringTokenizer     tokenizer( aSearch );
+
+        while( tokenizer.HasMoreTokens() )
+            terms.push_back( tokenizer.GetNextToken().Lower() );
+
+        m_tree.ResetScore();
+        m_indexedTree.ResetScore();
+
+        if( !terms.empty() )
+            m_index.ExcludeNonMatching( m_indexedTree, terms );
+
+        for( const wxString& term : terms )
+        {
+            EDA_COMBINED_MATCHER matcher( term );
+            m_tree.UpdateScore( matcher );
+        }
+
+        for( const wxString& term : terms )
+        {
+            EDA_COMBINED_MATCHER matcher( term );
+            m_indexedTree.UpdateScore( matcher );
+        }
+
+        m_index.StoreMatches( terms );
+    }
+
+    /**
+     * Check the scores of all the nodes of both trees are the same
+     */
+    void CheckSameScores() const
+    {
+        for( size_t lib = 0; lib < m_tree.m_Children.size(); ++lib )
+        {
+            const LIB_TREE_NODE& libNode = *m_tree.m_Children[lib];
+            const LIB_TREE_NODE& indexedLibNode = *m_indexedTree.m_Children[lib];
+
+            BOOST_CHECK_EQUAL( libNode.m_Score, indexedLibNode.m_Score );
+
+            for( size_t i = 0; i < libNode.m_Children.size(); ++i )
+            {
+                BOOST_TEST_CONTEXT( libNode.m_Children[i]->m_Name )
+                {
+                    BOOST_CHECK_EQUAL( libNode.m_Children[i]->m_Score,
+                                       indexedLibNode.m_Children[i]->m_Score );
+                }
+            }
+        }
+    }
+
+    LIB_TREE_NODE_ROOT    m_tree;
+    LIB_TREE_NODE_ROOT    m_indexedTree;
+    LIB_TREE_SEARCH_INDEX m_index;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( LibTreeSearchIndex, LIB_TREE_SEARCH_FIXTURE )
+
+
+/**
+ * Independent searches, with plain terms and with the other matchers syntaxes
+ */
+BOOST_AUTO_TEST_CASE( SameScores )
+{
+    const std::vector<wxString> searches = {
+        "",
+        "r",
+        "re",
+        "res",
+        "resistor",
+        "resistor smd",
+        "smd resistor",
+        "regulator",
+        "linear",
+        "reg lin",
+        "device cap",
+        "r_*",
+        "lm.*",
+        "lm???",
+        "vout>4",
+        "vout<=3.3",
+        "iout=",
+        "0603",
+        "xyz",
+        "ams1117-3.3",
+    };
+
+    for( const wxString& search : searches )
+    {
+        BOOST_TEST_CONTEXT( search )
+        {
+            // Also searched after an unrelated search, which must not be used
+            Search( "zzz" );
+            Search( search );
+            CheckSameScores();
+        }
+    }
+}
+
+
+/**
+ * Searches typed character by character, using the previous matches
+ */
+BOOST_AUTO_TEST_CASE( IncrementalSearches )
+{
+    const std::vector<wxString> typed = {
+        "resistor smd 0805",
+        "reg* 3.3",
+        "lm7 vout>4",
+        "capacitor",
+    };
+
+    for( const wxString& search : typed )
+    {
+        for( size_t len = 0; len <= search.length(); ++len )
+        {
+            BOOST_TEST_CONTEXT( search.Left( len ) )
+            {
+                Search( search.Left( len ) );
+                CheckSameScores();
+            }
+        }
+
+        // and erased
+        for( size_t len = search.length(); len > 0; --len )
+        {
+            BOOST_TEST_CONTEXT( search.Left( len - 1 ) )
+            {
+                Search( search.Left( len - 1 ) );
+                CheckSameScores();
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
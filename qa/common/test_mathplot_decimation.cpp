@@ -0,0 +1,326 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for mpMinMaxPyramid: the decimated traces must be plotted exactly as the full
+ * traces, also when they are extended
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <widgets/mathplot.h>
+
+#include <cmath>
+#include <random>
+
+
+/**
+ * The lines plotted for a trace by mpFXY::Plot in continuous mode: the polyline through the
+ * first point of each pixel column, and the vertical lines of the merged points.
+ */
+struct PLOTTED_TRACE
+{
+    std::vector<wxPoint>                     m_polyline;
+    std::vector<std::pair<wxPoint, wxPoint>> m_verticals;
+};
+
+
+/**
+ * Merge the points as mpFXY::Plot does
+ */
+class TRACE_PLOTTER
+{
+public:
+    TRACE_PLOTTER( wxCoord aStartPx, wxCoord aEndPx ) :
+            m_startPx( aStartPx ), m_endPx( aEndPx ), m_ymin( 0 ), m_ymax( 0 ), m_dup( 0 )
+    {
+    }
+
+    void AddPoint( wxCoord aX, wxCoord aY )
+    {
+        if( aX < m_startPx || aX > m_endPx )
+            return;
+
+        if( m_trace.m_polyline.empty() || m_trace.m_polyline.back().x != aX )
+        {
+            flushVertical();
+            m_ymin = m_ymax = aY;
+            m_dup = 0;
+            m_trace.m_polyline.emplace_back( aX, aY );
+        }
+        else
+        {
+            m_ymin = std::min( m_ymin, aY );
+            m_ymax = std::max( m_ymax, aY );
+            m_dup++;
+        }
+    }
+
+    const PLOTTED_TRACE& GetTrace()
+    {
+        flushVertical();
+        m_dup = 0;
+        return m_trace;
+    }
+
+private:
+    void flushVertical()
+    {
+        if( !m_trace.m_polyline.empty() && m_dup > 1 && m_ymin != m_ymax )
+        {
+            wxCoord x = m_trace.m_polyline.back().x;
+            m_trace.m_verticals.emplace_back( wxPoint( x, m_ymin ), wxPoint( x, m_ymax ) );
+        }
+    }
+
+    wxCoord       m_startPx, m_endPx;
+    wxCoord       m_ymin, m_ymax;
+    int           m_dup;
+    PLOTTED_TRACE m_trace;
+};
+
+
+/**
+ * A trace and the conversions of its values to pixels, as done by mpWindow
+ */
+class DECIMATION_FIXTURE
+{
+public:
+    void MakeTrace( size_t aCount, double aDuplicateRatio = 0.0 )
+    {
+        std::mt19937                           rng( 42 );
+        std::uniform_real_distribution<double> step( 0.0, 2.0 );
+        std::uniform_real_distribution<double> noise( -0.2, 0.2 );
+        std::uniform_real_distribution<double> duplicate( 0.0, 1.0 );
+
+        m_xs.resize( aCount );
+        m_ys.resize( aCount );
+
+        double x = 0.0;
+
+        for( size_t ii = 0; ii < aCount; ii++ )
+        {
+            if( duplicate( rng ) >= aDuplicateRatio )
+                x += step( rng );
+
+            m_xs[ii] = x;
+            m_ys[ii] = std::sin( x * 0.001 ) + noise( rng );
+        }
+
+        m_pyramid.Build( m_ys );
+    }
+
+    void SetView( double aPosX, double aScaleX )
+    {
+        m_posX = aPosX;
+        m_scaleX = aScaleX;
+    }
+
+    wxCoord ToPixelX( double aX ) const { return (wxCoord) ( ( aX - m_posX ) * m_scaleX ); }
+
+    wxCoord ToPixelY( double aY ) const { return (wxCoord) ( ( 1.5 - aY ) * 200.0 ); }
+
+    PLOTTED_TRACE PlotFull( wxCoord aStartPx, wxCoord aEndPx ) const
+    {
+        TRACE_PLOTTER plotter( aStartPx, aEndPx );
+
+        for( size_t ii = 0; ii < m_xs.size(); ii++ )
+            plotter.AddPoint( ToPixelX( m_xs[ii] ), ToPixelY( m_ys[ii] ) );
+
+        return plotter.GetTrace();
+    }
+
+    PLOTTED_TRACE PlotDecimated( wxCoord aStartPx, wxCoord aEndPx,
+                                 std::vector<wxPoint>& aPoints ) const
+    {
+        TRACE_PLOTTER plotter( aStartPx, aEndPx );
+
+        decimate( aStartPx, aEndPx, aPoints );
+
+        for( const wxPoint& point : aPoints )
+            plotter.AddPoint( point.x, point.y );
+
+        return plotter.GetTrace();
+    }
+
+protected:
+    void decimate( wxCoord aStartPx, wxCoord aEndPx, std::vector<wxPoint>& aPoints ) const
+    {
+        m_pyramid.Decimate( m_xs, m_ys,
+                            [this]( double x )
+                            {
+                                return ToPixelX( x );
+                            },
+                            [this]( double y )
+                            {
+                                return ToPixelY( y );
+                            },
+                            aStartPx, aEndPx, aPoints );
+    }
+
+    std::vector<double> m_xs;
+    std::vector<double> m_ys;
+    mpMinMaxPyramid     m_pyramid;
+    double              m_posX = 0.0;
+    double              m_scaleX = 1.0;
+};
+
+
+static bool PlottedTracesEqual( const PLOTTED_TRACE& aGot, const PLOTTED_TRACE& aExpected )
+{
+    if( aGot.m_polyline != aExpected.m_polyline )
+    {
+        BOOST_TEST_MESSAGE( "Polyline not equal: got " << aGot.m_polyline.size()
+                            << " points, expected " << aExpected.m_polyline.size() );
+        return false;
+    }
+
+    if( aGot.m_verticals != aExpected.m_verticals )
+    {
+        BOOST_TEST_MESSAGE( "Vertical lines not equal: got " << aGot.m_verticals.size()
+                            << ", expected " << aExpected.m_verticals.size() );
+        return false;
+    }
+
+    return true;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( MathplotDecimation, DECIMATION_FIXTURE )
+
+
+/**
+ * The extrema of the ranges are the ones of the values
+ */
+BOOST_AUTO_TEST_CASE( MinMax )
+{
+    MakeTrace( 1000 + 7 );
+
+    std::mt19937                          rng( 7 );
+    std::uniform_int_distribution<size_t> index( 0, m_ys.size() - 1 );
+
+    for( int ii = 0; ii < 2000; ii++ )
+    {
+        size_t begin = index( rng );
+        size_t end = std::min( begin + 1 + index( rng ) / ( 1 + ii % 50 ), m_ys.size() );
+
+        BOOST_TEST_CONTEXT( "Range " << begin << " .. " << end )
+        {
+            double minY, maxY;
+            m_pyramid.GetMinMax( m_ys, begin, end, minY, maxY );
+
+            auto expected = std::minmax_element( m_ys.begin() + begin, m_ys.begin() + end );
+
+            BOOST_CHECK_EQUAL( minY, *expected.first );
+            BOOST_CHECK_EQUAL( maxY, *expected.second );
+        }
+    }
+}
+
+
+/**
+ * The decimated traces are plotted as the full traces, at all the zoom levels
+ */
+BOOST_AUTO_TEST_CASE( SameAsFullTrace )
+{
+    for( double duplicateRatio : { 0.0, 0.5 } )
+    {
+        MakeTrace( 100000, duplicateRatio );
+
+        const double length = m_xs.back();
+
+        // From several pixels per point to thousands of points per pixel, and panned views
+        const std::vector<std::pair<double, double>> views = {
+            { 0.0, 1000.0 / length },
+            { -length / 10, 800.0 / length },
+            { length / 3, 1000.0 / length * 50 },
+            { length / 2, 5.0 },
+            { length - 10.0, 20.0 },
+            { length * 2, 1.0 },
+        };
+
+        for( const std::pair<double, double>& view : views )
+        {
+            BOOST_TEST_CONTEXT( "View " << view.first << ", scale " << view.second
+                                << ", duplicates " << duplicateRatio )
+            {
+                SetView( view.first, view.second );
+
+                std::vector<wxPoint> points;
+                PLOTTED_TRACE        decimated = PlotDecimated( 40, 1000, points );
+
+                BOOST_CHECK( PlottedTracesEqual( decimated, PlotFull( 40, 1000 ) ) );
+                BOOST_CHECK_LE( points.size(), 3 * ( 1000 - 40 + 1 ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * The pyramid of a trace extended while it is computed is the pyramid of the whole trace
+ */
+BOOST_AUTO_TEST_CASE( Extend )
+{
+    MakeTrace( 100000 );
+
+    std::vector<double> xs = std::move( m_xs );
+    std::vector<double> ys = std::move( m_ys );
+
+    m_xs.clear();
+    m_ys.clear();
+    m_pyramid.Clear();
+
+    SetView( 0.0, 1000.0 / xs.back() );
+
+    for( size_t count : { 0, 1, 15, 16, 17, 100, 1000, 1001, 50000, 100000 } )
+    {
+        m_xs.insert( m_xs.end(), xs.begin() + m_xs.size(), xs.begin() + count );
+        m_ys.insert( m_ys.end(), ys.begin() + m_ys.size(), ys.begin() + count );
+        m_pyramid.Extend( m_ys );
+
+        BOOST_TEST_CONTEXT( "Extended to " << count << " points" )
+        {
+            std::vector<wxPoint> points;
+            PLOTTED_TRACE        decimated = PlotDecimated( 0, 1000, points );
+
+            BOOST_CHECK( PlottedTracesEqual( decimated, PlotFull( 0, 1000 ) ) );
+
+            if( count > 0 )
+            {
+                double minY, maxY;
+                m_pyramid.GetMinMax( m_ys, 0, count, minY, maxY );
+
+                auto expected = std::minmax_element( m_ys.begin(), m_ys.end() );
+
+                BOOST_CHECK_EQUAL( minY, *expected.first );
+                BOOST_CHECK_EQUAL( maxY, *expected.second );
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for XNODE_WRITER: the documents written while they are built must be the ones
+ * written from their XNODE tree, in both formats
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <xnode.h>
+
+#include <macros.h>
+
+#include <wx/mstream.h>
+
+
+/**
+ * Build a document as the netlist exporters do, with the special characters of both formats
+ */
+static XNODE* makeDocument()
+{
+    auto node = []( const wxString& aName, const wxString& aText = wxEmptyString )
+                {
+                    XNODE* n = new XNODE( wxXML_ELEMENT_NODE, aName );
+
+                    if( !aText.IsEmpty() )
+                        n->AddChild( new XNODE( wxXML_TEXT_NODE, wxEmptyString, aText ) );
+
+                    return n;
+                };
+
+    XNODE* root = node( "export" );
+    root->AddAttribute( "version", "D" );
+
+    XNODE* design = node( "design" );
+    root->AddChild( design );
+    design->AddChild( node( "source", "/home/user/a (copy).kicad_sch" ) );
+    design->AddChild( node( "company" ) );
+
+    XNODE* textvar = node( "textvar", wxString::FromUTF8( "10 \xC2\xB5" "F & <more>" ) );
+    textvar->AddAttribute( "name", "CAP" );
+    design->AddChild( textvar );
+
+    XNODE* comment = node( "comment" );
+    comment->AddAttribute( "number", "1" );
+    comment->AddAttribute( "value", "" );
+    design->AddChild( comment );
+
+    XNODE* comps = node( "components" );
+    root->AddChild( comps );
+
+    XNODE* comp = node( "comp" );
+    comp->AddAttribute( "ref", "U1" );
+    comps->AddChild( comp );
+    comp->AddChild( node( "value", "\"quoted\"\ttab\nline\rreturn" ) );
+
+    XNODE* property = node( "property" );
+    property->AddAttribute( "name", "Note" );
+    property->AddAttribute( "value", "a \"b\"\t<c>\n&d\r" );
+    comp->AddChild( property );
+
+    root->AddChild( node( "libraries" ) );
+
+    return root;
+}
+
+
+/**
+ * Write the tree of aNode with the writer
+ */
+static void writeNode( XNODE* aNode, XNODE_WRITER& aWriter )
+{
+    aWriter.StartElement( TO_UTF8( aNode->GetName() ) );
+
+    for( wxXmlAttribute* attr = aNode->GetAttributes(); attr; attr = attr->GetNext() )
+        aWriter.AddAttribute( TO_UTF8( attr->GetName() ), attr->GetValue() );
+
+    for( XNODE* kid = aNode->GetChildren(); kid; kid = kid->GetNext() )
+    {
+        if( kid->GetType() == wxXML_TEXT_NODE )
+            aWriter.AddText( kid->GetContent() );
+        else
+            writeNode( kid, aWriter );
+    }
+
+    aWriter.EndElement();
+}
+
+
+BOOST_AUTO_TEST_SUITE( XNodeWriter )
+
+
+/**
+ * The S-expressions are the ones of XNODE::Format()
+ */
+BOOST_AUTO_TEST_CASE( SexprFormat )
+{
+    std::unique_ptr<XNODE> root( makeDocument() );
+
+    STRING_FORMATTER expected;
+    root->Format( &expected, 0 );
+
+    STRING_FORMATTER written;
+    XNODE_WRITER     writer( &written, XNODE_WRITER::SEXPR );
+    writeNode( root.get(), writer );
+
+    BOOST_CHECK_EQUAL( written.GetString(), expected.GetString() );
+}
+
+
+/**
+ * The XML documents are the ones of wxXmlDocument::Save()
+ */
+BOOST_AUTO_TEST_CASE( XmlFormat )
+{
+    XNODE* root = makeDocument();
+
+    STRING_FORMATTER written;
+    XNODE_WRITER     writer( &written, XNODE_WRITER::XML );
+    writeNode( root, writer );
+
+    wxXmlDocument        xdoc;
+    wxMemoryOutputStream stream;
+
+    xdoc.SetRoot( root );
+    BOOST_REQUIRE( xdoc.Save( stream, 2 ) );
+
+    std::string expected( stream.GetLength(), '\0' );
+    stream.CopyTo( &expected[0], expected.size() );
+
+    BOOST_CHECK_EQUAL( written.GetString(), expected );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
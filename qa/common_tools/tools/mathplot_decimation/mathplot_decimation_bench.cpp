@@ -0,0 +1,248 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the decimation of the large traces of the plots: the points of a
+ * generated trace are converted to pixels and merged as mpFXY::Plot does, with and without
+ * mpMinMaxPyramid::Decimate, at several zoom levels.
+ *
+ * Typical use:
+ *    qa_common_tools mathplot_decimation -v -n 10000000 -r 5
+ */
+
+#include <widgets/mathplot.h>
+
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <wx/cmdline.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+
+/**
+ * The lines plotted for a trace in continuous mode: the polyline through the first point of
+ * each pixel column, and the vertical lines of the merged points.
+ */
+struct PLOTTED_TRACE
+{
+    std::vector<wxPoint>                     m_polyline;
+    std::vector<std::pair<wxPoint, wxPoint>> m_verticals;
+
+    bool operator==( const PLOTTED_TRACE& aOther ) const
+    {
+        return m_polyline == aOther.m_polyline && m_verticals == aOther.m_verticals;
+    }
+};
+
+
+/**
+ * Merge the points of the pixel columns aStartPx .. aEndPx as mpFXY::Plot does
+ */
+static PLOTTED_TRACE mergePoints( const std::vector<wxPoint>& aPoints, wxCoord aStartPx,
+                                  wxCoord aEndPx )
+{
+    PLOTTED_TRACE trace;
+    wxCoord       ymin = 0, ymax = 0;
+    int           dup = 0;
+
+    auto flushVertical =
+            [&]()
+            {
+                if( !trace.m_polyline.empty() && dup > 1 && ymin != ymax )
+                {
+                    wxCoord x = trace.m_polyline.back().x;
+                    trace.m_verticals.emplace_back( wxPoint( x, ymin ), wxPoint( x, ymax ) );
+                }
+            };
+
+    for( const wxPoint& point : aPoints )
+    {
+        if( point.x < aStartPx || point.x > aEndPx )
+            continue;
+
+        if( trace.m_polyline.empty() || trace.m_polyline.back().x != point.x )
+        {
+            flushVertical();
+            ymin = ymax = point.y;
+            dup = 0;
+            trace.m_polyline.push_back( point );
+        }
+        else
+        {
+            ymin = std::min( ymin, point.y );
+            ymax = std::max( ymax, point.y );
+            dup++;
+        }
+    }
+
+    flushVertical();
+    return trace;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print the plot times" ).mb_str() },
+    { wxCMD_LINE_OPTION, "n", "points", _( "number of points of the trace (default 10M)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum DECIMATION_RET_CODES
+{
+    PLOT_MISMATCH = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int mathplot_decimation_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the plot of a large trace, with and without the "
+               "decimation of its points to the screen resolution." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long count = 10 * 1000 * 1000;
+    cl_parser.Found( "points", &count );
+    count = std::max( count, 2L );
+
+    long reps = 5;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    std::mt19937                           rng( 42 );
+    std::uniform_real_distribution<double> step( 0.0, 2.0 );
+    std::uniform_real_distribution<double> noise( -0.2, 0.2 );
+
+    std::vector<double> xs( count );
+    std::vector<double> ys( count );
+    double              x = 0.0;
+
+    for( long ii = 0; ii < count; ii++ )
+    {
+        x += step( rng );
+        xs[ii] = x;
+        ys[ii] = std::sin( x * 0.001 ) + noise( rng );
+    }
+
+    mpMinMaxPyramid pyramid;
+
+    PROF_COUNTER buildTimer;
+    pyramid.Build( ys );
+    double buildMs = buildTimer.msecs();
+
+    if( verbose )
+    {
+        std::cout << "Trace of " << count << " points, pyramid built in " << buildMs << "ms"
+                  << std::endl;
+    }
+
+    const wxCoord startPx = 0;
+    const wxCoord endPx = 1920;
+    const double  length = xs.back();
+    bool          mismatch = false;
+
+    for( double zoom : { 1.0, 10.0, 1000.0 } )
+    {
+        const double posX = length / 2 - length / zoom / 2;
+        const double scaleX = endPx * zoom / length;
+
+        auto toPixelX =
+                [&]( double aX )
+                {
+                    return (wxCoord) ( ( aX - posX ) * scaleX );
+                };
+
+        auto toPixelY =
+                []( double aY )
+                {
+                    return (wxCoord) ( ( 1.5 - aY ) * 200.0 );
+                };
+
+        double               fullMs = 0.0, decimatedMs = 0.0;
+        PLOTTED_TRACE        full, decimated;
+        std::vector<wxPoint> points;
+
+        for( long rep = 0; rep < reps; ++rep )
+        {
+            PROF_COUNTER fullTimer;
+            points.clear();
+
+            for( long ii = 0; ii < count; ii++ )
+                points.emplace_back( toPixelX( xs[ii] ), toPixelY( ys[ii] ) );
+
+            full = mergePoints( points, startPx, endPx );
+            fullMs += fullTimer.msecs();
+
+            PROF_COUNTER decimatedTimer;
+            points.clear();
+            pyramid.Decimate( xs, ys, toPixelX, toPixelY, startPx, endPx, points );
+            decimated = mergePoints( points, startPx, endPx );
+            decimatedMs += decimatedTimer.msecs();
+        }
+
+        if( !( decimated == full ) )
+        {
+            std::cerr << "Zoom " << zoom << ": the decimated trace is not the full trace"
+                      << std::endl;
+            mismatch = true;
+        }
+
+        if( verbose )
+        {
+            std::cout << "Zoom " << zoom << ": full trace " << fullMs / reps << "ms, decimated "
+                      << decimatedMs / reps << "ms (" << points.size() << " points)"
+                      << std::endl;
+        }
+    }
+
+    if( mismatch )
+        return DECIMATION_RET_CODES::PLOT_MISMATCH;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "mathplot_decimation",
+        "Benchmark the decimation of the large traces of the plots",
+        mathplot_decimation_main_func } );
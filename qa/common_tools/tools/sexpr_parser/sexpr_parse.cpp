@@ -38,6 +38,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <utility>
 
 
 class QA_SEXPR_PARSER
@@ -61,7 +62,29 @@ public:
         if( m_verbose )
             std::cout << "S-Expression Parsing took " << timer.msecs() << "ms" << std::endl;
 
-        return sexpr != nullptr;
+        if( !m_verbose )
+            return sexpr != nullptr;
+
+        // Compare with the document parsing, including the release of the trees
+        PROF_COUNTER releaseTimer;
+        sexpr.reset();
+        std::cout << "S-Expression release took " << releaseTimer.msecs() << "ms" << std::endl;
+
+        // ParseDocument() keeps its text: it is copied before the timing
+        std::string docText = sexpr_str;
+
+        PROF_COUNTER docTimer;
+        auto         doc = m_parser.ParseDocument( std::move( docText ) );
+        std::cout << "S-Expression document parsing took " << docTimer.msecs() << "ms"
+                  << std::endl;
+
+        PROF_COUNTER docReleaseTimer;
+        bool         ok = doc->GetRoot() != nullptr;
+        doc.reset();
+        std::cout << "S-Expression document release took " << docReleaseTimer.msecs() << "ms"
+                  << std::endl;
+
+        return ok;
     }
 
 private:
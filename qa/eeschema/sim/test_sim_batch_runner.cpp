@@ -0,0 +1,198 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for SIM_BATCH_RUNNER: the runs of the sweeps and Monte Carlo analyses, their
+ * netlists and the parsing of the raw files written by ngspice
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sim/sim_batch_runner.h>
+
+
+static const std::string NETLIST = ".title KiCad schematic\n"
+                                   "R1 in out 1k\n"
+                                   "C1 out 0 10n\n"
+                                   "V1 in 0 dc 0 ac 1\n"
+                                   ".tran 1u 1m\n"
+                                   ".end\n";
+
+
+class TEST_SIM_BATCH_RUNNER
+{
+public:
+    TEST_SIM_BATCH_RUNNER() :
+            m_runner( NETLIST, { "V(out)", "I(V1)" } )
+    {
+        m_runner.AddParam( "r1", SPICE_VALUE( "1k" ), SPICE_VALUE( "2k" ) );
+        m_runner.AddParam( "c1", SPICE_VALUE( "10n" ), SPICE_VALUE( "30n" ) );
+    }
+
+    SIM_BATCH_RUNNER m_runner;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( SimBatchRunner, TEST_SIM_BATCH_RUNNER )
+
+
+/**
+ * A sweep runs all the combinations of the values of the parameters
+ */
+BOOST_AUTO_TEST_CASE( SweepRuns )
+{
+    m_runner.CreateSweepRuns( 3 );
+
+    const std::vector<SIM_BATCH_RUNNER::RUN>& runs = m_runner.GetRuns();
+
+    BOOST_REQUIRE_EQUAL( runs.size(), 9 );
+
+    const std::vector<double> r1 = { 1e3, 1.5e3, 2e3 };
+    const std::vector<double> c1 = { 10e-9, 20e-9, 30e-9 };
+
+    for( size_t ii = 0; ii < runs.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Run " << ii )
+        {
+            BOOST_REQUIRE_EQUAL( runs[ii].m_values.size(), 2 );
+            BOOST_CHECK_CLOSE( runs[ii].m_values[0].ToDouble(), r1[ii % 3], 1e-9 );
+            BOOST_CHECK_CLOSE( runs[ii].m_values[1].ToDouble(), c1[ii / 3], 1e-9 );
+        }
+    }
+}
+
+
+/**
+ * The Monte Carlo values are within the ranges of the parameters, and reproducible
+ */
+BOOST_AUTO_TEST_CASE( MonteCarloRuns )
+{
+    m_runner.CreateMonteCarloRuns( 100, 42 );
+
+    std::vector<SIM_BATCH_RUNNER::RUN> runs = m_runner.GetRuns();
+
+    BOOST_REQUIRE_EQUAL( runs.size(), 100 );
+
+    for( const SIM_BATCH_RUNNER::RUN& run : runs )
+    {
+        BOOST_CHECK( run.m_values[0].ToDouble() >= 1e3 && run.m_values[0].ToDouble() <= 2e3 );
+        BOOST_CHECK( run.m_values[1].ToDouble() >= 10e-9
+                     && run.m_values[1].ToDouble() <= 30e-9 );
+    }
+
+    m_runner.CreateMonteCarloRuns( 100, 42 );
+
+    for( size_t ii = 0; ii < runs.size(); ++ii )
+        BOOST_CHECK( runs[ii].m_values[0] == m_runner.GetRuns()[ii].m_values[0] );
+}
+
+
+/**
+ * The netlist of a run alters the parameters, runs the simulation and writes the vectors
+ */
+BOOST_AUTO_TEST_CASE( RunNetlist )
+{
+    m_runner.CreateSweepRuns( 2 );
+
+    const std::string expected = ".title KiCad schematic\n"
+                                 "R1 in out 1k\n"
+                                 "C1 out 0 10n\n"
+                                 "V1 in 0 dc 0 ac 1\n"
+                                 ".tran 1u 1m\n"
+                                 ".control\n"
+                                 "alter @r1=2k\n"
+                                 "alter @c1=10n\n"
+                                 "run\n"
+                                 "set filetype=ascii\n"
+                                 "write \"run.raw\" V(out) I(V1)\n"
+                                 ".endc\n"
+                                 ".end\n";
+
+    BOOST_CHECK_EQUAL( m_runner.GetRunNetlist( 1, "run.raw" ), expected );
+}
+
+
+/**
+ * The real and complex vectors of the ASCII raw files are read
+ */
+BOOST_AUTO_TEST_CASE( ParseRawData )
+{
+    const std::string real = "Title: KiCad schematic\n"
+                             "Date: Thu Oct 15 10:00:00  2020\n"
+                             "Plotname: Transient Analysis\n"
+                             "Flags: real\n"
+                             "No. Variables: 3\n"
+                             "No. Points: 2\n"
+                             "Variables:\n"
+                             "\t0\ttime\ttime\n"
+                             "\t1\tv(out)\tvoltage\n"
+                             "\t2\ti(v1)\tcurrent\n"
+                             "Values:\n"
+                             " 0\t0.000000000000000e+00\n"
+                             "\t1.000000000000000e+00\n"
+                             "\t-2.500000000000000e-03\n"
+                             "\n"
+                             " 1\t1.000000000000000e-06\n"
+                             "\t9.990000000000000e-01\n"
+                             "\t-2.400000000000000e-03\n"
+                             "\n";
+
+    std::vector<std::vector<COMPLEX>> vectors;
+    bool                              complex = true;
+
+    BOOST_REQUIRE( SIM_BATCH_RUNNER::ParseRawData( real, vectors, complex ) );
+    BOOST_CHECK( !complex );
+    BOOST_REQUIRE_EQUAL( vectors.size(), 3 );
+    BOOST_REQUIRE_EQUAL( vectors[0].size(), 2 );
+    BOOST_CHECK_EQUAL( vectors[0][1].real(), 1e-6 );
+    BOOST_CHECK_EQUAL( vectors[1][1].real(), 0.999 );
+    BOOST_CHECK_EQUAL( vectors[2][0].real(), -2.5e-3 );
+
+    const std::string ac = "Title: KiCad schematic\n"
+                           "Plotname: AC Analysis\n"
+                           "Flags: complex\n"
+                           "No. Variables: 2\n"
+                           "No. Points: 1\n"
+                           "Variables:\n"
+                           "\t0\tfrequency\tfrequency grid=3\n"
+                           "\t1\tv(out)\tvoltage\n"
+                           "Values:\n"
+                           " 0\t1.000000000000000e+03,0.000000000000000e+00\n"
+                           "\t5.000000000000000e-01,-5.000000000000000e-01\n";
+
+    BOOST_REQUIRE( SIM_BATCH_RUNNER::ParseRawData( ac, vectors, complex ) );
+    BOOST_CHECK( complex );
+    BOOST_REQUIRE_EQUAL( vectors.size(), 2 );
+    BOOST_CHECK_EQUAL( vectors[0][0].real(), 1e3 );
+    BOOST_CHECK_EQUAL( vectors[1][0].imag(), -0.5 );
+
+    // A file truncated by a failed simulation
+    BOOST_CHECK( !SIM_BATCH_RUNNER::ParseRawData( real.substr( 0, real.size() - 30 ), vectors,
+                                                  complex ) );
+    BOOST_CHECK( !SIM_BATCH_RUNNER::ParseRawData( "", vectors, complex ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,243 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for LIB_TABLE_PRELOADER: the libraries of a symbol library table are loaded by
+ * the worker threads, and the modified libraries are reloaded
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <lib_table_preloader.h>
+
+#include <symbol_lib_table.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#include <functional>
+
+
+/**
+ * Record the events of the preloader
+ */
+class LIBRARY_EVENTS : public wxEvtHandler
+{
+public:
+    LIBRARY_EVENTS()
+    {
+        Bind( EDA_EVT_LIBRARY_PRELOADED,
+              [this]( wxCommandEvent& aEvent )
+              {
+                  m_preloaded.push_back( aEvent.GetString() );
+              } );
+
+        Bind( EDA_EVT_LIBRARY_UPDATED,
+              [this]( wxCommandEvent& aEvent )
+              {
+                  m_updated.push_back( aEvent.GetString() );
+              } );
+    }
+
+    std::vector<wxString> m_preloaded;
+    std::vector<wxString> m_updated;
+};
+
+
+class LIB_TABLE_PRELOADER_FIXTURE
+{
+public:
+    LIB_TABLE_PRELOADER_FIXTURE() :
+            m_tempFileName( wxFileName::CreateTempFileName( "kicad_preload_test" ) ),
+            m_fileName( m_tempFileName + ".kicad_sym" )
+    {
+        WriteLib( { "R" } );
+        m_table.InsertRow( new SYMBOL_LIB_TABLE_ROW( "test", m_fileName, "KiCad" ) );
+        m_preloader.AddListener( &m_listener );
+    }
+
+    ~LIB_TABLE_PRELOADER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+        wxRemoveFile( m_tempFileName );
+    }
+
+    /**
+     * Write the library with the symbols \a aNames, and move its modification time
+     * \a aAge seconds in the past
+     */
+    void WriteLib( const std::vector<std::string>& aNames, int aAge = 60 )
+    {
+        std::string content = "(kicad_symbol_lib (version 20200827) (generator test)\n";
+
+        for( const std::string& name : aNames )
+        {
+            content += "  (symbol \"" + name + "\" (in_bom yes) (on_board yes)\n"
+                       "    (property \"Value\" \"" + name + "\" (id 1) (at 0 0 0)))\n";
+        }
+
+        content += ")\n";
+
+        {
+            wxFFile file( m_fileName, "wb" );
+            file.Write( content.data(), content.size() );
+        }
+
+        wxDateTime modTime = wxDateTime::Now() - wxTimeSpan::Seconds( aAge );
+        wxFileName( m_fileName ).SetTimes( nullptr, &modTime, nullptr );
+    }
+
+    /**
+     * Process the events of the preloader and of the listener until \a aDone returns true,
+     * for at most \a aTimeout ms
+     */
+    bool WaitFor( const std::function<bool()>& aDone, int aTimeout = 10000 )
+    {
+        for( int ii = 0; ii < aTimeout / 10; ++ii )
+        {
+            m_preloader.ProcessPendingEvents();
+            m_listener.ProcessPendingEvents();
+
+            if( aDone() )
+                return true;
+
+            wxMilliSleep( 10 );
+        }
+
+        return false;
+    }
+
+    wxArrayString SymbolNames()
+    {
+        wxArrayString names;
+        m_table.EnumerateSymbolLib( "test", names );
+        return names;
+    }
+
+    wxString            m_tempFileName;     ///< The file created by CreateTempFileName().
+    wxString            m_fileName;
+    LIBRARY_EVENTS      m_listener;
+    LIB_TABLE_PRELOADER m_preloader;
+
+    // Deleted before the preloader, which it unregisters from
+    SYMBOL_LIB_TABLE    m_table;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( LibTablePreloader, LIB_TABLE_PRELOADER_FIXTURE )
+
+
+/**
+ * The libraries are loaded by the workers, and the listeners are notified
+ */
+BOOST_AUTO_TEST_CASE( Preload )
+{
+    m_preloader.Preload( &m_table );
+
+    BOOST_REQUIRE( WaitFor(
+            [&]()
+            {
+                return !m_listener.m_preloaded.empty();
+            } ) );
+
+    BOOST_CHECK( m_preloader.IsLibraryReady( &m_table, "test" ) );
+    BOOST_CHECK( m_table.IsSymbolLibLoaded( "test" ) );
+    BOOST_CHECK_EQUAL( m_listener.m_preloaded[0], "test" );
+
+    wxArrayString names = SymbolNames();
+
+    BOOST_REQUIRE_EQUAL( names.size(), 1 );
+    BOOST_CHECK_EQUAL( names[0], "R" );
+}
+
+
+/**
+ * Only the modified libraries are reloaded, on the main thread
+ */
+BOOST_AUTO_TEST_CASE( Reload )
+{
+    m_preloader.Preload( &m_table );
+
+    BOOST_REQUIRE( WaitFor(
+            [&]()
+            {
+                return !m_listener.m_preloaded.empty();
+            } ) );
+
+    // The check of an unchanged library does not reload it
+    m_preloader.CheckLibraries();
+    WaitFor(
+            []()
+            {
+                return false;
+            },
+            200 );
+
+    BOOST_CHECK( m_listener.m_updated.empty() );
+
+    WriteLib( { "C", "R" }, 0 );
+    m_preloader.CheckLibraries();
+
+    BOOST_REQUIRE( WaitFor(
+            [&]()
+            {
+                return !m_listener.m_updated.empty();
+            } ) );
+
+    BOOST_CHECK_EQUAL( m_listener.m_updated[0], "test" );
+
+    wxArrayString names = SymbolNames();
+
+    BOOST_REQUIRE_EQUAL( names.size(), 2 );
+    BOOST_CHECK_EQUAL( names[0], "C" );
+    BOOST_CHECK_EQUAL( names[1], "R" );
+}
+
+
+/**
+ * The libraries already used by the main thread are not reloaded by the workers, even when
+ * they were modified since
+ */
+BOOST_AUTO_TEST_CASE( LibraryInUse )
+{
+    BOOST_REQUIRE_EQUAL( SymbolNames().size(), 1 );
+
+    int modifyHash = m_table.GetModifyHash();
+
+    WriteLib( { "C", "R" }, 0 );
+    m_preloader.Preload( &m_table );
+
+    BOOST_REQUIRE( WaitFor(
+            [&]()
+            {
+                return !m_listener.m_preloaded.empty();
+            } ) );
+
+    BOOST_CHECK_EQUAL( m_table.GetModifyHash(), modifyHash );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
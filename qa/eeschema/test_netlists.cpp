@@ -75,6 +75,23 @@ static wxString getSchematicFile( const wxString& aBaseName )
 }
 
 
+/**
+ * Count the items of type aType
+ */
+static int countItems( EE_RTREE& aItems, KICAD_T aType )
+{
+    int count = 0;
+
+    for( SCH_ITEM* item : aItems.OfType( aType ) )
+    {
+        (void) item;
+        count++;
+    }
+
+    return count;
+}
+
+
 void TEST_NETLISTS_FIXTURE::loadSchematic( const wxString& aBaseName )
 {
     wxString fn = getSchematicFile( aBaseName );
@@ -241,6 +258,80 @@ BOOST_AUTO_TEST_CASE( ComplexHierarchy )
 }
 
 
+BOOST_AUTO_TEST_CASE( ComplexHierarchyScreens )
+{
+    loadSchematic( "complex_hierarchy" );
+
+    // The sub-sheets are parsed in parallel: the sheets of the same file must still share
+    // the screen, and belong to the screen of their parent sheet
+    SCH_SCREENS screens( m_schematic.Root() );
+
+    BOOST_CHECK_EQUAL( screens.GetCount(), 2 );
+
+    std::vector<SCH_SHEET*> subSheets;
+
+    for( SCH_ITEM* item : m_schematic.RootScreen()->Items().OfType( SCH_SHEET_T ) )
+        subSheets.push_back( static_cast<SCH_SHEET*>( item ) );
+
+    BOOST_REQUIRE_EQUAL( subSheets.size(), 2 );
+    BOOST_CHECK_EQUAL( subSheets[0]->GetScreen(), subSheets[1]->GetScreen() );
+    BOOST_CHECK_EQUAL( subSheets[0]->GetScreen()->GetRefCount(), 2 );
+    BOOST_CHECK( subSheets[0]->GetParent() == m_schematic.RootScreen() );
+    BOOST_CHECK( subSheets[1]->GetParent() == m_schematic.RootScreen() );
+}
+
+
+BOOST_AUTO_TEST_CASE( VideoScreens )
+{
+    loadSchematic( "video" );
+
+    // The 7 sub-sheets of the root sheet are distinct files, parsed by several threads: each
+    // sheet must get the screen of its own file, with the items of this file
+    SCH_SCREENS screens( m_schematic.Root() );
+
+    BOOST_CHECK_EQUAL( screens.GetCount(), 8 );
+
+    std::vector<SCH_SHEET*> subSheets;
+
+    for( SCH_ITEM* item : m_schematic.RootScreen()->Items().OfType( SCH_SHEET_T ) )
+        subSheets.push_back( static_cast<SCH_SHEET*>( item ) );
+
+    BOOST_REQUIRE_EQUAL( subSheets.size(), 7 );
+
+    SCH_PLUGIN::SCH_PLUGIN_RELEASER pi( SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD ) );
+
+    for( SCH_SHEET* sheet : subSheets )
+    {
+        BOOST_TEST_CONTEXT( sheet->GetFileName() )
+        {
+            SCH_SCREEN* screen = sheet->GetScreen();
+
+            BOOST_REQUIRE( screen );
+            BOOST_CHECK_EQUAL( screen->GetRefCount(), 1 );
+            BOOST_CHECK( sheet->GetParent() == m_schematic.RootScreen() );
+            BOOST_CHECK_EQUAL( wxFileName( screen->GetFileName() ).GetFullName(),
+                               sheet->GetFileName() );
+
+            // The file parsed alone, without any thread
+            std::unique_ptr<SCH_SHEET> alone( pi->Load( screen->GetFileName(), &m_schematic ) );
+
+            BOOST_REQUIRE( alone && alone->GetScreen() );
+
+            EE_RTREE& items = screen->Items();
+            EE_RTREE& aloneItems = alone->GetScreen()->Items();
+
+            BOOST_CHECK_EQUAL( items.size(), aloneItems.size() );
+
+            for( KICAD_T type : { SCH_COMPONENT_T, SCH_LINE_T, SCH_LABEL_T, SCH_GLOBAL_LABEL_T,
+                                  SCH_HIER_LABEL_T, SCH_JUNCTION_T, SCH_NO_CONNECT_T } )
+            {
+                BOOST_CHECK_EQUAL( countItems( items, type ), countItems( aloneItems, type ) );
+            }
+        }
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE( WeakVectorBusDisambiguation )
 {
     doNetlistTest( "weak_vector_bus_disambiguation" );
@@ -0,0 +1,486 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Test suite for SCH_REFERENCE_LIST::Annotate(): the annotation of a multi-unit, multi-sheet
+ * schematic is the one of the annotation before the references were indexed
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+#include "eeschema_test_utils.h"
+
+// Code under test
+#include <sch_reference_list.h>
+
+#include <class_libentry.h>
+#include <project.h>
+#include <sch_io_mgr.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <schematic.h>
+#include <settings/settings_manager.h>
+#include <wildcards_and_files_ext.h>
+
+#include <unordered_set>
+
+
+/**
+ * The annotation state of a reference, for the annotation as it was done before
+ */
+struct REF_STATE
+{
+    int  m_NumRef;
+    int  m_Unit;
+    bool m_IsNew;
+    int  m_Flag;
+    int  m_SheetNum;
+};
+
+
+/**
+ * The annotation of SCH_REFERENCE_LIST::Annotate() before the references were indexed: the
+ * whole list is searched for the numbers in use, the units and the locked units.
+ *
+ * The annotation state is kept in aState, as the members of SCH_REFERENCE are private; aList
+ * only provides the data which is not changed by the annotation.
+ */
+class SEQUENTIAL_ANNOTATION
+{
+public:
+    SEQUENTIAL_ANNOTATION( SCH_REFERENCE_LIST& aList, std::vector<REF_STATE>& aState ) :
+            m_list( aList ),
+            m_state( aState )
+    {
+    }
+
+    void Annotate( bool aUseSheetNum, int aSheetIntervalId, int aStartNumber,
+                   SCH_MULTI_UNIT_REFERENCE_MAP& aLockedUnitMap )
+    {
+        if( m_list.GetCount() == 0 )
+            return;
+
+        unsigned first = 0;
+        int      minRefId;
+
+        if( aUseSheetNum )
+            minRefId = m_state[first].m_SheetNum * aSheetIntervalId + 1;
+        else
+            minRefId = aStartNumber + 1;
+
+        std::unordered_set<wxString> inUseRefs;
+        std::vector<int>             idList;
+
+        getRefsInUse( first, idList, minRefId );
+
+        for( unsigned ii = 0; ii < m_list.GetCount(); ii++ )
+        {
+            SCH_REFERENCE& ref_unit = m_list[ii];
+            REF_STATE&     state = m_state[ii];
+
+            if( state.m_Flag )
+                continue;
+
+            SCH_REFERENCE_LIST* lockedList = nullptr;
+
+            for( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair : aLockedUnitMap )
+            {
+                for( unsigned thisRefI = 0; thisRefI < pair.second.GetCount(); ++thisRefI )
+                {
+                    if( pair.second[thisRefI].IsSameInstance( ref_unit ) )
+                    {
+                        lockedList = &pair.second;
+                        break;
+                    }
+                }
+
+                if( lockedList )
+                    break;
+            }
+
+            if( m_list[first].CompareRef( ref_unit ) != 0
+                    || ( aUseSheetNum && m_state[first].m_SheetNum != state.m_SheetNum ) )
+            {
+                first = ii;
+
+                if( aUseSheetNum )
+                    minRefId = state.m_SheetNum * aSheetIntervalId + 1;
+                else
+                    minRefId = aStartNumber + 1;
+
+                getRefsInUse( first, idList, minRefId );
+            }
+
+            if( ref_unit.GetLibPart()->GetUnitCount() <= 1 )
+            {
+                if( state.m_IsNew )
+                    state.m_NumRef = createFirstFreeRefId( idList, minRefId );
+
+                state.m_Unit = 1;
+                state.m_Flag = 1;
+                state.m_IsNew = false;
+                continue;
+            }
+
+            int numberOfUnits = ref_unit.GetLibPart()->GetUnitCount();
+
+            if( state.m_IsNew )
+            {
+                state.m_NumRef = createFirstFreeRefId( idList, minRefId );
+
+                if( !ref_unit.IsUnitsLocked() )
+                    state.m_Unit = 1;
+
+                state.m_Flag = 1;
+            }
+
+            if( lockedList )
+            {
+                for( unsigned thisRefI = 0; thisRefI < lockedList->GetCount(); ++thisRefI )
+                {
+                    SCH_REFERENCE& thisRef = ( *lockedList )[thisRefI];
+
+                    if( thisRef.IsSameInstance( ref_unit ) )
+                    {
+                        state.m_Unit = thisRef.GetUnit();
+                        inUseRefs.insert( fullReference( ii, state.m_Unit ) );
+                    }
+
+                    if( thisRef.CompareValue( ref_unit ) != 0 )
+                        continue;
+
+                    if( thisRef.CompareLibName( ref_unit ) != 0 )
+                        continue;
+
+                    for( unsigned jj = ii + 1; jj < m_list.GetCount(); jj++ )
+                    {
+                        if( !thisRef.IsSameInstance( m_list[jj] ) )
+                            continue;
+
+                        wxString candidate = fullReference( ii, thisRef.GetUnit() );
+
+                        if( inUseRefs.find( candidate ) == inUseRefs.end() )
+                        {
+                            m_state[jj].m_NumRef = state.m_NumRef;
+                            m_state[jj].m_Unit = thisRef.GetUnit();
+                            m_state[jj].m_IsNew = false;
+                            m_state[jj].m_Flag = 1;
+                            inUseRefs.insert( candidate );
+                            break;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                for( int unit = 1; unit <= numberOfUnits; unit++ )
+                {
+                    if( state.m_Unit == unit )
+                        continue;
+
+                    if( findUnit( ii, unit ) >= 0 )
+                        continue;
+
+                    for( unsigned jj = ii + 1; jj < m_list.GetCount(); jj++ )
+                    {
+                        SCH_REFERENCE& cmp_unit = m_list[jj];
+                        REF_STATE&     cmp_state = m_state[jj];
+
+                        if( cmp_state.m_Flag )
+                            continue;
+
+                        if( cmp_unit.CompareRef( ref_unit ) != 0 )
+                            continue;
+
+                        if( cmp_unit.CompareValue( ref_unit ) != 0 )
+                            continue;
+
+                        if( cmp_unit.CompareLibName( ref_unit ) != 0 )
+                            continue;
+
+                        if( aUseSheetNum
+                                && cmp_unit.GetSheetPath().Cmp( ref_unit.GetSheetPath() ) != 0 )
+                        {
+                            continue;
+                        }
+
+                        if( !cmp_state.m_IsNew )
+                            continue;
+
+                        if( !cmp_unit.IsUnitsLocked() || cmp_state.m_Unit == unit )
+                        {
+                            cmp_state.m_NumRef = state.m_NumRef;
+                            cmp_state.m_Unit = unit;
+                            cmp_state.m_Flag = 1;
+                            cmp_state.m_IsNew = false;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    wxString fullReference( unsigned aIndex, int aUnit ) const
+    {
+        wxString fullref = m_list[aIndex].GetRef();
+
+        if( m_state[aIndex].m_NumRef < 0 )
+            fullref << "?";
+        else
+            fullref << m_state[aIndex].m_NumRef;
+
+        fullref << ".." << aUnit;
+        return fullref;
+    }
+
+    int findUnit( unsigned aIndex, int aUnit ) const
+    {
+        for( unsigned ii = 0; ii < m_list.GetCount(); ii++ )
+        {
+            if( aIndex == ii || m_state[ii].m_IsNew
+                    || m_state[ii].m_NumRef != m_state[aIndex].m_NumRef
+                    || m_list[aIndex].CompareRef( m_list[ii] ) != 0 )
+            {
+                continue;
+            }
+
+            if( m_state[ii].m_Unit == aUnit )
+                return (int) ii;
+        }
+
+        return -1;
+    }
+
+    void getRefsInUse( unsigned aIndex, std::vector<int>& aIdList, int aMinRefId ) const
+    {
+        aIdList.clear();
+
+        for( unsigned ii = 0; ii < m_list.GetCount(); ii++ )
+        {
+            if( m_list[aIndex].CompareRef( m_list[ii] ) == 0 && m_state[ii].m_NumRef >= aMinRefId )
+                aIdList.push_back( m_state[ii].m_NumRef );
+        }
+
+        std::sort( aIdList.begin(), aIdList.end() );
+        aIdList.erase( std::unique( aIdList.begin(), aIdList.end() ), aIdList.end() );
+    }
+
+    static int createFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+    {
+        int      expectedId = aFirstValue;
+        unsigned ii = 0;
+
+        for( ; ii < aIdList.size(); ii++ )
+        {
+            if( expectedId <= aIdList[ii] )
+                break;
+        }
+
+        for( ; ii < aIdList.size(); ii++ )
+        {
+            if( expectedId != aIdList[ii] )
+            {
+                aIdList.insert( aIdList.begin() + ii, expectedId );
+                return expectedId;
+            }
+
+            expectedId++;
+        }
+
+        aIdList.push_back( expectedId );
+        return expectedId;
+    }
+
+    SCH_REFERENCE_LIST&     m_list;
+    std::vector<REF_STATE>& m_state;
+};
+
+
+class TEST_SCH_REFERENCE_LIST_FIXTURE
+{
+public:
+    TEST_SCH_REFERENCE_LIST_FIXTURE() :
+            m_schematic( nullptr ),
+            m_manager( true )
+    {
+        m_pi = SCH_IO_MGR::FindPlugin( SCH_IO_MGR::SCH_KICAD );
+    }
+
+    void loadSchematic( const wxString& aBaseName );
+
+    /**
+     * Annotate the references of the schematic with SCH_REFERENCE_LIST::Annotate() and with
+     * the sequential annotation, and check the results are the same
+     *
+     * @param aResetStep is the step of the references which are not annotated (1 for all)
+     */
+    void checkAnnotation( int aResetStep, bool aSortByX, bool aUseSheetNum, bool aLockUnits );
+
+    SCHEMATIC        m_schematic;
+    SCH_PLUGIN*      m_pi;
+    SETTINGS_MANAGER m_manager;
+};
+
+
+void TEST_SCH_REFERENCE_LIST_FIXTURE::loadSchematic( const wxString& aBaseName )
+{
+    wxFileName fn = KI_TEST::GetEeschemaTestDataDir();
+    fn.AppendDir( "netlists" );
+    fn.AppendDir( aBaseName );
+    fn.SetName( aBaseName );
+    fn.SetExt( KiCadSchematicFileExtension );
+
+    wxFileName pro( fn );
+    pro.SetExt( ProjectFileExtension );
+
+    m_manager.LoadProject( pro.GetFullPath() );
+    m_manager.Prj().SetElem( PROJECT::ELEM_SCH_PART_LIBS, nullptr );
+
+    m_schematic.Reset();
+    m_schematic.SetProject( &m_manager.Prj() );
+    m_schematic.SetRoot( m_pi->Load( fn.GetFullPath(), &m_schematic ) );
+
+    BOOST_REQUIRE_EQUAL( m_pi->GetError().IsEmpty(), true );
+
+    m_schematic.CurrentSheet().push_back( &m_schematic.Root() );
+
+    SCH_SCREENS screens( m_schematic.Root() );
+
+    for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        screen->UpdateLocalLibSymbolLinks();
+
+    SCH_SHEET_LIST sheets = m_schematic.GetSheets();
+
+    sheets.UpdateSymbolInstances( m_schematic.RootScreen()->GetSymbolInstances() );
+
+    for( SCH_SHEET_PATH& sheet : sheets )
+        sheet.UpdateAllScreenReferences();
+}
+
+
+void TEST_SCH_REFERENCE_LIST_FIXTURE::checkAnnotation( int aResetStep, bool aSortByX,
+                                                       bool aUseSheetNum, bool aLockUnits )
+{
+    SCH_SHEET_LIST               sheets = m_schematic.GetSheets();
+    SCH_REFERENCE_LIST           references;
+    SCH_MULTI_UNIT_REFERENCE_MAP lockedUnitMap;
+
+    sheets.GetComponents( references, false );
+
+    if( aLockUnits )
+        sheets.GetMultiUnitComponents( lockedUnitMap, false );
+
+    // Clear the annotation of some references
+    for( unsigned ii = 0; ii < references.GetCount(); ii += aResetStep )
+    {
+        wxString ref = references[ii].GetRef();
+
+        while( !ref.IsEmpty() && wxIsdigit( ref.Last() ) )
+            ref.RemoveLast();
+
+        references[ii].SetRef( ref + "?" );
+    }
+
+    references.SplitReferences();
+
+    if( aSortByX )
+        references.SortByXCoordinate();
+    else
+        references.SortByYCoordinate();
+
+    SCH_REFERENCE_LIST     sequential = references;
+    std::vector<REF_STATE> state;
+
+    for( unsigned ii = 0; ii < sequential.GetCount(); ii++ )
+    {
+        SCH_REFERENCE& ref = sequential[ii];
+        long           numRef = -1;
+
+        ref.GetRefNumber().ToLong( &numRef );
+
+        state.push_back( { (int) numRef, ref.GetUnit(), numRef < 0, 0,
+                           ref.GetSheetPath().GetVirtualPageNumber() } );
+    }
+
+    references.Annotate( aUseSheetNum, 100, 0, lockedUnitMap );
+    SEQUENTIAL_ANNOTATION( sequential, state ).Annotate( aUseSheetNum, 100, 0, lockedUnitMap );
+
+    for( unsigned ii = 0; ii < references.GetCount(); ii++ )
+    {
+        BOOST_TEST_CONTEXT( references[ii].GetRef() << " at " << ii )
+        {
+            wxString expected = state[ii].m_NumRef < 0 ? wxString( "?" )
+                                                       : wxString::Format( "%d",
+                                                                           state[ii].m_NumRef );
+
+            BOOST_CHECK_EQUAL( references[ii].GetRefNumber(), expected );
+            BOOST_CHECK_EQUAL( references[ii].GetUnit(), state[ii].m_Unit );
+        }
+    }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( SchReferenceList, TEST_SCH_REFERENCE_LIST_FIXTURE )
+
+
+/**
+ * The fixture has multi-unit parts and a sub-sheet used twice.  All the references or one
+ * in two are annotated, sorted by X or Y, with or without the sheet numbers and the locked
+ * units.
+ */
+BOOST_AUTO_TEST_CASE( AnnotateAsBefore )
+{
+    loadSchematic( "complex_hierarchy" );
+
+    SCH_SHEET_LIST     sheets = m_schematic.GetSheets();
+    SCH_REFERENCE_LIST references;
+    bool               hasMultiUnit = false;
+
+    sheets.GetComponents( references, false );
+
+    for( unsigned ii = 0; ii < references.GetCount(); ii++ )
+        hasMultiUnit |= references[ii].GetLibPart()->GetUnitCount() > 1;
+
+    BOOST_REQUIRE( hasMultiUnit );
+    BOOST_REQUIRE_GT( sheets.size(), 2 );
+
+    for( int resetStep : { 1, 2 } )
+    {
+        for( bool sortByX : { true, false } )
+        {
+            for( bool useSheetNum : { false, true } )
+            {
+                for( bool lockUnits : { false, true } )
+                {
+                    BOOST_TEST_CONTEXT( "reset step " << resetStep << ", sort by X " << sortByX
+                                        << ", sheet numbers " << useSheetNum
+                                        << ", locked units " << lockUnits )
+                    {
+                        checkAnnotation( resetStep, sortByX, useSheetNum, lockUnits );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,254 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for the symbol libraries of SCH_SEXPR_PLUGIN, which are indexed when loaded
+ * and whose symbols are parsed on the first access
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sch_plugins/kicad/sch_sexpr_plugin.h>
+
+#include <class_libentry.h>
+#include <lib_field.h>
+#include <lib_symbol_summary.h>
+#include <properties.h>
+#include <symbol_lib_table.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+
+static const char* libHeader =
+        "(kicad_symbol_lib (version 20200827) (generator kicad_symbol_editor)\n";
+
+static const char* libSymbols =
+        "  (symbol \"GND\" (power) (in_bom yes) (on_board yes)\n"
+        "    (property \"Reference\" \"#PWR\" (id 0) (at 0 0 0))\n"
+        "    (property \"Value\" \"GND\" (id 1) (at 0 -3.81 0))\n"
+        "  )\n"
+        "  (symbol \"R\" (in_bom yes) (on_board yes)\n"
+        "    (property \"Reference\" \"R\" (id 0) (at 2.032 0 90))\n"
+        "    (property \"Value\" \"R\" (id 1) (at 0 0 90))\n"
+        "    (property \"ki_description\" \"Resistor (with a \\\"quoted)\\\" text\" (id 4)\n"
+        "      (at 0 0 0))\n"
+        "    (symbol \"R_0_1\")\n"
+        "  )\n"
+        "  (symbol \"R_Small\" (extends \"R\")\n"
+        "    (property \"Reference\" \"R\" (id 0) (at 0 0 0))\n"
+        "    (property \"Value\" \"R_Small\" (id 1) (at 0 0 0))\n"
+        "  )\n";
+
+
+class SEXPR_SYMBOL_LIB_FIXTURE
+{
+public:
+    SEXPR_SYMBOL_LIB_FIXTURE() :
+            m_tempFileName( wxFileName::CreateTempFileName( "kicad_sym_test" ) ),
+            m_fileName( m_tempFileName + ".kicad_sym" )
+    {
+    }
+
+    ~SEXPR_SYMBOL_LIB_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+        wxRemoveFile( m_tempFileName );
+    }
+
+    void WriteLib( const std::string& aContent )
+    {
+        wxFFile file( m_fileName, "wb" );
+        file.Write( aContent.data(), aContent.size() );
+    }
+
+    wxString         m_tempFileName;    ///< The file created by CreateTempFileName().
+    wxString         m_fileName;
+    SCH_SEXPR_PLUGIN m_plugin;
+};
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_FIXTURE_TEST_SUITE( SexprSymbolLib, SEXPR_SYMBOL_LIB_FIXTURE )
+
+
+/**
+ * The names are enumerated from the index, and the symbols are parsed when loaded
+ */
+BOOST_AUTO_TEST_CASE( IndexedSymbols )
+{
+    WriteLib( std::string( libHeader ) + libSymbols + ")\n" );
+
+    wxArrayString names;
+    m_plugin.EnumerateSymbolLib( names, m_fileName );
+
+    BOOST_REQUIRE_EQUAL( names.size(), 3 );
+    BOOST_CHECK_EQUAL( names[0], "GND" );
+    BOOST_CHECK_EQUAL( names[1], "R" );
+    BOOST_CHECK_EQUAL( names[2], "R_Small" );
+
+    PROPERTIES powerOnly;
+    powerOnly[SYMBOL_LIB_TABLE::PropPowerSymsOnly] = "";
+
+    wxArrayString powerNames;
+    m_plugin.EnumerateSymbolLib( powerNames, m_fileName, &powerOnly );
+
+    BOOST_REQUIRE_EQUAL( powerNames.size(), 1 );
+    BOOST_CHECK_EQUAL( powerNames[0], "GND" );
+
+    // The parent of a derived symbol is parsed with it
+    LIB_PART* derived = m_plugin.LoadSymbol( m_fileName, "R_Small" );
+
+    BOOST_REQUIRE_NE( derived, nullptr );
+    BOOST_CHECK( derived->IsAlias() );
+
+    LIB_PART* parent = m_plugin.LoadSymbol( m_fileName, "R" );
+
+    BOOST_REQUIRE_NE( parent, nullptr );
+    BOOST_CHECK( derived->GetParent().lock().get() == parent );
+    BOOST_CHECK_EQUAL( parent->GetDescription(), "Resistor (with a \"quoted)\" text" );
+
+    BOOST_CHECK_EQUAL( m_plugin.LoadSymbol( m_fileName, "C" ), nullptr );
+
+    std::vector<LIB_PART*> symbols;
+    m_plugin.EnumerateSymbolLib( symbols, m_fileName );
+
+    BOOST_CHECK_EQUAL( symbols.size(), 3 );
+}
+
+
+/**
+ * The properties of the symbol tree are read from the index, and are the ones of the parsed
+ * symbols
+ */
+BOOST_AUTO_TEST_CASE( SymbolSummaries )
+{
+    WriteLib( std::string( libHeader ) + libSymbols
+              + "  (symbol \"U\" (in_bom yes) (on_board yes)\n"
+                "    (property \"Footprint\" \"Package_DIP:DIP-8\" (id 2) (at 0 0 0))\n"
+                "    (property \"ki_keywords\" \"dual\\top amp\" (id 4) (at 0 0 0))\n"
+                "    (symbol \"U_1_1\")\n"
+                "    (symbol \"U_2_1\")\n"
+                "    (symbol \"U_2_2\")\n"
+                "  )\n"
+                "  (symbol \"U_Alt\" (extends \"U\")\n"
+                "    (property \"ki_description\" \"Alternate\" (id 4) (at 0 0 0)))\n"
+                ")\n" );
+
+    std::vector<LIB_SYMBOL_SUMMARY> indexed;
+    m_plugin.EnumerateSymbolSummaries( indexed, m_fileName );
+
+    // Only the parent of a derived symbol is parsed
+    BOOST_REQUIRE_NE( m_plugin.LoadSymbol( m_fileName, "R_Small" ), nullptr );
+
+    std::vector<LIB_SYMBOL_SUMMARY> partlyParsed;
+    m_plugin.EnumerateSymbolSummaries( partlyParsed, m_fileName );
+
+    std::vector<LIB_PART*> symbols;
+    m_plugin.EnumerateSymbolLib( symbols, m_fileName );
+
+    BOOST_REQUIRE_EQUAL( symbols.size(), 5 );
+    BOOST_REQUIRE_EQUAL( indexed.size(), symbols.size() );
+    BOOST_REQUIRE_EQUAL( partlyParsed.size(), symbols.size() );
+
+    for( size_t ii = 0; ii < symbols.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( symbols[ii]->GetName() )
+        {
+            LIB_SYMBOL_SUMMARY parsed( symbols[ii] );
+
+            for( LIB_SYMBOL_SUMMARY* summary : { &indexed[ii], &partlyParsed[ii] } )
+            {
+                BOOST_CHECK_EQUAL( summary->GetName(), parsed.GetName() );
+                BOOST_CHECK_EQUAL( summary->GetDescription(), parsed.GetDescription() );
+                BOOST_CHECK_EQUAL( summary->GetSearchText(), parsed.GetSearchText() );
+                BOOST_CHECK_EQUAL( summary->IsRoot(), parsed.IsRoot() );
+                BOOST_CHECK_EQUAL( summary->GetUnitCount(), parsed.GetUnitCount() );
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL( indexed[3].GetUnitCount(), 2 );
+    BOOST_CHECK_EQUAL( indexed[4].GetUnitCount(), 2 );
+}
+
+
+/**
+ * A symbol which cannot be parsed stays in the library, and its error is reported on each
+ * access
+ */
+BOOST_AUTO_TEST_CASE( SymbolParseError )
+{
+    WriteLib( std::string( libHeader ) + libSymbols
+              + "  (symbol \"Bad\" (property \"Value\" \"Bad\" (id 1) (at x 0 0)))\n)\n" );
+
+    BOOST_CHECK_THROW( m_plugin.LoadSymbol( m_fileName, "Bad" ), IO_ERROR );
+    BOOST_CHECK_THROW( m_plugin.LoadSymbol( m_fileName, "Bad" ), IO_ERROR );
+
+    wxArrayString names;
+    m_plugin.EnumerateSymbolLib( names, m_fileName );
+
+    BOOST_CHECK_EQUAL( names.size(), 4 );
+    BOOST_CHECK_NE( m_plugin.LoadSymbol( m_fileName, "R" ), nullptr );
+}
+
+
+/**
+ * The libraries which cannot be indexed are fully parsed
+ */
+BOOST_AUTO_TEST_CASE( NotIndexedSymbols )
+{
+    // A symbol name with a library nickname, which is removed by the parser
+    WriteLib( std::string( libHeader ) + libSymbols
+              + "  (symbol \"lib:Q\" (property \"Value\" \"Q\" (id 1) (at 0 0 0)))\n)\n" );
+
+    wxArrayString names;
+    m_plugin.EnumerateSymbolLib( names, m_fileName );
+
+    BOOST_REQUIRE_EQUAL( names.size(), 4 );
+    BOOST_CHECK_EQUAL( names[3], "Q" );
+    BOOST_CHECK_NE( m_plugin.LoadSymbol( m_fileName, "Q" ), nullptr );
+}
+
+
+/**
+ * The errors of the derived symbols without parent are still reported when the library
+ * is loaded
+ */
+BOOST_AUTO_TEST_CASE( MissingParent )
+{
+    WriteLib( std::string( libHeader )
+              + "  (symbol \"R_Small\" (extends \"R\")\n"
+                "    (property \"Value\" \"R_Small\" (id 1) (at 0 0 0)))\n)\n" );
+
+    wxArrayString names;
+    BOOST_CHECK_THROW( m_plugin.EnumerateSymbolLib( names, m_fileName ), IO_ERROR );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,212 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the loading of Gerber and Excellon files, either one
+ * by one (as GerbView did previously) or all together in parallel.
+ *
+ * Typical use:
+ *    qa_gerbview_tools gerber_load -v -r 10 <gerber and drill files>
+ */
+
+#include <gerber_file_image.h>
+#include <gerber_file_image_list.h>
+#include <excellon_image.h>
+
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <iostream>
+#include <memory>
+
+
+using IMAGES = std::vector<std::unique_ptr<GERBER_FILE_IMAGE>>;
+
+
+/**
+ * Create an empty image for each file: drill files (.drl, .xln, .nc) are read as Excellon
+ * files, all others as Gerber files.
+ */
+static IMAGES createImages( const std::vector<wxString>& aFiles )
+{
+    IMAGES images;
+
+    for( const wxString& file : aFiles )
+    {
+        wxString ext = wxFileName( file ).GetExt().Lower();
+
+        if( ext == "drl" || ext == "xln" || ext == "nc" )
+            images.push_back( std::make_unique<EXCELLON_IMAGE>( 0 ) );
+        else
+            images.push_back( std::make_unique<GERBER_FILE_IMAGE>( 0 ) );
+    }
+
+    return images;
+}
+
+
+/**
+ * Read all the files one after the other, in the calling thread.
+ */
+static void loadSerial( const IMAGES& aImages, const std::vector<wxString>& aFiles )
+{
+    for( size_t ii = 0; ii < aImages.size(); ++ii )
+    {
+        EXCELLON_IMAGE* drill = dynamic_cast<EXCELLON_IMAGE*>( aImages[ii].get() );
+
+        if( drill )
+            drill->LoadFile( aFiles[ii] );
+        else
+            aImages[ii]->LoadGerberFile( aFiles[ii] );
+    }
+}
+
+
+/**
+ * Read all the files using the GerbView loader worker pool.
+ */
+static void loadParallel( const IMAGES& aImages, const std::vector<wxString>& aFiles )
+{
+    std::vector<GERBER_FILE_IMAGE*> images;
+
+    for( const std::unique_ptr<GERBER_FILE_IMAGE>& image : aImages )
+        images.push_back( image.get() );
+
+    GERBER_FILE_IMAGE_LIST::LoadFiles( images, aFiles );
+}
+
+
+/**
+ * Load the files aReps times with the given loader.
+ *
+ * @return the average load time, in ms
+ */
+template <typename LOADER>
+static double benchmark( LOADER aLoader, const std::vector<wxString>& aFiles, int aReps,
+                         size_t& aItemCount, size_t& aFailCount )
+{
+    double total = 0.0;
+
+    for( int rep = 0; rep < aReps; ++rep )
+    {
+        IMAGES images = createImages( aFiles );
+
+        PROF_COUNTER timer;
+        aLoader( images, aFiles );
+        total += timer.msecs();
+
+        aItemCount = 0;
+        aFailCount = 0;
+
+        for( const std::unique_ptr<GERBER_FILE_IMAGE>& image : images )
+        {
+            if( image->m_InUse )
+                aItemCount += image->GetItemsCount();
+            else
+                aFailCount++;
+        }
+    }
+
+    return total / aReps;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print loading information" ).mb_str() },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input files" ).mb_str(), wxCMD_LINE_VAL_STRING,
+            wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum GERBER_LOAD_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int gerber_load_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the loading of a set of Gerber and Excellon files, "
+               "one by one and in parallel." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long reps = 5;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    std::vector<wxString> files;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        wxFileName fn( cl_parser.GetParam( i ) );
+        fn.MakeAbsolute();
+        files.push_back( fn.GetFullPath() );
+    }
+
+    size_t serialItems = 0, serialFails = 0;
+    size_t parallelItems = 0, parallelFails = 0;
+
+    double serialMs = benchmark( loadSerial, files, reps, serialItems, serialFails );
+    double parallelMs = benchmark( loadParallel, files, reps, parallelItems, parallelFails );
+
+    if( verbose )
+    {
+        std::cout << "Files: " << files.size() << ", repetitions: " << reps << std::endl;
+        std::cout << "Serial load:   " << serialMs << "ms, " << serialItems << " items"
+                  << std::endl;
+        std::cout << "Parallel load: " << parallelMs << "ms, " << parallelItems << " items"
+                  << std::endl;
+        std::cout << "Speedup: " << serialMs / parallelMs << std::endl;
+    }
+
+    if( serialFails || parallelFails || serialItems != parallelItems )
+        return GERBER_LOAD_RET_CODES::LOAD_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "gerber_load",
+        "Benchmark Gerber and Excellon file loading", gerber_load_main_func } );
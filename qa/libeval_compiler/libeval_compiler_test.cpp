@@ -51,6 +51,44 @@ bool testEvalExpr( const std::string expr, LIBEVAL::VALUE expectedResult, bool e
 }
 
 
+/**
+ * Print the compile time of an expression, and its evaluation time with a new context for each
+ * evaluation, like in the DRC rule conditions.
+ */
+void benchEvalExpr( const std::string expr, BOARD_ITEM* itemA, BOARD_ITEM* itemB,
+                    int iterations = 1000000 )
+{
+    PCB_EXPR_COMPILER compiler;
+    PCB_EXPR_UCODE    ucode;
+    PCB_EXPR_CONTEXT  preflightContext( F_Cu );
+
+    PROF_COUNTER compileTimer;
+
+    if( !compiler.Compile( expr, &ucode, &preflightContext ) )
+    {
+        printf( "%s: compile error\n", expr.c_str() );
+        return;
+    }
+
+    double compileMs = compileTimer.msecs();
+    double sum = 0.0;
+
+    PROF_COUNTER runTimer;
+
+    for( int i = 0; i < iterations; i++ )
+    {
+        PCB_EXPR_CONTEXT context( F_Cu );
+        context.SetItems( itemA, itemB );
+        sum += ucode.Run( &context )->AsDouble();
+    }
+
+    double runMs = runTimer.msecs();
+
+    printf( "%s: compile %.3f ms, %d evaluations %.1f ms (%.1f ns/evaluation, sum %g)\n",
+            expr.c_str(), compileMs, iterations, runMs, runMs * 1e6 / iterations, sum );
+}
+
+
 int main( int argc, char *argv[] )
 {
     PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
@@ -92,6 +130,11 @@ int main( int argc, char *argv[] )
     trackA.SetWidth( Mils2iu( 10 ));
     trackB.SetWidth( Mils2iu( 20 ));
 
+    benchEvalExpr( "1mm + 2mm > 0.5mm * 4", &trackA, &trackB );
+    benchEvalExpr( "A.Width > B.Width", &trackA, &trackB );
+    benchEvalExpr( "A.Width + 10mil < B.Width && A.Layer != 'B.Cu'", &trackA, &trackB );
+    benchEvalExpr( "A.Netclass == 'HV' && B.Netclass != 'HV'", &trackA, &trackB );
+
     testEvalExpr( "A.fromTo('U1', 'U3') && A.NetClass == 'DDR3_A' ", VAL(0),false, &trackA, &trackB );
 
     return 0;
@@ -0,0 +1,218 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for SEXPR::PARSER::ParseDocument (the sexpr_parser utility of qa_common_tools
+ * compares its time with SEXPR::PARSER::Parse in verbose mode)
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <sexpr/sexpr_parser.h>
+
+#include "sexpr_test_utils.h"
+
+
+/**
+ * Check two trees have the same nodes and values.
+ *
+ * @return false if not equal (and output logging)
+ */
+static bool SexprTreesEqual( const SEXPR::SEXPR& aGot, const SEXPR::SEXPR& aExpected )
+{
+    if( KI_TEST::getType( aGot ) != KI_TEST::getType( aExpected ) )
+    {
+        BOOST_TEST_MESSAGE( "Sexpr type not equal: got " << KI_TEST::GetSexprDebugType( aGot )
+                            << ", expected " << KI_TEST::GetSexprDebugType( aExpected ) );
+        return false;
+    }
+
+    if( aGot.GetLineNumber() != aExpected.GetLineNumber() )
+    {
+        BOOST_TEST_MESSAGE( "Sexpr line number not equal: got " << aGot.GetLineNumber()
+                            << ", expected " << aExpected.GetLineNumber() );
+        return false;
+    }
+
+    if( aGot.IsList() )
+    {
+        if( aGot.GetNumberOfChildren() != aExpected.GetNumberOfChildren() )
+        {
+            BOOST_TEST_MESSAGE( "List is wrong length: got " << aGot.GetNumberOfChildren()
+                                << ", expected " << aExpected.GetNumberOfChildren() );
+            return false;
+        }
+
+        for( size_t i = 0; i < aGot.GetNumberOfChildren(); i++ )
+        {
+            if( !SexprTreesEqual( *aGot.GetChild( i ), *aExpected.GetChild( i ) ) )
+                return false;
+        }
+
+        return true;
+    }
+    else if( aGot.IsString() )
+    {
+        return KI_TEST::IsSexprValueEqual( aGot.GetString(), aExpected.GetString() );
+    }
+    else if( aGot.IsSymbol() )
+    {
+        return KI_TEST::IsSexprValueEqual( aGot.GetSymbol(), aExpected.GetSymbol() );
+    }
+    else if( aGot.IsInteger() )
+    {
+        return KI_TEST::IsSexprValueEqual( aGot.GetLongInteger(), aExpected.GetLongInteger() );
+    }
+
+    return KI_TEST::IsSexprValueEqual( aGot.GetDouble(), aExpected.GetDouble() );
+}
+
+
+/**
+ * Build a board-like s-expression of about aSize bytes
+ */
+static std::string makeBoardLikeSexpr( size_t aSize )
+{
+    std::string sexpr = "(kicad_pcb (version 20200724) (host pcbnew \"(5.99.0)\")\n";
+
+    for( int i = 0; sexpr.size() < aSize; i++ )
+    {
+        sexpr += "  (segment (start " + std::to_string( i % 1000 ) + ".25 -22.5) (end 104.1 "
+                 + std::to_string( i % 77 ) + ") (width 0.25) (layer \"F.Cu\") (net "
+                 + std::to_string( i % 300 ) + ") (tstamp 5E1A2B3C-0000-4000-8000-"
+                 + std::to_string( 100000000 + i ) + "))\n";
+    }
+
+    sexpr += ")\n";
+
+    return sexpr;
+}
+
+
+/**
+ * Declare the test suite
+ */
+BOOST_AUTO_TEST_SUITE( SexprDocument )
+
+/**
+ * Test several atoms in a list, including nested lists
+ */
+BOOST_AUTO_TEST_CASE( SymbolString )
+{
+    SEXPR::PARSER parser;
+    const auto    doc = parser.ParseDocument( "(symbol \"string\" 42 3.14 (nested 4 ()))" );
+
+    BOOST_REQUIRE_NE( doc->GetRoot(), nullptr );
+
+    const SEXPR::SEXPR& sexp = *doc->GetRoot();
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( sexp )( 5 ) );
+
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsSymbolWithValue, ( *sexp.GetChild( 0 ) )( "symbol" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsStringWithValue, ( *sexp.GetChild( 1 ) )( "string" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsIntegerWithValue, ( *sexp.GetChild( 2 ) )( 42 ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsDoubleWithValue, ( *sexp.GetChild( 3 ) )( 3.14 ) );
+
+    const SEXPR::SEXPR& sublist = *sexp.GetChild( 4 );
+    BOOST_REQUIRE_PREDICATE( KI_TEST::SexprIsListOfLength, ( sublist )( 3 ) );
+    BOOST_CHECK_PREDICATE(
+            KI_TEST::SexprIsSymbolWithValue, ( *sublist.GetChild( 0 ) )( "nested" ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsIntegerWithValue, ( *sublist.GetChild( 1 ) )( 4 ) );
+    BOOST_CHECK_PREDICATE( KI_TEST::SexprIsListOfLength, ( *sublist.GetChild( 2 ) )( 0 ) );
+}
+
+/**
+ * The text of the atoms is a view of the document text
+ */
+BOOST_AUTO_TEST_CASE( TextViews )
+{
+    SEXPR::PARSER parser;
+    const auto    doc = parser.ParseDocument( "(symbol \"a \\\"quoted\\\" string\")" );
+
+    BOOST_REQUIRE_NE( doc->GetRoot(), nullptr );
+
+    const std::string&     text = doc->GetText();
+    const SEXPR::SEXPR_TEXT symbol = doc->GetRoot()->GetChild( 0 )->GetText();
+    const SEXPR::SEXPR_TEXT str = doc->GetRoot()->GetChild( 1 )->GetText();
+
+    BOOST_CHECK( symbol.m_data == text.data() + 1 );
+    BOOST_CHECK( symbol == "symbol" );
+    BOOST_CHECK( str == "a \\\"quoted\\\" string" );
+    BOOST_CHECK( str != "a" );
+
+    // The string copies are kept by the document
+    BOOST_CHECK_EQUAL( &doc->GetRoot()->GetChild( 1 )->GetString(),
+                       &doc->GetRoot()->GetChild( 1 )->GetString() );
+    BOOST_CHECK_THROW( doc->GetRoot()->GetChild( 0 )->GetString(),
+                       SEXPR::INVALID_TYPE_EXCEPTION );
+}
+
+/**
+ * The documents and the trees of Parse() are identical, including the errors
+ */
+BOOST_AUTO_TEST_CASE( SameAsParse )
+{
+    const std::vector<std::string> cases = {
+        "",
+        "  ",
+        ")",
+        "()",
+        "(a (b \"c\" -1 .5 -.5 - 012 0x12) \"\" (d))",
+        "(a\n  (b\n    c)\n\t (d 1.0)\n)",
+        "(unclosed (list 1 2)",
+        "(symbol",
+        "3.14",
+        "(missing \"quote)",
+        makeBoardLikeSexpr( 10000 ),
+    };
+
+    for( const std::string& c : cases )
+    {
+        BOOST_TEST_CONTEXT( c.substr( 0, 40 ) )
+        {
+            SEXPR::PARSER                          parser, docParser;
+            std::unique_ptr<SEXPR::SEXPR>          sexp;
+            std::unique_ptr<SEXPR::SEXPR_DOCUMENT> doc;
+
+            try
+            {
+                sexp = parser.Parse( c );
+            }
+            catch( const SEXPR::PARSE_EXCEPTION& )
+            {
+                BOOST_CHECK_THROW( docParser.ParseDocument( c ), SEXPR::PARSE_EXCEPTION );
+                continue;
+            }
+
+            doc = docParser.ParseDocument( c );
+
+            BOOST_REQUIRE_EQUAL( sexp == nullptr, doc->GetRoot() == nullptr );
+
+            if( sexp )
+                BOOST_CHECK_PREDICATE( SexprTreesEqual, ( *doc->GetRoot() )( *sexp ) );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,327 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the zone to zone clearance test of the copper clearance DRC provider: the
+ * violations are the ones of the sequential test of all the segment pairs of the zones
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <common.h>
+#include <drc/drc_item.h>
+#include <drc/drc_engine.h>
+#include <math_for_graphics.h>
+#include <netinfo.h>
+#include <widgets/ui_common.h>
+
+
+/**
+ * A zone to zone violation: its code, its items and its position
+ */
+struct ZONE_VIOLATION
+{
+    int     m_code;
+    KIID    m_main;
+    KIID    m_aux;
+    wxPoint m_pos;
+
+    bool operator==( const ZONE_VIOLATION& aOther ) const
+    {
+        return m_code == aOther.m_code && m_main == aOther.m_main && m_aux == aOther.m_aux
+               && m_pos == aOther.m_pos;
+    }
+};
+
+
+std::ostream& operator<<( std::ostream& os, const ZONE_VIOLATION& aViolation )
+{
+    os << "ZONE_VIOLATION[ " << aViolation.m_code << ", "
+       << aViolation.m_main.AsString().ToStdString() << " -> "
+       << aViolation.m_aux.AsString().ToStdString() << " at " << aViolation.m_pos.x << ", "
+       << aViolation.m_pos.y << " ]";
+    return os;
+}
+
+
+class DRC_COPPER_ZONES_FIXTURE
+{
+public:
+    DRC_COPPER_ZONES_FIXTURE()
+    {
+        BOARD_DESIGN_SETTINGS& bds = m_board.GetDesignSettings();
+
+        bds.m_DRCSeverities[ DRCE_CLEARANCE ] = RPT_SEVERITY_ERROR;
+        bds.m_DRCSeverities[ DRCE_ZONES_INTERSECT ] = RPT_SEVERITY_ERROR;
+    }
+
+    /**
+     * Add a zone on a net, with a rectangular outline and an optional rectangular hole
+     * (coordinates in mm)
+     */
+    ZONE_CONTAINER* AddZone( const wxString& aNet, LSET aLayers, const BOX2D& aOutline,
+                             const BOX2D* aHole = nullptr, unsigned aPriority = 0 )
+    {
+        NETINFO_ITEM* net = m_board.FindNet( aNet );
+
+        if( !net )
+        {
+            net = new NETINFO_ITEM( &m_board, aNet );
+            m_board.Add( net );
+        }
+
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+        zone->SetLayerSet( aLayers );
+        zone->SetNetCode( net->GetNet() );
+        zone->SetPriority( aPriority );
+
+        auto appendRect =
+                [&]( const BOX2D& aRect, int aHoleIdx )
+                {
+                    zone->AppendCorner( mmPoint( aRect.GetX(), aRect.GetY() ), aHoleIdx );
+                    zone->AppendCorner( mmPoint( aRect.GetRight(), aRect.GetY() ), aHoleIdx );
+                    zone->AppendCorner( mmPoint( aRect.GetRight(), aRect.GetBottom() ),
+                                        aHoleIdx );
+                    zone->AppendCorner( mmPoint( aRect.GetX(), aRect.GetBottom() ), aHoleIdx );
+                };
+
+        appendRect( aOutline, -1 );
+
+        if( aHole )
+        {
+            zone->Outline()->NewHole();
+            appendRect( *aHole, 0 );
+        }
+
+        m_board.Add( zone );
+
+        return zone;
+    }
+
+    /**
+     * The zone to zone violations of the sequential test the provider did before its pairs
+     * were selected by their bounding boxes and tested in parallel
+     */
+    std::vector<ZONE_VIOLATION> SequentialViolations( DRC_ENGINE& aEngine )
+    {
+        std::vector<ZONE_VIOLATION>  violations;
+        std::vector<ZONE_CONTAINER*> zones;
+        SHAPE_POLY_SET               buffer;
+        SHAPE_POLY_SET*              boardOutline = nullptr;
+
+        if( m_board.GetBoardPolygonOutlines( buffer ) )
+            boardOutline = &buffer;
+
+        for( ZONE_CONTAINER* zone : m_board.Zones() )
+        {
+            if( !zone->GetIsRuleArea() )
+                zones.push_back( zone );
+        }
+
+        for( int layer_id = F_Cu; layer_id <= B_Cu; ++layer_id )
+        {
+            PCB_LAYER_ID layer = static_cast<PCB_LAYER_ID>( layer_id );
+
+            if( !m_board.IsLayerEnabled( layer ) )
+                continue;
+
+            std::vector<SHAPE_POLY_SET> smoothed_polys( zones.size() );
+
+            for( size_t ii = 0; ii < zones.size(); ii++ )
+            {
+                if( zones[ii]->IsOnLayer( layer ) )
+                    zones[ii]->BuildSmoothedPoly( smoothed_polys[ii], layer, boardOutline );
+            }
+
+            for( size_t ia = 0; ia < zones.size(); ia++ )
+            {
+                ZONE_CONTAINER* zoneRef = zones[ia];
+
+                if( !zoneRef->IsOnLayer( layer ) )
+                    continue;
+
+                for( size_t ia2 = ia + 1; ia2 < zones.size(); ia2++ )
+                {
+                    ZONE_CONTAINER* zoneToTest = zones[ia2];
+
+                    if( !zoneToTest->IsOnLayer( layer )
+                            || ( zoneRef->GetNetCode() == zoneToTest->GetNetCode()
+                                 && zoneRef->GetNetCode() >= 0 )
+                            || zoneRef->GetPriority() != zoneToTest->GetPriority() )
+                    {
+                        continue;
+                    }
+
+                    DRC_CONSTRAINT constraint = aEngine.EvalRulesForItems( CLEARANCE_CONSTRAINT,
+                                                                           zoneRef, zoneToTest );
+                    int            clearance = constraint.GetValue().Min();
+
+                    for( auto it = smoothed_polys[ia].IterateWithHoles(); it; it++ )
+                    {
+                        VECTOR2I vertex = *it;
+
+                        if( smoothed_polys[ia2].Contains( vertex ) )
+                        {
+                            violations.push_back( { DRCE_ZONES_INTERSECT, zoneRef->m_Uuid,
+                                                    zoneToTest->m_Uuid,
+                                                    wxPoint( vertex.x, vertex.y ) } );
+                        }
+                    }
+
+                    for( auto it = smoothed_polys[ia2].IterateWithHoles(); it; it++ )
+                    {
+                        VECTOR2I vertex = *it;
+
+                        if( smoothed_polys[ia].Contains( vertex ) )
+                        {
+                            violations.push_back( { DRCE_ZONES_INTERSECT, zoneToTest->m_Uuid,
+                                                    zoneRef->m_Uuid,
+                                                    wxPoint( vertex.x, vertex.y ) } );
+                        }
+                    }
+
+                    std::map<wxPoint, int> conflictPoints;
+
+                    for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt;
+                            refIt++ )
+                    {
+                        SEG refSegment = *refIt;
+
+                        for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles();
+                                testIt; testIt++ )
+                        {
+                            SEG     testSegment = *testIt;
+                            wxPoint pt;
+
+                            int d = GetClearanceBetweenSegments( testSegment.A.x, testSegment.A.y,
+                                                                 testSegment.B.x, testSegment.B.y,
+                                                                 0,
+                                                                 refSegment.A.x, refSegment.A.y,
+                                                                 refSegment.B.x, refSegment.B.y,
+                                                                 0, clearance, &pt.x, &pt.y );
+
+                            if( d < clearance )
+                            {
+                                if( conflictPoints.count( pt ) )
+                                    conflictPoints[ pt ] = std::min( conflictPoints[ pt ], d );
+                                else
+                                    conflictPoints[ pt ] = d;
+                            }
+                        }
+                    }
+
+                    for( const std::pair<const wxPoint, int>& conflict : conflictPoints )
+                    {
+                        int code = conflict.second <= 0 ? DRCE_ZONES_INTERSECT : DRCE_CLEARANCE;
+
+                        violations.push_back( { code, zoneRef->m_Uuid, zoneToTest->m_Uuid,
+                                                conflict.first } );
+                    }
+                }
+            }
+        }
+
+        return violations;
+    }
+
+    BOARD m_board;
+
+private:
+    static wxPoint mmPoint( double aX, double aY )
+    {
+        return wxPoint( Millimeter2iu( aX ), Millimeter2iu( aY ) );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcCopperZones, DRC_COPPER_ZONES_FIXTURE )
+
+
+/**
+ * Overlapping zones, zones closer than the clearance, a zone inside the hole of another one,
+ * and zones which are not tested (same net, different priorities, far apart)
+ */
+BOOST_AUTO_TEST_CASE( SameAsSequentialTest )
+{
+    const LSET front( 1, F_Cu );
+    const LSET back( 1, B_Cu );
+    const LSET both( 2, F_Cu, B_Cu );
+
+    AddZone( "A", front, BOX2D( VECTOR2D( 0, 0 ), VECTOR2D( 10, 10 ) ) );
+    AddZone( "B", front, BOX2D( VECTOR2D( 5, 5 ), VECTOR2D( 10, 10 ) ) );
+    AddZone( "C", both, BOX2D( VECTOR2D( 10.1, 0 ), VECTOR2D( 9.9, 4 ) ) );
+    AddZone( "D", front, BOX2D( VECTOR2D( 20.05, 0 ), VECTOR2D( 10, 4 ) ) );
+    AddZone( "A", front, BOX2D( VECTOR2D( 2, 2 ), VECTOR2D( 4, 4 ) ) );
+    AddZone( "E", front, BOX2D( VECTOR2D( 1, 1 ), VECTOR2D( 3, 3 ) ), nullptr, 1 );
+    AddZone( "B", both, BOX2D( VECTOR2D( 50, 50 ), VECTOR2D( 10, 10 ) ) );
+
+    const BOX2D hole( VECTOR2D( 12, 12 ), VECTOR2D( 10, 10 ) );
+
+    AddZone( "F", back, BOX2D( VECTOR2D( 10, 10 ), VECTOR2D( 14, 14 ) ), &hole );
+    AddZone( "G", back, BOX2D( VECTOR2D( 12.1, 12.1 ), VECTOR2D( 5, 5 ) ) );
+    AddZone( "H", back, BOX2D( VECTOR2D( 18, 18 ), VECTOR2D( 5, 5 ) ) );
+
+    DRC_ENGINE drcEngine( &m_board, &m_board.GetDesignSettings() );
+    drcEngine.InitEngine( wxFileName() );
+
+    std::vector<ZONE_VIOLATION> violations;
+
+    drcEngine.SetViolationHandler(
+            [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+            {
+                if( aItem->GetErrorCode() != DRCE_ZONES_INTERSECT
+                        && aItem->GetErrorCode() != DRCE_CLEARANCE )
+                {
+                    return;
+                }
+
+                violations.push_back( { aItem->GetErrorCode(), aItem->GetMainItemID(),
+                                        aItem->GetAuxItemID(), aPos } );
+            } );
+
+    drcEngine.RunTests( EDA_UNITS::MILLIMETRES, true, false );
+
+    const std::vector<ZONE_VIOLATION> expected = SequentialViolations( drcEngine );
+
+    // the board has violations of both kinds
+    BOOST_CHECK( std::count_if( expected.begin(), expected.end(),
+                                []( const ZONE_VIOLATION& aViolation )
+                                {
+                                    return aViolation.m_code == DRCE_CLEARANCE;
+                                } ) > 0 );
+    BOOST_CHECK( std::count_if( expected.begin(), expected.end(),
+                                []( const ZONE_VIOLATION& aViolation )
+                                {
+                                    return aViolation.m_code == DRCE_ZONES_INTERSECT;
+                                } ) > 0 );
+
+    // the violations are reported in the order of the sequential test
+    BOOST_CHECK_EQUAL_COLLECTIONS( violations.begin(), violations.end(), expected.begin(),
+                                   expected.end() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
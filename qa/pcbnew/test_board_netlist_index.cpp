@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for BOARD_NETLIST_INDEX: the footprints, pads and nets found by the index are the
+ * ones found by the searches of the board
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <netlist_reader/board_netlist_updater.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <netinfo.h>
+
+
+class BOARD_NETLIST_INDEX_FIXTURE
+{
+public:
+    MODULE* AddFootprint( const wxString& aReference, int aPadCount )
+    {
+        MODULE*   footprint = new MODULE( &m_board );
+        KIID_PATH path;
+
+        path.push_back( KIID() );
+        footprint->SetReference( aReference );
+        footprint->SetPath( path );
+
+        for( int ii = 0; ii < aPadCount; ++ii )
+        {
+            D_PAD* pad = new D_PAD( footprint );
+            pad->SetName( wxString::Format( "%d", ii + 1 ) );
+            footprint->Add( pad, ADD_MODE::APPEND );
+        }
+
+        m_board.Add( footprint, ADD_MODE::APPEND );
+
+        return footprint;
+    }
+
+    BOARD               m_board;
+    BOARD_NETLIST_INDEX m_index;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( BoardNetlistIndex, BOARD_NETLIST_INDEX_FIXTURE )
+
+
+/**
+ * The footprints are found by reference, case insensitively, and by path
+ */
+BOOST_AUTO_TEST_CASE( FindModules )
+{
+    MODULE* r1 = AddFootprint( "R1", 2 );
+    MODULE* r1Lower = AddFootprint( "r1", 2 );
+    MODULE* r2 = AddFootprint( "R2", 2 );
+
+    m_index.Build( &m_board );
+
+    const std::vector<MODULE*> expected = { r1, r1Lower };
+
+    BOOST_CHECK( m_index.FindModulesByReference( "R1" ) == expected );
+    BOOST_CHECK( m_index.FindModulesByReference( "r1" ) == expected );
+    BOOST_CHECK( m_index.FindModulesByReference( "R3" ).empty() );
+
+    BOOST_REQUIRE_EQUAL( m_index.FindModulesByPath( r2->GetPath() ).size(), 1 );
+    BOOST_CHECK_EQUAL( m_index.FindModulesByPath( r2->GetPath() )[0], r2 );
+    BOOST_CHECK( m_index.FindModulesByPath( KIID_PATH() ).empty() );
+
+    // As BOARD::FindModuleByReference()
+    BOOST_CHECK_EQUAL( m_index.FindModule( "R1" ), r1 );
+    BOOST_CHECK_EQUAL( m_index.FindModule( "r1" ), r1Lower );
+    BOOST_CHECK_EQUAL( m_index.FindModule( "R3" ), nullptr );
+}
+
+
+/**
+ * The pads are the ones of the first footprint of a reference, and the nets are found by name
+ */
+BOOST_AUTO_TEST_CASE( FindPadsAndNets )
+{
+    MODULE* first = AddFootprint( "U1", 2 );
+    AddFootprint( "U1", 4 );
+
+    NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, "/VCC" );
+    m_board.Add( net );
+
+    m_index.Build( &m_board );
+
+    BOOST_CHECK_EQUAL( m_index.FindPad( "U1", "2" ), first->FindPadByName( "2" ) );
+    BOOST_CHECK_EQUAL( m_index.FindPad( "U1", "3" ), nullptr );
+    BOOST_CHECK_EQUAL( m_index.FindPad( "U2", "1" ), nullptr );
+
+    BOOST_CHECK_EQUAL( m_index.FindNet( "/VCC" ), net );
+    BOOST_CHECK_EQUAL( m_index.FindNet( "/GND" ), nullptr );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
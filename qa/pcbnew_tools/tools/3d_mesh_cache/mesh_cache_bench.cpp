@@ -0,0 +1,284 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the warm 3D cache: the render data of a set of models is read
+ * from the ".3dc" scene graph cache files (and converted to meshes, as the 3D viewer did
+ * previously), then mapped from the ".3dm" mesh cache files.
+ *
+ * Typical use:
+ *    qa_pcbnew_tools 3d_mesh_cache -v -r 10 <3D model files>
+ */
+
+#include <3d_mesh_cache.h>
+#include <3d_plugin_manager.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <sg/scenegraph.h>
+
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+#include <iostream>
+
+
+/**
+ * The cache files of a model, and the size of its render data
+ */
+struct MODEL_CACHE_FILES
+{
+    wxString m_sceneCache;
+    wxString m_meshCache;
+    size_t   m_vertices;
+    size_t   m_indices;
+};
+
+
+static void countModel( const S3DMODEL& aModel, size_t& aVertices, size_t& aIndices )
+{
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        aVertices += aModel.m_Meshes[i].m_VertexSize;
+        aIndices += aModel.m_Meshes[i].m_FaceIdxSize;
+    }
+}
+
+
+/**
+ * Load a model with the plugins, and write both cache files in aCacheDir.
+ */
+static bool writeCacheFiles( S3D_PLUGIN_MANAGER& aPlugins, const wxString& aModelFile,
+                             const wxString& aCacheDir, int aIndex, MODEL_CACHE_FILES& aFiles )
+{
+    std::string pluginInfo;
+    SCENEGRAPH* scene = aPlugins.Load3DModel( aModelFile, pluginInfo );
+
+    if( !scene )
+        return false;
+
+    wxString baseName = aCacheDir + wxString::Format( "model%d", aIndex );
+
+    aFiles.m_sceneCache = baseName + ".3dc";
+    aFiles.m_meshCache = baseName + ".3dm";
+    aFiles.m_vertices = 0;
+    aFiles.m_indices = 0;
+
+    bool ok = S3D::WriteCache( aFiles.m_sceneCache.ToUTF8(), true, (SGNODE*) scene,
+                               pluginInfo.c_str() );
+
+    S3DMODEL* model = S3D::GetModel( scene );
+
+    if( model )
+    {
+        countModel( *model, aFiles.m_vertices, aFiles.m_indices );
+        ok = ok && S3D::WriteMeshCache( aFiles.m_meshCache, *model, pluginInfo );
+        S3D::Destroy3DModel( &model );
+    }
+    else
+    {
+        ok = false;
+    }
+
+    S3D::DestroyNode( (SGNODE*) scene );
+    return ok;
+}
+
+
+/**
+ * Read the scene graph cache files and convert them to render data.
+ *
+ * @return the total vertex count, to check the result
+ */
+static size_t loadSceneCaches( const std::vector<MODEL_CACHE_FILES>& aFiles )
+{
+    size_t vertices = 0, indices = 0;
+
+    for( const MODEL_CACHE_FILES& files : aFiles )
+    {
+        SGNODE* scene = S3D::ReadCache( files.m_sceneCache.ToUTF8(), nullptr, nullptr );
+
+        if( !scene )
+            continue;
+
+        S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+
+        if( model )
+        {
+            countModel( *model, vertices, indices );
+            S3D::Destroy3DModel( &model );
+        }
+
+        S3D::DestroyNode( scene );
+    }
+
+    return vertices;
+}
+
+
+/**
+ * Map the mesh cache files.
+ *
+ * @return the total vertex count, to check the result
+ */
+static size_t loadMeshCaches( const std::vector<MODEL_CACHE_FILES>& aFiles )
+{
+    size_t vertices = 0, indices = 0;
+
+    for( const MODEL_CACHE_FILES& files : aFiles )
+    {
+        S3D_MESH_CACHE meshCache;
+
+        if( meshCache.Open( files.m_meshCache, nullptr, nullptr ) )
+            countModel( *meshCache.GetModel(), vertices, indices );
+    }
+
+    return vertices;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print loading information" ).mb_str() },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input 3D model files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum MESH_CACHE_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    CACHE_MISMATCH,
+};
+
+
+int mesh_cache_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the 3D model caches: it reads the render data of a "
+               "set of models from the scene graph cache files, then from the mesh cache "
+               "files." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long reps = 5;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    // The cache files are written in a temporary directory
+    wxFileName cacheDir( wxFileName::GetTempDir(), "" );
+    cacheDir.AppendDir( wxString::Format( "kicad_3d_mesh_cache_%lu", wxGetProcessId() ) );
+
+    if( !cacheDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return MESH_CACHE_RET_CODES::LOAD_FAILED;
+
+    S3D_PLUGIN_MANAGER             plugins;
+    std::vector<MODEL_CACHE_FILES> files;
+    size_t                         expectedVertices = 0, indices = 0;
+    bool                           loadFailed = false;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        wxFileName fn( cl_parser.GetParam( i ) );
+        fn.MakeAbsolute();
+
+        MODEL_CACHE_FILES modelFiles;
+
+        if( !writeCacheFiles( plugins, fn.GetFullPath(), cacheDir.GetPathWithSep(), i,
+                              modelFiles ) )
+        {
+            std::cerr << "Cannot load " << fn.GetFullPath() << std::endl;
+            loadFailed = true;
+            continue;
+        }
+
+        files.push_back( modelFiles );
+        expectedVertices += modelFiles.m_vertices;
+        indices += modelFiles.m_indices;
+    }
+
+    double sceneMs = 0.0, meshMs = 0.0;
+    size_t sceneVertices = 0, meshVertices = 0;
+
+    for( long rep = 0; rep < reps; ++rep )
+    {
+        PROF_COUNTER sceneTimer;
+        sceneVertices = loadSceneCaches( files );
+        sceneMs += sceneTimer.msecs();
+
+        PROF_COUNTER meshTimer;
+        meshVertices = loadMeshCaches( files );
+        meshMs += meshTimer.msecs();
+    }
+
+    sceneMs /= reps;
+    meshMs /= reps;
+
+    if( verbose )
+    {
+        std::cout << "Models: " << files.size() << ", vertices: " << expectedVertices
+                  << ", indices: " << indices << ", repetitions: " << reps << std::endl;
+        std::cout << "Scene graph cache + conversion: " << sceneMs << "ms" << std::endl;
+        std::cout << "Mesh cache:                     " << meshMs << "ms" << std::endl;
+        std::cout << "Speedup: " << sceneMs / meshMs << std::endl;
+    }
+
+    for( const MODEL_CACHE_FILES& modelFiles : files )
+    {
+        wxRemoveFile( modelFiles.m_sceneCache );
+        wxRemoveFile( modelFiles.m_meshCache );
+    }
+
+    cacheDir.Rmdir();
+
+    if( loadFailed )
+        return MESH_CACHE_RET_CODES::LOAD_FAILED;
+
+    if( sceneVertices != expectedVertices || meshVertices != expectedVertices )
+        return MESH_CACHE_RET_CODES::CACHE_MISMATCH;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "3d_mesh_cache",
+        "Benchmark the 3D model scene graph and mesh caches", mesh_cache_main_func } );
@@ -0,0 +1,301 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the matching of a netlist in BOARD_NETLIST_UPDATER: the
+ * components of a netlist are matched to the footprints, pads and nets of a board with
+ * BOARD_NETLIST_INDEX, as the updater does, then with the searches of the board the updater
+ * made before.
+ *
+ * The netlist is made from the footprints of the board, which is read from a file or
+ * generated.  The updater itself needs a PCB_EDIT_FRAME, so it is not run.
+ *
+ * Typical use:
+ *    qa_pcbnew_tools netlist_index -v -r 5 board.kicad_pcb
+ *    qa_pcbnew_tools netlist_index -v -g 20000
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <netinfo.h>
+#include <netlist_reader/board_netlist_updater.h>
+#include <netlist_reader/pcb_netlist.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+
+#include <algorithm>
+#include <iostream>
+
+
+/**
+ * Fill aBoard with aCount footprints of aPadCount pads, each net connecting 4 pads
+ */
+static void generateBoard( BOARD& aBoard, int aCount, int aPadCount )
+{
+    std::vector<NETINFO_ITEM*> nets( std::max( aCount * aPadCount / 4, 1 ) );
+
+    for( size_t ii = 0; ii < nets.size(); ++ii )
+    {
+        nets[ii] = new NETINFO_ITEM( &aBoard, wxString::Format( "Net-%d", (int) ii ) );
+        aBoard.Add( nets[ii] );
+    }
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        MODULE*   footprint = new MODULE( &aBoard );
+        KIID_PATH path;
+
+        path.push_back( KIID() );
+        footprint->SetReference( wxString::Format( "U%d", ii + 1 ) );
+        footprint->SetPath( path );
+
+        for( int jj = 0; jj < aPadCount; ++jj )
+        {
+            D_PAD* pad = new D_PAD( footprint );
+            pad->SetName( wxString::Format( "%d", jj + 1 ) );
+            pad->SetNet( nets[( ii * aPadCount + jj ) / 4 % nets.size()] );
+            footprint->Add( pad, ADD_MODE::APPEND );
+        }
+
+        aBoard.Add( footprint, ADD_MODE::APPEND );
+    }
+}
+
+
+/**
+ * Make the netlist of the footprints of aBoard: the components and their pin nets are the
+ * ones of the footprints and their pads
+ */
+static void makeNetlist( BOARD& aBoard, NETLIST& aNetlist )
+{
+    for( MODULE* footprint : aBoard.Modules() )
+    {
+        COMPONENT* component = new COMPONENT( footprint->GetFPID(), footprint->GetReference(),
+                                              footprint->GetValue(), footprint->GetPath() );
+
+        for( D_PAD* pad : footprint->Pads() )
+        {
+            if( pad->GetNetCode() > 0 )
+                component->AddNet( pad->GetName(), pad->GetNetname(), wxEmptyString );
+        }
+
+        aNetlist.AddComponent( component );
+    }
+}
+
+
+/**
+ * Match the components as the updater did before the index: search all the footprints for
+ * each component, then search the board for the pads and the nets
+ *
+ * @return the count of matched pins
+ */
+static int matchWithSearches( BOARD& aBoard, NETLIST& aNetlist, bool aByPath )
+{
+    int matched = 0;
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ++ii )
+    {
+        COMPONENT* component = aNetlist.GetComponent( ii );
+
+        for( MODULE* footprint : aBoard.Modules() )
+        {
+            if( aByPath ? footprint->GetPath() != component->GetPath()
+                        : footprint->GetReference().CmpNoCase( component->GetReference() ) != 0 )
+            {
+                continue;
+            }
+
+            for( unsigned jj = 0; jj < component->GetNetCount(); ++jj )
+            {
+                const COMPONENT_NET& net = component->GetNet( jj );
+
+                if( footprint->FindPadByName( net.GetPinName() )
+                        && aBoard.FindNet( net.GetNetName() ) )
+                {
+                    matched++;
+                }
+            }
+        }
+    }
+
+    return matched;
+}
+
+
+/**
+ * Match the components with the index, as BOARD_NETLIST_UPDATER::UpdateNetlist() does
+ *
+ * @return the count of matched pins
+ */
+static int matchWithIndex( BOARD& aBoard, NETLIST& aNetlist, bool aByPath )
+{
+    BOARD_NETLIST_INDEX index;
+    int                 matched = 0;
+
+    index.Build( &aBoard );
+
+    for( unsigned ii = 0; ii < aNetlist.GetCount(); ++ii )
+    {
+        COMPONENT* component = aNetlist.GetComponent( ii );
+
+        const std::vector<MODULE*>& footprints =
+                aByPath ? index.FindModulesByPath( component->GetPath() )
+                        : index.FindModulesByReference( component->GetReference() );
+
+        for( MODULE* footprint : footprints )
+        {
+            for( unsigned jj = 0; jj < component->GetNetCount(); ++jj )
+            {
+                const COMPONENT_NET& net = component->GetNet( jj );
+
+                if( index.FindPad( footprint->GetReference(), net.GetPinName() )
+                        && index.FindNet( net.GetNetName() ) )
+                {
+                    matched++;
+                }
+            }
+        }
+    }
+
+    return matched;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print the matching times" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "p", "path", _( "match the footprints by path" ).mb_str() },
+    { wxCMD_LINE_OPTION, "g", "generate",
+            _( "generate a board of this number of footprints instead of reading one" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 3)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum NETLIST_INDEX_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    MATCH_MISMATCH,
+};
+
+
+int netlist_index_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the matching of a netlist to the footprints, pads and "
+               "nets of a board, with the index of the netlist updater and with the searches "
+               "of the board." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+    const bool byPath = cl_parser.Found( "path" );
+
+    long reps = 3;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    std::unique_ptr<BOARD> board;
+    long                   generated = 0;
+
+    if( cl_parser.Found( "generate", &generated ) )
+    {
+        board = std::make_unique<BOARD>();
+        generateBoard( *board, std::max( generated, 1L ), 8 );
+    }
+    else
+    {
+        std::string filename;
+
+        if( cl_parser.GetParamCount() )
+            filename = cl_parser.GetParam( 0 ).ToStdString();
+
+        board = KI_TEST::ReadBoardFromFileOrStream( filename );
+    }
+
+    if( !board )
+        return NETLIST_INDEX_RET_CODES::LOAD_FAILED;
+
+    NETLIST netlist;
+    makeNetlist( *board, netlist );
+
+    double indexMs = 0.0, searchMs = 0.0;
+    int    indexMatched = 0, searchMatched = 0;
+
+    for( long rep = 0; rep < reps; ++rep )
+    {
+        PROF_COUNTER indexTimer;
+        indexMatched = matchWithIndex( *board, netlist, byPath );
+        indexMs += indexTimer.msecs();
+
+        PROF_COUNTER searchTimer;
+        searchMatched = matchWithSearches( *board, netlist, byPath );
+        searchMs += searchTimer.msecs();
+    }
+
+    indexMs /= reps;
+    searchMs /= reps;
+
+    if( verbose )
+    {
+        std::cout << "Footprints: " << board->Modules().size() << ", matched pins: "
+                  << indexMatched << ", repetitions: " << reps << std::endl;
+        std::cout << "Searches: " << searchMs << "ms" << std::endl;
+        std::cout << "Index:    " << indexMs << "ms" << std::endl;
+        std::cout << "Speedup: " << searchMs / indexMs << std::endl;
+    }
+
+    if( indexMatched != searchMatched )
+    {
+        std::cerr << "The index matched " << indexMatched << " pins, the searches "
+                  << searchMatched << std::endl;
+        return NETLIST_INDEX_RET_CODES::MATCH_MISMATCH;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "netlist_index",
+        "Benchmark the matching of a netlist to the board items", netlist_index_main_func } );
@@ -0,0 +1,269 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to render a board with the 3D viewer raytracer, without any OpenGL
+ * context, and save the result as a PNG file.
+ *
+ * Typical use:
+ *    qa_pcbnew_tools raytrace_render -o board.png -W 1920 -H 1080 --rotx 45 board.kicad_pcb
+ *    qa_pcbnew_tools raytrace_render --bench 5 board.kicad_pcb
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <profile.h>
+#include <reporter.h>
+#include <settings/color_settings.h>
+
+#include <3d_canvas/board_adapter.h>
+#include <3d_rendering/ctrack_ball.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_viewer/3d_viewer_settings.h>
+
+#include <wx/cmdline.h>
+#include <wx/image.h>
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print rendering information" ).mb_str() },
+    { wxCMD_LINE_OPTION, "o", "output", _( "output PNG file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING },
+    { wxCMD_LINE_OPTION, "W", "width", _( "image width (default 1280)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "H", "height", _( "image height (default 960)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, nullptr, "rotx", _( "camera rotation around X, in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, nullptr, "roty", _( "camera rotation around Y, in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, nullptr, "rotz", _( "camera rotation around Z, in degrees" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, nullptr, "zoom", _( "camera zoom factor (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, nullptr, "passes",
+            _( "max progressive refinement passes (0 to disable)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, nullptr, "noise",
+            _( "noise level of a converged block (default 0.01)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE },
+    { wxCMD_LINE_OPTION, nullptr, "time-budget",
+            _( "max render time in ms, after the first pass (0 for no limit)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, nullptr, "bench",
+            _( "benchmark mode: render N times and report the timings" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum RAYTRACE_RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RENDER_FAILED,
+    SAVE_FAILED,
+};
+
+
+/**
+ * Set the board adapter colors from a color theme, as the 3D viewer frame does.
+ */
+static void setAdapterColors( BOARD_ADAPTER& aAdapter, COLOR_SETTINGS& aColors )
+{
+    auto set_color =
+            [] ( const COLOR4D& aColor, SFVEC4F& aTarget )
+            {
+                aTarget.r = aColor.r;
+                aTarget.g = aColor.g;
+                aTarget.b = aColor.b;
+                aTarget.a = aColor.a;
+            };
+
+    set_color( aColors.GetColor( LAYER_3D_BACKGROUND_BOTTOM ), aAdapter.m_BgColorBot );
+    set_color( aColors.GetColor( LAYER_3D_BACKGROUND_TOP ),    aAdapter.m_BgColorTop );
+    set_color( aColors.GetColor( LAYER_3D_BOARD ),             aAdapter.m_BoardBodyColor );
+    set_color( aColors.GetColor( LAYER_3D_COPPER ),            aAdapter.m_CopperColor );
+    set_color( aColors.GetColor( LAYER_3D_SILKSCREEN_BOTTOM ), aAdapter.m_SilkScreenColorBot );
+    set_color( aColors.GetColor( LAYER_3D_SILKSCREEN_TOP ),    aAdapter.m_SilkScreenColorTop );
+    set_color( aColors.GetColor( LAYER_3D_SOLDERMASK ),        aAdapter.m_SolderMaskColorBot );
+    set_color( aColors.GetColor( LAYER_3D_SOLDERMASK ),        aAdapter.m_SolderMaskColorTop );
+    set_color( aColors.GetColor( LAYER_3D_SOLDERPASTE ),       aAdapter.m_SolderPasteColor );
+}
+
+
+int raytrace_render_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a board with the raytracing engine of the 3D viewer, "
+               "without any OpenGL context, and saves the image as a PNG file. "
+               "3D models are not rendered." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long width = 1280;
+    long height = 960;
+    cl_parser.Found( "width", &width );
+    cl_parser.Found( "height", &height );
+
+    double rotx = 0.0, roty = 0.0, rotz = 0.0, zoom = 1.0;
+    cl_parser.Found( "rotx", &rotx );
+    cl_parser.Found( "roty", &roty );
+    cl_parser.Found( "rotz", &rotz );
+    cl_parser.Found( "zoom", &zoom );
+
+    long benchReps = 0;
+    cl_parser.Found( "bench", &benchReps );
+
+    wxString outputFile;
+    cl_parser.Found( "output", &outputFile );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return RAYTRACE_RENDER_RET_CODES::LOAD_FAILED;
+
+    // Use the default 3D viewer settings and color theme
+    EDA_3D_VIEWER_SETTINGS settings;
+    settings.ResetToDefaults();
+
+    COLOR_SETTINGS colors;
+
+    BOARD_ADAPTER adapter;
+    adapter.SetBoard( board.get() );
+    adapter.SetColorSettings( &colors );
+    adapter.Set3DCacheManager( nullptr );
+    adapter.LoadSettings( settings );
+
+    long passes = 0, timeBudget = 0;
+    double noise = 0.0;
+
+    if( cl_parser.Found( "passes", &passes ) )
+        adapter.m_raytrace_progressive_passes = passes;
+
+    if( cl_parser.Found( "noise", &noise ) )
+        adapter.m_raytrace_progressive_noise = noise;
+
+    if( cl_parser.Found( "time-budget", &timeBudget ) )
+        adapter.m_raytrace_progressive_time_budget = timeBudget;
+
+    adapter.RenderEngineSet( RENDER_ENGINE::RAYTRACING );
+    setAdapterColors( adapter, colors );
+
+    CTRACK_BALL camera( RANGE_SCALE_3D );
+
+    C3D_RENDER_RAYTRACING renderer( adapter, camera );
+
+    REPORTER& reporter = verbose ? STDOUT_REPORTER::GetInstance() : NULL_REPORTER::GetInstance();
+    const wxSize size( width, height );
+
+    // The first render loads the board, and sets the camera on the board center
+    wxImage image;
+    PROF_COUNTER firstRender;
+
+    if( !renderer.RenderOffscreen( size, image, &reporter, &reporter ) )
+        return RAYTRACE_RENDER_RET_CODES::RENDER_FAILED;
+
+    firstRender.Stop();
+
+    if( rotx != 0.0 || roty != 0.0 || rotz != 0.0 || zoom != 1.0 )
+    {
+        camera.RotateX( glm::radians( rotx ) );
+        camera.RotateY( glm::radians( roty ) );
+        camera.RotateZ( glm::radians( rotz ) );
+        camera.Zoom( zoom );
+
+        if( !renderer.RenderOffscreen( size, image, &reporter, &reporter ) )
+            return RAYTRACE_RENDER_RET_CODES::RENDER_FAILED;
+    }
+
+    if( benchReps > 0 )
+    {
+        double totalMs = 0.0;
+        size_t totalRays = 0;
+
+        for( long rep = 0; rep < benchReps; ++rep )
+        {
+            PROF_COUNTER timer;
+            renderer.RenderOffscreen( size, image, nullptr, nullptr );
+            totalMs += timer.msecs();
+            totalRays += renderer.GetCameraRaysCount();
+        }
+
+        std::cout << "Image: " << image.GetWidth() << "x" << image.GetHeight() << std::endl;
+        std::cout << "Load and first render: " << firstRender.msecs() << "ms" << std::endl;
+        std::cout << "BVH build: " << renderer.GetBVHBuildTime() / 1000.0 << "ms" << std::endl;
+        std::cout << "Render: " << totalMs / benchReps << "ms (average of " << benchReps
+                  << ")" << std::endl;
+        std::cout << "Camera rays/sec: " << totalRays / ( totalMs / 1000.0 ) << std::endl;
+        std::cout << "Camera rays/pixel: "
+                  << (double) totalRays / benchReps / ( image.GetWidth() * image.GetHeight() )
+                  << std::endl;
+        std::cout << "Refinement passes: " << renderer.GetRefinePassesCount()
+                  << ", blocks not converged: " << renderer.GetNotConvergedBlocksCount()
+                  << std::endl;
+    }
+
+    if( !outputFile.IsEmpty() )
+    {
+        wxImage::AddHandler( new wxPNGHandler );
+
+        if( !image.SaveFile( outputFile, wxBITMAP_TYPE_PNG ) )
+            return RAYTRACE_RENDER_RET_CODES::SAVE_FAILED;
+
+        if( verbose )
+            std::cout << "Saved " << outputFile << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "raytrace_render",
+        "Render a board with the raytracer into a PNG file", raytrace_render_main_func } );
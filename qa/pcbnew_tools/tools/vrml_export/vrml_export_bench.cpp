@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the VRML board exporter: the board is exported with the pads
+ * and vias merged in the copper layers, then with the shared padstack instances, and the
+ * export time and the output size are reported for both.
+ *
+ * The 3D models are not exported (there is no project, so no 3D model cache).
+ *
+ * Typical use:
+ *    qa_pcbnew_tools vrml_export -v -r 5 board.kicad_pcb
+ */
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <exporters/export_vrml_board.h>
+#include <profile.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#include <algorithm>
+#include <iostream>
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print export information" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "i", "inline",
+            _( "use the legacy output (the one used when the 3D models are copied)" ).mb_str() },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 3)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum VRML_EXPORT_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    EXPORT_FAILED,
+};
+
+
+/**
+ * The result of the exports of a board with one setting
+ */
+struct VRML_EXPORT_RESULT
+{
+    double            m_msecs = 0.0;    ///< average export time
+    wxULongLong       m_size = 0;       ///< output file size
+    VRML_EXPORT_STATS m_stats;
+};
+
+
+static bool exportBoard( BOARD& aBoard, const wxString& aFileName, const wxString& aSubdir,
+                         bool aInline, bool aShared, long aReps, VRML_EXPORT_RESULT& aResult )
+{
+    wxString errorMsg;
+
+    for( long rep = 0; rep < aReps; ++rep )
+    {
+        PROF_COUNTER timer;
+
+        if( !ExportBoardToVRML( &aBoard, nullptr, nullptr, aFileName, 1.0, aInline, false,
+                                false, aSubdir, 0.0, 0.0, aShared, errorMsg,
+                                &aResult.m_stats ) )
+        {
+            std::cerr << "Export failed: " << errorMsg << std::endl;
+            return false;
+        }
+
+        aResult.m_msecs += timer.msecs();
+    }
+
+    aResult.m_msecs /= aReps;
+    aResult.m_size = wxFileName::GetSize( aFileName );
+
+    return true;
+}
+
+
+int vrml_export_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the VRML export of a board, with and without the "
+               "shared padstack instances." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+    const bool useInline = cl_parser.Found( "inline" );
+
+    long reps = 3;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    std::string filename;
+
+    if( cl_parser.GetParamCount() )
+        filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !board )
+        return VRML_EXPORT_RET_CODES::LOAD_FAILED;
+
+    // The output is written in a temporary directory
+    wxFileName outputDir( wxFileName::GetTempDir(), "" );
+    outputDir.AppendDir( wxString::Format( "kicad_vrml_export_%lu", wxGetProcessId() ) );
+
+    if( !outputDir.Mkdir( wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return VRML_EXPORT_RET_CODES::EXPORT_FAILED;
+
+    wxString outputFile = outputDir.GetPathWithSep() + "board.wrl";
+    wxString subdir = outputDir.GetPathWithSep() + "shapes3D";
+
+    // A first untimed export fills the zones which are not filled
+    VRML_EXPORT_RESULT warmup, merged, shared;
+
+    bool ok = exportBoard( *board, outputFile, subdir, useInline, true, 1, warmup )
+              && exportBoard( *board, outputFile, subdir, useInline, false, reps, merged )
+              && exportBoard( *board, outputFile, subdir, useInline, true, reps, shared );
+
+    wxRemoveFile( outputFile );
+
+    if( wxFileName::DirExists( subdir ) )
+        wxFileName::Rmdir( subdir );
+
+    outputDir.Rmdir();
+
+    if( !ok )
+        return VRML_EXPORT_RET_CODES::EXPORT_FAILED;
+
+    if( verbose )
+    {
+        std::cout << "Output: " << ( useInline ? "legacy (inline)" : "scenegraph" )
+                  << ", repetitions: " << reps << std::endl;
+        std::cout << "Merged pads and vias: " << merged.m_msecs << "ms, "
+                  << merged.m_size.ToString() << " bytes" << std::endl;
+        std::cout << "Shared padstacks:     " << shared.m_msecs << "ms, "
+                  << shared.m_size.ToString() << " bytes ("
+                  << shared.m_stats.m_PadstackInstances << " instances of "
+                  << shared.m_stats.m_Padstacks << " padstacks)" << std::endl;
+        std::cout << "Speedup: " << merged.m_msecs / shared.m_msecs << ", size ratio: "
+                  << merged.m_size.ToDouble() / shared.m_size.ToDouble() << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "vrml_export",
+        "Benchmark the VRML board export", vrml_export_main_func } );
@@ -0,0 +1,254 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Utility tool to benchmark the parse throughput of the 3D model plugins (mainly the VRML
+ * one, for the large vendor models): each model is loaded with the plugins, without the 3D
+ * cache, and the load time and the throughput are reported.
+ *
+ * With -j, all the models are then loaded by several threads, as the 3D cache preloads them,
+ * and the speedup over the sequential loads is reported: the models of the reentrant plugins
+ * are loaded in parallel, the ones of the other plugins one at a time.
+ *
+ * Typical use:
+ *    qa_pcbnew_tools vrml_load -v -r 5 <3D model files>
+ *    qa_pcbnew_tools vrml_load -v -j 8 <3D model files>
+ */
+
+#include <3d_plugin_manager.h>
+#include <plugins/3dapi/ifsg_api.h>
+#include <sg/scenegraph.h>
+
+#include <profile.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+
+/**
+ * The load results of a model
+ */
+struct MODEL_LOAD_RESULT
+{
+    double m_msecs = 0.0;       ///< average load time
+    double m_size = 0.0;        ///< file size, in bytes
+    size_t m_vertices = 0;      ///< vertices of the render data, to check the result
+};
+
+
+/**
+ * Load a model aReps times with the plugins.
+ *
+ * @return false if the model cannot be loaded
+ */
+static bool loadModel( S3D_PLUGIN_MANAGER& aPlugins, const wxString& aModelFile, long aReps,
+                       MODEL_LOAD_RESULT& aResult )
+{
+    aResult.m_size = wxFileName::GetSize( aModelFile ).ToDouble();
+
+    for( long rep = 0; rep < aReps; ++rep )
+    {
+        std::string  pluginInfo;
+        PROF_COUNTER timer;
+        SCENEGRAPH*  scene = aPlugins.Load3DModel( aModelFile, pluginInfo );
+
+        aResult.m_msecs += timer.msecs();
+
+        if( !scene )
+            return false;
+
+        if( rep == 0 )
+        {
+            S3DMODEL* model = S3D::GetModel( scene );
+
+            if( model )
+            {
+                for( unsigned int i = 0; i < model->m_MeshesSize; ++i )
+                    aResult.m_vertices += model->m_Meshes[i].m_VertexSize;
+
+                S3D::Destroy3DModel( &model );
+            }
+        }
+
+        S3D::DestroyNode( (SGNODE*) scene );
+    }
+
+    aResult.m_msecs /= aReps;
+
+    return true;
+}
+
+
+/**
+ * Load all the models aReps times with aThreads threads sharing the plugins.
+ *
+ * @return the average time of a load of all the models
+ */
+static double loadModelsInParallel( S3D_PLUGIN_MANAGER& aPlugins,
+                                    const std::vector<wxString>& aModelFiles, long aReps,
+                                    long aThreads )
+{
+    PROF_COUNTER timer;
+
+    for( long rep = 0; rep < aReps; ++rep )
+    {
+        std::atomic<size_t>      nextModel( 0 );
+        std::vector<std::thread> threads;
+
+        for( long ii = 0; ii < aThreads; ++ii )
+        {
+            threads.emplace_back(
+                    [&]()
+                    {
+                        for( size_t jj = nextModel++; jj < aModelFiles.size(); jj = nextModel++ )
+                        {
+                            std::string pluginInfo;
+                            SCENEGRAPH* scene = aPlugins.Load3DModel( aModelFiles[jj],
+                                                                      pluginInfo );
+
+                            if( scene )
+                                S3D::DestroyNode( (SGNODE*) scene );
+                        }
+                    } );
+        }
+
+        for( std::thread& thread : threads )
+            thread.join();
+    }
+
+    return timer.msecs() / aReps;
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+    { wxCMD_LINE_SWITCH, "v", "verbose", _( "print loading information" ).mb_str() },
+    { wxCMD_LINE_OPTION, "r", "reps", _( "number of repetitions (default 3)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_OPTION, "j", "threads",
+            _( "also load the models with this number of threads" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER },
+    { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input 3D model files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_MULTIPLE },
+    { wxCMD_LINE_NONE }
+};
+
+
+enum VRML_LOAD_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+int vrml_load_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program benchmarks the parse throughput of the 3D model plugins: "
+               "each model is loaded with the plugins, without the 3D cache." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    long reps = 3;
+    cl_parser.Found( "reps", &reps );
+    reps = std::max( reps, 1L );
+
+    long threads = 0;
+    cl_parser.Found( "threads", &threads );
+
+    S3D_PLUGIN_MANAGER    plugins;
+    std::vector<wxString> modelFiles;
+    double                totalMs = 0.0, totalSize = 0.0;
+    bool                  loadFailed = false;
+
+    for( unsigned i = 0; i < cl_parser.GetParamCount(); i++ )
+    {
+        wxFileName fn( cl_parser.GetParam( i ) );
+        fn.MakeAbsolute();
+
+        MODEL_LOAD_RESULT result;
+
+        if( !loadModel( plugins, fn.GetFullPath(), reps, result ) )
+        {
+            std::cerr << "Cannot load " << fn.GetFullPath() << std::endl;
+            loadFailed = true;
+            continue;
+        }
+
+        modelFiles.push_back( fn.GetFullPath() );
+        totalMs += result.m_msecs;
+        totalSize += result.m_size;
+
+        if( verbose )
+        {
+            std::cout << fn.GetFullName() << ": " << result.m_size / 1e6 << "MB, "
+                      << result.m_vertices << " vertices, " << result.m_msecs << "ms, "
+                      << result.m_size / 1e3 / result.m_msecs << "MB/s" << std::endl;
+        }
+    }
+
+    if( verbose && totalMs > 0.0 )
+    {
+        std::cout << "Total: " << totalSize / 1e6 << "MB, " << totalMs << "ms, "
+                  << totalSize / 1e3 / totalMs << "MB/s (repetitions: " << reps << ")"
+                  << std::endl;
+    }
+
+    if( threads > 1 && !modelFiles.empty() )
+    {
+        double parallelMs = loadModelsInParallel( plugins, modelFiles, reps, threads );
+
+        if( verbose )
+        {
+            std::cout << threads << " threads: " << parallelMs << "ms, speedup: "
+                      << totalMs / parallelMs << std::endl;
+        }
+    }
+
+    if( loadFailed )
+        return VRML_LOAD_RET_CODES::LOAD_FAILED;
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( { "vrml_load",
+        "Benchmark the parse throughput of the 3D model plugins", vrml_load_main_func } );
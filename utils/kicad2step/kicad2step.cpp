@@ -34,6 +34,7 @@
 #include "pcb/kicadpcb.h"
 #include "kicad2step_frame_base.h"
 #include "panel_kicad2step.h"
+#include <profile.h>
 #include <Standard_Failure.hxx>     // In open cascade
 
 class KICAD2STEP_FRAME;
@@ -75,6 +76,7 @@ KICAD2MCAD_PRMS::KICAD2MCAD_PRMS()
     m_useGridOrigin = false;
     m_useDrillOrigin = false;
     m_includeVirtual = true;
+    m_verbose = false;
     m_xOrigin = 0.0;
     m_yOrigin = 0.0;
     m_minDistance = MIN_DISTANCE;
@@ -114,6 +116,8 @@ static const wxCmdLineEntryDesc cmdLineDesc[] =
         { wxCMD_LINE_OPTION, NULL, "min-distance",
             _( "Minimum distance between points to treat them as separate ones (default 0.01 mm)" ).mb_str(),
             wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+        { wxCMD_LINE_SWITCH, "v", "verbose", _( "report the time of each export phase" ).mb_str(),
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_PARAM_OPTIONAL },
         { wxCMD_LINE_SWITCH, "h", NULL, _( "display this message" ).mb_str(),
             wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
         { wxCMD_LINE_NONE, nullptr, nullptr, nullptr, wxCMD_LINE_VAL_NONE, 0 }
@@ -204,6 +208,9 @@ bool KICAD2MCAD_APP::OnCmdLineParsed( wxCmdLineParser& parser )
     if( parser.Found( "no-virtual" ) )
         m_params.m_includeVirtual = false;
 
+    if( parser.Found( "v" ) )
+        m_params.m_verbose = true;
+
     wxString tstr;
 
     if( parser.Found( "user-origin", &tstr ) )
@@ -364,8 +371,21 @@ int PANEL_KICAD2STEP::RunConverter()
 
     pcb.SetOrigin( m_params.m_xOrigin, m_params.m_yOrigin );
     pcb.SetMinDistance( m_params.m_minDistance );
+    pcb.SetVerbose( m_params.m_verbose );
     ReportMessage( wxString::Format( "Read: %s\n", m_params.m_filename ) );
 
+    PROF_COUNTER timer;
+
+    auto reportTime =
+            [&]( const char* aPhase )
+            {
+                if( m_params.m_verbose )
+                {
+                    ReportMessage( wxString::Format( "  time to %s: %.0f ms\n", aPhase,
+                                                     timer.msecs( true ) ) );
+                }
+            };
+
     // create the new streams to "redirect" cout and cerr output to
     // msgs_from_opencascade and errors_from_opencascade
     std::ostringstream msgs_from_opencascade;
@@ -375,6 +395,8 @@ int PANEL_KICAD2STEP::RunConverter()
 
     if( pcb.ReadFile( m_params.m_filename ) )
     {
+        reportTime( "read the board" );
+
         if( m_params.m_useDrillOrigin )
             pcb.UseDrillOrigin( true );
 
@@ -396,6 +418,7 @@ int PANEL_KICAD2STEP::RunConverter()
             }
 
             ReportMessage( "Write STEP file\n" );
+            timer.msecs( true );
 
         #ifdef SUPPORTS_IGES
             if( m_fmtIGES )
@@ -409,6 +432,13 @@ int PANEL_KICAD2STEP::RunConverter()
                 ReportMessage( "\nError Write STEP file\n" );
                 return -1;
             }
+
+            reportTime( "write the STEP file" );
+
+            if( m_params.m_verbose )
+            {
+                ReportMessage( wxString::Format( "  total time: %.0f ms\n", timer.msecs() ) );
+            }
         }
         catch( const Standard_Failure& e )
         {
@@ -101,7 +101,7 @@ bool KICADCURVE::Read( SEXPR::SEXPR* aEntry, CURVE_TYPE aCurveType )
             int ii = 0;
 
             // The first parameter is "pts", so skip it.
-            for( std::vector<SEXPR::SEXPR*>::const_iterator it = list->begin()+1;
+            for( SEXPR::SEXPR_VECTOR::const_iterator it = list->begin()+1;
                  it != list->end(); ++it, ++ii )
             {
                 SEXPR::SEXPR* sub_child = (*it);
@@ -30,6 +30,8 @@
 #include <sexpr/sexpr.h>
 #include <sexpr/sexpr_parser.h>
 
+#include <profile.h>
+
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stdpaths.h>
@@ -98,6 +100,7 @@ KICADPCB::KICADPCB()
     m_useDrillOrigin = false;
     m_hasGridOrigin = false;
     m_hasDrillOrigin = false;
+    m_verbose = false;
 }
 
 
@@ -499,9 +502,13 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         m_pcb_model->AddOutlineSegment( &lcurve );
     }
 
+    PROF_COUNTER timer;
+
     for( auto i : m_modules )
         i->ComposePCB( m_pcb_model, &m_resolver, origin, aComposeVirtual );
 
+    reportTime( "load models and add components and holes", timer );
+
     ReportMessage( "Create PCB solid model\n" );
 
     if( !m_pcb_model->CreatePCB() )
@@ -512,5 +519,17 @@ bool KICADPCB::ComposePCB( bool aComposeVirtual )
         return false;
     }
 
+    reportTime( "create PCB solid model", timer );
+
     return true;
 }
+
+
+void KICADPCB::reportTime( const char* aPhase, PROF_COUNTER& aTimer )
+{
+    if( m_verbose )
+    {
+        ReportMessage( wxString::Format( "  time to %s: %.0f ms\n", aPhase,
+                                         aTimer.msecs( true ) ) );
+    }
+}
@@ -49,6 +49,7 @@ namespace SEXPR
 class KICADMODULE;
 class KICADCURVE;
 class PCBMODEL;
+class PROF_COUNTER;
 
 class KICADPCB
 {
@@ -68,6 +69,8 @@ private:
     double      m_minDistance;
     // the names of layers in use, and the internal layer ID
     std::map<std::string, int> m_layersNames;
+    // set true to report the time of the export phases
+    bool        m_verbose;
 
     // PCB parameters/entities
     double                      m_thickness;
@@ -82,6 +85,9 @@ private:
     bool parseCurve( SEXPR::SEXPR* data, CURVE_TYPE aCurveType );
     bool parseRect( SEXPR::SEXPR* data );
 
+    // report the time since the last call (in verbose mode)
+    void reportTime( const char* aPhase, PROF_COUNTER& aTimer );
+
 public:
     KICADPCB();
     virtual ~KICADPCB();
@@ -109,6 +115,11 @@ public:
         m_minDistance = aDistance;
     }
 
+    void SetVerbose( bool aVerbose )
+    {
+        m_verbose = aVerbose;
+    }
+
     bool ReadFile( const wxString& aFileName );
     bool ComposePCB( bool aComposeVirtual = true );
     bool WriteSTEP( const wxString& aFileName );
@@ -29,7 +29,6 @@
 #include <wx/wx.h>
 #include <wx/filename.h>
 #include <wx/filefn.h>
-#include <wx/stdpaths.h>
 #include <wx/wfstream.h>
 
 #include <decompress.hpp>
@@ -45,6 +44,7 @@
 #include <IGESData_IGESModel.hxx>
 #include <Interface_Static.hxx>
 #include <Quantity_Color.hxx>
+#include <STEPCAFControl_Controller.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
 #include <APIHeaderSection_MakeHeader.hxx>
@@ -251,6 +251,17 @@ PCBMODEL::PCBMODEL()
     m_minx = 1.0e10;    // absurdly large number; any valid PCB X value will be smaller
     m_mincurve = m_curves.end();
     BRepBuilderAPI::Precision( 1.0e-6 );
+
+    // The reader settings are global: they are set once, before any model is read
+    STEPCAFControl_Controller::Init();
+    IGESControl_Controller::Init();
+
+    // Enable user-defined shape precision
+    Interface_Static::SetIVal( "read.precision.mode", 1 );
+
+    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
+    Interface_Static::SetRVal( "read.precision.val", USER_PREC );
+
     return;
 }
 
@@ -818,7 +829,7 @@ bool PCBMODEL::CreatePCB()
             ReportMessage( wxString::Format( ". %d/%d\n", cur_count, cntmax ) );
         }
     }
-#else   // Much faster than first version: group all holes and cut only once
+#else   // Much faster than first version: group all holes in a compound and cut only once
     if( m_cutouts.size() )
     {
         BRepAlgoAPI_Cut Cut;
@@ -826,12 +837,21 @@ bool PCBMODEL::CreatePCB()
         mainbrd.Append( board );
 
         Cut.SetArguments( mainbrd );
-        TopTools_ListOfShape holelist;
 
-        for( auto hole : m_cutouts )
-             holelist.Append( hole );
+        TopoDS_Compound holes;
+        TopoDS_Builder  builder;
+        builder.MakeCompound( holes );
+
+        for( const TopoDS_Shape& hole : m_cutouts )
+            builder.Add( holes, hole );
+
+        TopTools_ListOfShape holelist;
+        holelist.Append( holes );
 
         Cut.SetTools( holelist );
+#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX >= 0x070101 )
+        Cut.SetRunParallel( Standard_True );
+#endif
         Cut.Build();
         board = Cut.Shape();
     }
@@ -859,7 +879,7 @@ bool PCBMODEL::CreatePCB()
         topex.Next();
     }
 
-#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX > 0x070101 )
+#if ( defined OCC_VERSION_HEX ) && ( OCC_VERSION_HEX >= 0x070101 )
     m_assy->UpdateAssemblies();
 #endif
     return true;
@@ -954,183 +974,302 @@ bool PCBMODEL::WriteSTEP( const wxString& aFileName )
 }
 
 
-bool PCBMODEL::getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_Label& aLabel )
+/**
+ * A model to load: the file which is read, and the document which receives its data
+ */
+struct MODEL_LOAD
 {
-    std::string model_key = aFileName + "_" + std::to_string( aScale.x )
-                            + "_" + std::to_string( aScale.y ) + "_" + std::to_string( aScale.z );
+    std::string                 m_key;          // the key of the model in the model map
+    std::string                 m_fileName;     // the file which is read
+    std::string                 m_readFileName; // the file given to the reader: m_fileName,
+                                                // or the expanded copy of a compressed file
+    bool                        m_tempFile = false; // set true if m_readFileName is a copy
+    FormatType                  m_format;
+    TRIPLET                     m_scale;
+    Handle( TDocStd_Document )  m_doc;
+    bool                        m_read = false; // set true if the file has been read
+    wxString                    m_error;        // the errors, reported by addModel()
+};
 
-    MODEL_MAP::const_iterator mm = m_models.find( model_key );
 
-    if( mm != m_models.end() )
+/**
+ * Find the file which is read for a model file, and the model map key.
+ *
+ * WRL files are preferred for internal rendering, due to superior material properties,
+ * etc. However they are not suitable for MCAD export: if a .wrl file is specified, a
+ * replacement file is searched for it, and the label for THAT file is associated with
+ * the .wrl file.
+ */
+static void resolveModel( const std::string& aFileName, TRIPLET aScale, MODEL_LOAD& aLoad )
+{
+    aLoad.m_fileName = aFileName;
+    aLoad.m_format = fileType( aFileName.c_str() );
+    aLoad.m_scale = aScale;
+
+    if( aLoad.m_format == FMT_WRL || aLoad.m_format == FMT_WRZ )
     {
-        aLabel = mm->second;
-        return true;
+        wxFileName wrlName( aFileName );
+
+        wxString basePath = wrlName.GetPath();
+        wxString baseName = wrlName.GetName();
+
+        // List of alternate files to look for
+        // Given in order of preference
+        // (Break if match is found)
+        wxArrayString alts;
+
+        // Step files
+        alts.Add( "stp" );
+        alts.Add( "step" );
+        alts.Add( "STP" );
+        alts.Add( "STEP" );
+        alts.Add( "Stp" );
+        alts.Add( "Step" );
+        alts.Add( "stpz" );
+        alts.Add( "stpZ" );
+        alts.Add( "STPZ" );
+        alts.Add( "step.gz" );
+
+        // IGES files
+        alts.Add( "iges" );
+        alts.Add( "IGES" );
+        alts.Add( "igs" );
+        alts.Add( "IGS" );
+
+        //TODO - Other alternative formats?
+
+        for( const auto& alt : alts )
+        {
+            wxFileName altFile( basePath, baseName + "." + alt );
+
+            if( altFile.IsOk() && altFile.FileExists() )
+            {
+                std::string altFileName = altFile.GetFullPath().ToStdString();
+                FormatType  altFormat = fileType( altFileName.c_str() );
+
+                if( altFormat == FMT_STEP || altFormat == FMT_STEPZ || altFormat == FMT_IGES )
+                {
+                    aLoad.m_fileName = altFileName;
+                    aLoad.m_format = altFormat;
+                    break;
+                }
+            }
+        }
     }
 
-    aLabel.Nullify();
+    aLoad.m_key = aLoad.m_fileName + "_" + std::to_string( aScale.x )
+                  + "_" + std::to_string( aScale.y ) + "_" + std::to_string( aScale.z );
+}
 
-    Handle( TDocStd_Document )  doc;
-    m_app->NewDocument( "MDTV-XCAF", doc );
 
-    FormatType modelFmt = fileType( aFileName.c_str() );
+/**
+ * Find the file given to the reader of a model: a compressed STEP file is expanded to a
+ * temporary file.
+ */
+static void prepareModelFile( MODEL_LOAD& aLoad )
+{
+    const std::string& fileName = aLoad.m_fileName;
 
-    switch( modelFmt )
+    switch( aLoad.m_format )
     {
         case FMT_IGES:
-            if( !readIGES( doc, aFileName.c_str() ) )
-            {
-                ReportMessage( wxString::Format( "readIGES() failed on filename %s\n",
-                               aFileName ) );
-                return false;
-            }
-            break;
-
         case FMT_STEP:
-            if( !readSTEP( doc, aFileName.c_str() ) )
-            {
-                ReportMessage( wxString::Format( "readSTEP() failed on filename %s\n",
-                               aFileName ) );
-                return false;
-            }
+            aLoad.m_readFileName = fileName;
             break;
 
         case FMT_STEPZ:
         {
-            wxFileInputStream ifile( aFileName );
-            wxFileName outFile( aFileName );
-
-            outFile.SetPath( wxStandardPaths::Get().GetTempDir() );
-            outFile.SetExt( "STEP" );
-
+            wxFileInputStream ifile( fileName );
             wxFileOffset size = ifile.GetLength();
 
             if( size == wxInvalidOffset )
             {
-                ReportMessage( wxString::Format( "readSTEP() failed on filename %s\n",
-                                                 aFileName ) );
-                    return false;
+                aLoad.m_error = wxString::Format( "readSTEP() failed on filename %s\n", fileName );
+                break;
             }
 
-            {
-                wxFileOutputStream ofile( outFile.GetFullPath() );
+            // the expanded file has a unique name in the shared temporary directory
+            wxString outFile = wxFileName::CreateTempFileName( "kicad2step" );
 
-                if( !ofile.IsOk() )
-                {
-                    ReportMessage( wxString::Format( "readSTEP() failed on filename %s\n",
-                                                     outFile.GetFullPath() ) );
-                    return false;
-                }
+            if( outFile.IsEmpty() )
+            {
+                aLoad.m_error = wxString::Format( "readSTEP() failed on filename %s\n", fileName );
+                break;
+            }
 
-                char *buffer = new char[size];
+            bool expandedOk = false;
 
-                ifile.Read( buffer, size);
-                std::string expanded;
+            {
+                wxFileOutputStream ofile( outFile );
 
-                try
+                if( !ofile.IsOk() )
                 {
-                    expanded = gzip::decompress( buffer, size );
+                    aLoad.m_error = wxString::Format( "readSTEP() failed on filename %s\n",
+                                                      outFile );
                 }
-                catch(...)
+                else
                 {
-                    delete[] buffer;
-                    return false;
-                }
+                    std::vector<char> buffer( size );
 
-                delete[] buffer;
+                    ifile.Read( buffer.data(), size );
+                    std::string expanded;
+
+                    try
+                    {
+                        expanded = gzip::decompress( buffer.data(), size );
+                        expandedOk = true;
+                    }
+                    catch(...)
+                    {
+                        aLoad.m_error = wxString::Format( "readSTEP() failed on filename %s\n",
+                                                          fileName );
+                    }
 
-                ofile.Write( expanded.data(), expanded.size() );
-                ofile.Close();
+                    ofile.Write( expanded.data(), expanded.size() );
+                    ofile.Close();
+                }
             }
 
-            return getModelLabel( outFile.GetFullPath().ToStdString(), aScale, aLabel );
+            if( expandedOk )
+            {
+                aLoad.m_readFileName = outFile.ToUTF8();
+                aLoad.m_tempFile = true;
+            }
+            else
+            {
+                wxRemoveFile( outFile );
+            }
 
             break;
         }
 
-        case FMT_WRL:
-        case FMT_WRZ:
-            /* WRL files are preferred for internal rendering,
-             * due to superior material properties, etc.
-             * However they are not suitable for MCAD export.
-             *
-             * If a .wrl file is specified, attempt to locate
-             * a replacement file for it.
-             *
-             * If a valid replacement file is found, the label
-             * for THAT file will be associated with the .wrl file
-             *
-             */
-            {
-                wxFileName wrlName( aFileName );
-
-                wxString basePath = wrlName.GetPath();
-                wxString baseName = wrlName.GetName();
-
-                // List of alternate files to look for
-                // Given in order of preference
-                // (Break if match is found)
-                wxArrayString alts;
-
-                // Step files
-                alts.Add( "stp" );
-                alts.Add( "step" );
-                alts.Add( "STP" );
-                alts.Add( "STEP" );
-                alts.Add( "Stp" );
-                alts.Add( "Step" );
-                alts.Add( "stpz" );
-                alts.Add( "stpZ" );
-                alts.Add( "STPZ" );
-                alts.Add( "step.gz" );
-
-                // IGES files
-                alts.Add( "iges" );
-                alts.Add( "IGES" );
-                alts.Add( "igs" );
-                alts.Add( "IGS" );
-
-                //TODO - Other alternative formats?
-
-                for( const auto& alt : alts )
-                {
-                    wxFileName altFile( basePath, baseName + "." + alt );
+        default:
+            break;
+    }
+}
 
-                    if( altFile.IsOk() && altFile.FileExists() )
-                    {
-                        std::string altFileName = altFile.GetFullPath().ToStdString();
 
-                        if( getModelLabel( altFileName, aScale, aLabel ) )
-                        {
-                            return true;
-                        }
-                    }
-                }
-            }
+bool PCBMODEL::getModelLabel( const std::string& aFileName, TRIPLET aScale, TDF_Label& aLabel )
+{
+    MODEL_LOAD load;
+    resolveModel( aFileName, aScale, load );
+
+    MODEL_MAP::const_iterator mm = m_models.find( load.m_key );
+
+    if( mm != m_models.end() )
+    {
+        // the models which could not be loaded are kept with a null label
+        aLabel = mm->second;
+        return !aLabel.IsNull();
+    }
+
+    m_app->NewDocument( "MDTV-XCAF", load.m_doc );
+    prepareModelFile( load );
+    readModel( load );
+
+    return addModel( load, aLabel );
+}
+
+
+void PCBMODEL::readModel( MODEL_LOAD& aLoad )
+{
+    try
+    {
+        readModelFile( aLoad );
+    }
+    catch( const Standard_Failure& e )
+    {
+        aLoad.m_read = false;
+        aLoad.m_error << wxString::Format( "could not read %s\n>>Opencascade error: %s\n",
+                                           aLoad.m_fileName, e.GetMessageString() );
+    }
+    catch( ... )
+    {
+        aLoad.m_read = false;
+        aLoad.m_error << wxString::Format( "could not read %s\n", aLoad.m_fileName );
+    }
+
+    if( aLoad.m_tempFile )
+        wxRemoveFile( aLoad.m_readFileName );
+}
+
+
+void PCBMODEL::readModelFile( MODEL_LOAD& aLoad )
+{
+    const std::string& fileName = aLoad.m_fileName;
+
+    switch( aLoad.m_format )
+    {
+        case FMT_IGES:
+            aLoad.m_read = readIGES( aLoad.m_doc, aLoad.m_readFileName.c_str() );
+
+            if( !aLoad.m_read )
+                aLoad.m_error = wxString::Format( "readIGES() failed on filename %s\n", fileName );
+
+            break;
+
+        case FMT_STEP:
+        case FMT_STEPZ:
+            // a compressed file which could not be expanded has no file to read, and its
+            // error is already set
+            if( aLoad.m_readFileName.empty() )
+                break;
+
+            aLoad.m_read = readSTEP( aLoad.m_doc, aLoad.m_readFileName.c_str() );
+
+            if( !aLoad.m_read )
+                aLoad.m_error = wxString::Format( "readSTEP() failed on filename %s\n", fileName );
 
             break;
 
+        case FMT_WRL:
+        case FMT_WRZ:
+            // no replacement file: the component has an empty model
+            aLoad.m_read = true;
+            break;
+
         // TODO: implement IDF and EMN converters
 
         default:
-            return false;
+            break;
     }
+}
 
-    aLabel = transferModel( doc, m_doc, aScale );
 
-    if( aLabel.IsNull() )
+bool PCBMODEL::addModel( MODEL_LOAD& aLoad, TDF_Label& aLabel )
+{
+    aLabel.Nullify();
+
+    if( !aLoad.m_error.IsEmpty() )
+        ReportMessage( aLoad.m_error );
+
+    if( aLoad.m_read )
     {
-        ReportMessage( wxString::Format( "could not transfer model data from file %s\n", aFileName  ) );
-        return false;
+        aLabel = transferModel( aLoad.m_doc, m_doc, aLoad.m_scale );
+
+        if( aLabel.IsNull() )
+        {
+            ReportMessage( wxString::Format( "could not transfer model data from file %s\n",
+                                             aLoad.m_fileName ) );
+        }
     }
 
+    // the model data is in the assembly now
+    aLoad.m_doc->Close();
+
+    // failed models are kept too, so they are not loaded again for each component
+    m_models.insert( MODEL_DATUM( aLoad.m_key, aLabel ) );
+
+    if( aLabel.IsNull() )
+        return false;
+
     // attach the PART NAME ( base filename: note that in principle
     // different models may have the same base filename )
-    wxFileName afile( aFileName.c_str() );
+    wxFileName afile( aLoad.m_fileName.c_str() );
     std::string pname( afile.GetName().ToUTF8() );
     TCollection_ExtendedString partname( pname.c_str() );
     TDataStd_Name::Set( aLabel, partname );
 
-    m_models.insert( MODEL_DATUM( model_key, aLabel ) );
     ++m_components;
     return true;
 }
@@ -1192,45 +1331,34 @@ bool PCBMODEL::getModelLocation( bool aBottom, DOUBLET aPosition, double aRotati
 }
 
 
+// note: the document is closed by the caller, and the read precision is set by the
+// PCBMODEL constructor
 bool PCBMODEL::readIGES( Handle( TDocStd_Document )& doc, const char* fname )
 {
-    IGESControl_Controller::Init();
     IGESCAFControl_Reader reader;
     IFSelect_ReturnStatus stat  = reader.ReadFile( fname );
 
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use IGES label names
     reader.SetLayerMode(false); // ignore LAYER data
 
     if ( !reader.Transfer( doc ) )
-    {
-        doc->Close();
         return false;
-    }
 
     // are there any shapes to translate?
     if( reader.NbShapes() < 1 )
-    {
-        doc->Close();
         return false;
-    }
 
     return true;
 }
 
 
+// note: the document is closed by the caller, and the read precision is set by the
+// PCBMODEL constructor
 bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
 {
     STEPCAFControl_Reader reader;
@@ -1239,31 +1367,17 @@ bool PCBMODEL::readSTEP( Handle(TDocStd_Document)& doc, const char* fname )
     if( stat != IFSelect_RetDone )
         return false;
 
-    // Enable user-defined shape precision
-    if( !Interface_Static::SetIVal( "read.precision.mode", 1 ) )
-        return false;
-
-    // Set the shape conversion precision to USER_PREC (default 0.0001 has too many triangles)
-    if( !Interface_Static::SetRVal( "read.precision.val", USER_PREC ) )
-        return false;
-
     // set other translation options
     reader.SetColorMode(true);  // use model colors
     reader.SetNameMode(false);  // don't use label names
     reader.SetLayerMode(false); // ignore LAYER data
 
     if ( !reader.Transfer( doc ) )
-    {
-        doc->Close();
         return false;
-    }
 
     // are there any shapes to translate?
     if( reader.NbRootsForTransfer() < 1 )
-    {
-        doc->Close();
         return false;
-    }
 
     return true;
 }
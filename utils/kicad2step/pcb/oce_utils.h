@@ -45,6 +45,7 @@ typedef std::pair< std::string, TDF_Label > MODEL_DATUM;
 typedef std::map< std::string, TDF_Label > MODEL_MAP;
 
 class KICADPAD;
+struct MODEL_LOAD;
 
 class OUTLINE
 {
@@ -87,7 +88,8 @@ class PCBMODEL
     TDF_Label                       m_assy_label;
     bool                            m_hasPCB;       // set true if CreatePCB() has been invoked
     TDF_Label                       m_pcb_label;    // label for the PCB model
-    MODEL_MAP                       m_models;       // map of file names to model labels
+    MODEL_MAP                       m_models;       // map of file names and scales to model
+                                                    // labels (null for the failed models)
     int                             m_components;   // number of successfully loaded components;
     double                          m_precision;    // model (length unit) numeric precision
     double                          m_angleprec;    // angle numeric precision
@@ -99,7 +101,14 @@ class PCBMODEL
     std::list< KICADCURVE >     m_curves;
     std::vector< TopoDS_Shape > m_cutouts;
 
-    bool getModelLabel( const std::string aFileName, TRIPLET aScale, TDF_Label& aLabel );
+    bool getModelLabel( const std::string& aFileName, TRIPLET aScale, TDF_Label& aLabel );
+
+    // read the file of a model, prepared by getModelLabel(), into its document
+    void readModel( MODEL_LOAD& aLoad );
+    void readModelFile( MODEL_LOAD& aLoad );
+
+    // transfer a model read by readModel() to the assembly, and add it to m_models
+    bool addModel( MODEL_LOAD& aLoad, TDF_Label& aLabel );
 
     bool getModelLocation( bool aBottom, DOUBLET aPosition, double aRotation,
         TRIPLET aOffset, TRIPLET aOrientation, TopLoc_Location& aLocation );